@@ -0,0 +1,315 @@
+#pragma once
+#include "AnimationLoader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// Smallest-three quaternion (48 bits)
+// =========================================================================
+// The largest |component| is dropped (2-bit index) and rebuilt from the unit
+// length; the other three lie in [-1/sqrt2, 1/sqrt2] and get 15 bits each.
+struct PackedQuat {
+  uint16_t bits[3];
+
+  static constexpr float RANGE = 0.70710678f; // 1/sqrt(2)
+  static constexpr uint32_t MAX_VALUE = (1u << 15) - 1;
+
+  static PackedQuat Encode(const Quat &qIn) {
+    Quat q = qIn.Normalized();
+    float c[4] = {q.x, q.y, q.z, q.w};
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+      if (std::abs(c[i]) > std::abs(c[largest]))
+        largest = i;
+    }
+    float sign = c[largest] < 0.0f ? -1.0f : 1.0f; // q and -q are the same
+
+    uint64_t packed = static_cast<uint64_t>(largest);
+    int shift = 2;
+    for (int i = 0; i < 4; ++i) {
+      if (i == largest)
+        continue;
+      float v = std::clamp(c[i] * sign, -RANGE, RANGE);
+      float n = (v + RANGE) / (2.0f * RANGE);
+      uint64_t qv = static_cast<uint64_t>(std::lround(n * MAX_VALUE));
+      packed |= qv << shift;
+      shift += 15;
+    }
+
+    PackedQuat p;
+    p.bits[0] = static_cast<uint16_t>(packed);
+    p.bits[1] = static_cast<uint16_t>(packed >> 16);
+    p.bits[2] = static_cast<uint16_t>(packed >> 32);
+    return p;
+  }
+
+  Quat Decode() const {
+    uint64_t packed = static_cast<uint64_t>(bits[0]) |
+                      (static_cast<uint64_t>(bits[1]) << 16) |
+                      (static_cast<uint64_t>(bits[2]) << 32);
+    int largest = static_cast<int>(packed & 3u);
+    float c[4];
+    float sumSq = 0.0f;
+    int shift = 2;
+    for (int i = 0; i < 4; ++i) {
+      if (i == largest)
+        continue;
+      uint32_t qv = static_cast<uint32_t>((packed >> shift) & MAX_VALUE);
+      c[i] = (static_cast<float>(qv) / MAX_VALUE) * 2.0f * RANGE - RANGE;
+      sumSq += c[i] * c[i];
+      shift += 15;
+    }
+    c[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSq));
+    return {c[0], c[1], c[2], c[3]};
+  }
+};
+
+// =========================================================================
+// Compressed Clip
+// =========================================================================
+// Each channel is keyframe-reduced independently. A channel with one key is
+// constant and costs no search at runtime.
+template <typename T> struct CompressedChannel {
+  std::vector<float> times;
+  std::vector<T> values;
+
+  bool IsConstant() const { return values.size() == 1; }
+  size_t SizeBytes() const {
+    return times.size() * sizeof(float) + values.size() * sizeof(T);
+  }
+};
+
+struct CompressedTrack {
+  int boneIndex = -1;
+  CompressedChannel<Vec3> translation;
+  CompressedChannel<PackedQuat> rotation;
+  CompressedChannel<Vec3> scale;
+};
+
+struct CompressedClip {
+  std::string name;
+  float duration = 0.0f;
+  bool loops = true;
+  std::vector<CompressedTrack> tracks;
+
+  size_t SizeBytes() const {
+    size_t bytes = 0;
+    for (const auto &t : tracks) {
+      bytes += t.translation.SizeBytes() + t.rotation.SizeBytes() +
+               t.scale.SizeBytes();
+    }
+    return bytes;
+  }
+
+  float LocalTime(float t) const {
+    if (loops && duration > 0) {
+      float local = std::fmod(t, duration);
+      return local < 0 ? local + duration : local;
+    }
+    return std::clamp(t, 0.0f, duration);
+  }
+
+  // Runtime decompression: same contract as AnimationClip::SampleAll. The
+  // cursor holds three keys per track (translation, rotation, scale).
+  void SampleAll(float t, BoneKeyframe *out,
+                 AnimationCursor *cursor = nullptr) const {
+    float localT = LocalTime(t);
+    if (cursor && cursor->keys.size() != tracks.size() * 3)
+      cursor->Reset(tracks.size() * 3);
+    uint32_t scratch[3] = {0, 0, 0};
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+      const CompressedTrack &track = tracks[i];
+      uint32_t *keys = cursor ? &cursor->keys[i * 3] : scratch;
+      BoneKeyframe &kf = out[i];
+      kf.time = localT;
+      kf.translation = SampleVec3(track.translation, localT, keys[0]);
+      kf.rotation = SampleQuat(track.rotation, localT, keys[1]);
+      kf.scale = SampleVec3(track.scale, localT, keys[2]);
+    }
+  }
+
+private:
+  // Segment lookup shared by all channel types; returns alpha in [0, 1]
+  static uint32_t Segment(const std::vector<float> &times, float t,
+                          uint32_t &cursor, float &alpha) {
+    if (t <= times.front()) {
+      alpha = 0.0f;
+      return 0;
+    }
+    if (t >= times.back()) {
+      alpha = 1.0f;
+      return static_cast<uint32_t>(times.size()) - 2;
+    }
+    uint32_t i = FindKeyIndex(times, t, cursor);
+    alpha = (t - times[i]) / (times[i + 1] - times[i]);
+    return i;
+  }
+
+  static Vec3 SampleVec3(const CompressedChannel<Vec3> &ch, float t,
+                         uint32_t &cursor) {
+    if (ch.values.empty())
+      return {};
+    if (ch.IsConstant())
+      return ch.values[0];
+    float alpha;
+    uint32_t i = Segment(ch.times, t, cursor, alpha);
+    return ch.values[i] + (ch.values[i + 1] - ch.values[i]) * alpha;
+  }
+
+  static Quat SampleQuat(const CompressedChannel<PackedQuat> &ch, float t,
+                         uint32_t &cursor) {
+    if (ch.values.empty())
+      return Quat::Identity();
+    if (ch.IsConstant())
+      return ch.values[0].Decode();
+    float alpha;
+    uint32_t i = Segment(ch.times, t, cursor, alpha);
+    return Quat::Slerp(ch.values[i].Decode(), ch.values[i + 1].Decode(),
+                       alpha);
+  }
+};
+
+// =========================================================================
+// Compressor
+// =========================================================================
+struct CompressionSettings {
+  float translationError = 0.001f; // Metres
+  float rotationError = 0.001f;    // Radians
+  float scaleError = 0.001f;       // Absolute scale units
+};
+
+class AnimationCompressor {
+public:
+  // Uncompressed footprint of a clip's key data (SoA streams)
+  static size_t RawSizeBytes(const AnimationClip &clip) {
+    size_t keys = 0;
+    for (const auto &t : clip.tracks)
+      keys += t.KeyCount();
+    return keys * (sizeof(float) + 2 * sizeof(Vec3) + sizeof(Quat));
+  }
+
+  static CompressedClip Compress(const AnimationClip &clip,
+                                 const CompressionSettings &settings = {}) {
+    CompressedClip out;
+    out.name = clip.name;
+    out.duration = clip.duration;
+    out.loops = clip.loops;
+    out.tracks.reserve(clip.tracks.size());
+
+    for (const auto &track : clip.tracks) {
+      CompressedTrack ct;
+      ct.boneIndex = track.boneIndex;
+      ReduceVec3(track.times, track.translations, settings.translationError,
+                 ct.translation);
+      ReduceVec3(track.times, track.scales, settings.scaleError, ct.scale);
+      ReduceQuat(track.times, track.rotations, settings.rotationError,
+                 ct.rotation);
+      out.tracks.push_back(std::move(ct));
+    }
+
+    std::cout << "[AnimationCompressor] '" << clip.name
+              << "': " << RawSizeBytes(clip) << " -> " << out.SizeBytes()
+              << " bytes" << std::endl;
+    return out;
+  }
+
+private:
+  static float QuatAngle(const Quat &a, const Quat &b) {
+    float d = std::abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+    return 2.0f * std::acos(std::min(1.0f, d));
+  }
+
+  // Greedy error-bounded reduction: extend each segment while interpolating
+  // between its end keys reproduces every dropped reference key.
+  // Returns the kept key indices.
+  template <typename Value, typename ErrorFn>
+  static std::vector<uint32_t> ReduceKeys(const std::vector<Value> &values,
+                                          const std::vector<Value> &reference,
+                                          const std::vector<float> &times,
+                                          ErrorFn error) {
+    std::vector<uint32_t> kept;
+    uint32_t n = static_cast<uint32_t>(values.size());
+    if (n == 0)
+      return kept;
+    kept.push_back(0);
+    uint32_t anchor = 0;
+    for (uint32_t end = 2; end < n; ++end) {
+      bool fits = true;
+      for (uint32_t k = anchor + 1; k < end && fits; ++k) {
+        float alpha = (times[k] - times[anchor]) / (times[end] - times[anchor]);
+        fits = error(values[anchor], values[end], alpha, reference[k]);
+      }
+      if (!fits) {
+        anchor = end - 1;
+        kept.push_back(anchor);
+      }
+    }
+    if (n > 1)
+      kept.push_back(n - 1);
+    return kept;
+  }
+
+  static void ReduceVec3(const std::vector<float> &times,
+                         const std::vector<Vec3> &values, float tolerance,
+                         CompressedChannel<Vec3> &out) {
+    if (values.empty())
+      return;
+    bool constant = std::all_of(values.begin(), values.end(), [&](Vec3 v) {
+      return Vec3::Distance(v, values[0]) <= tolerance;
+    });
+    if (constant) {
+      out.values.push_back(values[0]);
+      return;
+    }
+    auto kept = ReduceKeys(
+        values, values, times, [&](const Vec3 &a, const Vec3 &b, float alpha,
+                           const Vec3 &ref) {
+          return Vec3::Distance(a + (b - a) * alpha, ref) <= tolerance;
+        });
+    for (uint32_t i : kept) {
+      out.times.push_back(times[i]);
+      out.values.push_back(values[i]);
+    }
+  }
+
+  static void ReduceQuat(const std::vector<float> &times,
+                         const std::vector<Quat> &values, float tolerance,
+                         CompressedChannel<PackedQuat> &out) {
+    if (values.empty())
+      return;
+    // Interpolate the quantized keys but measure against the source keys, so
+    // the bound includes the 15-bit error.
+    std::vector<Quat> decoded(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+      decoded[i] = PackedQuat::Encode(values[i]).Decode();
+
+    bool constant = true;
+    for (size_t i = 0; i < values.size() && constant; ++i)
+      constant = QuatAngle(decoded[0], values[i]) <= tolerance;
+    if (constant) {
+      out.values.push_back(PackedQuat::Encode(values[0]));
+      return;
+    }
+    auto kept = ReduceKeys(decoded, values, times,
+                      [&](const Quat &a, const Quat &b, float alpha,
+                          const Quat &ref) {
+                        return QuatAngle(Quat::Slerp(a, b, alpha), ref) <=
+                               tolerance;
+                      });
+    for (uint32_t i : kept) {
+      out.times.push_back(times[i]);
+      out.values.push_back(PackedQuat::Encode(values[i]));
+    }
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <array>
 #include <string>
 #include <vector>
 
@@ -24,43 +25,88 @@ struct BoneKeyframe {
   Vec3 scale;
 };
 
+// Index of the key starting the segment containing t (times[i] <= t), for
+// times.size() >= 2. `cursor` is the previous result: sequential playback
+// checks it and the next segment first (O(1)), anything else falls back to a
+// binary search.
+inline uint32_t FindKeyIndex(const std::vector<float> &times, float t,
+                             uint32_t &cursor) {
+  const uint32_t last = static_cast<uint32_t>(times.size()) - 1;
+  uint32_t c = std::min(cursor, last - 1);
+  if (t >= times[c]) {
+    if (t < times[c + 1])
+      return cursor = c;
+    if (c + 2 <= last && t < times[c + 2])
+      return cursor = c + 1;
+  }
+  auto it = std::upper_bound(times.begin(), times.end(), t);
+  uint32_t i = static_cast<uint32_t>(it - times.begin());
+  return cursor = std::clamp(i, 1u, last) - 1;
+}
+
+// Keyframes are stored SoA: sampling touches the small `times` array for the
+// key search and only reads two entries of each value stream.
 struct BoneTrack {
   int boneIndex;
   std::string boneName;
-  std::vector<BoneKeyframe> keyframes;
+  std::vector<float> times;
+  std::vector<Vec3> translations;
+  std::vector<Quat> rotations;
+  std::vector<Vec3> scales;
+
+  size_t KeyCount() const { return times.size(); }
+
+  void AddKey(const BoneKeyframe &kf) {
+    times.push_back(kf.time);
+    translations.push_back(kf.translation);
+    rotations.push_back(kf.rotation);
+    scales.push_back(kf.scale);
+  }
+
+  BoneKeyframe Key(size_t i) const {
+    return {times[i], translations[i], rotations[i], scales[i]};
+  }
+
+  uint32_t FindKey(float t, uint32_t &cursor) const {
+    return FindKeyIndex(times, t, cursor);
+  }
 
   // Interpolate bone transform at time t
   BoneKeyframe Sample(float t) const {
-    if (keyframes.empty())
+    uint32_t cursor = 0;
+    return Sample(t, cursor);
+  }
+
+  BoneKeyframe Sample(float t, uint32_t &cursor) const {
+    if (times.empty())
       return {};
-    if (keyframes.size() == 1 || t <= keyframes.front().time)
-      return keyframes.front();
-    if (t >= keyframes.back().time)
-      return keyframes.back();
-
-    // Find surrounding keyframes
-    size_t i = 0;
-    for (; i < keyframes.size() - 1; i++) {
-      if (t < keyframes[i + 1].time)
-        break;
-    }
+    if (times.size() == 1 || t <= times.front())
+      return Key(0);
+    if (t >= times.back())
+      return Key(times.size() - 1);
 
-    const auto &a = keyframes[i];
-    const auto &b = keyframes[i + 1];
-    float alpha = (t - a.time) / (b.time - a.time);
+    uint32_t i = FindKey(t, cursor);
+    float alpha = (t - times[i]) / (times[i + 1] - times[i]);
 
     BoneKeyframe result;
     result.time = t;
     // Lerp translation and scale
     result.translation =
-        a.translation + (b.translation - a.translation) * alpha;
-    result.scale = a.scale + (b.scale - a.scale) * alpha;
+        translations[i] + (translations[i + 1] - translations[i]) * alpha;
+    result.scale = scales[i] + (scales[i + 1] - scales[i]) * alpha;
     // Slerp rotation
-    result.rotation = Quat::Slerp(a.rotation, b.rotation, alpha);
+    result.rotation = Quat::Slerp(rotations[i], rotations[i + 1], alpha);
     return result;
   }
 };
 
+// Per-instance playback state: one key cursor per track
+struct AnimationCursor {
+  std::vector<uint32_t> keys;
+
+  void Reset(size_t trackCount) { keys.assign(trackCount, 0); }
+};
+
 struct AnimationClip {
   std::string name;
   float duration = 0.0f;
@@ -68,22 +114,35 @@ struct AnimationClip {
   std::vector<BoneTrack> tracks;
   bool loops = true;
 
-  // Sample all bone transforms at time t
-  std::vector<BoneKeyframe> SampleAll(float t) const {
-    float clampedT = t;
+  // Map t into the clip's time range (wrap or clamp)
+  float LocalTime(float t) const {
     if (loops && duration > 0) {
-      clampedT = std::fmod(t, duration);
-      if (clampedT < 0)
-        clampedT += duration;
-    } else {
-      clampedT = std::clamp(t, 0.0f, duration);
+      float local = std::fmod(t, duration);
+      return local < 0 ? local + duration : local;
     }
+    return std::clamp(t, 0.0f, duration);
+  }
 
-    std::vector<BoneKeyframe> result;
-    result.reserve(tracks.size());
-    for (const auto &track : tracks) {
-      result.push_back(track.Sample(clampedT));
+  // Sample all bone transforms at time t into `out` (tracks.size() entries).
+  // Pass the instance's cursor to make sequential playback O(1) per track.
+  void SampleAll(float t, BoneKeyframe *out,
+                 AnimationCursor *cursor = nullptr) const {
+    float localT = LocalTime(t);
+    if (cursor && cursor->keys.size() != tracks.size())
+      cursor->Reset(tracks.size());
+    for (size_t i = 0; i < tracks.size(); ++i) {
+      if (cursor) {
+        out[i] = tracks[i].Sample(localT, cursor->keys[i]);
+      } else {
+        out[i] = tracks[i].Sample(localT);
+      }
     }
+  }
+
+  // Allocating convenience overload
+  std::vector<BoneKeyframe> SampleAll(float t) const {
+    std::vector<BoneKeyframe> result(tracks.size());
+    SampleAll(t, result.data());
     return result;
   }
 };
@@ -170,7 +229,7 @@ public:
           kf.rotation = Quat::FromAxisAngle(Vec3(0, 1, 0), angle) * kf.rotation;
         }
 
-        track.keyframes.push_back(kf);
+        track.AddKey(kf);
       }
       clip.tracks.push_back(track);
     }
@@ -211,13 +270,116 @@ public:
           kf.scale = kf.scale + Vec3(breath, breath * 0.5f, breath);
         }
 
-        track.keyframes.push_back(kf);
+        track.AddKey(kf);
       }
       clip.tracks.push_back(track);
     }
     return clip;
   }
 
+  // Create a run cycle (faster, exaggerated walk)
+  static AnimationClip CreateRunCycle(const Skeleton &skeleton,
+                                      float duration = 0.6f) {
+    AnimationClip clip = CreateWalkCycle(skeleton, duration);
+    clip.name = "run_cycle";
+    for (auto &track : clip.tracks) {
+      const Bone &bone = skeleton.bones[track.boneIndex];
+      Quat invBind{-bone.localRotation.x, -bone.localRotation.y,
+                   -bone.localRotation.z, bone.localRotation.w};
+      for (size_t k = 0; k < track.KeyCount(); ++k) {
+        track.translations[k] =
+            bone.localPosition +
+            (track.translations[k] - bone.localPosition) * 2.0f;
+        // Double the swing: the walk key is offset * bind, apply offset twice
+        Quat offset = track.rotations[k] * invBind;
+        track.rotations[k] = offset * track.rotations[k];
+      }
+    }
+    return clip;
+  }
+
+  // Create a pose animation: bones whose name contains one of the
+  // keys rotate about `axis` by amount * sin(pi * t / duration) (out and back)
+  static AnimationClip CreatePoseAnim(const Skeleton &skeleton,
+                                      const std::string &name, float duration,
+                                      bool loops, const Vec3 &axis,
+                                      const std::vector<std::string> &keys,
+                                      float amount, float rootDrop = 0.0f) {
+    AnimationClip clip;
+    clip.name = name;
+    clip.duration = duration;
+    clip.loops = loops;
+
+    for (size_t i = 0; i < skeleton.bones.size(); i++) {
+      BoneTrack track;
+      track.boneIndex = static_cast<int>(i);
+      track.boneName = skeleton.bones[i].name;
+      bool driven = std::any_of(keys.begin(), keys.end(), [&](const auto &k) {
+        return track.boneName.find(k) != std::string::npos;
+      });
+
+      for (int k = 0; k < 5; k++) {
+        float t = (static_cast<float>(k) / 4.0f) * duration;
+        float phase = std::sin((t / duration) * 3.14159f);
+
+        BoneKeyframe kf;
+        kf.time = t;
+        kf.translation = skeleton.bones[i].localPosition;
+        kf.rotation = skeleton.bones[i].localRotation;
+        kf.scale = skeleton.bones[i].localScale;
+        if (driven)
+          kf.rotation =
+              Quat::FromAxisAngle(axis, amount * phase) * kf.rotation;
+        if (skeleton.bones[i].parentIndex < 0)
+          kf.translation.y -= rootDrop * phase;
+        track.AddKey(kf);
+      }
+      clip.tracks.push_back(track);
+    }
+    return clip;
+  }
+
+  static AnimationClip CreateAttackAnim(const Skeleton &skeleton) {
+    return CreatePoseAnim(skeleton, "attack", 0.8f, false, Vec3(1, 0, 0),
+                          {"Neck", "Head", "Chest"}, 0.35f);
+  }
+
+  static AnimationClip CreateDrinkAnim(const Skeleton &skeleton) {
+    return CreatePoseAnim(skeleton, "drink", 2.0f, true, Vec3(1, 0, 0),
+                          {"Neck", "Head"}, 0.6f, 0.1f);
+  }
+
+  static AnimationClip CreateSleepAnim(const Skeleton &skeleton) {
+    return CreatePoseAnim(skeleton, "sleep", 4.0f, true, Vec3(0, 1, 0),
+                          {"Neck", "Tail"}, 0.4f, 0.6f);
+  }
+
+  // Resample a clip to one key per frame at `framesPerSecond` (the dense
+  // form DCC exporters emit; the compressor's usual input)
+  static AnimationClip Resample(const AnimationClip &clip,
+                                float framesPerSecond) {
+    AnimationClip dense = clip;
+    int frameCount =
+        std::max(1, static_cast<int>(std::ceil(clip.duration *
+                                               framesPerSecond))) + 1;
+    for (size_t i = 0; i < clip.tracks.size(); ++i) {
+      BoneTrack &track = dense.tracks[i];
+      track.times.clear();
+      track.translations.clear();
+      track.rotations.clear();
+      track.scales.clear();
+      uint32_t cursor = 0;
+      for (int f = 0; f < frameCount; ++f) {
+        float t = std::min(f / framesPerSecond, clip.duration);
+        BoneKeyframe kf = clip.tracks[i].Sample(t, cursor);
+        kf.time = t;
+        track.AddKey(kf);
+      }
+    }
+    dense.ticksPerSecond = framesPerSecond;
+    return dense;
+  }
+
   // Create a basic dinosaur skeleton
   static Skeleton CreateDinosaurSkeleton() {
     Skeleton skel;
@@ -0,0 +1,593 @@
+#pragma once
+#include "../Graphics/GPUAnimationInstancing.h"
+#include "../Graphics/MorphDeltaCodec.h"
+#include "../Graphics/UberMesh.h"
+#include "GLTFLoader.h"
+#include "MappedFile.h"
+#include "TextureLoader.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// Baked Asset Pak (.mpak)
+// =========================================================================
+// Offline-cooked, GPU-ready asset blobs. Layout:
+//   PakHeader | blob | blob | ... | PakEntry[entryCount]
+// Every blob starts on a PAK_ALIGNMENT boundary, so the runtime maps the
+// file and hands typed pointers straight to staging buffers. Blobs are
+// stored in the exact layout the engine uploads:
+//   Mesh      Vertex[vertexCount], then uint32_t[indexCount]
+//   MorphSet  PackedMorphBuffer::WriteGPU image, then '\0'-separated names
+//   BoneAtlas BoneAtlas rows (float or half), then PakClipRecord[clipCount]
+//   Texture   TextureData::pixels (all mip levels)
+// A pak cooked against a different Vertex layout or PAK_VERSION is
+// rejected; re-run MesozoicCook after changing either.
+
+constexpr uint32_t PAK_MAGIC = 0x4B41504D; // "MPAK"
+constexpr uint32_t PAK_VERSION = 1;
+constexpr size_t PAK_ALIGNMENT = 16;
+constexpr size_t PAK_NAME_LENGTH = 48;
+
+enum class PakEntryType : uint32_t {
+  Mesh = 1,
+  MorphSet = 2,
+  BoneAtlas = 3,
+  Texture = 4
+};
+
+struct PakHeader {
+  uint32_t magic = PAK_MAGIC;
+  uint32_t version = PAK_VERSION;
+  uint32_t entryCount = 0;
+  uint32_t vertexStride = sizeof(Graphics::Vertex);
+  uint64_t tocOffset = 0;
+  uint64_t fileSize = 0;
+};
+
+struct PakEntry {
+  char name[PAK_NAME_LENGTH] = {};
+  PakEntryType type = PakEntryType::Mesh;
+  uint32_t reserved = 0;
+  uint64_t offset = 0; // From the start of the file
+  uint64_t size = 0;
+  // Mesh:      vertexCount, indexCount, indexOffset
+  // MorphSet:  vertexCount, targetCount, namesOffset, namesSize
+  // BoneAtlas: format, bonesPerRow, rowCount, clipCount, clipOffset
+  // Texture:   width, height, mipLevels, format, channels, srgb
+  uint32_t params[6] = {};
+
+  std::string_view Name() const {
+    return {name, strnlen(name, PAK_NAME_LENGTH)};
+  }
+};
+
+struct PakClipRecord {
+  char name[32] = {};
+  uint32_t firstRow = 0;
+  uint32_t frameCount = 0;
+  uint32_t boneCount = 0;
+  float framesPerSecond = 30.0f;
+  float duration = 0.0f;
+  uint32_t loops = 1;
+};
+
+static_assert(sizeof(PakHeader) == 32, "PakHeader layout");
+static_assert(sizeof(PakEntry) == 96, "PakEntry layout");
+static_assert(sizeof(PakClipRecord) == 56, "PakClipRecord layout");
+
+// Zero-copy views into a mapped pak
+struct PakMeshView {
+  const Graphics::Vertex *vertices = nullptr;
+  uint32_t vertexCount = 0;
+  const uint32_t *indices = nullptr;
+  uint32_t indexCount = 0;
+
+  bool Valid() const { return vertices != nullptr; }
+};
+
+struct PakMorphView {
+  const uint8_t *gpuData = nullptr; // PackedMorphBuffer::WriteGPU layout
+  size_t gpuSize = 0;
+  uint32_t vertexCount = 0;
+  uint32_t targetCount = 0;
+  std::vector<std::string> names;
+
+  bool Valid() const { return gpuData != nullptr; }
+};
+
+// =========================================================================
+// Pak Writer (used by MesozoicCook and tests)
+// =========================================================================
+// The Add* calls reject (and report) names that do not fit the fixed-size
+// name fields, since a truncated name could never be found again.
+class PakWriter {
+public:
+  bool AddMesh(const std::string &name, const Graphics::UberMesh &mesh) {
+    PakEntry *entry = Begin(name, PakEntryType::Mesh);
+    if (!entry)
+      return false;
+    PakEntry &e = *entry;
+    e.params[0] = static_cast<uint32_t>(mesh.baseVertices.size());
+    e.params[1] = static_cast<uint32_t>(mesh.indices.size());
+    Append(mesh.baseVertices.data(),
+           mesh.baseVertices.size() * sizeof(Graphics::Vertex));
+    e.params[2] = Align();
+    Append(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    End(e);
+    return true;
+  }
+
+  bool AddMorphs(const std::string &name,
+                 const Graphics::PackedMorphBuffer &morphs) {
+    PakEntry *entry = Begin(name, PakEntryType::MorphSet);
+    if (!entry)
+      return false;
+    PakEntry &e = *entry;
+    e.params[0] = morphs.vertexCount;
+    e.params[1] = morphs.targetCount;
+    std::vector<uint8_t> image(morphs.GPUSizeBytes());
+    morphs.WriteGPU(image.data());
+    Append(image.data(), image.size());
+    std::string names;
+    for (const auto &n : morphs.names) {
+      names += n;
+      names += '\0';
+    }
+    e.params[2] = Align();
+    e.params[3] = static_cast<uint32_t>(names.size());
+    Append(names.data(), names.size());
+    End(e);
+    return true;
+  }
+
+  bool AddBoneAtlas(const std::string &name, const Graphics::BoneAtlas &atlas,
+                    const std::vector<Graphics::BakedClip> &clips) {
+    for (const auto &clip : clips) {
+      if (!NameFits(clip.name, sizeof(PakClipRecord::name), "Clip"))
+        return false;
+    }
+    PakEntry *entry = Begin(name, PakEntryType::BoneAtlas);
+    if (!entry)
+      return false;
+    PakEntry &e = *entry;
+    e.params[0] = static_cast<uint32_t>(atlas.format);
+    e.params[1] = atlas.bonesPerRow;
+    e.params[2] = atlas.rowCount;
+    e.params[3] = static_cast<uint32_t>(clips.size());
+    Append(atlas.Data(), atlas.SizeBytes());
+    e.params[4] = Align();
+    for (const auto &clip : clips) {
+      PakClipRecord rec;
+      CopyName(rec.name, clip.name);
+      rec.firstRow = clip.firstRow;
+      rec.frameCount = clip.frameCount;
+      rec.boneCount = clip.boneCount;
+      rec.framesPerSecond = clip.framesPerSecond;
+      rec.duration = clip.duration;
+      rec.loops = clip.loops ? 1 : 0;
+      Append(&rec, sizeof(rec));
+    }
+    End(e);
+    return true;
+  }
+
+  bool AddTexture(const std::string &name, const TextureData &tex) {
+    PakEntry *entry = Begin(name, PakEntryType::Texture);
+    if (!entry)
+      return false;
+    PakEntry &e = *entry;
+    e.params[0] = tex.width;
+    e.params[1] = tex.height;
+    e.params[2] = tex.mipLevels;
+    e.params[3] = static_cast<uint32_t>(tex.format);
+    e.params[4] = tex.channels;
+    e.params[5] = tex.srgb ? 1 : 0;
+    Append(tex.pixels.data(), tex.pixels.size());
+    End(e);
+    return true;
+  }
+
+  size_t EntryCount() const { return entries.size(); }
+
+  // Serialize header + blobs + TOC
+  std::vector<uint8_t> Build() const {
+    size_t blobEnd = sizeof(PakHeader) + blob.size();
+    std::vector<uint8_t> out(
+        (blobEnd + PAK_ALIGNMENT - 1) & ~(PAK_ALIGNMENT - 1), 0);
+    if (!blob.empty())
+      std::memcpy(out.data() + sizeof(PakHeader), blob.data(), blob.size());
+
+    PakHeader header;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.tocOffset = out.size();
+    for (PakEntry e : entries) {
+      e.offset += sizeof(PakHeader); // Blob offsets are relative until now
+      const auto *p = reinterpret_cast<const uint8_t *>(&e);
+      out.insert(out.end(), p, p + sizeof(e));
+    }
+    header.fileSize = out.size();
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out;
+  }
+
+  bool WriteFile(const std::string &filepath) const {
+    std::vector<uint8_t> pak = Build();
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+      std::cerr << "[PakWriter] Failed to open for writing: " << filepath
+                << std::endl;
+      return false;
+    }
+    file.write(reinterpret_cast<const char *>(pak.data()),
+               static_cast<std::streamsize>(pak.size()));
+    return file.good();
+  }
+
+private:
+  std::vector<PakEntry> entries;
+  std::vector<uint8_t> blob; // Without the header (it is 16-byte sized)
+
+  // Names are stored '\0'-terminated in a field of `cap` bytes
+  static bool NameFits(const std::string &name, size_t cap, const char *what) {
+    if (name.size() < cap)
+      return true;
+    std::cerr << "[PakWriter] " << what << " name longer than " << cap - 1
+              << " characters: " << name << std::endl;
+    return false;
+  }
+
+  static void CopyName(char *dst, const std::string &name) {
+    std::memcpy(dst, name.data(), name.size()); // Checked by NameFits
+  }
+
+  PakEntry *Begin(const std::string &name, PakEntryType type) {
+    if (!NameFits(name, PAK_NAME_LENGTH, "Entry"))
+      return nullptr;
+    Align();
+    PakEntry e;
+    CopyName(e.name, name);
+    e.type = type;
+    e.offset = blob.size();
+    entries.push_back(e);
+    return &entries.back();
+  }
+
+  void End(PakEntry &e) { e.size = blob.size() - e.offset; }
+
+  // Pads the blob and returns the padded offset relative to the open entry
+  uint32_t Align() {
+    blob.resize((blob.size() + PAK_ALIGNMENT - 1) & ~(PAK_ALIGNMENT - 1), 0);
+    return entries.empty()
+               ? 0
+               : static_cast<uint32_t>(blob.size() - entries.back().offset);
+  }
+
+  void Append(const void *src, size_t bytes) {
+    const auto *p = static_cast<const uint8_t *>(src);
+    blob.insert(blob.end(), p, p + bytes);
+  }
+};
+
+// =========================================================================
+// Pak Reader (runtime)
+// =========================================================================
+class AssetPak {
+public:
+  bool Open(const std::string &path) {
+    name = path;
+    if (!file.Open(path))
+      return false;
+    return OpenMemory(file.Data(), file.Size());
+  }
+
+  // Use a pak image already in memory (must outlive the pak). `data` must
+  // be PAK_ALIGNMENT aligned for the typed views to be valid.
+  bool OpenMemory(const uint8_t *bytes, size_t bytesSize) {
+    data = nullptr;
+    size = 0;
+    toc = nullptr;
+    entryCount = 0;
+    if (!bytes || bytesSize < sizeof(PakHeader))
+      return Error("file too small");
+    PakHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != PAK_MAGIC)
+      return Error("bad magic");
+    if (header.version != PAK_VERSION)
+      return Error("unsupported version (re-cook with MesozoicCook)");
+    if (header.vertexStride != sizeof(Graphics::Vertex))
+      return Error("vertex layout changed (re-cook with MesozoicCook)");
+    if (header.fileSize > bytesSize || header.tocOffset > header.fileSize ||
+        (header.fileSize - header.tocOffset) / sizeof(PakEntry) <
+            header.entryCount)
+      return Error("truncated file");
+    if (reinterpret_cast<uintptr_t>(bytes) % PAK_ALIGNMENT != 0)
+      return Error("image is not 16-byte aligned");
+
+    const auto *entries =
+        reinterpret_cast<const PakEntry *>(bytes + header.tocOffset);
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+      // Written so that a huge offset or size cannot wrap around
+      if (entries[i].offset > header.tocOffset ||
+          entries[i].size > header.tocOffset - entries[i].offset)
+        return Error("entry overruns file");
+      if (entries[i].offset % PAK_ALIGNMENT != 0)
+        return Error("misaligned entry");
+    }
+    data = bytes;
+    size = header.fileSize;
+    toc = entries;
+    entryCount = header.entryCount;
+    return true;
+  }
+
+  bool IsOpen() const { return data != nullptr; }
+  size_t SizeBytes() const { return size; }
+  uint32_t EntryCount() const { return entryCount; }
+  const PakEntry &Entry(uint32_t i) const { return toc[i]; }
+
+  const PakEntry *Find(std::string_view entryName, PakEntryType type) const {
+    for (uint32_t i = 0; i < entryCount; ++i) {
+      if (toc[i].type == type && toc[i].Name() == entryName)
+        return &toc[i];
+    }
+    return nullptr;
+  }
+
+  const uint8_t *Blob(const PakEntry &e) const { return data + e.offset; }
+
+  // The typed readers below trust nothing in params[]: every offset and
+  // count is checked against the entry's size, and a corrupt entry reads as
+  // missing.
+  PakMeshView Mesh(std::string_view meshName) const {
+    PakMeshView view;
+    const PakEntry *e = Find(meshName, PakEntryType::Mesh);
+    if (!e)
+      return view;
+    if (!Fits(*e, 0, e->params[0], sizeof(Graphics::Vertex)) ||
+        e->params[2] % alignof(uint32_t) != 0 ||
+        !Fits(*e, e->params[2], e->params[1], sizeof(uint32_t))) {
+      Corrupt(*e);
+      return view;
+    }
+    view.vertices = reinterpret_cast<const Graphics::Vertex *>(Blob(*e));
+    view.vertexCount = e->params[0];
+    view.indices = reinterpret_cast<const uint32_t *>(Blob(*e) + e->params[2]);
+    view.indexCount = e->params[1];
+    return view;
+  }
+
+  PakMorphView Morphs(std::string_view setName) const {
+    PakMorphView view;
+    const PakEntry *e = Find(setName, PakEntryType::MorphSet);
+    if (!e)
+      return view;
+    constexpr size_t header = Graphics::PackedMorphBuffer::MAX_TARGETS *
+                              sizeof(Graphics::MorphTargetScale);
+    const uint32_t vertexCount = e->params[0], targetCount = e->params[1];
+    if (targetCount > Graphics::PackedMorphBuffer::MAX_TARGETS ||
+        !Fits(*e, header, uint64_t(vertexCount) * targetCount,
+              sizeof(Graphics::PackedMorphDelta)) ||
+        !Fits(*e, e->params[2], e->params[3], 1)) {
+      Corrupt(*e);
+      return view;
+    }
+    // Every name must end with its '\0' inside the names block
+    const char *names = reinterpret_cast<const char *>(Blob(*e) + e->params[2]);
+    std::vector<std::string> parsed;
+    for (uint32_t pos = 0; pos < e->params[3];) {
+      size_t left = e->params[3] - pos;
+      size_t len = strnlen(names + pos, left);
+      if (len == left) {
+        Corrupt(*e);
+        return view;
+      }
+      parsed.emplace_back(names + pos, len);
+      pos += static_cast<uint32_t>(len) + 1;
+    }
+    view.vertexCount = vertexCount;
+    view.targetCount = targetCount;
+    view.gpuData = Blob(*e);
+    view.gpuSize = header + size_t(vertexCount) * targetCount *
+                                sizeof(Graphics::PackedMorphDelta);
+    view.names = std::move(parsed);
+    return view;
+  }
+
+  // Copying loaders for systems that own their storage. Both are straight
+  // memcpys of the cooked layout.
+  bool LoadMesh(std::string_view meshName, Graphics::UberMesh &out) const {
+    PakMeshView view = Mesh(meshName);
+    if (!view.Valid())
+      return false;
+    out.baseVertices.assign(view.vertices, view.vertices + view.vertexCount);
+    out.indices.assign(view.indices, view.indices + view.indexCount);
+    return true;
+  }
+
+  bool LoadMorphs(std::string_view setName,
+                  Graphics::PackedMorphBuffer &out) const {
+    PakMorphView view = Morphs(setName);
+    if (!view.Valid())
+      return false;
+    out.vertexCount = view.vertexCount;
+    out.targetCount = view.targetCount;
+    out.names = view.names;
+    const auto *scales =
+        reinterpret_cast<const Graphics::MorphTargetScale *>(view.gpuData);
+    out.scales.assign(scales, scales + view.targetCount);
+    const auto *deltas = reinterpret_cast<const Graphics::PackedMorphDelta *>(
+        view.gpuData + Graphics::PackedMorphBuffer::MAX_TARGETS *
+                           sizeof(Graphics::MorphTargetScale));
+    out.deltas.assign(deltas,
+                      deltas + size_t(view.vertexCount) * view.targetCount);
+    return true;
+  }
+
+  bool LoadBoneAtlas(std::string_view atlasName, Graphics::BoneAtlas &atlas,
+                     std::vector<Graphics::BakedClip> &clips) const {
+    const PakEntry *e = Find(atlasName, PakEntryType::BoneAtlas);
+    if (!e)
+      return false;
+    const auto format = static_cast<Graphics::BoneFormat>(e->params[0]);
+    if (format != Graphics::BoneFormat::Float3x4 &&
+        format != Graphics::BoneFormat::Half3x4)
+      return Corrupt(*e);
+    const size_t valueBytes =
+        format == Graphics::BoneFormat::Half3x4 ? sizeof(uint16_t)
+                                                : sizeof(float);
+    const uint64_t rowValues =
+        uint64_t(e->params[1]) * Graphics::BoneAtlas::VALUES_PER_BONE;
+    if (!Fits(*e, 0, e->params[2], rowValues * valueBytes) ||
+        e->params[4] % alignof(PakClipRecord) != 0 ||
+        !Fits(*e, e->params[4], e->params[3], sizeof(PakClipRecord)))
+      return Corrupt(*e);
+    const auto *recs =
+        reinterpret_cast<const PakClipRecord *>(Blob(*e) + e->params[4]);
+    for (uint32_t i = 0; i < e->params[3]; ++i) {
+      // Every clip's frames and bones lie inside the atlas
+      if (recs[i].frameCount > e->params[2] ||
+          recs[i].firstRow > e->params[2] - recs[i].frameCount ||
+          recs[i].boneCount > e->params[1])
+        return Corrupt(*e);
+    }
+    atlas.format = format;
+    atlas.bonesPerRow = e->params[1];
+    atlas.rowCount = e->params[2];
+    size_t values = atlas.RowStride() * atlas.rowCount;
+    atlas.rows.clear();
+    atlas.halfs.clear();
+    if (atlas.format == Graphics::BoneFormat::Half3x4) {
+      const auto *src = reinterpret_cast<const uint16_t *>(Blob(*e));
+      atlas.halfs.assign(src, src + values);
+    } else {
+      const auto *src = reinterpret_cast<const float *>(Blob(*e));
+      atlas.rows.assign(src, src + values);
+    }
+    clips.clear();
+    for (uint32_t i = 0; i < e->params[3]; ++i) {
+      Graphics::BakedClip clip;
+      clip.name.assign(recs[i].name, strnlen(recs[i].name, 32));
+      clip.firstRow = recs[i].firstRow;
+      clip.frameCount = recs[i].frameCount;
+      clip.boneCount = recs[i].boneCount;
+      clip.framesPerSecond = recs[i].framesPerSecond;
+      clip.duration = recs[i].duration;
+      clip.loops = recs[i].loops != 0;
+      clips.push_back(clip);
+    }
+    return true;
+  }
+
+  bool LoadTexture(std::string_view texName, TextureData &out) const {
+    const PakEntry *e = Find(texName, PakEntryType::Texture);
+    if (!e)
+      return false;
+    // Checked before BuildMipLayout, which allocates a record per level
+    if (e->params[0] == 0 || e->params[1] == 0 || e->params[2] == 0 ||
+        e->params[2] > TextureData::FullMipCount(e->params[0], e->params[1]) ||
+        e->params[3] > uint32_t(PixelFormat::BC7))
+      return Corrupt(*e);
+    out.name = std::string(texName);
+    out.width = e->params[0];
+    out.height = e->params[1];
+    out.mipLevels = e->params[2];
+    out.format = static_cast<PixelFormat>(e->params[3]);
+    out.channels = e->params[4];
+    out.srgb = e->params[5] != 0;
+    if (out.BuildMipLayout(out.mipLevels) != e->size)
+      return Corrupt(*e); // Format and dimensions disagree with the blob
+    out.pixels.assign(Blob(*e), Blob(*e) + e->size);
+    out.valid = true;
+    return true;
+  }
+
+private:
+  std::string name;
+  MappedFile file;
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+  const PakEntry *toc = nullptr;
+  uint32_t entryCount = 0;
+
+  bool Error(const char *what) {
+    std::cerr << "[AssetPak] " << name << ": " << what << std::endl;
+    return false;
+  }
+
+  // `count` elements of `elementSize` bytes starting `offset` bytes into
+  // the blob lie inside it (overflow-safe)
+  static bool Fits(const PakEntry &e, uint64_t offset, uint64_t count,
+                   uint64_t elementSize) {
+    if (offset > e.size)
+      return false;
+    return elementSize == 0 || count <= (e.size - offset) / elementSize;
+  }
+
+  bool Corrupt(const PakEntry &e) const {
+    std::cerr << "[AssetPak] " << name << ": corrupt entry '" << e.Name()
+              << "'" << std::endl;
+    return false;
+  }
+};
+
+// =========================================================================
+// Cook helpers (offline conversions shared by MesozoicCook and fallbacks)
+// =========================================================================
+namespace PakCook {
+
+// glTF primitive -> engine vertex layout
+inline Graphics::UberMesh ToUberMesh(const GLTFPrimitive &prim) {
+  Graphics::UberMesh mesh;
+  mesh.baseVertices.reserve(prim.vertices.size());
+  for (const auto &v : prim.vertices) {
+    Graphics::Vertex out{};
+    out.position = {v.position.x, v.position.y, v.position.z};
+    out.normal = {v.normal.x, v.normal.y, v.normal.z};
+    out.tangent = {v.tangent[0], v.tangent[1], v.tangent[2], v.tangent[3]};
+    out.uv = {v.uv[0], v.uv[1]};
+    out.boneIndices = {v.boneIndices[0], v.boneIndices[1], v.boneIndices[2],
+                       v.boneIndices[3]};
+    out.boneWeights = {v.boneWeights[0], v.boneWeights[1], v.boneWeights[2],
+                       v.boneWeights[3]};
+    mesh.baseVertices.push_back(out);
+  }
+  mesh.indices = prim.indices;
+  return mesh;
+}
+
+// The assets Main.cpp used to generate on every launch
+inline bool AddBuiltinAssets(PakWriter &pak) {
+  GLTFMesh dino = GLTFLoader::CreateDinosaurPlaceholder(6.0f, 3.0f);
+  bool ok = pak.AddMesh("Dinosaur", ToUberMesh(dino.primitives[0]));
+  ok &= pak.AddMesh(
+      "Grass", ToUberMesh(GLTFLoader::CreateGrassMesh(1.5f).primitives[0]));
+
+  // Slider targets lead; the vertex shader reads them from slots 0-2
+  MorphTargetSet morphs = MorphTargetExtractor::GenerateDinosaurMorphs(dino);
+  ok &= pak.AddMorphs(
+      "Dinosaur", Graphics::MorphDeltaCodec::Encode(
+                      morphs, {"Target_Snout", "Target_Bulk", "Target_Horn"}));
+
+  Skeleton skeleton = AnimationLoader::CreateDinosaurSkeleton();
+  Graphics::GPUAnimationSystem anims(Graphics::BoneFormat::Half3x4);
+  anims.BakeClip(skeleton, AnimationLoader::CreateIdleAnim(skeleton));
+  anims.BakeClip(skeleton, AnimationLoader::CreateWalkCycle(skeleton));
+  anims.BakeClip(skeleton, AnimationLoader::CreateRunCycle(skeleton));
+  ok &= pak.AddBoneAtlas("Dinosaur", anims.atlas, anims.clips);
+  return ok;
+}
+
+} // namespace PakCook
+
+} // namespace Assets
+} // namespace Mesozoic
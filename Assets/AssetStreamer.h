@@ -0,0 +1,344 @@
+#pragma once
+#include "../Core/Threading/JobSystem.h"
+#include "../Graphics/UberMesh.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// Asynchronous Asset Streaming
+// =========================================================================
+// Assets are registered by name with a loader that does the I/O and decode.
+// Acquiring a handle queues the load; Update() (main thread, once a frame)
+//   1. starts the nearest queued loads on JobSystem workers,
+//   2. uploads finished loads nearest-first until the frame's byte budget
+//      is spent (at least one per frame, so large assets still progress),
+//   3. evicts unreferenced resident assets in LRU order while the resident
+//      total is over the memory budget.
+// Priorities are distances (lower loads first) and may change every frame;
+// the queue keeps stale entries and skips them when popped.
+// Everything except the loader itself runs on the main thread.
+// Only meshes stream so far: textures are still created at startup, and a
+// Texture kind needs its own payload and a renderer slot to upload into.
+
+enum class AssetKind : uint8_t { Mesh };
+
+enum class AssetState : uint8_t {
+  Unloaded,
+  Queued,   // Waiting for a worker
+  Loading,  // Loader running on a worker
+  Decoded,  // Waiting for upload budget
+  Resident, // Uploaded; gpuId is valid
+  Failed
+};
+
+struct AssetPayload {
+  AssetKind kind = AssetKind::Mesh;
+  Graphics::UberMesh mesh;
+
+  size_t SizeBytes() const {
+    return mesh.baseVertices.size() * sizeof(Graphics::Vertex) +
+           mesh.indices.size() * sizeof(uint32_t);
+  }
+};
+
+class AssetStreamer {
+public:
+  using Handle = uint32_t;
+  static constexpr Handle INVALID_HANDLE = 0xFFFFFFFFu;
+  static constexpr uint32_t INVALID_GPU_ID = 0xFFFFFFFFu;
+
+  // Runs on a worker thread; fills the payload, returns false on failure
+  using LoadFn = std::function<bool(AssetPayload &)>;
+  // Main thread; uploads the payload and returns the renderer's id for it
+  using UploadFn =
+      std::function<uint32_t(const std::string &, const AssetPayload &)>;
+  // Main thread; releases the GPU copy of an evicted asset
+  using EvictFn = std::function<void(const std::string &, uint32_t gpuId)>;
+
+  struct Settings {
+    size_t memoryBudget = 256u << 20;  // Resident bytes before LRU eviction
+    size_t uploadBudget = 4u << 20;    // Bytes uploaded per Update()
+    uint32_t maxInFlight = 4;          // Concurrent loads on the workers
+    bool keepCpuCopy = false;          // Keep payloads after upload
+  };
+
+  struct Stats {
+    uint64_t loads = 0;
+    uint64_t uploads = 0;
+    uint64_t evictions = 0;
+    uint64_t failures = 0;
+    size_t uploadedLastFrame = 0;
+  };
+
+  explicit AssetStreamer(Core::Threading::JobSystem &jobs)
+      : AssetStreamer(jobs, Settings{}) {}
+  AssetStreamer(Core::Threading::JobSystem &jobs, Settings settings)
+      : jobs(jobs), settings(settings) {}
+
+  // Workers write into entries owned by the streamer
+  ~AssetStreamer() { WaitForLoads(); }
+
+  AssetStreamer(const AssetStreamer &) = delete;
+  AssetStreamer &operator=(const AssetStreamer &) = delete;
+
+  // Registering an existing name returns its handle unchanged
+  Handle Register(const std::string &name, AssetKind kind, LoadFn load) {
+    auto it = lookup.find(name);
+    if (it != lookup.end())
+      return it->second;
+    Handle h = static_cast<Handle>(entries.size());
+    entries.emplace_back();
+    Entry &e = entries.back();
+    e.name = name;
+    e.kind = kind;
+    e.load = std::move(load);
+    lookup.emplace(name, h);
+    return h;
+  }
+
+  Handle Find(const std::string &name) const {
+    auto it = lookup.find(name);
+    return it == lookup.end() ? INVALID_HANDLE : it->second;
+  }
+
+  // Every Acquire must be paired with a Release
+  void Acquire(Handle h, float priority = 0.0f) {
+    if (h >= entries.size())
+      return;
+    Entry &e = entries[h];
+    if (e.refCount++ == 0 && e.state == AssetState::Resident)
+      lru.erase(e.lruPos);
+    if (e.state == AssetState::Unloaded) {
+      e.priority = priority;
+      Enqueue(h);
+    } else {
+      SetPriority(h, priority);
+    }
+  }
+
+  void Release(Handle h) {
+    if (h >= entries.size() || entries[h].refCount == 0)
+      return;
+    Entry &e = entries[h];
+    if (--e.refCount > 0)
+      return;
+    if (e.state == AssetState::Resident) {
+      lru.push_front(h);
+      e.lruPos = lru.begin();
+    } else if (e.state == AssetState::Queued) {
+      e.state = AssetState::Unloaded; // Its queue entries go stale
+    } // Loading / Decoded results are dropped when they reach Update()
+  }
+
+  // Lower loads first (e.g. distance to the nearest user of the asset)
+  void SetPriority(Handle h, float priority) {
+    if (h >= entries.size())
+      return;
+    Entry &e = entries[h];
+    if (e.priority == priority)
+      return;
+    e.priority = priority;
+    if (e.state == AssetState::Queued)
+      queue.push({priority, h, ++e.stamp});
+  }
+
+  void Update(const UploadFn &upload, const EvictFn &evict = {}) {
+    Dispatch();
+    Upload(upload);
+    Trim(evict);
+  }
+
+  // Blocks until no loads are running (shutdown, tests)
+  void WaitForLoads() {
+    std::unique_lock<std::mutex> lock(completedMutex);
+    completedCV.wait(lock, [this] { return inFlight == 0; });
+  }
+
+  AssetState State(Handle h) const { return entries[h].state; }
+  bool IsResident(Handle h) const {
+    return h < entries.size() && entries[h].state == AssetState::Resident;
+  }
+  uint32_t GpuId(Handle h) const {
+    return IsResident(h) ? entries[h].gpuId : INVALID_GPU_ID;
+  }
+  // Only valid while Decoded, or Resident with keepCpuCopy
+  const AssetPayload *Payload(Handle h) const {
+    return entries[h].payload.get();
+  }
+  uint32_t RefCount(Handle h) const { return entries[h].refCount; }
+  const std::string &Name(Handle h) const { return entries[h].name; }
+
+  size_t ResidentBytes() const { return residentBytes; }
+  size_t ResidentCount() const { return residentCount; }
+  uint32_t InFlight() {
+    std::lock_guard<std::mutex> lock(completedMutex);
+    return inFlight;
+  }
+  const Stats &GetStats() const { return stats; }
+  Settings &GetSettings() { return settings; }
+
+private:
+  struct Entry {
+    std::string name;
+    AssetKind kind = AssetKind::Mesh;
+    LoadFn load;
+    AssetState state = AssetState::Unloaded;
+    float priority = 0.0f;
+    uint32_t stamp = 0; // Invalidates older queue entries
+    uint32_t refCount = 0;
+    uint32_t gpuId = INVALID_GPU_ID;
+    size_t bytes = 0;
+    std::shared_ptr<AssetPayload> payload;
+    std::list<Handle>::iterator lruPos;
+  };
+
+  struct QueueItem {
+    float priority;
+    Handle handle;
+    uint32_t stamp;
+    bool operator<(const QueueItem &o) const {
+      return priority > o.priority; // Min-heap on priority
+    }
+  };
+
+  struct Completion {
+    Handle handle;
+    bool ok;
+  };
+
+  Core::Threading::JobSystem &jobs;
+  Settings settings;
+  std::vector<Entry> entries; // Never shrinks; handles stay valid
+  std::unordered_map<std::string, Handle> lookup;
+  std::priority_queue<QueueItem> queue;
+  std::vector<Handle> decoded; // Waiting for upload budget
+  std::list<Handle> lru;       // Unreferenced resident, most recent first
+  size_t residentBytes = 0;
+  size_t residentCount = 0;
+  Stats stats;
+
+  std::mutex completedMutex;
+  std::condition_variable completedCV;
+  std::vector<Completion> completed;
+  uint32_t inFlight = 0;
+
+  void Enqueue(Handle h) {
+    Entry &e = entries[h];
+    e.state = AssetState::Queued;
+    queue.push({e.priority, h, ++e.stamp});
+  }
+
+  void Dispatch() {
+    while (!queue.empty()) {
+      {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        if (inFlight >= settings.maxInFlight)
+          return;
+      }
+      QueueItem item = queue.top();
+      queue.pop();
+      Entry &e = entries[item.handle];
+      if (e.state != AssetState::Queued || e.stamp != item.stamp)
+        continue; // Reprioritized or released since it was pushed
+
+      e.state = AssetState::Loading;
+      e.payload = std::make_shared<AssetPayload>();
+      e.payload->kind = e.kind;
+      {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        ++inFlight;
+      }
+      Handle h = item.handle;
+      jobs.PushJob([this, h, load = e.load, payload = e.payload] {
+        bool ok = load && load(*payload);
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completed.push_back({h, ok});
+        --inFlight;
+        completedCV.notify_all();
+      });
+      ++stats.loads;
+    }
+  }
+
+  void Upload(const UploadFn &upload) {
+    std::vector<Completion> done;
+    {
+      std::lock_guard<std::mutex> lock(completedMutex);
+      done.swap(completed);
+    }
+    for (const Completion &c : done) {
+      Entry &e = entries[c.handle];
+      if (!c.ok) {
+        std::cerr << "[AssetStreamer] Failed to load " << e.name << std::endl;
+        e.state = AssetState::Failed;
+        e.payload.reset();
+        ++stats.failures;
+        continue;
+      }
+      e.state = AssetState::Decoded;
+      decoded.push_back(c.handle);
+    }
+
+    // Nearest first; anything over budget waits for the next frame
+    std::sort(decoded.begin(), decoded.end(), [this](Handle a, Handle b) {
+      return entries[a].priority < entries[b].priority;
+    });
+    size_t spent = 0;
+    size_t next = 0;
+    for (; next < decoded.size(); ++next) {
+      Entry &e = entries[decoded[next]];
+      if (e.refCount == 0) { // Released while loading
+        e.state = AssetState::Unloaded;
+        e.payload.reset();
+        continue;
+      }
+      size_t bytes = e.payload->SizeBytes();
+      if (spent > 0 && spent + bytes > settings.uploadBudget)
+        break;
+      e.gpuId = upload ? upload(e.name, *e.payload) : INVALID_GPU_ID;
+      e.bytes = bytes;
+      e.state = AssetState::Resident;
+      if (!settings.keepCpuCopy)
+        e.payload.reset();
+      residentBytes += bytes;
+      ++residentCount;
+      spent += bytes;
+      ++stats.uploads;
+    }
+    decoded.erase(decoded.begin(), decoded.begin() + next);
+    stats.uploadedLastFrame = spent;
+  }
+
+  void Trim(const EvictFn &evict) {
+    while (residentBytes > settings.memoryBudget && !lru.empty()) {
+      Handle h = lru.back();
+      lru.pop_back();
+      Entry &e = entries[h];
+      if (evict)
+        evict(e.name, e.gpuId);
+      residentBytes -= e.bytes;
+      --residentCount;
+      e.bytes = 0;
+      e.gpuId = INVALID_GPU_ID;
+      e.payload.reset();
+      e.state = AssetState::Unloaded;
+      ++stats.evictions;
+    }
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -0,0 +1,783 @@
+#pragma once
+#include "../Core/Threading/JobSystem.h"
+#include "TextureData.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <vector>
+
+#ifndef MESOZOIC_SSE
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MESOZOIC_SSE 1
+#else
+#define MESOZOIC_SSE 0
+#endif
+#endif
+#if MESOZOIC_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// BCn Block Compression
+// =========================================================================
+// Offline encoder for the cooker: RGBA8 mip chains become BC1 (opaque
+// color, 8 bytes/block), BC3 (color + alpha), BC5 (two-channel normals) or
+// BC7 (high quality color + alpha), 4-8x smaller than RGBA8 in memory and
+// bandwidth. Every block is fitted by
+//   1. the principal axis of its texels (power iteration) for endpoints,
+//   2. an exact nearest-palette search for indices, 4 texels per SSE step,
+//   3. with Quality, least-squares endpoint refinement from those indices.
+// BC7 uses the unpartitioned modes: mode 6 (RGBA, 4-bit indices, p-bits)
+// and, with Quality, mode 5 (separate alpha indices, channel rotation) for
+// blocks whose alpha does not follow the color. Block rows of each level are
+// split into tiles on the JobSystem.
+
+enum class BCnQuality : uint8_t {
+  Fast,   // One fit per block
+  Quality // Refined endpoints; BC7 also searches mode 5 and rotations
+};
+
+struct BCnSettings {
+  PixelFormat format = PixelFormat::BC1; // BC1, BC3, BC5 or BC7
+  BCnQuality quality = BCnQuality::Fast;
+  // Must not be the pool the caller itself runs on (tiles are awaited)
+  Core::Threading::JobSystem *jobs = nullptr;
+  uint32_t blockRowsPerTile = 8;
+};
+
+namespace BCn {
+
+// 4x4 texels, one array per channel
+struct Block {
+  alignas(16) float c[4][16];
+};
+
+// Interpolation weights (of 64) for 2- and 4-bit BC7 indices
+constexpr uint8_t WEIGHTS2[4] = {0, 21, 43, 64};
+constexpr uint8_t WEIGHTS4[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                  34, 38, 43, 47, 51, 55, 60, 64};
+
+// Clamps to the image edge for partial blocks
+inline void LoadBlock(const uint8_t *rgba, uint32_t w, uint32_t h,
+                      uint32_t bx, uint32_t by, Block &blk) {
+  for (uint32_t y = 0; y < 4; ++y) {
+    uint32_t sy = std::min(by * 4 + y, h - 1);
+    for (uint32_t x = 0; x < 4; ++x) {
+      uint32_t sx = std::min(bx * 4 + x, w - 1);
+      const uint8_t *p = rgba + (size_t(sy) * w + sx) * 4;
+      for (int ch = 0; ch < 4; ++ch)
+        blk.c[ch][y * 4 + x] = p[ch];
+    }
+  }
+}
+
+// Nearest of `count` palette entries for every texel, comparing only the
+// channels with a non-zero weight; returns the summed weighted error
+inline float FitIndices(const Block &blk, const float (*palette)[4],
+                        int count, const float weights[4], uint8_t idx[16]) {
+#if MESOZOIC_SSE
+  __m128 total = _mm_setzero_ps();
+  for (int i = 0; i < 16; i += 4) {
+    __m128 px[4];
+    for (int ch = 0; ch < 4; ++ch)
+      px[ch] = _mm_load_ps(blk.c[ch] + i);
+    __m128 best = _mm_set1_ps(3.0e38f);
+    __m128i bestIdx = _mm_setzero_si128();
+    for (int k = 0; k < count; ++k) {
+      __m128 d = _mm_setzero_ps();
+      for (int ch = 0; ch < 4; ++ch) {
+        if (weights[ch] == 0.0f)
+          continue;
+        __m128 diff = _mm_sub_ps(px[ch], _mm_set1_ps(palette[k][ch]));
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_mul_ps(diff, diff),
+                                     _mm_set1_ps(weights[ch])));
+      }
+      __m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, best));
+      bestIdx = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)),
+                             _mm_andnot_si128(closer, bestIdx));
+      best = _mm_min_ps(best, d);
+    }
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), bestIdx);
+    for (int j = 0; j < 4; ++j)
+      idx[i + j] = static_cast<uint8_t>(lanes[j]);
+    total = _mm_add_ps(total, best);
+  }
+  alignas(16) float sums[4];
+  _mm_store_ps(sums, total);
+  return sums[0] + sums[1] + sums[2] + sums[3];
+#else
+  float total = 0.0f;
+  for (int i = 0; i < 16; ++i) {
+    float best = 3.0e38f;
+    idx[i] = 0;
+    for (int k = 0; k < count; ++k) {
+      float d = 0.0f;
+      for (int ch = 0; ch < 4; ++ch) {
+        if (weights[ch] == 0.0f)
+          continue;
+        float diff = blk.c[ch][i] - palette[k][ch];
+        d += diff * diff * weights[ch];
+      }
+      if (d < best) {
+        best = d;
+        idx[i] = static_cast<uint8_t>(k);
+      }
+    }
+    total += best;
+  }
+  return total;
+#endif
+}
+
+// Endpoints spanning the texels along their principal axis
+inline void FitAxis(const Block &blk, const float weights[4], float e0[4],
+                    float e1[4]) {
+  float mean[4] = {};
+  for (int ch = 0; ch < 4; ++ch) {
+    for (int i = 0; i < 16; ++i)
+      mean[ch] += blk.c[ch][i];
+    mean[ch] /= 16.0f;
+  }
+  float cov[4][4] = {};
+  for (int i = 0; i < 16; ++i) {
+    float d[4];
+    for (int ch = 0; ch < 4; ++ch)
+      d[ch] = weights[ch] != 0.0f ? blk.c[ch][i] - mean[ch] : 0.0f;
+    for (int a = 0; a < 4; ++a)
+      for (int b = 0; b < 4; ++b)
+        cov[a][b] += d[a] * d[b];
+  }
+  // Power iteration from the covariance row of the widest channel
+  int widest = 0;
+  for (int a = 1; a < 4; ++a)
+    if (cov[a][a] > cov[widest][widest])
+      widest = a;
+  float axis[4] = {cov[widest][0], cov[widest][1], cov[widest][2],
+                   cov[widest][3]};
+  for (int iter = 0; iter < 8; ++iter) {
+    float next[4] = {};
+    for (int a = 0; a < 4; ++a)
+      for (int b = 0; b < 4; ++b)
+        next[a] += cov[a][b] * axis[b];
+    float len = std::max({std::abs(next[0]), std::abs(next[1]),
+                          std::abs(next[2]), std::abs(next[3])});
+    if (len < 1e-6f)
+      break; // Flat block: any axis works
+    for (int a = 0; a < 4; ++a)
+      axis[a] = next[a] / len;
+  }
+  float lo = 3.0e38f, hi = -3.0e38f;
+  for (int i = 0; i < 16; ++i) {
+    float t = 0.0f;
+    for (int ch = 0; ch < 4; ++ch)
+      t += (blk.c[ch][i] - mean[ch]) * axis[ch] * (weights[ch] != 0.0f);
+    lo = std::min(lo, t);
+    hi = std::max(hi, t);
+  }
+  float len2 = 0.0f;
+  for (int ch = 0; ch < 4; ++ch)
+    len2 += axis[ch] * axis[ch] * (weights[ch] != 0.0f);
+  if (len2 < 1e-12f)
+    len2 = 1.0f;
+  for (int ch = 0; ch < 4; ++ch) {
+    e0[ch] = std::clamp(mean[ch] + axis[ch] * lo / len2, 0.0f, 255.0f);
+    e1[ch] = std::clamp(mean[ch] + axis[ch] * hi / len2, 0.0f, 255.0f);
+  }
+}
+
+// Least-squares endpoints for fixed indices; `w` maps index -> [0, 1]
+inline bool RefineEndpoints(const Block &blk, const uint8_t idx[16],
+                            const float *w, float e0[4], float e1[4]) {
+  float aa = 0, ab = 0, bb = 0, ax[4] = {}, bx[4] = {};
+  for (int i = 0; i < 16; ++i) {
+    float beta = w[idx[i]], alpha = 1.0f - beta;
+    aa += alpha * alpha;
+    ab += alpha * beta;
+    bb += beta * beta;
+    for (int ch = 0; ch < 4; ++ch) {
+      ax[ch] += alpha * blk.c[ch][i];
+      bx[ch] += beta * blk.c[ch][i];
+    }
+  }
+  float det = aa * bb - ab * ab;
+  if (std::abs(det) < 1e-6f)
+    return false; // Every texel uses the same index
+  for (int ch = 0; ch < 4; ++ch) {
+    e0[ch] = std::clamp((ax[ch] * bb - bx[ch] * ab) / det, 0.0f, 255.0f);
+    e1[ch] = std::clamp((bx[ch] * aa - ax[ch] * ab) / det, 0.0f, 255.0f);
+  }
+  return true;
+}
+
+// Little-endian bit packing for 128-bit BC7 blocks
+struct BitWriter {
+  uint8_t *out;
+  uint32_t pos = 0;
+  void Put(uint32_t v, uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i, ++pos)
+      out[pos >> 3] |= uint8_t(((v >> i) & 1) << (pos & 7));
+  }
+};
+struct BitReader {
+  const uint8_t *in;
+  uint32_t pos = 0;
+  uint32_t Get(uint32_t n) {
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < n; ++i, ++pos)
+      v |= uint32_t((in[pos >> 3] >> (pos & 7)) & 1) << i;
+    return v;
+  }
+};
+
+// ---- BC1 ----------------------------------------------------------------
+
+inline uint16_t Pack565(const float c[4]) {
+  auto q = [](float v, int maxv) {
+    return std::clamp(int(std::lround(v * maxv / 255.0f)), 0, maxv);
+  };
+  return uint16_t((q(c[0], 31) << 11) | (q(c[1], 63) << 5) | q(c[2], 31));
+}
+
+inline void Unpack565(uint16_t c, float out[4]) {
+  int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+  out[0] = float((r << 3) | (r >> 2));
+  out[1] = float((g << 2) | (g >> 4));
+  out[2] = float((b << 3) | (b >> 2));
+  out[3] = 255.0f;
+}
+
+// Four-color BC1 block; returns the RGB squared error
+inline float EncodeBC1(const Block &blk, uint8_t *out, bool refine) {
+  static const float rgb[4] = {1.0f, 1.0f, 1.0f, 0.0f};
+  static const float thirds[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+  float e0[4], e1[4];
+  FitAxis(blk, rgb, e0, e1);
+
+  uint16_t c0 = 0, c1 = 0;
+  uint8_t idx[16] = {};
+  float bestErr = 3.0e38f;
+  for (int pass = 0; pass < (refine ? 3 : 1); ++pass) {
+    uint16_t a = Pack565(e1), b = Pack565(e0);
+    if (a < b)
+      std::swap(a, b); // c0 > c1 selects four-color mode
+    float pal[4][4] = {};
+    Unpack565(a, pal[0]);
+    Unpack565(b, pal[1]);
+    for (int ch = 0; ch < 3; ++ch) {
+      pal[2][ch] = (2.0f * pal[0][ch] + pal[1][ch]) / 3.0f;
+      pal[3][ch] = (pal[0][ch] + 2.0f * pal[1][ch]) / 3.0f;
+    }
+    uint8_t trial[16];
+    float err = a == b ? FitIndices(blk, pal, 1, rgb, trial)
+                       : FitIndices(blk, pal, 4, rgb, trial);
+    if (err < bestErr) {
+      bestErr = err;
+      c0 = a;
+      c1 = b;
+      std::memcpy(idx, trial, 16);
+    }
+    if (pass + 1 < (refine ? 3 : 1)) {
+      // Refine toward the quantized pair actually used (c0 = e0 side)
+      Unpack565(c0, e0);
+      Unpack565(c1, e1);
+      if (!RefineEndpoints(blk, idx, thirds, e0, e1))
+        break;
+    }
+  }
+  out[0] = uint8_t(c0);
+  out[1] = uint8_t(c0 >> 8);
+  out[2] = uint8_t(c1);
+  out[3] = uint8_t(c1 >> 8);
+  uint32_t bits = 0;
+  for (int i = 0; i < 16; ++i)
+    bits |= uint32_t(idx[i]) << (i * 2);
+  std::memcpy(out + 4, &bits, 4); // Little-endian hosts
+  return bestErr;
+}
+
+inline void DecodeBC1(const uint8_t *in, uint8_t rgba[64]) {
+  uint16_t c0 = uint16_t(in[0] | (in[1] << 8));
+  uint16_t c1 = uint16_t(in[2] | (in[3] << 8));
+  float pal[4][4];
+  Unpack565(c0, pal[0]);
+  Unpack565(c1, pal[1]);
+  for (int ch = 0; ch < 3; ++ch) {
+    if (c0 > c1) {
+      pal[2][ch] = (2.0f * pal[0][ch] + pal[1][ch]) / 3.0f;
+      pal[3][ch] = (pal[0][ch] + 2.0f * pal[1][ch]) / 3.0f;
+    } else {
+      pal[2][ch] = (pal[0][ch] + pal[1][ch]) / 2.0f;
+      pal[3][ch] = 0.0f;
+    }
+  }
+  pal[2][3] = 255.0f;
+  pal[3][3] = c0 > c1 ? 255.0f : 0.0f; // Punch-through alpha
+  uint32_t bits = uint32_t(in[4]) | (uint32_t(in[5]) << 8) |
+                  (uint32_t(in[6]) << 16) | (uint32_t(in[7]) << 24);
+  for (int i = 0; i < 16; ++i) {
+    const float *p = pal[(bits >> (i * 2)) & 3];
+    for (int ch = 0; ch < 4; ++ch)
+      rgba[i * 4 + ch] = uint8_t(std::lround(p[ch]));
+  }
+}
+
+// ---- BC4 (BC3 alpha, BC5 channels) --------------------------------------
+
+// Eight-value mode: code 0 = max, 1 = min, 2..7 step from max to min
+inline void EncodeBC4(const float v[16], uint8_t *out) {
+  float lo = v[0], hi = v[0];
+  for (int i = 1; i < 16; ++i) {
+    lo = std::min(lo, v[i]);
+    hi = std::max(hi, v[i]);
+  }
+  int a0 = int(std::lround(hi)), a1 = int(std::lround(lo));
+  out[0] = uint8_t(a0);
+  out[1] = uint8_t(a1);
+  uint64_t bits = 0;
+  if (a0 != a1) {
+    float scale = 7.0f / float(a0 - a1);
+    for (int i = 0; i < 16; ++i) {
+      int step = int(std::lround((float(a0) - v[i]) * scale)); // 0..7
+      step = std::clamp(step, 0, 7);
+      uint64_t code = step == 0 ? 0 : step == 7 ? 1 : uint64_t(step + 1);
+      bits |= code << (i * 3);
+    }
+  }
+  for (int b = 0; b < 6; ++b)
+    out[2 + b] = uint8_t(bits >> (b * 8));
+}
+
+inline void DecodeBC4(const uint8_t *in, uint8_t out[16], int stride = 1) {
+  int a0 = in[0], a1 = in[1];
+  int pal[8] = {a0, a1};
+  if (a0 > a1) {
+    for (int k = 1; k < 7; ++k)
+      pal[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+  } else {
+    for (int k = 1; k < 5; ++k)
+      pal[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+    pal[6] = 0;
+    pal[7] = 255;
+  }
+  uint64_t bits = 0;
+  for (int b = 0; b < 6; ++b)
+    bits |= uint64_t(in[2 + b]) << (b * 8);
+  for (int i = 0; i < 16; ++i)
+    out[i * stride] = uint8_t(pal[(bits >> (i * 3)) & 7]);
+}
+
+// ---- BC7 ----------------------------------------------------------------
+
+struct BC7Candidate {
+  float error = 3.0e38f;
+  uint8_t bytes[16] = {};
+};
+
+// Mode 6: RGBA 7-bit endpoints + per-endpoint p-bit, 4-bit indices
+inline void TryBC7Mode6(const Block &blk, bool refine, BC7Candidate &best) {
+  static const float all[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+  static const float w4[16] = {0 / 64.f,  4 / 64.f,  9 / 64.f,  13 / 64.f,
+                               17 / 64.f, 21 / 64.f, 26 / 64.f, 30 / 64.f,
+                               34 / 64.f, 38 / 64.f, 43 / 64.f, 47 / 64.f,
+                               51 / 64.f, 55 / 64.f, 60 / 64.f, 64 / 64.f};
+  float e0[4], e1[4];
+  FitAxis(blk, all, e0, e1);
+  for (int pass = 0; pass < (refine ? 3 : 1); ++pass) {
+    int bestQ[2][4] = {}, bestP[2] = {};
+    uint8_t bestIdx[16] = {};
+    float bestErr = 3.0e38f;
+    for (int p = 0; p < 4; ++p) {
+      int pb[2] = {p & 1, p >> 1};
+      int q[2][4];
+      float ends[2][4];
+      for (int e = 0; e < 2; ++e) {
+        const float *src = e == 0 ? e0 : e1;
+        for (int ch = 0; ch < 4; ++ch) {
+          q[e][ch] = std::clamp(int(std::lround((src[ch] - pb[e]) / 2.0f)),
+                                0, 127);
+          ends[e][ch] = float((q[e][ch] << 1) | pb[e]);
+        }
+      }
+      float pal[16][4];
+      for (int k = 0; k < 16; ++k) {
+        for (int ch = 0; ch < 4; ++ch) {
+          pal[k][ch] = float(((64 - WEIGHTS4[k]) * int(ends[0][ch]) +
+                              WEIGHTS4[k] * int(ends[1][ch]) + 32) >>
+                             6);
+        }
+      }
+      uint8_t idx[16];
+      float err = FitIndices(blk, pal, 16, all, idx);
+      if (err < bestErr) {
+        bestErr = err;
+        std::memcpy(bestQ, q, sizeof(q));
+        bestP[0] = pb[0];
+        bestP[1] = pb[1];
+        std::memcpy(bestIdx, idx, 16);
+      }
+    }
+    if (bestErr < best.error) {
+      // Index 0's top bit is implicit: swap ends so it is clear
+      if (bestIdx[0] & 8) {
+        std::swap(bestQ[0], bestQ[1]);
+        std::swap(bestP[0], bestP[1]);
+        for (auto &i : bestIdx)
+          i = uint8_t(15 - i);
+      }
+      best.error = bestErr;
+      std::memset(best.bytes, 0, 16);
+      BitWriter bits{best.bytes};
+      bits.Put(1u << 6, 7);
+      for (int ch = 0; ch < 4; ++ch) {
+        bits.Put(uint32_t(bestQ[0][ch]), 7);
+        bits.Put(uint32_t(bestQ[1][ch]), 7);
+      }
+      bits.Put(uint32_t(bestP[0]), 1);
+      bits.Put(uint32_t(bestP[1]), 1);
+      for (int i = 0; i < 16; ++i)
+        bits.Put(bestIdx[i], i == 0 ? 3 : 4);
+    }
+    if (pass + 1 < (refine ? 3 : 1)) {
+      uint8_t idx[16];
+      float pal[16][4];
+      for (int k = 0; k < 16; ++k) {
+        for (int ch = 0; ch < 4; ++ch)
+          pal[k][ch] = e0[ch] + (e1[ch] - e0[ch]) * w4[k];
+      }
+      FitIndices(blk, pal, 16, all, idx);
+      if (!RefineEndpoints(blk, idx, w4, e0, e1))
+        break;
+    }
+  }
+}
+
+// Mode 5: RGB 7-bit + A 8-bit endpoints with separate 2-bit indices; the
+// rotation swaps alpha with one color channel before encoding
+inline void TryBC7Mode5(const Block &src, int rotation, bool refine,
+                        BC7Candidate &best) {
+  static const float rgbW[4] = {1.0f, 1.0f, 1.0f, 0.0f};
+  static const float alphaW[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  static const float w2[4] = {0.0f, 21 / 64.f, 43 / 64.f, 1.0f};
+  Block blk = src;
+  if (rotation > 0)
+    std::swap(blk.c[rotation - 1], blk.c[3]);
+
+  float e0[4], e1[4];
+  FitAxis(blk, rgbW, e0, e1);
+  int cq[2][3] = {};
+  uint8_t cIdx[16] = {};
+  float colorErr = 3.0e38f;
+  for (int pass = 0; pass < (refine ? 3 : 1); ++pass) {
+    int q[2][3];
+    float pal[4][4] = {};
+    for (int e = 0; e < 2; ++e) {
+      for (int ch = 0; ch < 3; ++ch)
+        q[e][ch] = std::clamp(int(std::lround((e ? e1 : e0)[ch] * 127.0f /
+                                              255.0f)),
+                              0, 127);
+    }
+    for (int k = 0; k < 4; ++k) {
+      for (int ch = 0; ch < 3; ++ch) {
+        int a = (q[0][ch] << 1) | (q[0][ch] >> 6);
+        int b = (q[1][ch] << 1) | (q[1][ch] >> 6);
+        pal[k][ch] =
+            float(((64 - WEIGHTS2[k]) * a + WEIGHTS2[k] * b + 32) >> 6);
+      }
+    }
+    uint8_t idx[16];
+    float err = FitIndices(blk, pal, 4, rgbW, idx);
+    if (err < colorErr) {
+      colorErr = err;
+      std::memcpy(cq, q, sizeof(q));
+      std::memcpy(cIdx, idx, 16);
+    }
+    if (pass + 1 < (refine ? 3 : 1) && !RefineEndpoints(blk, idx, w2, e0, e1))
+      break;
+  }
+
+  // Alpha (or the rotated channel) spans its own min..max
+  float lo = 255.0f, hi = 0.0f;
+  for (int i = 0; i < 16; ++i) {
+    lo = std::min(lo, blk.c[3][i]);
+    hi = std::max(hi, blk.c[3][i]);
+  }
+  int aq[2] = {int(std::lround(lo)), int(std::lround(hi))};
+  float apal[4][4] = {};
+  for (int k = 0; k < 4; ++k)
+    apal[k][3] =
+        float(((64 - WEIGHTS2[k]) * aq[0] + WEIGHTS2[k] * aq[1] + 32) >> 6);
+  uint8_t aIdx[16];
+  float alphaErr = FitIndices(blk, apal, 4, alphaW, aIdx);
+
+  float err = colorErr + alphaErr;
+  if (err >= best.error)
+    return;
+  if (cIdx[0] & 2) {
+    std::swap(cq[0], cq[1]);
+    for (auto &i : cIdx)
+      i = uint8_t(3 - i);
+  }
+  if (aIdx[0] & 2) {
+    std::swap(aq[0], aq[1]);
+    for (auto &i : aIdx)
+      i = uint8_t(3 - i);
+  }
+  best.error = err;
+  std::memset(best.bytes, 0, 16);
+  BitWriter bits{best.bytes};
+  bits.Put(1u << 5, 6);
+  bits.Put(uint32_t(rotation), 2);
+  for (int ch = 0; ch < 3; ++ch) {
+    bits.Put(uint32_t(cq[0][ch]), 7);
+    bits.Put(uint32_t(cq[1][ch]), 7);
+  }
+  bits.Put(uint32_t(aq[0]), 8);
+  bits.Put(uint32_t(aq[1]), 8);
+  for (int i = 0; i < 16; ++i)
+    bits.Put(cIdx[i], i == 0 ? 1 : 2);
+  for (int i = 0; i < 16; ++i)
+    bits.Put(aIdx[i], i == 0 ? 1 : 2);
+}
+
+inline float EncodeBC7(const Block &blk, uint8_t *out, bool quality) {
+  BC7Candidate best;
+  TryBC7Mode6(blk, quality, best);
+  if (quality) {
+    for (int rotation = 0; rotation < 4; ++rotation)
+      TryBC7Mode5(blk, rotation, true, best);
+  }
+  std::memcpy(out, best.bytes, 16);
+  return best.error;
+}
+
+// Decodes the modes EncodeBC7 emits (5 and 6); false for any other mode
+inline bool DecodeBC7(const uint8_t *in, uint8_t rgba[64]) {
+  BitReader bits{in};
+  int mode = 0;
+  while (mode < 8 && bits.Get(1) == 0)
+    ++mode;
+  if (mode == 6) {
+    int q[2][4], p[2];
+    for (int ch = 0; ch < 4; ++ch) {
+      q[0][ch] = int(bits.Get(7));
+      q[1][ch] = int(bits.Get(7));
+    }
+    p[0] = int(bits.Get(1));
+    p[1] = int(bits.Get(1));
+    for (int i = 0; i < 16; ++i) {
+      uint32_t w = WEIGHTS4[bits.Get(i == 0 ? 3 : 4)];
+      for (int ch = 0; ch < 4; ++ch) {
+        uint32_t a = uint32_t((q[0][ch] << 1) | p[0]);
+        uint32_t b = uint32_t((q[1][ch] << 1) | p[1]);
+        rgba[i * 4 + ch] = uint8_t(((64 - w) * a + w * b + 32) >> 6);
+      }
+    }
+    return true;
+  }
+  if (mode == 5) {
+    int rotation = int(bits.Get(2));
+    uint32_t c[2][4];
+    for (int ch = 0; ch < 3; ++ch) {
+      for (int e = 0; e < 2; ++e) {
+        uint32_t v = bits.Get(7);
+        c[e][ch] = (v << 1) | (v >> 6);
+      }
+    }
+    c[0][3] = bits.Get(8);
+    c[1][3] = bits.Get(8);
+    uint32_t ci[16], ai[16];
+    for (int i = 0; i < 16; ++i)
+      ci[i] = bits.Get(i == 0 ? 1 : 2);
+    for (int i = 0; i < 16; ++i)
+      ai[i] = bits.Get(i == 0 ? 1 : 2);
+    for (int i = 0; i < 16; ++i) {
+      uint8_t *px = rgba + i * 4;
+      for (int ch = 0; ch < 4; ++ch) {
+        uint32_t w = WEIGHTS2[ch == 3 ? ai[i] : ci[i]];
+        px[ch] = uint8_t(((64 - w) * c[0][ch] + w * c[1][ch] + 32) >> 6);
+      }
+      if (rotation > 0)
+        std::swap(px[rotation - 1], px[3]);
+    }
+    return true;
+  }
+  return false;
+}
+
+} // namespace BCn
+
+class BCnEncoder {
+public:
+  // Compresses every mip level of an RGBA8 texture in place
+  static bool Compress(TextureData &tex, const BCnSettings &settings = {}) {
+    if (!tex.valid || tex.format != PixelFormat::RGBA8 ||
+        BlockBytesFor(settings.format) == 0) {
+      std::cerr << "[BCnEncoder] Unsupported texture or target format: "
+                << tex.name << std::endl;
+      return false;
+    }
+    uint32_t levels = std::max(1u, tex.mipLevels);
+    std::vector<TextureMip> source = tex.mips;
+    if (source.size() != levels) {
+      TextureData layout;
+      layout.width = tex.width;
+      layout.height = tex.height;
+      layout.BuildMipLayout(levels);
+      source = layout.mips;
+    }
+
+    TextureData out;
+    out.width = tex.width;
+    out.height = tex.height;
+    out.format = settings.format;
+    out.pixels.resize(out.BuildMipLayout(levels));
+    const size_t blockBytes = out.BlockBytes();
+    const bool refine = settings.quality == BCnQuality::Quality;
+
+    for (uint32_t level = 0; level < levels; ++level) {
+      const TextureMip &src = source[level];
+      const uint8_t *rgba = tex.pixels.data() + src.offset;
+      uint8_t *dst = out.pixels.data() + out.mips[level].offset;
+      uint32_t blocksX = (src.width + 3) / 4;
+      uint32_t blocksY = (src.height + 3) / 4;
+      ForBlockRows(settings, blocksY, [&](uint32_t y0, uint32_t y1) {
+        BCn::Block blk;
+        for (uint32_t by = y0; by < y1; ++by) {
+          for (uint32_t bx = 0; bx < blocksX; ++bx) {
+            BCn::LoadBlock(rgba, src.width, src.height, bx, by, blk);
+            uint8_t *block = dst + (size_t(by) * blocksX + bx) * blockBytes;
+            EncodeBlock(settings.format, blk, block, refine);
+          }
+        }
+      });
+    }
+
+    tex.pixels.swap(out.pixels);
+    tex.mips = out.mips;
+    tex.format = settings.format;
+    if (settings.format == PixelFormat::BC5) {
+      tex.channels = 2;
+      tex.srgb = false; // Vectors, never color
+    }
+    return true;
+  }
+
+  // Back to RGBA8, e.g. for devices without BC support. BC5 decodes like a
+  // GPU samples it: (x, y, 0, 1).
+  static bool Decompress(TextureData &tex) {
+    if (!tex.valid || !tex.IsBlockCompressed())
+      return false;
+    uint32_t levels = std::max(1u, tex.mipLevels);
+    if (tex.mips.size() != levels)
+      tex.BuildMipLayout(levels);
+    TextureData out;
+    out.width = tex.width;
+    out.height = tex.height;
+    out.format = PixelFormat::RGBA8;
+    out.pixels.resize(out.BuildMipLayout(levels));
+    const size_t blockBytes = tex.BlockBytes();
+
+    for (uint32_t level = 0; level < levels; ++level) {
+      const TextureMip &mip = tex.mips[level];
+      const uint8_t *src = tex.pixels.data() + mip.offset;
+      uint8_t *dst = out.pixels.data() + out.mips[level].offset;
+      uint32_t blocksX = (mip.width + 3) / 4;
+      uint32_t blocksY = (mip.height + 3) / 4;
+      for (uint32_t by = 0; by < blocksY; ++by) {
+        for (uint32_t bx = 0; bx < blocksX; ++bx) {
+          const uint8_t *block = src + (size_t(by) * blocksX + bx) * blockBytes;
+          uint8_t texels[64];
+          if (!DecodeBlock(tex.format, block, texels))
+            return false;
+          for (uint32_t y = 0; y < 4 && by * 4 + y < mip.height; ++y) {
+            uint8_t *row = dst + (size_t(by * 4 + y) * mip.width + bx * 4) * 4;
+            for (uint32_t x = 0; x < 4 && bx * 4 + x < mip.width; ++x)
+              std::memcpy(row + x * 4, texels + (y * 4 + x) * 4, 4);
+          }
+        }
+      }
+    }
+    tex.pixels.swap(out.pixels);
+    tex.mips = out.mips;
+    tex.format = PixelFormat::RGBA8;
+    tex.channels = 4;
+    return true;
+  }
+
+  static size_t BlockBytesFor(PixelFormat format) {
+    TextureData probe;
+    probe.format = format;
+    return probe.BlockBytes();
+  }
+
+private:
+  static void EncodeBlock(PixelFormat format, const BCn::Block &blk,
+                          uint8_t *out, bool refine) {
+    switch (format) {
+    case PixelFormat::BC1:
+      BCn::EncodeBC1(blk, out, refine);
+      break;
+    case PixelFormat::BC3:
+      BCn::EncodeBC4(blk.c[3], out);
+      BCn::EncodeBC1(blk, out + 8, refine);
+      break;
+    case PixelFormat::BC5:
+      BCn::EncodeBC4(blk.c[0], out);
+      BCn::EncodeBC4(blk.c[1], out + 8);
+      break;
+    default:
+      BCn::EncodeBC7(blk, out, refine);
+      break;
+    }
+  }
+
+  static bool DecodeBlock(PixelFormat format, const uint8_t *in,
+                          uint8_t texels[64]) {
+    switch (format) {
+    case PixelFormat::BC1:
+      BCn::DecodeBC1(in, texels);
+      return true;
+    case PixelFormat::BC3:
+      BCn::DecodeBC1(in + 8, texels);
+      BCn::DecodeBC4(in, texels + 3, 4);
+      return true;
+    case PixelFormat::BC5:
+      BCn::DecodeBC4(in, texels, 4);
+      BCn::DecodeBC4(in + 8, texels + 1, 4);
+      for (int i = 0; i < 16; ++i) {
+        texels[i * 4 + 2] = 0;
+        texels[i * 4 + 3] = 255;
+      }
+      return true;
+    default:
+      return BCn::DecodeBC7(in, texels);
+    }
+  }
+
+  // Runs fn(y0, y1) over tiles of block rows, on the workers if any
+  template <typename Fn>
+  static void ForBlockRows(const BCnSettings &s, uint32_t rows, Fn &&fn) {
+    uint32_t tile = std::max(1u, s.blockRowsPerTile);
+    if (!s.jobs || rows <= tile) {
+      fn(0u, rows);
+      return;
+    }
+    std::vector<std::future<void>> pending;
+    for (uint32_t y = 0; y < rows; y += tile) {
+      uint32_t end = std::min(rows, y + tile);
+      pending.push_back(s.jobs->PushJob([&fn, y, end] { fn(y, end); }));
+    }
+    for (auto &f : pending)
+      f.get();
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -0,0 +1,253 @@
+#pragma once
+#include "GLTFLoader.h"
+#include "JsonTokenizer.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// Binary glTF (.glb)
+// =========================================================================
+// 12-byte header, then a JSON chunk and an optional BIN chunk, each with an
+// 8-byte chunk header and 4-byte aligned length. The file is memory-mapped,
+// the JSON chunk is tokenized in place and accessors are read straight out
+// of the BIN chunk.
+
+constexpr uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+constexpr uint32_t GLB_VERSION = 2;
+constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+
+struct GLBHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t length; // Whole file
+};
+
+struct GLBChunkHeader {
+  uint32_t length; // Payload bytes
+  uint32_t type;
+};
+
+// =========================================================================
+// GLB Asset: mapped file + GLB container + glTF document
+// =========================================================================
+class GLBAsset {
+public:
+  bool Open(const std::string &path) {
+    name = path;
+    if (!file.Open(path))
+      return false;
+    return OpenMemory(file.Data(), file.Size());
+  }
+
+  // Parse a GLB image already in memory (must outlive the asset)
+  bool OpenMemory(const uint8_t *data, size_t size) {
+    GLBHeader header;
+    if (size < sizeof(GLBHeader) + sizeof(GLBChunkHeader))
+      return Error("file too small");
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != GLB_MAGIC)
+      return Error("bad magic");
+    if (header.version != GLB_VERSION)
+      return Error("unsupported version");
+    if (header.length > size)
+      return Error("truncated file");
+
+    size_t pos = sizeof(GLBHeader);
+    std::string_view json;
+    const uint8_t *bin = nullptr;
+    size_t binSize = 0;
+    while (pos + sizeof(GLBChunkHeader) <= header.length) {
+      GLBChunkHeader chunk;
+      std::memcpy(&chunk, data + pos, sizeof(chunk));
+      pos += sizeof(chunk);
+      if (pos + chunk.length > header.length)
+        return Error("chunk overruns file");
+      if (chunk.type == GLB_CHUNK_JSON && json.empty()) {
+        json = {reinterpret_cast<const char *>(data + pos), chunk.length};
+      } else if (chunk.type == GLB_CHUNK_BIN && !bin) {
+        bin = data + pos;
+        binSize = chunk.length;
+      } // Unknown chunks are skipped per the spec
+      pos += (chunk.length + 3) & ~size_t(3);
+    }
+    if (json.empty())
+      return Error("missing JSON chunk");
+    document.name = name;
+    return document.Parse(json, bin, binSize);
+  }
+
+  const GLTFDocument &Document() const { return document; }
+  JsonValue Root() const { return document.Root(); }
+  const JsonDocument &Json() const { return document.Json(); }
+  const uint8_t *Bin() const { return document.Bin(); }
+  size_t BinSize() const { return document.BinSize(); }
+  AccessorView Accessor(int index) const { return document.Accessor(index); }
+  GLTFScene ToScene() const { return document.ToScene(); }
+
+private:
+  std::string name;
+  MappedFile file;
+  GLTFDocument document;
+
+  bool Error(const char *what) {
+    std::cerr << "[GLBLoader] " << name << ": " << what << std::endl;
+    return false;
+  }
+};
+
+// =========================================================================
+// GLB Loader / Writer
+// =========================================================================
+class GLBLoader {
+public:
+  static GLTFScene Load(const std::string &filepath) {
+    GLBAsset asset;
+    if (!asset.Open(filepath))
+      return {};
+    GLTFScene scene = asset.ToScene();
+    std::cout << "[GLBLoader] Loaded: " << filepath << std::endl;
+    std::cout << "  Meshes: " << scene.meshes.size()
+              << " | Materials: " << scene.materials.size()
+              << " | Nodes: " << scene.nodes.size()
+              << " | Animations: " << scene.animations.size() << std::endl;
+    return scene;
+  }
+
+  // Minimal GLB writer for tooling and tests: one mesh (interleaved-free,
+  // one accessor per attribute) and optional animation channels.
+  static std::vector<uint8_t> Write(const GLTFMesh &mesh,
+                                    const GLTFAnimation *anim = nullptr) {
+    std::vector<uint8_t> binData;
+    std::string views, accessors;
+    int accessorCount = 0;
+
+    auto addAccessor = [&](const void *src, size_t bytes, size_t count,
+                           const char *type, int componentType) {
+      size_t offset = binData.size();
+      const auto *p = static_cast<const uint8_t *>(src);
+      binData.insert(binData.end(), p, p + bytes);
+      binData.resize((binData.size() + 3) & ~size_t(3), 0);
+      if (accessorCount > 0) {
+        views += ",";
+        accessors += ",";
+      }
+      views += "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) +
+               ",\"byteLength\":" + std::to_string(bytes) + "}";
+      accessors += "{\"bufferView\":" + std::to_string(accessorCount) +
+                   ",\"componentType\":" + std::to_string(componentType) +
+                   ",\"count\":" + std::to_string(count) + ",\"type\":\"" +
+                   type + "\"}";
+      return accessorCount++;
+    };
+
+    std::string prims;
+    for (const auto &prim : mesh.primitives) {
+      size_t n = prim.vertices.size();
+      std::vector<float> pos(n * 3), nrm(n * 3), uv(n * 2);
+      for (size_t i = 0; i < n; ++i) {
+        const GLTFVertex &v = prim.vertices[i];
+        pos[i * 3] = v.position.x;
+        pos[i * 3 + 1] = v.position.y;
+        pos[i * 3 + 2] = v.position.z;
+        nrm[i * 3] = v.normal.x;
+        nrm[i * 3 + 1] = v.normal.y;
+        nrm[i * 3 + 2] = v.normal.z;
+        uv[i * 2] = v.uv[0];
+        uv[i * 2 + 1] = v.uv[1];
+      }
+      int p = addAccessor(pos.data(), pos.size() * 4, n, "VEC3", 5126);
+      int q = addAccessor(nrm.data(), nrm.size() * 4, n, "VEC3", 5126);
+      int t = addAccessor(uv.data(), uv.size() * 4, n, "VEC2", 5126);
+      int i = addAccessor(prim.indices.data(), prim.indices.size() * 4,
+                          prim.indices.size(), "SCALAR", 5125);
+      if (!prims.empty())
+        prims += ",";
+      prims += "{\"attributes\":{\"POSITION\":" + std::to_string(p) +
+               ",\"NORMAL\":" + std::to_string(q) +
+               ",\"TEXCOORD_0\":" + std::to_string(t) +
+               "},\"indices\":" + std::to_string(i) + "}";
+    }
+
+    std::string animations;
+    if (anim) {
+      std::string samplers, channels;
+      for (size_t c = 0; c < anim->channels.size(); ++c) {
+        const auto &ch = anim->channels[c];
+        size_t keys = ch.times.size();
+        size_t comps = keys ? ch.values.size() / keys : 0;
+        int in = addAccessor(ch.times.data(), keys * 4, keys, "SCALAR", 5126);
+        int out = addAccessor(ch.values.data(), ch.values.size() * 4, keys,
+                              comps == 4 ? "VEC4" : "VEC3", 5126);
+        if (c > 0) {
+          samplers += ",";
+          channels += ",";
+        }
+        samplers += "{\"input\":" + std::to_string(in) +
+                    ",\"output\":" + std::to_string(out) + "}";
+        channels += "{\"sampler\":" + std::to_string(c) +
+                    ",\"target\":{\"node\":" + std::to_string(ch.nodeIndex) +
+                    ",\"path\":\"" + ch.path + "\"}}";
+      }
+      animations = ",\"animations\":[{\"name\":\"" + anim->name +
+                   "\",\"samplers\":[" + samplers + "],\"channels\":[" +
+                   channels + "]}]";
+    }
+
+    std::string json =
+        "{\"asset\":{\"version\":\"2.0\",\"generator\":\"Mesozoic\"},"
+        "\"buffers\":[{\"byteLength\":" +
+        std::to_string(binData.size()) + "}],\"bufferViews\":[" + views +
+        "],\"accessors\":[" + accessors + "],\"meshes\":[{\"name\":\"" +
+        mesh.name + "\",\"primitives\":[" + prims +
+        "]}],\"nodes\":[{\"name\":\"" + mesh.name + "\",\"mesh\":0}]" +
+        animations + "}";
+    json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+    std::vector<uint8_t> out;
+    auto put = [&out](const void *src, size_t bytes) {
+      const auto *p = static_cast<const uint8_t *>(src);
+      out.insert(out.end(), p, p + bytes);
+    };
+    GLBHeader header{GLB_MAGIC, GLB_VERSION,
+                     static_cast<uint32_t>(12 + 8 + json.size() + 8 +
+                                           binData.size())};
+    GLBChunkHeader jsonChunk{static_cast<uint32_t>(json.size()),
+                             GLB_CHUNK_JSON};
+    GLBChunkHeader binChunk{static_cast<uint32_t>(binData.size()),
+                            GLB_CHUNK_BIN};
+    put(&header, sizeof(header));
+    put(&jsonChunk, sizeof(jsonChunk));
+    put(json.data(), json.size());
+    put(&binChunk, sizeof(binChunk));
+    put(binData.data(), binData.size());
+    return out;
+  }
+
+  static bool WriteFile(const std::string &filepath,
+                        const std::vector<uint8_t> &glb) {
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+      std::cerr << "[GLBLoader] Failed to open for writing: " << filepath
+                << std::endl;
+      return false;
+    }
+    file.write(reinterpret_cast<const char *>(glb.data()),
+               static_cast<std::streamsize>(glb.size()));
+    return file.good();
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -1,11 +1,14 @@
 #pragma once
 #include "../Core/Math/Vec3.h"
+#include "JsonTokenizer.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <fstream>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 namespace Mesozoic {
@@ -93,157 +96,452 @@ struct GLTFScene {
 };
 
 // =========================================================================
-// Minimal JSON parser for glTF (no external dependencies)
+// Accessors
 // =========================================================================
+enum class GLTFComponentType : uint32_t {
+  Byte = 5120,
+  UnsignedByte = 5121,
+  Short = 5122,
+  UnsignedShort = 5123,
+  UnsignedInt = 5125,
+  Float = 5126,
+};
 
-class MiniJSON {
-public:
-  enum class Type { Null, Bool, Number, String, Array, Object };
-
-  struct Value {
-    Type type = Type::Null;
-    double number = 0;
-    bool boolean = false;
-    std::string str;
-    std::vector<Value> array;
-    std::unordered_map<std::string, Value> object;
-
-    const Value &operator[](const std::string &key) const {
-      static Value null;
-      auto it = object.find(key);
-      return it != object.end() ? it->second : null;
+inline uint32_t ComponentSize(GLTFComponentType t) {
+  switch (t) {
+  case GLTFComponentType::Byte:
+  case GLTFComponentType::UnsignedByte:
+    return 1;
+  case GLTFComponentType::Short:
+  case GLTFComponentType::UnsignedShort:
+    return 2;
+  default:
+    return 4;
+  }
+}
+
+inline bool IsComponentType(uint32_t t) {
+  return (t >= 5120 && t <= 5123) || t == 5125 || t == 5126;
+}
+
+// glTF component type of a scalar, or of a std::array's elements; As<T>()
+// only hands out views whose components really are of that type
+template <typename T> struct GLTFComponentOf;
+template <> struct GLTFComponentOf<int8_t> {
+  static constexpr GLTFComponentType value = GLTFComponentType::Byte;
+};
+template <> struct GLTFComponentOf<uint8_t> {
+  static constexpr GLTFComponentType value = GLTFComponentType::UnsignedByte;
+};
+template <> struct GLTFComponentOf<int16_t> {
+  static constexpr GLTFComponentType value = GLTFComponentType::Short;
+};
+template <> struct GLTFComponentOf<uint16_t> {
+  static constexpr GLTFComponentType value =
+      GLTFComponentType::UnsignedShort;
+};
+template <> struct GLTFComponentOf<uint32_t> {
+  static constexpr GLTFComponentType value = GLTFComponentType::UnsignedInt;
+};
+template <> struct GLTFComponentOf<float> {
+  static constexpr GLTFComponentType value = GLTFComponentType::Float;
+};
+template <typename T, size_t N>
+struct GLTFComponentOf<std::array<T, N>> : GLTFComponentOf<T> {};
+
+inline uint32_t ComponentCount(std::string_view type) {
+  if (type == "SCALAR")
+    return 1;
+  if (type == "VEC2")
+    return 2;
+  if (type == "VEC3")
+    return 3;
+  if (type == "VEC4" || type == "MAT2")
+    return 4;
+  if (type == "MAT3")
+    return 9;
+  if (type == "MAT4")
+    return 16;
+  return 0;
+}
+
+// Strided element access into mapped memory (memcpy keeps unaligned loads
+// legal and compiles to a plain load)
+template <typename T> struct StridedView {
+  const uint8_t *base = nullptr;
+  uint32_t count = 0;
+  uint32_t stride = sizeof(T);
+
+  T operator[](uint32_t i) const {
+    T v;
+    std::memcpy(&v, base + size_t(i) * stride, sizeof(T));
+    return v;
+  }
+  uint32_t Size() const { return count; }
+  bool Contiguous() const { return stride == sizeof(T); }
+};
+
+// A resolved accessor: pointer into the BIN chunk plus layout
+struct AccessorView {
+  const uint8_t *data = nullptr;
+  uint32_t count = 0;
+  uint32_t stride = 0; // Bytes between elements
+  uint32_t components = 0;
+  GLTFComponentType componentType = GLTFComponentType::Float;
+  bool normalized = false;
+
+  bool Valid() const { return data != nullptr; }
+  uint32_t ElementSize() const {
+    return components * ComponentSize(componentType);
+  }
+
+  // Zero-copy typed view; T must match the component type and element size
+  // exactly (e.g. std::array<float, 3> for a float VEC3)
+  template <typename T> StridedView<T> As() const {
+    if (!Valid() || sizeof(T) != ElementSize() ||
+        GLTFComponentOf<T>::value != componentType)
+      return {};
+    return {data, count, stride};
+  }
+
+  // Converting read of one component (normalized integers map to [0,1] or
+  // [-1,1] per the glTF spec)
+  float Float(uint32_t i, uint32_t c) const {
+    const uint8_t *p = data + size_t(i) * stride +
+                       size_t(c) * ComponentSize(componentType);
+    switch (componentType) {
+    case GLTFComponentType::Float: {
+      float v;
+      std::memcpy(&v, p, 4);
+      return v;
+    }
+    case GLTFComponentType::UnsignedByte:
+      return normalized ? *p / 255.0f : *p;
+    case GLTFComponentType::Byte: {
+      float v = static_cast<int8_t>(*p);
+      return normalized ? std::max(v / 127.0f, -1.0f) : v;
+    }
+    case GLTFComponentType::UnsignedShort: {
+      uint16_t v;
+      std::memcpy(&v, p, 2);
+      return normalized ? v / 65535.0f : v;
+    }
+    case GLTFComponentType::Short: {
+      int16_t v;
+      std::memcpy(&v, p, 2);
+      return normalized ? std::max(v / 32767.0f, -1.0f) : float(v);
     }
+    case GLTFComponentType::UnsignedInt: {
+      uint32_t v;
+      std::memcpy(&v, p, 4);
+      return static_cast<float>(v);
+    }
+    }
+    return 0.0f;
+  }
 
-    const Value &operator[](size_t index) const {
-      static Value null;
-      return index < array.size() ? array[index] : null;
+  uint32_t Uint(uint32_t i, uint32_t c) const {
+    const uint8_t *p = data + size_t(i) * stride +
+                       size_t(c) * ComponentSize(componentType);
+    switch (componentType) {
+    case GLTFComponentType::UnsignedByte:
+    case GLTFComponentType::Byte:
+      return *p;
+    case GLTFComponentType::UnsignedShort:
+    case GLTFComponentType::Short: {
+      uint16_t v;
+      std::memcpy(&v, p, 2);
+      return v;
+    }
+    case GLTFComponentType::UnsignedInt: {
+      uint32_t v;
+      std::memcpy(&v, p, 4);
+      return v;
+    }
+    case GLTFComponentType::Float: {
+      float v;
+      std::memcpy(&v, p, 4);
+      return static_cast<uint32_t>(v);
+    }
     }
+    return 0;
+  }
+};
 
-    int AsInt() const { return static_cast<int>(number); }
-    float AsFloat() const { return static_cast<float>(number); }
-    bool Has(const std::string &key) const {
-      return object.find(key) != object.end();
+// =========================================================================
+// glTF Document: tokenized JSON + binary buffer
+// =========================================================================
+// Shared by the text (.gltf + external .bin) and binary (.glb) loaders.
+// The JSON text and the buffer are borrowed and must outlive the document.
+class GLTFDocument {
+public:
+  std::string name;
+
+  bool Parse(std::string_view json, const uint8_t *buffer, size_t bufferSize) {
+    bin = buffer;
+    binSize = bufferSize;
+    if (!doc.Parse(json)) {
+      std::cerr << "[GLTFLoader] " << name << ": malformed JSON at byte "
+                << doc.errorOffset << std::endl;
+      return false;
     }
-    size_t Size() const { return type == Type::Array ? array.size() : 0; }
-  };
 
-  static Value Parse(const std::string &json) {
-    size_t pos = 0;
-    return ParseValue(json, pos);
+    // Index the arrays that are looked up by number so Accessor() is O(1)
+    accessorTokens.clear();
+    for (JsonValue a : Root()["accessors"])
+      accessorTokens.push_back(a.Index());
+    bufferViewTokens.clear();
+    for (JsonValue v : Root()["bufferViews"])
+      bufferViewTokens.push_back(v.Index());
+    return true;
   }
 
-private:
-  static void SkipWhitespace(const std::string &s, size_t &pos) {
-    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\n' ||
-                              s[pos] == '\r' || s[pos] == '\t'))
-      pos++;
+  void SetBuffer(const uint8_t *buffer, size_t bufferSize) {
+    bin = buffer;
+    binSize = bufferSize;
   }
 
-  static Value ParseValue(const std::string &s, size_t &pos) {
-    SkipWhitespace(s, pos);
-    if (pos >= s.size())
+  JsonValue Root() const { return doc.Root(); }
+  const JsonDocument &Json() const { return doc; }
+  const uint8_t *Bin() const { return bin; }
+  size_t BinSize() const { return binSize; }
+
+  // Resolve accessor `index` against buffer 0. Sparse accessors and extra
+  // buffers are not supported and yield an invalid view.
+  AccessorView Accessor(int index) const {
+    AccessorView view;
+    if (index < 0 || size_t(index) >= accessorTokens.size())
+      return view;
+    JsonValue acc(&doc, accessorTokens[index]);
+    int bvIndex = acc["bufferView"].AsInt(-1);
+    if (bvIndex < 0 || size_t(bvIndex) >= bufferViewTokens.size() ||
+        acc.Has("sparse"))
+      return view;
+    JsonValue bv(&doc, bufferViewTokens[bvIndex]);
+    if (bv["buffer"].AsInt() != 0 || !bin)
+      return view;
+
+    // Negative sizes and offsets would wrap once cast, so they go first
+    const int count = acc["count"].AsInt(-1);
+    const int type = acc["componentType"].AsInt(-1);
+    const int stride = bv["byteStride"].AsInt(0);
+    const int accOffset = acc["byteOffset"].AsInt(0);
+    const int viewOffset = bv["byteOffset"].AsInt(0);
+    const int viewLength = bv["byteLength"].AsInt(-1);
+    if (count < 0 || stride < 0 || accOffset < 0 || viewOffset < 0 ||
+        viewLength < 0 || type < 0 || !IsComponentType(uint32_t(type)))
+      return view;
+
+    view.count = static_cast<uint32_t>(count);
+    view.components = ComponentCount(acc["type"].AsString());
+    view.componentType = static_cast<GLTFComponentType>(type);
+    view.normalized = acc["normalized"].AsBool();
+    view.stride = static_cast<uint32_t>(stride);
+    if (view.stride == 0)
+      view.stride = view.ElementSize();
+    if (view.components == 0 || view.stride < view.ElementSize())
       return {};
 
-    char c = s[pos];
-    if (c == '"')
-      return ParseString(s, pos);
-    if (c == '{')
-      return ParseObject(s, pos);
-    if (c == '[')
-      return ParseArray(s, pos);
-    if (c == 't' || c == 'f')
-      return ParseBool(s, pos);
-    if (c == 'n') {
-      pos += 4;
+    // The view lies in the BIN chunk and the elements in the view, without
+    // forming any sum that could overflow
+    if (size_t(viewOffset) > binSize ||
+        size_t(viewLength) > binSize - size_t(viewOffset) ||
+        size_t(accOffset) > size_t(viewLength))
       return {};
-    }
-    return ParseNumber(s, pos);
+    const size_t avail = size_t(viewLength) - size_t(accOffset);
+    if (view.count > 0 &&
+        (view.ElementSize() > avail ||
+         size_t(view.count - 1) > (avail - view.ElementSize()) / view.stride))
+      return {};
+    view.data = bin + size_t(viewOffset) + size_t(accOffset);
+    return view;
   }
 
-  static Value ParseString(const std::string &s, size_t &pos) {
-    Value v;
-    v.type = Type::String;
-    pos++; // skip opening "
-    while (pos < s.size() && s[pos] != '"') {
-      if (s[pos] == '\\') {
-        pos++;
+  // Decode the whole document into the engine's scene structures
+  GLTFScene ToScene() const {
+    GLTFScene scene;
+    scene.name = name;
+    JsonValue root = Root();
+
+    for (JsonValue m : root["meshes"])
+      scene.meshes.push_back(ReadMesh(m));
+
+    for (JsonValue m : root["materials"]) {
+      GLTFMaterial mat;
+      mat.name = m["name"].Unescaped();
+      JsonValue pbr = m["pbrMetallicRoughness"];
+      uint32_t j = 0;
+      for (JsonValue c : pbr["baseColorFactor"]) {
+        if (j < 4)
+          mat.baseColor[j++] = c.AsFloat();
       }
-      v.str += s[pos++];
+      mat.metallic = pbr["metallicFactor"].AsFloat(0.0f);
+      mat.roughness = pbr["roughnessFactor"].AsFloat(0.5f);
+      mat.albedoTexture = pbr["baseColorTexture"]["index"].AsInt(-1);
+      mat.metallicRoughnessTexture =
+          pbr["metallicRoughnessTexture"]["index"].AsInt(-1);
+      mat.normalTexture = m["normalTexture"]["index"].AsInt(-1);
+      mat.occlusionTexture = m["occlusionTexture"]["index"].AsInt(-1);
+      scene.materials.push_back(mat);
+    }
+
+    for (JsonValue t : root["textures"]) {
+      GLTFTexture tex;
+      JsonValue image = root["images"][static_cast<size_t>(t["source"].AsInt())];
+      tex.uri = image["uri"].Unescaped();
+      scene.textures.push_back(tex);
+    }
+
+    for (JsonValue n : root["nodes"]) {
+      GLTFNode node;
+      node.name = n["name"].Unescaped();
+      node.meshIndex = n["mesh"].AsInt(-1);
+      node.skinIndex = n["skin"].AsInt(-1);
+      ReadFloats(n["translation"], node.translation, 3);
+      ReadFloats(n["rotation"], node.rotation, 4);
+      ReadFloats(n["scale"], node.scale, 3);
+      for (JsonValue c : n["children"])
+        node.children.push_back(c.AsInt());
+      scene.nodes.push_back(node);
     }
-    pos++; // skip closing "
-    return v;
-  }
 
-  static Value ParseNumber(const std::string &s, size_t &pos) {
-    Value v;
-    v.type = Type::Number;
-    size_t start = pos;
-    if (pos < s.size() && s[pos] == '-')
-      pos++;
-    while (pos < s.size() &&
-           (std::isdigit(s[pos]) || s[pos] == '.' || s[pos] == 'e' ||
-            s[pos] == 'E' || s[pos] == '+' || s[pos] == '-'))
-      pos++;
-
-    std::string numStr = s.substr(start, pos - start);
-    try {
-      if (!numStr.empty()) {
-        v.number = std::stod(numStr);
-      } else {
-        v.number = 0.0;
+    for (JsonValue s : root["skins"]) {
+      GLTFSkin skin;
+      skin.name = s["name"].Unescaped();
+      for (JsonValue j : s["joints"])
+        skin.jointIndices.push_back(j.AsInt());
+      if (s.Has("inverseBindMatrices")) {
+        auto mats = Accessor(s["inverseBindMatrices"].AsInt())
+                        .As<std::array<float, 16>>();
+        for (uint32_t i = 0; i < mats.Size(); ++i)
+          skin.inverseBindMatrices.push_back(mats[i]);
       }
-    } catch (...) {
-      v.number = 0.0;
+      scene.skins.push_back(std::move(skin));
     }
-    return v;
+
+    for (JsonValue a : root["animations"])
+      scene.animations.push_back(ReadAnimation(a));
+
+    scene.valid = true;
+    return scene;
   }
 
-  static Value ParseBool(const std::string &s, size_t &pos) {
-    Value v;
-    v.type = Type::Bool;
-    if (s[pos] == 't') {
-      v.boolean = true;
-      pos += 4;
-    } else {
-      v.boolean = false;
-      pos += 5;
+private:
+  JsonDocument doc;
+  const uint8_t *bin = nullptr;
+  size_t binSize = 0;
+  std::vector<uint32_t> accessorTokens;   // Accessor index -> token
+  std::vector<uint32_t> bufferViewTokens; // Buffer view index -> token
+
+  static void ReadFloats(JsonValue arr, float *out, uint32_t n) {
+    uint32_t i = 0;
+    for (JsonValue v : arr) {
+      if (i < n)
+        out[i++] = v.AsFloat();
     }
-    return v;
   }
 
-  static Value ParseArray(const std::string &s, size_t &pos) {
-    Value v;
-    v.type = Type::Array;
-    pos++; // skip [
-    SkipWhitespace(s, pos);
-    while (pos < s.size() && s[pos] != ']') {
-      v.array.push_back(ParseValue(s, pos));
-      SkipWhitespace(s, pos);
-      if (pos < s.size() && s[pos] == ',')
-        pos++;
-      SkipWhitespace(s, pos);
+  GLTFMesh ReadMesh(JsonValue m) const {
+    GLTFMesh mesh;
+    mesh.name = m["name"].Unescaped();
+    for (JsonValue p : m["primitives"]) {
+      if (p["mode"].AsInt(4) != 4)
+        continue; // Triangles only
+      JsonValue attr = p["attributes"];
+      AccessorView pos = Accessor(attr["POSITION"].AsInt(-1));
+      if (!pos.Valid())
+        continue;
+
+      GLTFPrimitive prim;
+      prim.materialIndex = p["material"].AsInt(-1);
+      prim.vertices.resize(pos.count);
+
+      // Fast path: float VEC3 positions/normals copy straight through
+      auto positions = pos.As<std::array<float, 3>>();
+      for (uint32_t i = 0; i < pos.count; ++i) {
+        auto v = positions.base ? positions[i]
+                                : std::array<float, 3>{pos.Float(i, 0),
+                                                       pos.Float(i, 1),
+                                                       pos.Float(i, 2)};
+        prim.vertices[i].position = Vec3(v[0], v[1], v[2]);
+      }
+      AccessorView nrm = Accessor(attr["NORMAL"].AsInt(-1));
+      if (nrm.Valid() && nrm.count == pos.count) {
+        for (uint32_t i = 0; i < nrm.count; ++i)
+          prim.vertices[i].normal =
+              Vec3(nrm.Float(i, 0), nrm.Float(i, 1), nrm.Float(i, 2));
+      }
+      ReadAttribute(attr["TEXCOORD_0"], prim, 2,
+                    [](GLTFVertex &v) { return v.uv; });
+      ReadAttribute(attr["TANGENT"], prim, 4,
+                    [](GLTFVertex &v) { return v.tangent; });
+      ReadAttribute(attr["WEIGHTS_0"], prim, 4,
+                    [](GLTFVertex &v) { return v.boneWeights; });
+      AccessorView joints = Accessor(attr["JOINTS_0"].AsInt(-1));
+      if (joints.Valid() && joints.count == pos.count) {
+        for (uint32_t i = 0; i < joints.count; ++i)
+          for (uint32_t c = 0; c < 4 && c < joints.components; ++c)
+            prim.vertices[i].boneIndices[c] =
+                static_cast<uint16_t>(joints.Uint(i, c));
+      }
+
+      AccessorView idx = Accessor(p["indices"].AsInt(-1));
+      if (idx.Valid()) {
+        prim.indices.resize(idx.count);
+        if (idx.componentType == GLTFComponentType::UnsignedInt &&
+            idx.stride == 4) {
+          std::memcpy(prim.indices.data(), idx.data, size_t(idx.count) * 4);
+        } else {
+          for (uint32_t i = 0; i < idx.count; ++i)
+            prim.indices[i] = idx.Uint(i, 0);
+        }
+      }
+      mesh.primitives.push_back(std::move(prim));
     }
-    pos++; // skip ]
-    return v;
+    return mesh;
   }
 
-  static Value ParseObject(const std::string &s, size_t &pos) {
-    Value v;
-    v.type = Type::Object;
-    pos++; // skip {
-    SkipWhitespace(s, pos);
-    while (pos < s.size() && s[pos] != '}') {
-      Value key = ParseString(s, pos);
-      SkipWhitespace(s, pos);
-      pos++; // skip :
-      v.object[key.str] = ParseValue(s, pos);
-      SkipWhitespace(s, pos);
-      if (pos < s.size() && s[pos] == ',')
-        pos++;
-      SkipWhitespace(s, pos);
+  template <typename Field>
+  void ReadAttribute(JsonValue accessor, GLTFPrimitive &prim,
+                     uint32_t maxComponents, Field field) const {
+    AccessorView view = Accessor(accessor.AsInt(-1));
+    if (!view.Valid() || view.count != prim.vertices.size())
+      return;
+    uint32_t n = std::min(view.components, maxComponents);
+    for (uint32_t i = 0; i < view.count; ++i) {
+      float *dst = field(prim.vertices[i]);
+      for (uint32_t c = 0; c < n; ++c)
+        dst[c] = view.Float(i, c);
     }
-    pos++; // skip }
-    return v;
+  }
+
+  GLTFAnimation ReadAnimation(JsonValue a) const {
+    GLTFAnimation anim;
+    anim.name = a["name"].Unescaped();
+    JsonValue samplers = a["samplers"];
+    for (JsonValue c : a["channels"]) {
+      GLTFAnimation::Channel ch;
+      ch.nodeIndex = c["target"]["node"].AsInt(-1);
+      ch.path = c["target"]["path"].Unescaped();
+      JsonValue s = samplers[static_cast<size_t>(c["sampler"].AsInt())];
+      AccessorView in = Accessor(s["input"].AsInt(-1));
+      AccessorView out = Accessor(s["output"].AsInt(-1));
+      if (in.Valid()) {
+        ch.times.resize(in.count);
+        for (uint32_t i = 0; i < in.count; ++i)
+          ch.times[i] = in.Float(i, 0);
+        if (!ch.times.empty())
+          anim.duration = std::max(anim.duration, ch.times.back());
+      }
+      if (out.Valid()) {
+        ch.values.resize(size_t(out.count) * out.components);
+        for (uint32_t i = 0; i < out.count; ++i)
+          for (uint32_t k = 0; k < out.components; ++k)
+            ch.values[size_t(i) * out.components + k] = out.Float(i, k);
+      }
+      anim.channels.push_back(std::move(ch));
+    }
+    return anim;
   }
 };
 
@@ -253,124 +551,36 @@ private:
 
 class GLTFLoader {
 public:
+  // Text glTF: the .gltf is mapped and tokenized in place; buffer 0 may be
+  // an external .bin next to it (data: URIs are not supported). Use
+  // GLBLoader for binary .glb files.
   static GLTFScene Load(const std::string &filepath) {
-    GLTFScene scene;
-    scene.name = filepath;
-
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    MappedFile json;
+    if (!json.Open(filepath)) {
       std::cerr << "[GLTFLoader] Failed to open: " << filepath << std::endl;
-      return scene;
+      return {};
     }
 
-    std::stringstream ss;
-    ss << file.rdbuf();
-    std::string json = ss.str();
-    file.close();
-
-    auto root = MiniJSON::Parse(json);
-    if (root.type != MiniJSON::Type::Object) {
+    GLTFDocument document;
+    document.name = filepath;
+    if (!document.Parse(json.View(), nullptr, 0) ||
+        !document.Root().IsObject()) {
       std::cerr << "[GLTFLoader] Invalid JSON" << std::endl;
-      return scene;
-    }
-
-    // Parse materials
-    if (root.Has("materials")) {
-      for (size_t i = 0; i < root["materials"].Size(); i++) {
-        const auto &m = root["materials"][i];
-        GLTFMaterial mat;
-        mat.name = m["name"].str;
-        if (m.Has("pbrMetallicRoughness")) {
-          const auto &pbr = m["pbrMetallicRoughness"];
-          if (pbr.Has("baseColorFactor")) {
-            for (int j = 0;
-                 j < 4 && j < static_cast<int>(pbr["baseColorFactor"].Size());
-                 j++)
-              mat.baseColor[j] = pbr["baseColorFactor"][j].AsFloat();
-          }
-          mat.metallic = pbr.Has("metallicFactor")
-                             ? pbr["metallicFactor"].AsFloat()
-                             : 0.0f;
-          mat.roughness = pbr.Has("roughnessFactor")
-                              ? pbr["roughnessFactor"].AsFloat()
-                              : 0.5f;
-          if (pbr.Has("baseColorTexture"))
-            mat.albedoTexture = pbr["baseColorTexture"]["index"].AsInt();
-          if (pbr.Has("metallicRoughnessTexture"))
-            mat.metallicRoughnessTexture =
-                pbr["metallicRoughnessTexture"]["index"].AsInt();
-        }
-        if (m.Has("normalTexture"))
-          mat.normalTexture = m["normalTexture"]["index"].AsInt();
-        scene.materials.push_back(mat);
-      }
-    }
-
-    // Parse textures
-    if (root.Has("textures")) {
-      for (size_t i = 0; i < root["textures"].Size(); i++) {
-        GLTFTexture tex;
-        const auto &t = root["textures"][i];
-        if (t.Has("source") && root.Has("images")) {
-          int srcIdx = t["source"].AsInt();
-          if (srcIdx < static_cast<int>(root["images"].Size()))
-            tex.uri = root["images"][srcIdx]["uri"].str;
-        }
-        scene.textures.push_back(tex);
-      }
-    }
-
-    // Parse nodes
-    if (root.Has("nodes")) {
-      for (size_t i = 0; i < root["nodes"].Size(); i++) {
-        const auto &n = root["nodes"][i];
-        GLTFNode node;
-        node.name = n["name"].str;
-        if (n.Has("mesh"))
-          node.meshIndex = n["mesh"].AsInt();
-        if (n.Has("skin"))
-          node.skinIndex = n["skin"].AsInt();
-        if (n.Has("translation")) {
-          for (int j = 0; j < 3; j++)
-            node.translation[j] = n["translation"][j].AsFloat();
-        }
-        if (n.Has("rotation")) {
-          for (int j = 0; j < 4; j++)
-            node.rotation[j] = n["rotation"][j].AsFloat();
-        }
-        if (n.Has("scale")) {
-          for (int j = 0; j < 3; j++)
-            node.scale[j] = n["scale"][j].AsFloat();
-        }
-        if (n.Has("children")) {
-          for (size_t j = 0; j < n["children"].Size(); j++)
-            node.children.push_back(n["children"][j].AsInt());
-        }
-        scene.nodes.push_back(node);
-      }
+      return {};
     }
 
-    // Parse animations
-    if (root.Has("animations")) {
-      for (size_t i = 0; i < root["animations"].Size(); i++) {
-        const auto &a = root["animations"][i];
-        GLTFAnimation anim;
-        anim.name = a["name"].str;
-        // Note: Full accessor/buffer parsing needed for real keyframe data
-        // This parses the channel structure
-        if (a.Has("channels")) {
-          for (size_t j = 0; j < a["channels"].Size(); j++) {
-            GLTFAnimation::Channel ch;
-            ch.nodeIndex = a["channels"][j]["target"]["node"].AsInt();
-            ch.path = a["channels"][j]["target"]["path"].str;
-            anim.channels.push_back(ch);
-          }
-        }
-        scene.animations.push_back(anim);
-      }
+    MappedFile buffer;
+    JsonValue buffer0 = document.Root()["buffers"][size_t(0)];
+    std::string uri = buffer0["uri"].Unescaped();
+    if (!uri.empty() && uri.rfind("data:", 0) != 0) {
+      size_t slash = filepath.find_last_of("/\\");
+      std::string dir =
+          slash == std::string::npos ? "" : filepath.substr(0, slash + 1);
+      if (buffer.Open(dir + uri))
+        document.SetBuffer(buffer.Data(), buffer.Size());
     }
 
-    scene.valid = true;
+    GLTFScene scene = document.ToScene();
     std::cout << "[GLTFLoader] Loaded: " << filepath << std::endl;
     std::cout << "  Materials: " << scene.materials.size()
               << " | Textures: " << scene.textures.size()
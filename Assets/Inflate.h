@@ -0,0 +1,560 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// DEFLATE / zlib Decompression (RFC 1950, RFC 1951)
+// =========================================================================
+// Streaming, table-driven inflate. Input may be split over several spans
+// (PNG splits its zlib stream across IDAT chunks) and output is pulled in
+// caller-sized pieces, so the only working memory is the 32 KB history
+// window plus the Huffman tables.
+//   - Bits are read from a 64-bit buffer refilled 8 bytes at a time, enough
+//     for a whole length/distance pair between refills.
+//   - Huffman codes resolve with one lookup in a 10-bit root table; longer
+//     codes take a second lookup in a per-prefix subtable.
+//   - Matches at distance >= 8 copy 8 bytes per step.
+
+namespace Deflate {
+
+constexpr uint16_t LENGTH_BASE[29] = {3,  4,  5,  6,   7,   8,   9,   10,
+                                      11, 13, 15, 17,  19,  23,  27,  31,
+                                      35, 43, 51, 59,  67,  83,  99,  115,
+                                      131, 163, 195, 227, 258};
+constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                      1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                      4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t DIST_BASE[30] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,
+                                    4, 4, 5, 5, 6, 6, 7,  7,  8,  8,
+                                    9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// Order the code length code lengths are transmitted in
+constexpr uint8_t CLEN_ORDER[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                    11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+constexpr uint32_t WINDOW_SIZE = 32768;
+constexpr uint32_t MAX_MATCH = 258;
+
+inline uint32_t ReverseBits(uint32_t code, uint32_t length) {
+  uint32_t r = 0;
+  for (uint32_t i = 0; i < length; ++i, code >>= 1)
+    r = (r << 1) | (code & 1);
+  return r;
+}
+
+inline uint32_t Adler32(uint32_t adler, const uint8_t *data, size_t size) {
+  uint32_t a = adler & 0xFFFF, b = adler >> 16;
+  while (size > 0) {
+    size_t n = std::min<size_t>(size, 5552); // Largest n without overflow
+    size -= n;
+    for (size_t i = 0; i < n; ++i) {
+      a += data[i];
+      b += a;
+    }
+    data += n;
+    a %= 65521;
+    b %= 65521;
+  }
+  return (b << 16) | a;
+}
+
+} // namespace Deflate
+
+// Canonical Huffman decode table.
+// Entry: bits 0-15 symbol (or subtable offset), bits 16-23 code length
+// (0 = invalid code), bits 24-27 subtable index bits, bit 31 subtable link.
+class HuffmanTable {
+public:
+  static constexpr uint32_t ROOT_BITS = 10;
+  static constexpr uint32_t SUBTABLE = 0x80000000u;
+
+  // Returns false for over-subscribed code lengths
+  bool Build(const uint8_t *lengths, uint32_t count) {
+    uint32_t lengthCount[16] = {};
+    for (uint32_t s = 0; s < count; ++s)
+      ++lengthCount[lengths[s]];
+    lengthCount[0] = 0;
+    int left = 1;
+    for (uint32_t len = 1; len < 16; ++len) {
+      left = (left << 1) - static_cast<int>(lengthCount[len]);
+      if (left < 0)
+        return false;
+    }
+    uint32_t nextCode[16] = {};
+    for (uint32_t len = 1, code = 0; len < 16; ++len) {
+      code = (code + lengthCount[len - 1]) << 1;
+      nextCode[len] = code;
+    }
+
+    // Longest code under each root prefix sizes its subtable
+    uint8_t subBits[1 << ROOT_BITS] = {};
+    codes.resize(count);
+    for (uint32_t s = 0; s < count; ++s) {
+      uint32_t len = lengths[s];
+      if (len == 0)
+        continue;
+      codes[s] = Deflate::ReverseBits(nextCode[len]++, len);
+      if (len > ROOT_BITS) {
+        uint32_t root = codes[s] & ROOT_MASK;
+        subBits[root] =
+            std::max<uint8_t>(subBits[root], uint8_t(len - ROOT_BITS));
+      }
+    }
+    entries.assign(1 << ROOT_BITS, 0);
+    for (uint32_t root = 0; root < (1u << ROOT_BITS); ++root) {
+      if (subBits[root] == 0)
+        continue;
+      uint32_t offset = static_cast<uint32_t>(entries.size());
+      entries[root] = SUBTABLE | (uint32_t(subBits[root]) << 24) | offset;
+      entries.resize(entries.size() + (size_t(1) << subBits[root]), 0);
+    }
+    for (uint32_t s = 0; s < count; ++s) {
+      uint32_t len = lengths[s];
+      if (len == 0)
+        continue;
+      uint32_t entry = (len << 16) | s;
+      if (len <= ROOT_BITS) {
+        for (uint32_t i = codes[s]; i < (1u << ROOT_BITS); i += 1u << len)
+          entries[i] = entry;
+      } else {
+        uint32_t link = entries[codes[s] & ROOT_MASK];
+        uint32_t offset = link & 0xFFFF;
+        uint32_t size = 1u << ((link >> 24) & 0xF);
+        for (uint32_t i = codes[s] >> ROOT_BITS; i < size;
+             i += 1u << (len - ROOT_BITS))
+          entries[offset + i] = entry;
+      }
+    }
+    return true;
+  }
+
+  // `bits` must hold at least 15 valid bits
+  uint32_t Lookup(uint64_t bits) const {
+    uint32_t e = entries[bits & ROOT_MASK];
+    if (e & SUBTABLE) {
+      uint32_t mask = (1u << ((e >> 24) & 0xF)) - 1;
+      e = entries[(e & 0xFFFF) + ((bits >> ROOT_BITS) & mask)];
+    }
+    return e;
+  }
+
+private:
+  static constexpr uint32_t ROOT_MASK = (1u << ROOT_BITS) - 1;
+  std::vector<uint32_t> entries;
+  std::vector<uint32_t> codes;
+};
+
+class Inflater {
+public:
+  Inflater() : window(WINDOW_CAPACITY) {}
+
+  // Starts a new zlib stream (or raw DEFLATE with zlibHeader = false);
+  // add its input spans with AddInput before reading
+  void Reset(bool zlibHeader = true) {
+    spans.clear();
+    spanIndex = 0;
+    spanPos = 0;
+    bitBuf = 0;
+    bitCount = 0;
+    padBytes = 0;
+    writePos = readPos = 0;
+    storedLeft = 0;
+    blockType = NO_BLOCK;
+    finalBlock = false;
+    expectHeader = zlibHeader;
+    expectTrailer = zlibHeader;
+    done = failed = false;
+    adler = 1;
+    trailerAdler = 0;
+    trailerRead = false;
+  }
+
+  // The span must stay valid until the stream is read to the end
+  void AddInput(const uint8_t *data, size_t size) {
+    if (size > 0)
+      spans.push_back({data, size});
+  }
+
+  // Fills up to `size` bytes; returns fewer only at the end of the stream
+  // or on error (check Failed())
+  size_t Read(uint8_t *out, size_t size) {
+    size_t produced = 0;
+    while (produced < size && !failed) {
+      if (readPos < writePos) {
+        size_t n = std::min(size - produced, writePos - readPos);
+        std::memcpy(out + produced, window.data() + readPos, n);
+        if (verifyChecksum)
+          adler = Deflate::Adler32(adler, out + produced, n);
+        readPos += n;
+        produced += n;
+        continue;
+      }
+      if (done)
+        break;
+      if (writePos > WINDOW_CAPACITY - CHUNK_SIZE / 2)
+        Slide();
+      Decode(writePos + (size - produced));
+    }
+    return produced;
+  }
+
+  // Verifies the zlib Adler-32 trailer against everything read
+  void SetVerifyChecksum(bool verify) { verifyChecksum = verify; }
+
+  // True once the final block (and zlib trailer) has been read and every
+  // output byte delivered
+  bool Done() const { return done && readPos == writePos; }
+  bool Failed() const { return failed; }
+
+  // Checks the trailer if verification is on; call after Done()
+  bool ChecksumMatches() const {
+    return !verifyChecksum || (trailerRead && adler == trailerAdler);
+  }
+
+  // One-shot helper for small buffers
+  static bool Zlib(const uint8_t *data, size_t size, std::vector<uint8_t> &out,
+                   bool verify = true) {
+    Inflater inflater;
+    inflater.Reset(true);
+    inflater.SetVerifyChecksum(verify);
+    inflater.AddInput(data, size);
+    out.clear();
+    uint8_t chunk[16384];
+    size_t n;
+    while ((n = inflater.Read(chunk, sizeof(chunk))) > 0)
+      out.insert(out.end(), chunk, chunk + n);
+    return inflater.Done() && !inflater.Failed() &&
+           inflater.ChecksumMatches();
+  }
+
+private:
+  struct Span {
+    const uint8_t *data;
+    size_t size;
+  };
+  enum BlockType : uint8_t { NO_BLOCK, STORED, HUFFMAN };
+
+  // History plus room to decode ahead before sliding
+  static constexpr size_t CHUNK_SIZE = 65536;
+  static constexpr size_t WINDOW_CAPACITY =
+      Deflate::WINDOW_SIZE + CHUNK_SIZE + Deflate::MAX_MATCH + 16;
+
+  std::vector<Span> spans;
+  size_t spanIndex = 0, spanPos = 0;
+  uint64_t bitBuf = 0;
+  uint32_t bitCount = 0;
+  uint32_t padBytes = 0; // Zero bytes fed past the end of the input
+
+  std::vector<uint8_t> window;
+  size_t writePos = 0, readPos = 0;
+  uint32_t storedLeft = 0;
+  BlockType blockType = NO_BLOCK;
+  bool finalBlock = false;
+  bool expectHeader = true, expectTrailer = true;
+  bool trailerRead = false;
+  bool done = false, failed = false;
+  bool verifyChecksum = false;
+  uint32_t adler = 1, trailerAdler = 0;
+  HuffmanTable litLen, dist;
+
+  void Refill() {
+    if (bitCount > 56)
+      return;
+    while (spanIndex < spans.size() && spanPos == spans[spanIndex].size) {
+      ++spanIndex;
+      spanPos = 0;
+    }
+    if (spanIndex < spans.size() && spans[spanIndex].size - spanPos >= 8) {
+      uint64_t v;
+      std::memcpy(&v, spans[spanIndex].data + spanPos, 8); // Little-endian
+      bitBuf |= v << bitCount;
+      spanPos += (63 - bitCount) >> 3;
+      bitCount |= 56;
+      return;
+    }
+    while (bitCount <= 56) { // Span boundary or end of input
+      uint64_t byte = 0;
+      while (spanIndex < spans.size() && spanPos == spans[spanIndex].size) {
+        ++spanIndex;
+        spanPos = 0;
+      }
+      if (spanIndex < spans.size())
+        byte = spans[spanIndex].data[spanPos++];
+      else if (++padBytes > 16) // At least 8 padding bytes consumed
+        failed = true;
+      bitBuf |= byte << bitCount;
+      bitCount += 8;
+    }
+  }
+
+  uint32_t Bits(uint32_t n) { return uint32_t(bitBuf & ((1ull << n) - 1)); }
+  void Consume(uint32_t n) {
+    bitBuf >>= n;
+    bitCount -= n;
+  }
+  uint32_t Take(uint32_t n) {
+    Refill();
+    uint32_t v = Bits(n);
+    Consume(n);
+    return v;
+  }
+
+  // Keeps the last 32 KB of history at the front of the window
+  void Slide() {
+    size_t keep = std::min<size_t>(writePos, Deflate::WINDOW_SIZE);
+    std::memmove(window.data(), window.data() + writePos - keep, keep);
+    readPos -= writePos - keep;
+    writePos = keep;
+  }
+
+  void Fail() {
+    failed = true;
+    done = true;
+  }
+
+  // Decodes until the window holds `target` bytes or the stream ends. A
+  // match started below the cap always fits, overshoot included.
+  void Decode(size_t target) {
+    target = std::min(target, WINDOW_CAPACITY - Deflate::MAX_MATCH - 16);
+    if (expectHeader && !ReadZlibHeader())
+      return;
+    while (writePos < target && !failed) {
+      if (blockType == NO_BLOCK) {
+        if (finalBlock) {
+          Finish();
+          return;
+        }
+        if (!ReadBlockHeader())
+          return;
+        continue;
+      }
+      if (blockType == STORED)
+        CopyStored(target);
+      else
+        DecodeHuffman(target);
+    }
+  }
+
+  bool ReadZlibHeader() {
+    expectHeader = false;
+    uint32_t cmf = Take(8);
+    uint32_t flg = Take(8);
+    if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 ||
+        (flg & 0x20)) { // Preset dictionaries are not used by PNG
+      Fail();
+      return false;
+    }
+    return true;
+  }
+
+  void Finish() {
+    if (expectTrailer) {
+      Consume(bitCount & 7); // Trailer is byte aligned
+      uint32_t v = 0;
+      for (int i = 0; i < 4; ++i)
+        v = (v << 8) | Take(8);
+      trailerAdler = v;
+      trailerRead = true;
+    }
+    done = !failed;
+  }
+
+  bool ReadBlockHeader() {
+    uint32_t header = Take(3);
+    finalBlock = header & 1;
+    switch (header >> 1) {
+    case 0: {
+      Consume(bitCount & 7);
+      uint32_t len = Take(16);
+      uint32_t nlen = Take(16);
+      if ((len ^ 0xFFFF) != nlen) {
+        Fail();
+        return false;
+      }
+      storedLeft = len;
+      blockType = STORED;
+      return true;
+    }
+    case 1:
+      BuildFixedTables();
+      blockType = HUFFMAN;
+      return true;
+    case 2:
+      if (!ReadDynamicTables()) {
+        Fail();
+        return false;
+      }
+      blockType = HUFFMAN;
+      return true;
+    default:
+      Fail();
+      return false;
+    }
+  }
+
+  void BuildFixedTables() {
+    uint8_t lengths[288 + 32];
+    std::fill(lengths, lengths + 144, uint8_t(8));
+    std::fill(lengths + 144, lengths + 256, uint8_t(9));
+    std::fill(lengths + 256, lengths + 280, uint8_t(7));
+    std::fill(lengths + 280, lengths + 288, uint8_t(8));
+    std::fill(lengths + 288, lengths + 320, uint8_t(5));
+    litLen.Build(lengths, 288);
+    dist.Build(lengths + 288, 32);
+  }
+
+  bool ReadDynamicTables() {
+    uint32_t hlit = Take(5) + 257;
+    uint32_t hdist = Take(5) + 1;
+    uint32_t hclen = Take(4) + 4;
+    if (hlit > 286 || hdist > 30)
+      return false;
+    uint8_t clenLengths[19] = {};
+    for (uint32_t i = 0; i < hclen; ++i)
+      clenLengths[Deflate::CLEN_ORDER[i]] = uint8_t(Take(3));
+    HuffmanTable clen;
+    if (!clen.Build(clenLengths, 19))
+      return false;
+
+    uint8_t lengths[286 + 30] = {};
+    uint32_t total = hlit + hdist;
+    for (uint32_t i = 0; i < total;) {
+      Refill();
+      uint32_t e = clen.Lookup(bitBuf);
+      uint32_t len = (e >> 16) & 0xFF;
+      if (len == 0)
+        return false;
+      Consume(len);
+      uint32_t sym = e & 0xFFFF;
+      if (sym < 16) {
+        lengths[i++] = uint8_t(sym);
+        continue;
+      }
+      uint32_t repeat;
+      uint8_t value = 0;
+      if (sym == 16) {
+        if (i == 0)
+          return false;
+        value = lengths[i - 1];
+        repeat = 3 + Take(2);
+      } else if (sym == 17) {
+        repeat = 3 + Take(3);
+      } else {
+        repeat = 11 + Take(7);
+      }
+      if (i + repeat > total)
+        return false;
+      std::fill(lengths + i, lengths + i + repeat, value);
+      i += repeat;
+    }
+    if (lengths[256] == 0) // No end-of-block code
+      return false;
+    return litLen.Build(lengths, hlit) && dist.Build(lengths + hlit, hdist);
+  }
+
+  void CopyStored(size_t target) {
+    // Bytes still in the bit buffer come first
+    while (storedLeft > 0 && bitCount >= 8 && writePos < target) {
+      window[writePos++] = uint8_t(bitBuf);
+      Consume(8);
+      --storedLeft;
+    }
+    if (storedLeft > 0 && writePos < target)
+      bitBuf = 0; // Drop look-ahead bits; the bytes are copied directly
+    while (storedLeft > 0 && writePos < target) {
+      while (spanIndex < spans.size() && spanPos == spans[spanIndex].size) {
+        ++spanIndex;
+        spanPos = 0;
+      }
+      if (spanIndex == spans.size()) {
+        Fail();
+        return;
+      }
+      size_t n = std::min({size_t(storedLeft), target - writePos,
+                           spans[spanIndex].size - spanPos});
+      std::memcpy(window.data() + writePos, spans[spanIndex].data + spanPos,
+                  n);
+      spanPos += n;
+      writePos += n;
+      storedLeft -= uint32_t(n);
+    }
+    if (storedLeft == 0)
+      blockType = NO_BLOCK;
+  }
+
+  void DecodeHuffman(size_t target) {
+    uint8_t *out = window.data();
+    while (writePos < target) {
+      Refill(); // 56 bits: litlen(15) + extra(5) + dist(15) + extra(13)
+      if (failed)
+        return;
+      uint32_t e = litLen.Lookup(bitBuf);
+      uint32_t len = (e >> 16) & 0xFF;
+      if (len == 0) {
+        Fail();
+        return;
+      }
+      Consume(len);
+      uint32_t sym = e & 0xFFFF;
+      if (sym < 256) {
+        out[writePos++] = uint8_t(sym);
+        continue;
+      }
+      if (sym == 256) {
+        blockType = NO_BLOCK;
+        return;
+      }
+      sym -= 257;
+      if (sym >= 29) {
+        Fail();
+        return;
+      }
+      uint32_t length =
+          Deflate::LENGTH_BASE[sym] + Bits(Deflate::LENGTH_EXTRA[sym]);
+      Consume(Deflate::LENGTH_EXTRA[sym]);
+
+      e = dist.Lookup(bitBuf);
+      len = (e >> 16) & 0xFF;
+      sym = e & 0xFFFF;
+      if (len == 0 || sym >= 30) {
+        Fail();
+        return;
+      }
+      Consume(len);
+      uint32_t distance =
+          Deflate::DIST_BASE[sym] + Bits(Deflate::DIST_EXTRA[sym]);
+      Consume(Deflate::DIST_EXTRA[sym]);
+      if (distance > writePos) {
+        Fail();
+        return;
+      }
+      CopyMatch(length, distance);
+    }
+  }
+
+  void CopyMatch(uint32_t n, uint32_t distance) {
+    uint8_t *dst = window.data() + writePos;
+    const uint8_t *src = dst - distance;
+    if (distance >= 8) {
+      for (uint32_t i = 0; i < n; i += 8) // Writes up to 7 bytes past n
+        std::memcpy(dst + i, src + i, 8);
+    } else if (distance == 1) {
+      std::memset(dst, src[0], n);
+    } else {
+      for (uint32_t i = 0; i < n; ++i)
+        dst[i] = src[i];
+    }
+    writePos += n;
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -0,0 +1,659 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef MESOZOIC_SSE
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MESOZOIC_SSE 1
+#else
+#define MESOZOIC_SSE 0
+#endif
+#endif
+#if MESOZOIC_SSE
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// Zero-copy JSON
+// =========================================================================
+// JsonReader is a single-pass SAX parser: it validates the structure and
+// reports keys, strings and numbers as string_views into the source, so
+// nothing is copied or allocated apart from its container stack.
+// JsonDocument builds a DOM on top of it as one flat, pre-order token array
+// (the arena). Each container token records where its subtree ends, which
+// makes skipping a sibling O(1). Numbers are converted with std::from_chars
+// on access. The source must outlive the document.
+
+enum class JsonType : uint8_t { Null, Bool, Number, String, Array, Object };
+
+struct JsonToken {
+  JsonType type = JsonType::Null;
+  bool escaped = false; // String contains backslash escapes
+  uint32_t start = 0;   // Byte offset (strings exclude the quotes)
+  uint32_t length = 0;  // Byte length
+  uint32_t count = 0;   // Array elements / object members
+  uint32_t end = 0;     // Index one past the last token of this subtree
+};
+
+// =========================================================================
+// Scanning primitives (16 bytes at a time with SSE2)
+// =========================================================================
+namespace JsonScan {
+inline bool IsWhitespace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline uint32_t FirstBit(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+inline size_t SkipWhitespace(const char *s, size_t pos, size_t n) {
+  // Most tokens are not preceded by whitespace; only vectorize runs
+  if (pos >= n || !IsWhitespace(s[pos]))
+    return pos;
+#if MESOZOIC_SSE
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i nl = _mm_set1_epi8('\n');
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i tab = _mm_set1_epi8('\t');
+  while (pos + 16 <= n) {
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + pos));
+    __m128i ws = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(c, space), _mm_cmpeq_epi8(c, nl)),
+        _mm_or_si128(_mm_cmpeq_epi8(c, cr), _mm_cmpeq_epi8(c, tab)));
+    uint32_t other = ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+    if (other)
+      return pos + FirstBit(other);
+    pos += 16;
+  }
+#endif
+  while (pos < n && IsWhitespace(s[pos]))
+    ++pos;
+  return pos;
+}
+
+// Next '"' or '\\' at or after pos (n if none)
+inline size_t FindQuoteOrEscape(const char *s, size_t pos, size_t n) {
+#if MESOZOIC_SSE
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i slash = _mm_set1_epi8('\\');
+  while (pos + 16 <= n) {
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + pos));
+    uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(c, quote), _mm_cmpeq_epi8(c, slash))));
+    if (hits)
+      return pos + FirstBit(hits);
+    pos += 16;
+  }
+#endif
+  while (pos < n && s[pos] != '"' && s[pos] != '\\')
+    ++pos;
+  return pos;
+}
+
+inline bool IsNumberChar(char c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+         c == 'e' || c == 'E';
+}
+
+// JSON number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+inline bool IsNumber(std::string_view s) {
+  size_t i = 0;
+  auto digits = [&] {
+    size_t start = i;
+    while (i < s.size() && s[i] >= '0' && s[i] <= '9')
+      ++i;
+    return i > start;
+  };
+  if (i < s.size() && s[i] == '-')
+    ++i;
+  if (i < s.size() && s[i] == '0')
+    ++i;
+  else if (!digits())
+    return false;
+  if (i < s.size() && s[i] == '.') {
+    ++i;
+    if (!digits())
+      return false;
+  }
+  if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+    ++i;
+    if (i < s.size() && (s[i] == '+' || s[i] == '-'))
+      ++i;
+    if (!digits())
+      return false;
+  }
+  return i == s.size();
+}
+
+inline int HexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+inline void AppendUtf8(std::string &out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+inline int32_t ReadHex4(std::string_view raw, size_t at) {
+  if (at + 4 > raw.size())
+    return -1;
+  int32_t v = 0;
+  for (size_t k = 0; k < 4; ++k) {
+    int h = HexValue(raw[at + k]);
+    if (h < 0)
+      return -1;
+    v = (v << 4) | h;
+  }
+  return v;
+}
+
+// Decode the escapes of a raw string body (as passed to the handlers)
+inline std::string Unescape(std::string_view raw) {
+  std::string out;
+  out.reserve(raw.size());
+  for (size_t i = 0; i < raw.size(); ++i) {
+    char c = raw[i];
+    if (c != '\\' || i + 1 >= raw.size()) {
+      out += c;
+      continue;
+    }
+    char e = raw[++i];
+    switch (e) {
+    case 'b':
+      out += '\b';
+      break;
+    case 'f':
+      out += '\f';
+      break;
+    case 'n':
+      out += '\n';
+      break;
+    case 'r':
+      out += '\r';
+      break;
+    case 't':
+      out += '\t';
+      break;
+    case 'u': {
+      int32_t cp = ReadHex4(raw, i + 1);
+      if (cp < 0) {
+        out += 'u';
+        break;
+      }
+      i += 4;
+      // Surrogate pair
+      if (cp >= 0xD800 && cp < 0xDC00 && i + 2 < raw.size() &&
+          raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+        int32_t lo = ReadHex4(raw, i + 3);
+        if (lo >= 0xDC00 && lo < 0xE000) {
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+          i += 6;
+        }
+      }
+      AppendUtf8(out, static_cast<uint32_t>(cp));
+      break;
+    }
+    default: // \" \\ \/
+      out += e;
+      break;
+    }
+  }
+  return out;
+}
+
+inline bool ToDouble(std::string_view s, double &out) {
+  auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+  return res.ec == std::errc() && res.ptr == s.data() + s.size();
+}
+} // namespace JsonScan
+
+// =========================================================================
+// SAX reader
+// =========================================================================
+// Handler callbacks return false to stop early (Read then returns false
+// with errorOffset at the current position). Derive from JsonSaxHandler to
+// inherit no-op defaults. Scalars arrive as their raw source text; use
+// JsonScan::ToDouble / JsonScan::Unescape when a value is needed.
+struct JsonSaxHandler {
+  bool StartObject(std::string_view) { return true; } // View of '{'
+  bool EndObject(std::string_view, uint32_t) { return true; }
+  bool StartArray(std::string_view) { return true; }
+  bool EndArray(std::string_view, uint32_t) { return true; }
+  bool Key(std::string_view, bool) { return true; }    // (raw, escaped)
+  bool String(std::string_view, bool) { return true; } // (raw, escaped)
+  bool Number(std::string_view) { return true; }
+  bool Bool(std::string_view, bool) { return true; }
+  bool Null(std::string_view) { return true; }
+};
+
+class JsonReader {
+public:
+  size_t errorOffset = 0;
+
+  template <typename Handler> bool Read(std::string_view text, Handler &h) {
+    using namespace JsonScan;
+    const char *s = text.data();
+    const size_t n = text.size();
+    stack.clear();
+    errorOffset = 0;
+    bool haveRoot = false;
+
+    size_t pos = 0;
+    while (true) {
+      pos = SkipWhitespace(s, pos, n);
+      if (pos >= n)
+        break;
+      char c = s[pos];
+      switch (c) {
+      case '{':
+      case '[': {
+        if (!BeginValue(haveRoot))
+          return Fail(pos);
+        bool object = c == '{';
+        stack.push_back({0, object, Expect::First});
+        bool ok = object ? h.StartObject(text.substr(pos, 1))
+                         : h.StartArray(text.substr(pos, 1));
+        if (!ok)
+          return Fail(pos);
+        ++pos;
+        break;
+      }
+      case '}':
+      case ']': {
+        bool object = c == '}';
+        // Only right after the opener or after a complete item: rejects
+        // [1,] {"a":} and {"a":1,}
+        if (stack.empty() || stack.back().object != object ||
+            (stack.back().expect != Expect::First &&
+             stack.back().expect != Expect::Separator))
+          return Fail(pos);
+        uint32_t count = stack.back().count;
+        stack.pop_back();
+        bool ok = object ? h.EndObject(text.substr(pos, 1), count)
+                         : h.EndArray(text.substr(pos, 1), count);
+        if (!ok)
+          return Fail(pos);
+        ++pos;
+        break;
+      }
+      case ',':
+        if (stack.empty() || stack.back().expect != Expect::Separator)
+          return Fail(pos); // [,1] [1,,2] {,"a":1}
+        stack.back().expect = Expect::Item;
+        ++pos;
+        break;
+      case '"': {
+        size_t body = pos + 1;
+        size_t q = body;
+        bool escaped = false;
+        while (true) {
+          q = FindQuoteOrEscape(s, q, n);
+          if (q >= n)
+            return Fail(pos);
+          if (s[q] == '"')
+            break;
+          escaped = true;
+          q += 2; // Skip the escaped character
+        }
+        std::string_view raw = text.substr(body, q - body);
+        // Where an object wants a member, the string is its key and must
+        // be followed by ':'
+        if (!stack.empty() && stack.back().object &&
+            (stack.back().expect == Expect::First ||
+             stack.back().expect == Expect::Item)) {
+          size_t after = SkipWhitespace(s, q + 1, n);
+          if (after >= n || s[after] != ':')
+            return Fail(after);
+          ++stack.back().count;
+          stack.back().expect = Expect::Value;
+          if (!h.Key(raw, escaped))
+            return Fail(pos);
+          pos = after + 1;
+        } else {
+          if (!BeginValue(haveRoot) || !h.String(raw, escaped))
+            return Fail(pos);
+          pos = q + 1;
+        }
+        break;
+      }
+      case 't':
+      case 'f':
+      case 'n': {
+        std::string_view word = c == 't' ? "true" : c == 'f' ? "false" : "null";
+        std::string_view raw = text.substr(pos, word.size());
+        if (raw != word || !BeginValue(haveRoot))
+          return Fail(pos);
+        bool ok = c == 'n' ? h.Null(raw) : h.Bool(raw, c == 't');
+        if (!ok)
+          return Fail(pos);
+        pos += word.size();
+        break;
+      }
+      default: {
+        size_t start = pos;
+        while (pos < n && IsNumberChar(s[pos]))
+          ++pos;
+        std::string_view number = text.substr(start, pos - start);
+        if (!IsNumber(number) || !BeginValue(haveRoot) || !h.Number(number))
+          return Fail(start);
+        break;
+      }
+      }
+    }
+    if (!stack.empty() || !haveRoot)
+      return Fail(n);
+    return true;
+  }
+
+private:
+  // What may come next inside a container. An item is an array value or
+  // an object key; objects then want the member value after the ':'.
+  enum class Expect : uint8_t {
+    First,     // Just opened: an item or the closer
+    Item,      // After ','
+    Value,     // After "key":
+    Separator, // After an item: ',' or the closer
+  };
+
+  struct OpenContainer {
+    uint32_t count;
+    bool object;
+    Expect expect;
+  };
+  std::vector<OpenContainer> stack;
+
+  bool Fail(size_t pos) {
+    errorOffset = pos;
+    return false;
+  }
+
+  // Account for a value in the enclosing container
+  bool BeginValue(bool &haveRoot) {
+    if (stack.empty()) {
+      if (haveRoot)
+        return false; // Only one root value
+      haveRoot = true;
+      return true;
+    }
+    OpenContainer &top = stack.back();
+    if (top.object ? top.expect != Expect::Value
+                   : top.expect == Expect::Separator)
+      return false; // Missing key, or missing ',' between items
+    if (!top.object)
+      ++top.count;
+    top.expect = Expect::Separator;
+    return true;
+  }
+};
+
+// =========================================================================
+// DOM
+// =========================================================================
+class JsonDocument;
+
+// Lightweight handle to a token; invalid handles behave like null
+class JsonValue {
+public:
+  static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+  JsonValue() = default;
+  JsonValue(const JsonDocument *doc, uint32_t index) : doc(doc), index(index) {}
+
+  bool Valid() const { return doc && index != INVALID; }
+  JsonType Type() const;
+  bool IsNull() const { return Type() == JsonType::Null; }
+  bool IsObject() const { return Type() == JsonType::Object; }
+  bool IsArray() const { return Type() == JsonType::Array; }
+
+  // Object member lookup (linear in the member count)
+  JsonValue operator[](std::string_view key) const;
+  // Array element (O(i); prefer range-for when iterating)
+  JsonValue operator[](size_t i) const;
+  bool Has(std::string_view key) const { return (*this)[key].Valid(); }
+  size_t Size() const;
+
+  double AsDouble(double fallback = 0.0) const;
+  float AsFloat(float fallback = 0.0f) const {
+    return static_cast<float>(AsDouble(fallback));
+  }
+  int AsInt(int fallback = 0) const;
+  bool AsBool(bool fallback = false) const;
+  std::string_view AsString() const; // Raw (escapes are not decoded)
+  std::string Unescaped() const;     // Decoded copy
+
+  // Range-for over array elements or object values
+  class Iterator {
+  public:
+    Iterator(const JsonDocument *doc, uint32_t index, uint32_t step)
+        : doc(doc), index(index), keyStep(step) {}
+    JsonValue operator*() const { return {doc, index + keyStep}; }
+    Iterator &operator++();
+    bool operator!=(const Iterator &o) const { return index != o.index; }
+
+  private:
+    const JsonDocument *doc;
+    uint32_t index;   // Token of the element (or of the member key)
+    uint32_t keyStep; // 1 inside objects: skip the key token
+  };
+  Iterator begin() const;
+  Iterator end() const;
+
+  uint32_t Index() const { return index; }
+
+private:
+  const JsonDocument *doc = nullptr;
+  uint32_t index = INVALID;
+};
+
+class JsonDocument {
+public:
+  std::string_view text;
+  std::vector<JsonToken> tokens;
+  size_t errorOffset = 0;
+
+  // Returns false on malformed input; errorOffset points at the problem
+  bool Parse(std::string_view source) {
+    text = source;
+    tokens.clear();
+    tokens.reserve(source.size() / 8 + 1);
+    Builder builder;
+    builder.doc = this;
+    if (!reader.Read(source, builder)) {
+      errorOffset = reader.errorOffset;
+      tokens.clear();
+      return false;
+    }
+    errorOffset = 0;
+    return true;
+  }
+
+  JsonValue Root() const {
+    return {this, tokens.empty() ? JsonValue::INVALID : 0u};
+  }
+
+  std::string_view Slice(const JsonToken &t) const {
+    return text.substr(t.start, t.length);
+  }
+
+private:
+  JsonReader reader;
+
+  // SAX handler that appends tokens; containers are patched on close
+  struct Builder : JsonSaxHandler {
+    JsonDocument *doc = nullptr;
+    std::vector<uint32_t> open;
+
+    uint32_t Offset(std::string_view v) const {
+      return static_cast<uint32_t>(v.data() - doc->text.data());
+    }
+    bool Scalar(JsonType type, std::string_view raw, bool escaped = false) {
+      uint32_t idx = static_cast<uint32_t>(doc->tokens.size());
+      doc->tokens.push_back({type, escaped, Offset(raw),
+                             static_cast<uint32_t>(raw.size()), 0, idx + 1});
+      return true;
+    }
+    bool Start(JsonType type, std::string_view at) {
+      open.push_back(static_cast<uint32_t>(doc->tokens.size()));
+      doc->tokens.push_back({type, false, Offset(at), 0, 0, 0});
+      return true;
+    }
+    bool End(std::string_view at, uint32_t count) {
+      JsonToken &t = doc->tokens[open.back()];
+      open.pop_back();
+      t.count = count;
+      t.end = static_cast<uint32_t>(doc->tokens.size());
+      t.length = Offset(at) + 1 - t.start;
+      return true;
+    }
+
+    bool StartObject(std::string_view at) {
+      return Start(JsonType::Object, at);
+    }
+    bool EndObject(std::string_view at, uint32_t n) { return End(at, n); }
+    bool StartArray(std::string_view at) { return Start(JsonType::Array, at); }
+    bool EndArray(std::string_view at, uint32_t n) { return End(at, n); }
+    bool Key(std::string_view raw, bool esc) {
+      return Scalar(JsonType::String, raw, esc);
+    }
+    bool String(std::string_view raw, bool esc) {
+      return Scalar(JsonType::String, raw, esc);
+    }
+    bool Number(std::string_view raw) { return Scalar(JsonType::Number, raw); }
+    bool Bool(std::string_view raw, bool) {
+      return Scalar(JsonType::Bool, raw);
+    }
+    bool Null(std::string_view raw) { return Scalar(JsonType::Null, raw); }
+  };
+};
+
+// =========================================================================
+// JsonValue implementation
+// =========================================================================
+inline JsonType JsonValue::Type() const {
+  return Valid() ? doc->tokens[index].type : JsonType::Null;
+}
+
+inline JsonValue JsonValue::operator[](std::string_view key) const {
+  if (Type() != JsonType::Object)
+    return {};
+  const auto &tokens = doc->tokens;
+  uint32_t i = index + 1;
+  for (uint32_t m = 0; m < tokens[index].count; ++m) {
+    if (doc->Slice(tokens[i]) == key)
+      return {doc, i + 1};
+    i = tokens[i + 1].end; // Skip key and value subtree
+  }
+  return {};
+}
+
+inline JsonValue JsonValue::operator[](size_t element) const {
+  if (Type() != JsonType::Array || element >= doc->tokens[index].count)
+    return {};
+  uint32_t i = index + 1;
+  for (size_t e = 0; e < element; ++e)
+    i = doc->tokens[i].end;
+  return {doc, i};
+}
+
+inline size_t JsonValue::Size() const {
+  JsonType t = Type();
+  return (t == JsonType::Array || t == JsonType::Object)
+             ? doc->tokens[index].count
+             : 0;
+}
+
+inline double JsonValue::AsDouble(double fallback) const {
+  if (Type() != JsonType::Number)
+    return fallback;
+  double v;
+  return JsonScan::ToDouble(doc->Slice(doc->tokens[index]), v) ? v : fallback;
+}
+
+inline int JsonValue::AsInt(int fallback) const {
+  if (Type() != JsonType::Number)
+    return fallback;
+  std::string_view s = doc->Slice(doc->tokens[index]);
+  int v = fallback;
+  auto res = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (res.ec == std::errc() && res.ptr == s.data() + s.size())
+    return v;
+  return static_cast<int>(AsDouble(fallback)); // "1.0", "1e3"
+}
+
+inline bool JsonValue::AsBool(bool fallback) const {
+  if (Type() != JsonType::Bool)
+    return fallback;
+  return doc->text[doc->tokens[index].start] == 't';
+}
+
+inline std::string_view JsonValue::AsString() const {
+  if (Type() != JsonType::String)
+    return {};
+  return doc->Slice(doc->tokens[index]);
+}
+
+inline std::string JsonValue::Unescaped() const {
+  if (Type() != JsonType::String)
+    return {};
+  const JsonToken &t = doc->tokens[index];
+  return t.escaped ? JsonScan::Unescape(doc->Slice(t))
+                   : std::string(doc->Slice(t));
+}
+
+inline JsonValue::Iterator &JsonValue::Iterator::operator++() {
+  index = doc->tokens[index + keyStep].end;
+  return *this;
+}
+
+inline JsonValue::Iterator JsonValue::begin() const {
+  JsonType t = Type();
+  if (t != JsonType::Array && t != JsonType::Object)
+    return end();
+  return {doc, index + 1, t == JsonType::Object ? 1u : 0u};
+}
+
+inline JsonValue::Iterator JsonValue::end() const {
+  JsonType t = Type();
+  if (t != JsonType::Array && t != JsonType::Object)
+    return {doc, 0, 0};
+  return {doc, doc->tokens[index].end, 0};
+}
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -0,0 +1,144 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// Read-only memory-mapped file
+// =========================================================================
+// The OS pages the file in on demand, so loaders can hand out pointers into
+// the mapping instead of copying it into a std::string first.
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      Close();
+      std::swap(data, other.data);
+      std::swap(size, other.size);
+#ifdef _WIN32
+      std::swap(file, other.file);
+      std::swap(mapping, other.mapping);
+#endif
+    }
+    return *this;
+  }
+
+  bool Open(const std::string &path) {
+    Close();
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      file = nullptr;
+      std::cerr << "[MappedFile] Failed to open: " << path << std::endl;
+      return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+      Close();
+      return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0)
+      return true;
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+      Close();
+      return false;
+    }
+    data = static_cast<const uint8_t *>(
+        MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      std::cerr << "[MappedFile] Failed to open: " << path << std::endl;
+      return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+      ::close(fd);
+      return true;
+    }
+    void *ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference
+    if (ptr == MAP_FAILED) {
+      size = 0;
+      return false;
+    }
+    data = static_cast<const uint8_t *>(ptr);
+#endif
+    if (!data) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() {
+#ifdef _WIN32
+    if (data)
+      UnmapViewOfFile(data);
+    if (mapping)
+      CloseHandle(mapping);
+    if (file)
+      CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (data)
+      ::munmap(const_cast<uint8_t *>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+  }
+
+  const uint8_t *Data() const { return data; }
+  size_t Size() const { return size; }
+  bool IsOpen() const { return data != nullptr; }
+  std::string_view View() const {
+    return {reinterpret_cast<const char *>(data), size};
+  }
+
+private:
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  HANDLE file = nullptr;
+  HANDLE mapping = nullptr;
+#endif
+};
+
+} // namespace Assets
+} // namespace Mesozoic
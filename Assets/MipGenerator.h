@@ -0,0 +1,376 @@
+#pragma once
+#include "../Core/Threading/JobSystem.h"
+#include "TextureData.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <vector>
+
+#ifndef MESOZOIC_SSE
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MESOZOIC_SSE 1
+#else
+#define MESOZOIC_SSE 0
+#endif
+#endif
+#if MESOZOIC_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// Mip Chain Generation
+// =========================================================================
+// Level 1 is filtered from level 0 decoded row by row into linear float4
+// texels; every later level is filtered from the previous float level (no
+// requantization drift) and then written back as 8-bit. Color data is
+// filtered in linear space and re-encoded as sRGB; normal maps are filtered
+// as vectors and renormalized.
+// Rows are split into tiles that run on JobSystem workers when provided.
+
+enum class MipFilter : uint8_t {
+  Box,   // 2x2 average; fast, slightly blurry
+  Kaiser // Kaiser-windowed sinc; sharper, may ring on hard edges
+};
+
+struct MipSettings {
+  MipFilter filter = MipFilter::Box;
+  bool srgb = true;       // RGB is sRGB-encoded color (alpha is linear)
+  bool normalMap = false; // RGB is a [0,1]-packed unit vector
+  uint32_t maxLevels = 0; // 0 = full chain down to 1x1
+  float kaiserAlpha = 4.0f;
+  float kaiserRadius = 3.0f; // In destination texels
+  // Must not be the pool the caller itself runs on (tiles are awaited)
+  Core::Threading::JobSystem *jobs = nullptr;
+  uint32_t rowsPerTile = 32;
+};
+
+namespace MipFilters {
+
+// Exact sRGB transfer functions
+inline float SrgbToLinear(float c) {
+  return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+inline float LinearToSrgb(float c) {
+  return c <= 0.0031308f ? c * 12.92f
+                         : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+// 8-bit sRGB -> linear
+inline const std::array<float, 256> &DecodeTable() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> t{};
+    for (int i = 0; i < 256; ++i)
+      t[i] = SrgbToLinear(i / 255.0f);
+    return t;
+  }();
+  return table;
+}
+
+// Linear (16-bit fixed point) -> 8-bit sRGB. 64 KB, fine enough that the
+// darkest sRGB steps (~20 entries apart) round correctly.
+inline const std::vector<uint8_t> &EncodeTable() {
+  static const std::vector<uint8_t> table = [] {
+    std::vector<uint8_t> t(65536);
+    for (int i = 0; i < 65536; ++i) {
+      t[i] = static_cast<uint8_t>(
+          std::lround(LinearToSrgb(i / 65535.0f) * 255.0f));
+    }
+    return t;
+  }();
+  return table;
+}
+
+inline double BesselI0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if (term < 1e-12 * sum)
+      break;
+  }
+  return sum;
+}
+
+inline float Kaiser(float x, float radius, float alpha) {
+  float t = x / radius;
+  if (t <= -1.0f || t >= 1.0f)
+    return 0.0f;
+  return static_cast<float>(BesselI0(alpha * std::sqrt(1.0 - t * t)) /
+                            BesselI0(alpha));
+}
+
+inline float Sinc(float x) {
+  if (std::abs(x) < 1e-6f)
+    return 1.0f;
+  float px = 3.14159265f * x;
+  return std::sin(px) / px;
+}
+
+// Normalized taps for one destination texel along one axis
+struct Taps {
+  int first = 0;
+  std::vector<float> weights;
+};
+
+inline std::vector<Taps> KaiserTaps(uint32_t src, uint32_t dst, float radius,
+                                    float alpha) {
+  std::vector<Taps> taps(dst);
+  float scale = static_cast<float>(src) / dst;
+  float support = radius * scale;
+  for (uint32_t d = 0; d < dst; ++d) {
+    float center = (d + 0.5f) * scale;
+    int lo = static_cast<int>(std::floor(center - support));
+    int hi = static_cast<int>(std::ceil(center + support));
+    Taps &t = taps[d];
+    t.first = lo;
+    float total = 0.0f;
+    for (int s = lo; s <= hi; ++s) {
+      float x = (s + 0.5f - center) / scale;
+      float w = Sinc(x) * Kaiser(x, radius, alpha);
+      t.weights.push_back(w);
+      total += w;
+    }
+    for (float &w : t.weights)
+      w /= total;
+  }
+  return taps;
+}
+
+// acc += w * px for one float4 texel
+inline void MulAdd4(float *acc, const float *px, float w) {
+#if MESOZOIC_SSE
+  _mm_storeu_ps(acc, _mm_add_ps(_mm_loadu_ps(acc),
+                                _mm_mul_ps(_mm_loadu_ps(px), _mm_set1_ps(w))));
+#else
+  for (int c = 0; c < 4; ++c)
+    acc[c] += px[c] * w;
+#endif
+}
+
+} // namespace MipFilters
+
+class MipGenerator {
+public:
+  // Replaces tex.pixels with the full chain and fills tex.mips. Only RGBA8
+  // is supported; other formats are left untouched.
+  static bool Generate(TextureData &tex, const MipSettings &settings = {}) {
+    if (!tex.valid || tex.format != PixelFormat::RGBA8 || tex.channels != 4 ||
+        tex.pixels.size() < size_t(tex.width) * tex.height * 4) {
+      std::cerr << "[MipGenerator] Unsupported texture: " << tex.name
+                << std::endl;
+      return false;
+    }
+
+    uint32_t levels = TextureData::FullMipCount(tex.width, tex.height);
+    if (settings.maxLevels > 0)
+      levels = std::min(levels, settings.maxLevels);
+    tex.pixels.resize(tex.BuildMipLayout(levels));
+
+    std::vector<float> cur, next, tmp;
+    for (uint32_t level = 1; level < levels; ++level) {
+      const TextureMip &dst = tex.mips[level];
+      SourceLevel src{level == 1 ? tex.pixels.data() : nullptr,
+                      level == 1 ? nullptr : cur.data(),
+                      tex.mips[level - 1].width, tex.mips[level - 1].height};
+      next.assign(size_t(dst.width) * dst.height * 4, 0.0f);
+      if (settings.filter == MipFilter::Kaiser)
+        KaiserLevel(src, next, dst, tmp, settings);
+      else
+        BoxLevel(src, next, dst, settings);
+
+      uint8_t *out = tex.pixels.data() + dst.offset;
+      ForRows(settings, dst.height, [&](uint32_t y0, uint32_t y1) {
+        Quantize(next.data(), out, dst.width, y0, y1, settings);
+      });
+      cur.swap(next);
+    }
+    return true;
+  }
+
+private:
+  // The level being filtered: level 0 stays 8-bit and is decoded a row at a
+  // time (no full-resolution float copy), later levels are already float
+  struct SourceLevel {
+    const uint8_t *bytes;
+    const float *texels;
+    uint32_t width;
+    uint32_t height;
+
+    const float *Row(uint32_t y, std::vector<float> &scratch,
+                     const MipSettings &s) const {
+      if (texels)
+        return texels + size_t(y) * width * 4;
+      scratch.resize(size_t(width) * 4);
+      Expand(bytes + size_t(y) * width * 4, scratch.data(), width, s);
+      return scratch.data();
+    }
+  };
+
+  // Runs fn(y0, y1) over row tiles, on the workers if there are any
+  template <typename Fn>
+  static void ForRows(const MipSettings &s, uint32_t rows, Fn &&fn) {
+    uint32_t tile = std::max(1u, s.rowsPerTile);
+    if (!s.jobs || rows <= tile) {
+      fn(0u, rows);
+      return;
+    }
+    std::vector<std::future<void>> pending;
+    for (uint32_t y = 0; y < rows; y += tile) {
+      uint32_t end = std::min(rows, y + tile);
+      pending.push_back(s.jobs->PushJob([&fn, y, end] { fn(y, end); }));
+    }
+    for (auto &f : pending)
+      f.get();
+  }
+
+  static void Expand(const uint8_t *src, float *dst, uint32_t count,
+                     const MipSettings &s) {
+    const auto &decode = MipFilters::DecodeTable();
+    const float inv255 = 1.0f / 255.0f;
+    size_t n = size_t(count) * 4;
+    if (s.normalMap) {
+      for (size_t i = 0; i < n; i += 4) {
+        for (int c = 0; c < 3; ++c)
+          dst[i + c] = src[i + c] * (2.0f * inv255) - 1.0f;
+        dst[i + 3] = src[i + 3] * inv255;
+      }
+    } else if (s.srgb) {
+      for (size_t i = 0; i < n; i += 4) {
+        for (int c = 0; c < 3; ++c)
+          dst[i + c] = decode[src[i + c]];
+        dst[i + 3] = src[i + 3] * inv255;
+      }
+    } else {
+      for (size_t i = 0; i < n; ++i)
+        dst[i] = src[i] * inv255;
+    }
+  }
+
+  static void Quantize(const float *src, uint8_t *dst, uint32_t width,
+                       uint32_t y0, uint32_t y1, const MipSettings &s) {
+    const auto &encode = MipFilters::EncodeTable();
+    bool srgb = s.srgb && !s.normalMap;
+    auto unorm = [](float v) {
+      return static_cast<uint8_t>(
+          std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+    };
+    for (size_t i = size_t(y0) * width * 4; i < size_t(y1) * width * 4;
+         i += 4) {
+      float r = src[i], g = src[i + 1], b = src[i + 2];
+      if (s.normalMap) {
+        float len = std::sqrt(r * r + g * g + b * b);
+        float inv = len > 1e-8f ? 1.0f / len : 0.0f;
+        r = r * inv * 0.5f + 0.5f;
+        g = g * inv * 0.5f + 0.5f;
+        b = len > 1e-8f ? b * inv * 0.5f + 0.5f : 1.0f;
+      }
+      if (srgb) {
+        auto lin = [&](float v) {
+          return encode[std::lround(std::clamp(v, 0.0f, 1.0f) * 65535.0f)];
+        };
+        dst[i] = lin(r);
+        dst[i + 1] = lin(g);
+        dst[i + 2] = lin(b);
+      } else {
+        dst[i] = unorm(r);
+        dst[i + 1] = unorm(g);
+        dst[i + 2] = unorm(b);
+      }
+      dst[i + 3] = unorm(src[i + 3]);
+    }
+  }
+
+  static void BoxLevel(const SourceLevel &src, std::vector<float> &next,
+                       const TextureMip &dst, const MipSettings &s) {
+    ForRows(s, dst.height, [&](uint32_t y0, uint32_t y1) {
+      std::vector<float> scratch0, scratch1;
+      for (uint32_t y = y0; y < y1; ++y) {
+        uint32_t sy0 = std::min(2 * y, src.height - 1);
+        uint32_t sy1 = std::min(2 * y + 1, src.height - 1);
+        const float *r0 = src.Row(sy0, scratch0, s);
+        const float *r1 = src.Row(sy1, scratch1, s);
+        float *out = &next[size_t(y) * dst.width * 4];
+        for (uint32_t x = 0; x < dst.width; ++x) {
+          size_t a = size_t(std::min(2 * x, src.width - 1)) * 4;
+          size_t b = size_t(std::min(2 * x + 1, src.width - 1)) * 4;
+#if MESOZOIC_SSE
+          __m128 sum = _mm_add_ps(
+              _mm_add_ps(_mm_loadu_ps(r0 + a), _mm_loadu_ps(r0 + b)),
+              _mm_add_ps(_mm_loadu_ps(r1 + a), _mm_loadu_ps(r1 + b)));
+          _mm_storeu_ps(out + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+          for (int c = 0; c < 4; ++c) {
+            out[x * 4 + c] =
+                0.25f * (r0[a + c] + r0[b + c] + r1[a + c] + r1[b + c]);
+          }
+#endif
+        }
+      }
+    });
+  }
+
+  // Separable: horizontal into tmp (dst.width x src.height), then vertical
+  static void KaiserLevel(const SourceLevel &src, std::vector<float> &next,
+                          const TextureMip &dst, std::vector<float> &tmp,
+                          const MipSettings &s) {
+    using namespace MipFilters;
+    std::vector<Taps> tx =
+        KaiserTaps(src.width, dst.width, s.kaiserRadius, s.kaiserAlpha);
+    std::vector<Taps> ty =
+        KaiserTaps(src.height, dst.height, s.kaiserRadius, s.kaiserAlpha);
+    int maxX = static_cast<int>(src.width) - 1;
+    int maxY = static_cast<int>(src.height) - 1;
+
+    tmp.assign(size_t(dst.width) * src.height * 4, 0.0f);
+    ForRows(s, src.height, [&](uint32_t y0, uint32_t y1) {
+      std::vector<float> scratch;
+      for (uint32_t y = y0; y < y1; ++y) {
+        const float *row = src.Row(y, scratch, s);
+        float *out = &tmp[size_t(y) * dst.width * 4];
+        for (uint32_t x = 0; x < dst.width; ++x) {
+          const Taps &t = tx[x];
+          size_t taps = t.weights.size();
+          bool interior = t.first >= 0 && t.first + int(taps) - 1 <= maxX;
+#if MESOZOIC_SSE
+          __m128 acc = _mm_setzero_ps();
+          for (size_t k = 0; k < taps; ++k) {
+            int sx = interior ? t.first + int(k)
+                              : std::clamp(t.first + int(k), 0, maxX);
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(row + size_t(sx) * 4),
+                                             _mm_set1_ps(t.weights[k])));
+          }
+          _mm_storeu_ps(out + x * 4, acc);
+#else
+          for (size_t k = 0; k < taps; ++k) {
+            int sx = interior ? t.first + int(k)
+                              : std::clamp(t.first + int(k), 0, maxX);
+            MulAdd4(out + x * 4, row + size_t(sx) * 4, t.weights[k]);
+          }
+#endif
+        }
+      }
+    });
+
+    ForRows(s, dst.height, [&](uint32_t y0, uint32_t y1) {
+      for (uint32_t y = y0; y < y1; ++y) {
+        const Taps &t = ty[y];
+        float *out = &next[size_t(y) * dst.width * 4];
+        for (size_t k = 0; k < t.weights.size(); ++k) {
+          int sy = std::clamp(t.first + static_cast<int>(k), 0, maxY);
+          const float *row = &tmp[size_t(sy) * dst.width * 4];
+          for (uint32_t x = 0; x < dst.width; ++x)
+            MulAdd4(out + x * 4, row + x * 4, t.weights[k]);
+        }
+      }
+    });
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -2,6 +2,7 @@
 #include "../Core/Math/Vec3.h"
 #include "GLTFLoader.h"
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -16,11 +17,38 @@ using Math::Vec3;
 // Morph Target Data
 // =========================================================================
 
+// Sparse: only vertices the target moves are kept. indices[i] is the base
+// vertex that positionDeltas[i] / normalDeltas[i] apply to.
 struct MorphTarget {
   std::string name;
+  std::vector<uint32_t> indices;    // Ascending base vertex indices
   std::vector<Vec3> positionDeltas; // Difference from base mesh
   std::vector<Vec3> normalDeltas;
   float defaultWeight = 0.0f;
+
+  // Drop zero deltas from a dense target (one entry per base vertex)
+  void Sparsify(float epsilon = 1e-6f) {
+    bool dense = indices.empty();
+    normalDeltas.resize(positionDeltas.size(), Vec3(0, 0, 0));
+    size_t out = 0;
+    for (size_t i = 0; i < positionDeltas.size(); ++i) {
+      const Vec3 &n = normalDeltas[i];
+      if (positionDeltas[i].LengthSq() <= epsilon * epsilon &&
+          n.LengthSq() <= epsilon * epsilon)
+        continue;
+      uint32_t vertex = dense ? static_cast<uint32_t>(i) : indices[i];
+      if (dense)
+        indices.push_back(vertex);
+      else
+        indices[out] = vertex;
+      positionDeltas[out] = positionDeltas[i];
+      normalDeltas[out] = n;
+      ++out;
+    }
+    indices.resize(out);
+    positionDeltas.resize(out);
+    normalDeltas.resize(out);
+  }
 };
 
 struct MorphTargetSet {
@@ -39,13 +67,13 @@ struct MorphTargetSet {
         continue;
 
       const auto &target = targets[t];
-      for (size_t v = 0; v < vertCount && v < target.positionDeltas.size();
-           v++) {
-        result[v].position = result[v].position + target.positionDeltas[v] * w;
-        if (v < target.normalDeltas.size()) {
-          result[v].normal =
-              (result[v].normal + target.normalDeltas[v] * w).Normalized();
-        }
+      for (size_t i = 0; i < target.indices.size(); i++) {
+        uint32_t v = target.indices[i];
+        if (v >= vertCount)
+          break;
+        result[v].position = result[v].position + target.positionDeltas[i] * w;
+        result[v].normal =
+            (result[v].normal + target.normalDeltas[i] * w).Normalized();
       }
     }
     return result;
@@ -88,6 +116,7 @@ public:
             variantVerts[v].normal - set.baseMesh[v].normal;
       }
 
+      target.Sparsify();
       set.targets.push_back(target);
     }
 
@@ -250,6 +279,9 @@ public:
       set.targets.push_back(target);
     }
 
+    for (auto &target : set.targets)
+      target.Sparsify();
+
     std::cout << "[MorphTargetExtractor] Generated " << set.targets.size()
               << " DNA-driven morph targets for '" << set.meshName << "'"
               << std::endl;
@@ -0,0 +1,612 @@
+#pragma once
+#include "../Core/Threading/JobSystem.h"
+#include "Inflate.h"
+#include "MappedFile.h"
+#include "TextureData.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef MESOZOIC_SSE
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MESOZOIC_SSE 1
+#else
+#define MESOZOIC_SSE 0
+#endif
+#endif
+#if MESOZOIC_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// PNG Decoding
+// =========================================================================
+// Self-contained PNG reader (no zlib). The IDAT chunks are inflated straight
+// out of the file buffer and every scanline is unfiltered and expanded to
+// RGBA8 as soon as it is complete, directly into the caller's buffer: RGBA8
+// images are unfiltered in place, everything else goes through two scratch
+// rows. All color types, bit depths 1-16, tRNS transparency and Adam7
+// interlacing are supported; 16-bit samples keep their high byte.
+// Sub/Avg/Paeth reconstruction is serial along a row, so the SSE2 paths
+// process the channels of one pixel per step (3 and 4 byte pixels); Up is
+// vectorized 16 bytes at a time.
+
+enum class PNGColorType : uint8_t {
+  Gray = 0,
+  RGB = 2,
+  Palette = 3,
+  GrayAlpha = 4,
+  RGBA = 6
+};
+
+struct PNGInfo {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint8_t bitDepth = 8;
+  PNGColorType colorType = PNGColorType::RGBA;
+  bool interlaced = false;
+
+  uint32_t Channels() const {
+    switch (colorType) {
+    case PNGColorType::Gray:
+    case PNGColorType::Palette:
+      return 1;
+    case PNGColorType::GrayAlpha:
+      return 2;
+    case PNGColorType::RGB:
+      return 3;
+    default:
+      return 4;
+    }
+  }
+  // Byte distance to the corresponding byte of the previous pixel
+  uint32_t FilterStride() const {
+    return std::max(1u, Channels() * bitDepth / 8);
+  }
+  size_t RowBytes(uint32_t w) const {
+    return (size_t(w) * Channels() * bitDepth + 7) / 8;
+  }
+};
+
+struct PNGDecodeOptions {
+  bool verifyChecksums = false; // Chunk CRC-32 and zlib Adler-32
+};
+
+namespace PNGFormat {
+
+constexpr uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+constexpr uint32_t MAX_DIMENSION = 16384;
+
+enum FilterType : uint8_t { None = 0, Sub = 1, Up = 2, Average = 3, Paeth = 4 };
+
+// Adam7 pass origins and steps
+constexpr uint8_t ADAM7_X0[7] = {0, 4, 0, 2, 0, 1, 0};
+constexpr uint8_t ADAM7_Y0[7] = {0, 0, 4, 0, 2, 0, 1};
+constexpr uint8_t ADAM7_DX[7] = {8, 8, 4, 4, 2, 2, 1};
+constexpr uint8_t ADAM7_DY[7] = {8, 8, 8, 4, 4, 2, 2};
+
+inline uint32_t ReadU32(const uint8_t *p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+         (uint32_t(p[2]) << 8) | p[3];
+}
+
+inline uint32_t ChunkType(const char *tag) {
+  return ReadU32(reinterpret_cast<const uint8_t *>(tag));
+}
+
+inline const std::array<uint32_t, 256> &CrcTable() {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k)
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[n] = c;
+    }
+    return t;
+  }();
+  return table;
+}
+
+// Continue with the previous result; start from 0
+inline uint32_t Crc32(uint32_t crc, const uint8_t *data, size_t size) {
+  const auto &table = CrcTable();
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+inline uint8_t PaethPredictor(int a, int b, int c) {
+  int pa = std::abs(b - c);
+  int pb = std::abs(a - c);
+  int pc = std::abs(a + b - 2 * c);
+  if (pa <= pb && pa <= pc)
+    return uint8_t(a);
+  return uint8_t(pb <= pc ? b : c);
+}
+
+} // namespace PNGFormat
+
+// Scanline filter reconstruction. `prev` is the previous unfiltered row of
+// the same pass (all zeros for the first row).
+namespace PNGFilters {
+
+inline void UnfilterScalar(uint8_t type, uint8_t *cur, const uint8_t *prev,
+                           size_t n, uint32_t bpp) {
+  using namespace PNGFormat;
+  switch (type) {
+  case Sub:
+    for (size_t i = bpp; i < n; ++i)
+      cur[i] = uint8_t(cur[i] + cur[i - bpp]);
+    break;
+  case Up:
+    for (size_t i = 0; i < n; ++i)
+      cur[i] = uint8_t(cur[i] + prev[i]);
+    break;
+  case Average:
+    for (size_t i = 0; i < bpp; ++i)
+      cur[i] = uint8_t(cur[i] + (prev[i] >> 1));
+    for (size_t i = bpp; i < n; ++i)
+      cur[i] = uint8_t(cur[i] + ((cur[i - bpp] + prev[i]) >> 1));
+    break;
+  case Paeth:
+    for (size_t i = 0; i < bpp; ++i)
+      cur[i] = uint8_t(cur[i] + prev[i]);
+    for (size_t i = bpp; i < n; ++i)
+      cur[i] = uint8_t(cur[i] + PaethPredictor(cur[i - bpp], prev[i],
+                                               prev[i - bpp]));
+    break;
+  default:
+    break;
+  }
+}
+
+#if MESOZOIC_SSE
+// One pixel of `bpp` (3 or 4) bytes in the low lanes
+inline __m128i LoadPixel(const uint8_t *p, uint32_t bpp) {
+  uint32_t v = 0;
+  std::memcpy(&v, p, bpp);
+  return _mm_cvtsi32_si128(static_cast<int>(v));
+}
+inline void StorePixel(uint8_t *p, __m128i x, uint32_t bpp) {
+  uint32_t v = static_cast<uint32_t>(_mm_cvtsi128_si32(x));
+  std::memcpy(p, &v, bpp);
+}
+
+inline void UnfilterUp(uint8_t *cur, const uint8_t *prev, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cur + i));
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(prev + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(cur + i), _mm_add_epi8(c, p));
+  }
+  for (; i < n; ++i)
+    cur[i] = uint8_t(cur[i] + prev[i]);
+}
+
+inline void UnfilterSub(uint8_t *cur, size_t n, uint32_t bpp) {
+  __m128i a = _mm_setzero_si128();
+  for (size_t i = 0; i < n; i += bpp) {
+    a = _mm_add_epi8(a, LoadPixel(cur + i, bpp));
+    StorePixel(cur + i, a, bpp);
+  }
+}
+
+inline void UnfilterAverage(uint8_t *cur, const uint8_t *prev, size_t n,
+                            uint32_t bpp) {
+  const __m128i one = _mm_set1_epi8(1);
+  __m128i a = _mm_setzero_si128();
+  for (size_t i = 0; i < n; i += bpp) {
+    __m128i b = LoadPixel(prev + i, bpp);
+    // _mm_avg_epu8 rounds up; the filter truncates
+    __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                               _mm_and_si128(_mm_xor_si128(a, b), one));
+    a = _mm_add_epi8(avg, LoadPixel(cur + i, bpp));
+    StorePixel(cur + i, a, bpp);
+  }
+}
+
+inline __m128i Abs16(__m128i x) {
+  return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+inline __m128i Select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline void UnfilterPaeth(uint8_t *cur, const uint8_t *prev, size_t n,
+                          uint32_t bpp) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i a = zero, c = zero; // Left and upper-left, widened to 16 bits
+  for (size_t i = 0; i < n; i += bpp) {
+    __m128i b = _mm_unpacklo_epi8(LoadPixel(prev + i, bpp), zero);
+    __m128i pbc = _mm_sub_epi16(b, c); // p - a
+    __m128i pac = _mm_sub_epi16(a, c); // p - b
+    __m128i pa = Abs16(pbc);
+    __m128i pb = Abs16(pac);
+    __m128i pc = Abs16(_mm_add_epi16(pbc, pac));
+    __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+    // Ties prefer a, then b
+    __m128i nearest =
+        Select(_mm_cmpeq_epi16(smallest, pa), a,
+               Select(_mm_cmpeq_epi16(smallest, pb), b, c));
+    __m128i x = _mm_add_epi8(_mm_packus_epi16(nearest, zero),
+                             LoadPixel(cur + i, bpp));
+    StorePixel(cur + i, x, bpp);
+    a = _mm_unpacklo_epi8(x, zero);
+    c = b;
+  }
+}
+#endif
+
+// Returns false for an unknown filter type
+inline bool Unfilter(uint8_t type, uint8_t *cur, const uint8_t *prev,
+                     size_t n, uint32_t bpp) {
+  if (type > PNGFormat::Paeth)
+    return false;
+#if MESOZOIC_SSE
+  if (type == PNGFormat::Up) {
+    UnfilterUp(cur, prev, n);
+    return true;
+  }
+  if (bpp == 3 || bpp == 4) {
+    switch (type) {
+    case PNGFormat::Sub:
+      UnfilterSub(cur, n, bpp);
+      return true;
+    case PNGFormat::Average:
+      UnfilterAverage(cur, prev, n, bpp);
+      return true;
+    case PNGFormat::Paeth:
+      UnfilterPaeth(cur, prev, n, bpp);
+      return true;
+    default:
+      return true;
+    }
+  }
+#endif
+  UnfilterScalar(type, cur, prev, n, bpp);
+  return true;
+}
+
+} // namespace PNGFilters
+
+class PNGDecoder {
+public:
+  // Parses the signature and IHDR only
+  static bool ReadInfo(const uint8_t *data, size_t size, PNGInfo &info) {
+    if (size < 33 || std::memcmp(data, PNGFormat::SIGNATURE, 8) != 0)
+      return false;
+    if (PNGFormat::ReadU32(data + 8) != 13 ||
+        PNGFormat::ReadU32(data + 12) != PNGFormat::ChunkType("IHDR"))
+      return false;
+    const uint8_t *h = data + 16;
+    info.width = PNGFormat::ReadU32(h);
+    info.height = PNGFormat::ReadU32(h + 4);
+    info.bitDepth = h[8];
+    info.colorType = static_cast<PNGColorType>(h[9]);
+    info.interlaced = h[12] == 1;
+    if (info.width == 0 || info.height == 0 ||
+        info.width > PNGFormat::MAX_DIMENSION ||
+        info.height > PNGFormat::MAX_DIMENSION || h[10] != 0 || h[11] != 0 ||
+        h[12] > 1)
+      return false;
+    uint8_t d = info.bitDepth;
+    switch (info.colorType) {
+    case PNGColorType::Gray:
+      return d == 1 || d == 2 || d == 4 || d == 8 || d == 16;
+    case PNGColorType::Palette:
+      return d == 1 || d == 2 || d == 4 || d == 8;
+    case PNGColorType::RGB:
+    case PNGColorType::GrayAlpha:
+    case PNGColorType::RGBA:
+      return d == 8 || d == 16;
+    default:
+      return false;
+    }
+  }
+
+  // Streams the image into `dst` as RGBA8 rows `rowPitch` bytes apart
+  // (at least width * 4). Scratch buffers are kept for the next call.
+  bool Decode(const uint8_t *data, size_t size, uint8_t *dst,
+              size_t rowPitch, const PNGDecodeOptions &options = {}) {
+    if (!ReadInfo(data, size, info) || rowPitch < size_t(info.width) * 4)
+      return false;
+    if (!ReadChunks(data, size, options))
+      return false;
+    inflater.SetVerifyChecksum(options.verifyChecksums);
+    bool ok = info.interlaced ? DecodeInterlaced(dst, rowPitch)
+                              : DecodePass(dst, rowPitch, 0, 0, 1, 1,
+                                           info.width, info.height);
+    if (ok && options.verifyChecksums) {
+      uint8_t extra;
+      ok = inflater.Read(&extra, 1) == 0 && inflater.Done() &&
+           inflater.ChecksumMatches();
+    }
+    return ok && !inflater.Failed();
+  }
+
+  const PNGInfo &Info() const { return info; }
+
+  // Decodes an in-memory file into a new RGBA8 texture
+  static TextureData LoadMemory(const uint8_t *data, size_t size,
+                                const std::string &name = "png",
+                                const PNGDecodeOptions &options = {}) {
+    PNGDecoder decoder;
+    return decoder.DecodeTexture(data, size, name, options);
+  }
+
+  static TextureData Load(const std::string &filepath,
+                          const PNGDecodeOptions &options = {}) {
+    PNGDecoder decoder;
+    return decoder.LoadFile(filepath, options);
+  }
+
+  // Decodes every file on `jobs` (serially without one). Each worker reuses
+  // one decoder and pulls the next file when it finishes; results keep the
+  // order of `paths` and failed entries have valid == false.
+  static std::vector<TextureData>
+  LoadBatch(const std::vector<std::string> &paths,
+            Core::Threading::JobSystem *jobs = nullptr,
+            const PNGDecodeOptions &options = {}) {
+    std::vector<TextureData> results(paths.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+      PNGDecoder decoder;
+      for (size_t i = next++; i < paths.size(); i = next++)
+        results[i] = decoder.LoadFile(paths[i], options);
+    };
+    size_t workers =
+        jobs ? std::min<size_t>(paths.size(), jobs->ThreadCount()) : 0;
+    std::vector<std::future<void>> futures;
+    for (size_t w = 0; w < workers; ++w)
+      futures.push_back(jobs->PushJob(worker));
+    if (futures.empty())
+      worker();
+    for (auto &f : futures)
+      f.get();
+    return results;
+  }
+
+  TextureData LoadFile(const std::string &filepath,
+                       const PNGDecodeOptions &options = {}) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+      std::cerr << "[PNGDecoder] Could not open " << filepath << std::endl;
+      TextureData tex;
+      tex.name = filepath;
+      return tex;
+    }
+    return DecodeTexture(file.Data(), file.Size(), filepath, options);
+  }
+
+  TextureData DecodeTexture(const uint8_t *data, size_t size,
+                            const std::string &name,
+                            const PNGDecodeOptions &options = {}) {
+    TextureData tex;
+    tex.name = name;
+    PNGInfo header;
+    if (!ReadInfo(data, size, header)) {
+      std::cerr << "[PNGDecoder] Invalid PNG header: " << name << std::endl;
+      return tex;
+    }
+    tex.width = header.width;
+    tex.height = header.height;
+    tex.channels = 4;
+    tex.format = PixelFormat::RGBA8;
+    tex.pixels.resize(size_t(tex.width) * tex.height * 4);
+    if (!Decode(data, size, tex.pixels.data(), size_t(tex.width) * 4,
+                options)) {
+      std::cerr << "[PNGDecoder] Corrupt PNG: " << name << std::endl;
+      tex.pixels.clear();
+      tex.width = tex.height = 0;
+      return tex;
+    }
+    tex.BuildMipLayout(1);
+    tex.valid = true;
+    return tex;
+  }
+
+private:
+  PNGInfo info;
+  Inflater inflater;
+  std::array<uint32_t, 256> palette{}; // RGBA, little-endian byte order
+  uint32_t paletteSize = 0;
+  bool hasColorKey = false;
+  uint16_t colorKey[3] = {}; // Gray or RGB sample values drawn transparent
+  std::vector<uint8_t> rowA, rowB;
+
+  bool ReadChunks(const uint8_t *data, size_t size,
+                  const PNGDecodeOptions &options) {
+    using PNGFormat::ChunkType;
+    inflater.Reset(true);
+    paletteSize = 0;
+    hasColorKey = false;
+    for (uint32_t i = 0; i < 256; ++i)
+      palette[i] = 0xFF000000u;
+    bool sawIdat = false, sawIend = false;
+    size_t pos = 8;
+    while (pos + 12 <= size && !sawIend) {
+      uint32_t length = PNGFormat::ReadU32(data + pos);
+      uint32_t type = PNGFormat::ReadU32(data + pos + 4);
+      if (length > size - pos - 12)
+        return false;
+      const uint8_t *body = data + pos + 8;
+      if (options.verifyChecksums &&
+          PNGFormat::Crc32(0, data + pos + 4, length + 4) !=
+              PNGFormat::ReadU32(body + length))
+        return false;
+      pos += size_t(length) + 12;
+
+      if (type == ChunkType("IDAT")) {
+        inflater.AddInput(body, length);
+        sawIdat = true;
+      } else if (type == ChunkType("PLTE")) {
+        if (length % 3 != 0 || length / 3 > 256)
+          return false;
+        paletteSize = length / 3;
+        for (uint32_t i = 0; i < paletteSize; ++i) {
+          palette[i] = 0xFF000000u | (uint32_t(body[i * 3 + 2]) << 16) |
+                       (uint32_t(body[i * 3 + 1]) << 8) | body[i * 3];
+        }
+      } else if (type == ChunkType("tRNS")) {
+        ReadTransparency(body, length);
+      } else if (type == ChunkType("IEND")) {
+        sawIend = true;
+      } else if (!(type & 0x20000000u) && type != ChunkType("IHDR")) {
+        return false; // Unknown critical chunk
+      }
+    }
+    if (info.colorType == PNGColorType::Palette && paletteSize == 0)
+      return false;
+    return sawIdat;
+  }
+
+  void ReadTransparency(const uint8_t *body, uint32_t length) {
+    if (info.colorType == PNGColorType::Palette) {
+      for (uint32_t i = 0; i < length && i < 256; ++i)
+        palette[i] = (palette[i] & 0x00FFFFFFu) | (uint32_t(body[i]) << 24);
+    } else if (info.colorType == PNGColorType::Gray && length >= 2) {
+      hasColorKey = true;
+      colorKey[0] = uint16_t((body[0] << 8) | body[1]);
+    } else if (info.colorType == PNGColorType::RGB && length >= 6) {
+      hasColorKey = true;
+      for (int c = 0; c < 3; ++c)
+        colorKey[c] = uint16_t((body[c * 2] << 8) | body[c * 2 + 1]);
+    }
+  }
+
+  bool DecodeInterlaced(uint8_t *dst, size_t rowPitch) {
+    using namespace PNGFormat;
+    for (int p = 0; p < 7; ++p) {
+      if (info.width <= ADAM7_X0[p] || info.height <= ADAM7_Y0[p])
+        continue; // Empty passes have no scanlines at all
+      uint32_t w = (info.width - ADAM7_X0[p] + ADAM7_DX[p] - 1) / ADAM7_DX[p];
+      uint32_t h = (info.height - ADAM7_Y0[p] + ADAM7_DY[p] - 1) / ADAM7_DY[p];
+      if (!DecodePass(dst, rowPitch, ADAM7_X0[p], ADAM7_Y0[p], ADAM7_DX[p],
+                      ADAM7_DY[p], w, h))
+        return false;
+    }
+    return true;
+  }
+
+  // Decodes a w x h (sub-)image whose pixel (x, y) lands at
+  // (x0 + x * dx, y0 + y * dy) in the destination
+  bool DecodePass(uint8_t *dst, size_t rowPitch, uint32_t x0, uint32_t y0,
+                  uint32_t dx, uint32_t dy, uint32_t w, uint32_t h) {
+    size_t rowBytes = info.RowBytes(w);
+    uint32_t bpp = info.FilterStride();
+    // RGBA8 rows are unfiltered in place in the destination
+    bool direct = !info.interlaced && info.colorType == PNGColorType::RGBA &&
+                  info.bitDepth == 8;
+    rowA.assign(rowBytes, 0);
+    rowB.assign(direct ? 0 : rowBytes, 0);
+    uint8_t *prev = rowA.data(); // Zeros for the first row
+    uint8_t *cur = direct ? nullptr : rowB.data();
+
+    for (uint32_t y = 0; y < h; ++y) {
+      uint8_t *outRow = dst + size_t(y0 + y * dy) * rowPitch;
+      if (direct)
+        cur = outRow;
+      uint8_t filter;
+      if (inflater.Read(&filter, 1) != 1 ||
+          inflater.Read(cur, rowBytes) != rowBytes ||
+          !PNGFilters::Unfilter(filter, cur, prev, rowBytes, bpp))
+        return false;
+      if (!direct) {
+        Expand(cur, w, outRow + size_t(x0) * 4, size_t(dx) * 4);
+        std::swap(cur, prev);
+      } else {
+        prev = cur;
+      }
+    }
+    return true;
+  }
+
+  // Converts one unfiltered scanline of w pixels to RGBA8, `step` bytes
+  // apart in the output
+  void Expand(const uint8_t *src, uint32_t w, uint8_t *out,
+              size_t step) const {
+    const uint8_t depth = info.bitDepth;
+    switch (info.colorType) {
+    case PNGColorType::RGBA:
+      for (uint32_t x = 0; x < w; ++x, out += step) {
+        const uint8_t *s = src + size_t(x) * (depth / 2); // 4 or 8 bytes
+        uint32_t hi = depth == 16 ? 2 : 1;
+        out[0] = s[0];
+        out[1] = s[hi];
+        out[2] = s[hi * 2];
+        out[3] = s[hi * 3];
+      }
+      break;
+    case PNGColorType::RGB:
+      for (uint32_t x = 0; x < w; ++x, out += step) {
+        uint32_t hi = depth == 16 ? 2 : 1;
+        const uint8_t *s = src + size_t(x) * 3 * hi;
+        out[0] = s[0];
+        out[1] = s[hi];
+        out[2] = s[hi * 2];
+        out[3] = hasColorKey && Sample(s, 0) == colorKey[0] &&
+                         Sample(s, 1) == colorKey[1] &&
+                         Sample(s, 2) == colorKey[2]
+                     ? 0
+                     : 255;
+      }
+      break;
+    case PNGColorType::GrayAlpha:
+      for (uint32_t x = 0; x < w; ++x, out += step) {
+        uint32_t hi = depth == 16 ? 2 : 1;
+        const uint8_t *s = src + size_t(x) * 2 * hi;
+        out[0] = out[1] = out[2] = s[0];
+        out[3] = s[hi];
+      }
+      break;
+    case PNGColorType::Gray:
+      for (uint32_t x = 0; x < w; ++x, out += step) {
+        uint32_t v = Sample(src, x);
+        uint8_t g = depth == 16 ? uint8_t(v >> 8)
+                                : uint8_t(v * (255 / ((1u << depth) - 1)));
+        out[0] = out[1] = out[2] = g;
+        out[3] = hasColorKey && v == colorKey[0] ? 0 : 255;
+      }
+      break;
+    case PNGColorType::Palette:
+      for (uint32_t x = 0; x < w; ++x, out += step) {
+        uint32_t index = Sample(src, x);
+        uint32_t rgba = index < paletteSize ? palette[index] : 0xFF000000u;
+        out[0] = uint8_t(rgba);
+        out[1] = uint8_t(rgba >> 8);
+        out[2] = uint8_t(rgba >> 16);
+        out[3] = uint8_t(rgba >> 24);
+      }
+      break;
+    }
+  }
+
+  // Sample i of a row at the image's bit depth (MSB-first when packed)
+  uint32_t Sample(const uint8_t *row, size_t i) const {
+    switch (info.bitDepth) {
+    case 16:
+      return (uint32_t(row[i * 2]) << 8) | row[i * 2 + 1];
+    case 8:
+      return row[i];
+    default: {
+      size_t bit = i * info.bitDepth;
+      uint32_t shift = 8 - info.bitDepth - uint32_t(bit & 7);
+      return (row[bit >> 3] >> shift) & ((1u << info.bitDepth) - 1);
+    }
+    }
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
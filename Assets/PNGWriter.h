@@ -0,0 +1,315 @@
+#pragma once
+#include "PNGDecoder.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Mesozoic {
+namespace Assets {
+
+// =========================================================================
+// PNG Encoding
+// =========================================================================
+// Small PNG writer for screenshots, cooked previews and decoder tests. The
+// zlib stream uses greedy LZ77 (hash chains over the 32 KB window) with the
+// fixed Huffman code, or stored blocks when compression is off. That is
+// quick to write but not small; re-save through a real optimizer for
+// shipping art.
+
+struct PNGWriteSettings {
+  int filter = -1;              // -1 picks per row, otherwise 0-4 for all
+  bool compress = true;         // false writes stored DEFLATE blocks
+  uint32_t idatSize = 1u << 16; // Largest IDAT chunk body
+};
+
+class PNGWriter {
+public:
+  // RGBA8 pixels, tightly packed rows
+  static std::vector<uint8_t> Encode(const uint8_t *rgba, uint32_t width,
+                                     uint32_t height,
+                                     const PNGWriteSettings &settings = {}) {
+    PNGInfo info;
+    info.width = width;
+    info.height = height;
+    info.bitDepth = 8;
+    info.colorType = PNGColorType::RGBA;
+    return Assemble(info, FilterImage(info, rgba, settings.filter), settings);
+  }
+
+  static bool WriteFile(const std::string &path, const TextureData &tex,
+                        const PNGWriteSettings &settings = {}) {
+    if (!tex.valid || tex.format != PixelFormat::RGBA8) {
+      std::cerr << "[PNGWriter] Only RGBA8 textures can be written: "
+                << tex.name << std::endl;
+      return false;
+    }
+    std::vector<uint8_t> png =
+        Encode(tex.pixels.data(), tex.width, tex.height, settings);
+    std::ofstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+      std::cerr << "[PNGWriter] Cannot write " << path << std::endl;
+      return false;
+    }
+    f.write(reinterpret_cast<const char *>(png.data()),
+            static_cast<std::streamsize>(png.size()));
+    return f.good();
+  }
+
+  // Filters packed scanlines (RowBytes(width) each) of a non-interlaced
+  // image, prefixing every row with its filter type byte
+  static std::vector<uint8_t> FilterImage(const PNGInfo &info,
+                                          const uint8_t *rows, int filter) {
+    size_t rowBytes = info.RowBytes(info.width);
+    uint32_t bpp = info.FilterStride();
+    std::vector<uint8_t> out((rowBytes + 1) * info.height);
+    std::vector<uint8_t> zero(rowBytes, 0), candidate(rowBytes);
+    for (uint32_t y = 0; y < info.height; ++y) {
+      const uint8_t *cur = rows + y * rowBytes;
+      const uint8_t *prev = y > 0 ? cur - rowBytes : zero.data();
+      uint8_t *dst = out.data() + y * (rowBytes + 1);
+      if (filter >= 0) {
+        dst[0] = uint8_t(filter);
+        FilterRow(uint8_t(filter), cur, prev, rowBytes, bpp, dst + 1);
+        continue;
+      }
+      // Smallest sum of signed residuals, the usual libpng heuristic
+      uint64_t best = ~0ull;
+      for (uint8_t type = 0; type <= PNGFormat::Paeth; ++type) {
+        FilterRow(type, cur, prev, rowBytes, bpp, candidate.data());
+        uint64_t cost = 0;
+        for (uint8_t v : candidate)
+          cost += uint64_t(std::abs(int(int8_t(v))));
+        if (cost < best) {
+          best = cost;
+          dst[0] = type;
+          std::copy(candidate.begin(), candidate.end(), dst + 1);
+        }
+      }
+    }
+    return out;
+  }
+
+  static void FilterRow(uint8_t type, const uint8_t *cur, const uint8_t *prev,
+                        size_t n, uint32_t bpp, uint8_t *out) {
+    for (size_t i = 0; i < n; ++i) {
+      int a = i >= bpp ? cur[i - bpp] : 0;
+      int b = prev[i];
+      int c = i >= bpp ? prev[i - bpp] : 0;
+      int predicted = 0;
+      switch (type) {
+      case PNGFormat::Sub:
+        predicted = a;
+        break;
+      case PNGFormat::Up:
+        predicted = b;
+        break;
+      case PNGFormat::Average:
+        predicted = (a + b) >> 1;
+        break;
+      case PNGFormat::Paeth:
+        predicted = PNGFormat::PaethPredictor(a, b, c);
+        break;
+      default:
+        break;
+      }
+      out[i] = uint8_t(cur[i] - predicted);
+    }
+  }
+
+  // Wraps filtered scanlines (interlaced ones pass by pass) in a PNG file.
+  // `palette` is PLTE's RGB triples, `transparency` tRNS's body.
+  static std::vector<uint8_t>
+  Assemble(const PNGInfo &info, const std::vector<uint8_t> &scanlines,
+           const PNGWriteSettings &settings = {},
+           const std::vector<uint8_t> &palette = {},
+           const std::vector<uint8_t> &transparency = {}) {
+    std::vector<uint8_t> png(PNGFormat::SIGNATURE, PNGFormat::SIGNATURE + 8);
+    uint8_t ihdr[13] = {};
+    PutU32(ihdr, info.width);
+    PutU32(ihdr + 4, info.height);
+    ihdr[8] = info.bitDepth;
+    ihdr[9] = static_cast<uint8_t>(info.colorType);
+    ihdr[12] = info.interlaced ? 1 : 0;
+    WriteChunk(png, "IHDR", ihdr, sizeof(ihdr));
+    if (!palette.empty())
+      WriteChunk(png, "PLTE", palette.data(), palette.size());
+    if (!transparency.empty())
+      WriteChunk(png, "tRNS", transparency.data(), transparency.size());
+    std::vector<uint8_t> zlib =
+        ZlibCompress(scanlines.data(), scanlines.size(), settings.compress);
+    size_t chunk = std::max<size_t>(1, settings.idatSize);
+    for (size_t pos = 0; pos < zlib.size(); pos += chunk) {
+      WriteChunk(png, "IDAT", zlib.data() + pos,
+                 std::min(chunk, zlib.size() - pos));
+    }
+    WriteChunk(png, "IEND", nullptr, 0);
+    return png;
+  }
+
+  static std::vector<uint8_t> ZlibCompress(const uint8_t *data, size_t size,
+                                           bool compress = true) {
+    std::vector<uint8_t> out = {0x78, 0x01};
+    if (compress) {
+      CompressFixed(data, size, out);
+    } else {
+      size_t pos = 0;
+      do {
+        size_t n = std::min<size_t>(size - pos, 65535);
+        out.push_back(pos + n == size ? 1 : 0); // BFINAL, BTYPE = 00
+        out.push_back(uint8_t(n));
+        out.push_back(uint8_t(n >> 8));
+        out.push_back(uint8_t(~n));
+        out.push_back(uint8_t(~n >> 8));
+        out.insert(out.end(), data + pos, data + pos + n);
+        pos += n;
+      } while (pos < size);
+    }
+    uint8_t adler[4];
+    PutU32(adler, Deflate::Adler32(1, data, size));
+    out.insert(out.end(), adler, adler + 4);
+    return out;
+  }
+
+private:
+  struct BitWriter {
+    std::vector<uint8_t> &out;
+    uint64_t buf = 0;
+    uint32_t count = 0;
+
+    void Put(uint32_t bits, uint32_t n) {
+      buf |= uint64_t(bits) << count;
+      count += n;
+      while (count >= 8) {
+        out.push_back(uint8_t(buf));
+        buf >>= 8;
+        count -= 8;
+      }
+    }
+    void Flush() {
+      if (count > 0)
+        out.push_back(uint8_t(buf));
+      buf = 0;
+      count = 0;
+    }
+  };
+
+  static void PutU32(uint8_t *p, uint32_t v) {
+    p[0] = uint8_t(v >> 24);
+    p[1] = uint8_t(v >> 16);
+    p[2] = uint8_t(v >> 8);
+    p[3] = uint8_t(v);
+  }
+
+  static void WriteChunk(std::vector<uint8_t> &png, const char *type,
+                         const uint8_t *body, size_t size) {
+    uint8_t header[8];
+    PutU32(header, static_cast<uint32_t>(size));
+    std::copy(type, type + 4, header + 4);
+    png.insert(png.end(), header, header + 8);
+    if (size > 0)
+      png.insert(png.end(), body, body + size);
+    uint32_t crc = PNGFormat::Crc32(0, header + 4, 4);
+    if (size > 0)
+      crc = PNGFormat::Crc32(crc, body, size);
+    uint8_t trailer[4];
+    PutU32(trailer, crc);
+    png.insert(png.end(), trailer, trailer + 4);
+  }
+
+  // Fixed Huffman literal/length code, already bit-reversed for output
+  static void PutLiteralLength(BitWriter &bits, uint32_t sym) {
+    uint32_t code, len;
+    if (sym < 144) {
+      code = 0x30 + sym;
+      len = 8;
+    } else if (sym < 256) {
+      code = 0x190 + sym - 144;
+      len = 9;
+    } else if (sym < 280) {
+      code = sym - 256;
+      len = 7;
+    } else {
+      code = 0xC0 + sym - 280;
+      len = 8;
+    }
+    bits.Put(Deflate::ReverseBits(code, len), len);
+  }
+
+  static void PutMatch(BitWriter &bits, uint32_t length, uint32_t dist) {
+    const uint16_t *lb = Deflate::LENGTH_BASE;
+    uint32_t lc = uint32_t(std::upper_bound(lb, lb + 29, length) - lb) - 1;
+    PutLiteralLength(bits, 257 + lc);
+    bits.Put(length - lb[lc], Deflate::LENGTH_EXTRA[lc]);
+    const uint16_t *db = Deflate::DIST_BASE;
+    uint32_t dc = uint32_t(std::upper_bound(db, db + 30, dist) - db) - 1;
+    bits.Put(Deflate::ReverseBits(dc, 5), 5);
+    bits.Put(dist - db[dc], Deflate::DIST_EXTRA[dc]);
+  }
+
+  static void CompressFixed(const uint8_t *data, size_t size,
+                            std::vector<uint8_t> &out) {
+    constexpr uint32_t HASH_BITS = 15;
+    constexpr uint32_t WINDOW_MASK = Deflate::WINDOW_SIZE - 1;
+    constexpr int MAX_CHAIN = 16;
+    std::vector<int64_t> head(size_t(1) << HASH_BITS, -1);
+    std::vector<int64_t> prev(Deflate::WINDOW_SIZE, -1);
+    auto hash = [&](size_t i) {
+      uint32_t v = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16);
+      return (v * 2654435761u) >> (32 - HASH_BITS);
+    };
+    auto insert = [&](size_t i) {
+      uint32_t h = hash(i);
+      prev[i & WINDOW_MASK] = head[h];
+      head[h] = int64_t(i);
+    };
+
+    BitWriter bits{out};
+    bits.Put(1, 1); // BFINAL
+    bits.Put(1, 2); // BTYPE = fixed Huffman
+    size_t i = 0;
+    while (i < size) {
+      uint32_t bestLen = 0, bestDist = 0;
+      if (i + 3 <= size) {
+        size_t maxLen = std::min<size_t>(Deflate::MAX_MATCH, size - i);
+        int64_t cand = head[hash(i)];
+        for (int chain = 0; chain < MAX_CHAIN && cand >= 0; ++chain) {
+          size_t dist = i - size_t(cand);
+          if (dist > Deflate::WINDOW_SIZE)
+            break;
+          size_t len = 0;
+          while (len < maxLen && data[cand + len] == data[i + len])
+            ++len;
+          if (len > bestLen) {
+            bestLen = uint32_t(len);
+            bestDist = uint32_t(dist);
+            if (len == maxLen)
+              break;
+          }
+          int64_t next = prev[size_t(cand) & WINDOW_MASK];
+          if (next >= cand) // Slot reused by a newer position
+            break;
+          cand = next;
+        }
+        insert(i);
+      }
+      if (bestLen >= 3) {
+        PutMatch(bits, bestLen, bestDist);
+        for (size_t k = i + 1; k < i + bestLen && k + 3 <= size; ++k)
+          insert(k);
+        i += bestLen;
+      } else {
+        PutLiteralLength(bits, data[i]);
+        ++i;
+      }
+    }
+    PutLiteralLength(bits, 256);
+    bits.Flush();
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
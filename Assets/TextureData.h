@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Mesozoic {
+namespace Assets {
+
+// Texture pixel formats
+enum class PixelFormat : uint8_t {
+  R8,
+  RG8,
+  RGB8,
+  RGBA8,
+  R16F,
+  RG16F,
+  RGBA16F,
+  R32F,
+  RGBA32F,
+  BC1,
+  BC3,
+  BC5,
+  BC7 // Block compression
+};
+
+// One level of a mip chain inside TextureData::pixels
+struct TextureMip {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  size_t offset = 0; // Bytes from the start of `pixels`
+  size_t size = 0;
+};
+
+struct TextureData {
+  std::string name;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t channels = 4;
+  uint32_t mipLevels = 1;
+  PixelFormat format = PixelFormat::RGBA8;
+  bool srgb = false; // Color data is sRGB-encoded (picks the _SRGB format)
+  std::vector<uint8_t> pixels; // All levels, largest first, tightly packed
+  std::vector<TextureMip> mips;
+  bool valid = false;
+
+  // Lays out `levels` mips back to back (each dimension halves, min 1) and
+  // returns the total byte size. The layout only depends on the dimensions
+  // and format, so it can be rebuilt from a cooked header and the whole
+  // chain uploaded from one staging copy.
+  size_t BuildMipLayout(uint32_t levels) {
+    mipLevels = levels;
+    mips.resize(levels);
+    size_t offset = 0;
+    uint32_t w = width, h = height;
+    for (uint32_t i = 0; i < levels; ++i) {
+      mips[i] = {w, h, offset, LevelSize(w, h)};
+      offset += mips[i].size;
+      w = w > 1 ? w / 2 : 1;
+      h = h > 1 ? h / 2 : 1;
+    }
+    return offset;
+  }
+
+  // Levels in a full chain down to 1x1
+  static uint32_t FullMipCount(uint32_t w, uint32_t h) {
+    uint32_t levels = 1;
+    while (w > 1 || h > 1) {
+      w = w > 1 ? w / 2 : 1;
+      h = h > 1 ? h / 2 : 1;
+      ++levels;
+    }
+    return levels;
+  }
+
+  const uint8_t *MipData(uint32_t level) const {
+    return pixels.data() + (mips.empty() ? 0 : mips[level].offset);
+  }
+
+  bool IsBlockCompressed() const { return BlockBytes() != 0; }
+
+  // Bytes per 4x4 block for BCn formats, 0 otherwise
+  size_t BlockBytes() const {
+    switch (format) {
+    case PixelFormat::BC1:
+      return 8;
+    case PixelFormat::BC3:
+    case PixelFormat::BC5:
+    case PixelFormat::BC7:
+      return 16;
+    default:
+      return 0;
+    }
+  }
+
+  // Block formats cover partial blocks at the edges (and 1x1/2x2 mips)
+  size_t LevelSize(uint32_t w, uint32_t h) const {
+    if (IsBlockCompressed())
+      return size_t((w + 3) / 4) * ((h + 3) / 4) * BlockBytes();
+    return size_t(w) * h * BytesPerPixel();
+  }
+
+  size_t BytesPerPixel() const {
+    switch (format) {
+    case PixelFormat::R8:
+      return 1;
+    case PixelFormat::RG8:
+      return 2;
+    case PixelFormat::RGB8:
+      return 3;
+    case PixelFormat::RGBA8:
+      return 4;
+    case PixelFormat::R16F:
+      return 2;
+    case PixelFormat::RG16F:
+      return 4;
+    case PixelFormat::RGBA16F:
+      return 8;
+    case PixelFormat::R32F:
+      return 4;
+    case PixelFormat::RGBA32F:
+      return 16;
+    default:
+      return 4;
+    }
+  }
+};
+
+} // namespace Assets
+} // namespace Mesozoic
@@ -1,4 +1,7 @@
 #pragma once
+#include "MipGenerator.h"
+#include "PNGDecoder.h"
+#include "TextureData.h"
 #include <cstdint>
 #include <fstream>
 #include <iostream>
@@ -8,62 +11,9 @@
 namespace Mesozoic {
 namespace Assets {
 
-// Texture pixel formats
-enum class PixelFormat : uint8_t {
-  R8,
-  RG8,
-  RGB8,
-  RGBA8,
-  R16F,
-  RG16F,
-  RGBA16F,
-  R32F,
-  RGBA32F,
-  BC1,
-  BC3,
-  BC5,
-  BC7 // Block compression
-};
-
-struct TextureData {
-  std::string name;
-  uint32_t width = 0;
-  uint32_t height = 0;
-  uint32_t channels = 4;
-  uint32_t mipLevels = 1;
-  PixelFormat format = PixelFormat::RGBA8;
-  std::vector<uint8_t> pixels;
-  bool valid = false;
-
-  size_t BytesPerPixel() const {
-    switch (format) {
-    case PixelFormat::R8:
-      return 1;
-    case PixelFormat::RG8:
-      return 2;
-    case PixelFormat::RGB8:
-      return 3;
-    case PixelFormat::RGBA8:
-      return 4;
-    case PixelFormat::R16F:
-      return 2;
-    case PixelFormat::RG16F:
-      return 4;
-    case PixelFormat::RGBA16F:
-      return 8;
-    case PixelFormat::R32F:
-      return 4;
-    case PixelFormat::RGBA32F:
-      return 16;
-    default:
-      return 4;
-    }
-  }
-};
-
 class TextureLoader {
 public:
-  // Load PNG/TGA/BMP/JPG — uses stb_image if available, fallback to stub
+  // Load PNG or BMP; other formats get a placeholder checkerboard
   static TextureData LoadFromFile(const std::string &filepath) {
     TextureData tex;
     tex.name = filepath;
@@ -150,75 +100,27 @@ public:
     return CreateSolid(w, h, 128, 128, 255, 255);
   }
 
-  // Generate mip chain (box filter)
-  static void GenerateMipmaps(TextureData &tex) {
-    if (!tex.valid || tex.width < 2 || tex.height < 2)
-      return;
-
-    uint32_t mipW = tex.width / 2;
-    uint32_t mipH = tex.height / 2;
-    tex.mipLevels = 1;
+  // Generate the full mip chain in place (see MipGenerator for filters)
+  static bool GenerateMipmaps(TextureData &tex,
+                              const MipSettings &settings = {}) {
+    return MipGenerator::Generate(tex, settings);
+  }
 
-    while (mipW >= 1 && mipH >= 1) {
-      size_t mipSize = mipW * mipH * tex.channels;
-      size_t srcOffset =
-          tex.pixels.size() - (mipW * 2) * (mipH * 2) * tex.channels;
-      tex.pixels.resize(tex.pixels.size() + mipSize);
-      // Box filter would go here - simplified for now
-      tex.mipLevels++;
-      if (mipW == 1 && mipH == 1)
-        break;
-      mipW = mipW > 1 ? mipW / 2 : 1;
-      mipH = mipH > 1 ? mipH / 2 : 1;
-    }
+  // Decodes many PNGs in parallel (see PNGDecoder::LoadBatch)
+  static std::vector<TextureData>
+  LoadPNGBatch(const std::vector<std::string> &paths,
+               Core::Threading::JobSystem *jobs = nullptr) {
+    return PNGDecoder::LoadBatch(paths, jobs);
   }
 
 private:
-  // Minimal PNG loader (reads IHDR for dimensions, creates placeholder data)
   static TextureData LoadPNG(const std::string &filepath, size_t fileSize) {
-    TextureData tex;
-    tex.name = filepath;
-
-    std::ifstream f(filepath, std::ios::binary);
-    if (!f.is_open())
-      return tex;
-
-    // Skip signature (8 bytes) + chunk length (4) + "IHDR" (4)
-    f.seekg(16);
-    uint8_t dims[8];
-    f.read(reinterpret_cast<char *>(dims), 8);
-
-    // Big-endian width and height
-    tex.width = (dims[0] << 24) | (dims[1] << 16) | (dims[2] << 8) | dims[3];
-    tex.height = (dims[4] << 24) | (dims[5] << 16) | (dims[6] << 8) | dims[7];
-
-    if (tex.width == 0 || tex.height == 0 || tex.width > 16384 ||
-        tex.height > 16384) {
-      std::cerr << "[TextureLoader] Invalid PNG dimensions: " << tex.width
-                << "x" << tex.height << std::endl;
-      return CreateCheckerboard(256, 256, filepath);
+    TextureData tex = PNGDecoder::Load(filepath);
+    if (tex.valid) {
+      std::cout << "[TextureLoader] Loaded PNG: " << filepath << " ("
+                << tex.width << "x" << tex.height << ", " << fileSize
+                << " bytes)" << std::endl;
     }
-
-    tex.channels = 4;
-    tex.format = PixelFormat::RGBA8;
-    // Full PNG decompression requires zlib — create placeholder with correct
-    // dimensions
-    tex.pixels.resize(tex.width * tex.height * 4);
-    // Fill with gradient pattern as visual indicator
-    for (uint32_t y = 0; y < tex.height; y++) {
-      for (uint32_t x = 0; x < tex.width; x++) {
-        size_t idx = (y * tex.width + x) * 4;
-        tex.pixels[idx + 0] = static_cast<uint8_t>((x * 255) / tex.width);
-        tex.pixels[idx + 1] = static_cast<uint8_t>((y * 255) / tex.height);
-        tex.pixels[idx + 2] = 128;
-        tex.pixels[idx + 3] = 255;
-      }
-    }
-
-    tex.valid = true;
-    std::cout << "[TextureLoader] Loaded PNG header: " << filepath << " ("
-              << tex.width << "x" << tex.height << ", " << fileSize << " bytes)"
-              << std::endl;
     return tex;
   }
 
@@ -149,6 +149,11 @@ public:
     return grad.Normalized();
   }
 
+  // Both scent buffers
+  size_t MemoryBytes() const {
+    return (gridA.capacity() + gridB.capacity()) * sizeof(float);
+  }
+
 private:
   std::vector<float> gridA;
   std::vector<float> gridB;
@@ -0,0 +1,319 @@
+#pragma once
+#include "../Threading/JobSystem.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Mesozoic {
+namespace Core {
+namespace Profiling {
+
+// =========================================================================
+// Lock-free Ring Buffer
+// =========================================================================
+// Single producer, single consumer. A full ring rejects the push rather
+// than making the producer wait for the consumer.
+template <typename T, size_t Capacity> class SPSCRing {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  bool TryPush(const T &value) {
+    size_t head = writeIndex.load(std::memory_order_relaxed);
+    if (head - readIndex.load(std::memory_order_acquire) == Capacity)
+      return false;
+    slots[head & (Capacity - 1)] = value;
+    writeIndex.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPop(T &out) {
+    size_t tail = readIndex.load(std::memory_order_relaxed);
+    if (tail == writeIndex.load(std::memory_order_acquire))
+      return false;
+    out = slots[tail & (Capacity - 1)];
+    readIndex.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t SizeApprox() const {
+    return writeIndex.load(std::memory_order_acquire) -
+           readIndex.load(std::memory_order_acquire);
+  }
+
+private:
+  alignas(64) std::atomic<size_t> writeIndex{0};
+  alignas(64) std::atomic<size_t> readIndex{0};
+  std::array<T, Capacity> slots{};
+};
+
+// =========================================================================
+// Frame Profiler
+// =========================================================================
+// Named channels (tick times, counters, gauges) recorded from any thread.
+// Each thread pushes events into its own SPSC ring, so recording never
+// takes a lock; EndFrame() on the main thread drains the rings and appends
+// one value per channel to a fixed history that the perf HUD graphs.
+//
+//   Profiler profiler;
+//   uint32_t simTick = profiler.Register("Sim tick", Profiler::Kind::Time);
+//   { Profiler::Scope s(profiler, simTick); sim.Tick(dt); }
+//   profiler.EndFrame();
+
+class Profiler {
+public:
+  enum class Kind : uint8_t { Time, Count, Bytes, Percent };
+
+  static constexpr uint32_t MAX_CHANNELS = 64;
+  static constexpr uint32_t HISTORY = 128; // Frames kept per channel
+  static constexpr uint32_t MAX_THREADS = 64;
+  static constexpr uint32_t RING_EVENTS = 4096; // Per thread per frame
+  static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+  static constexpr uint32_t FRAME = 0; // Built-in: time between EndFrames
+
+  Profiler() : instance(NextInstance()) {
+    Register("Frame", Kind::Time);
+    lastEndFrame = std::chrono::steady_clock::now();
+  }
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  // Disabled profilers drop Record/Set calls after one relaxed load
+  std::atomic<bool> enabled{true};
+
+  // Main thread, before other threads record into the channel. Gauges
+  // keep their last Set() value; other channels sum the frame's Record()
+  // calls and read 0 for frames without any. Registering a name again
+  // returns the existing channel.
+  uint32_t Register(const std::string &name, Kind kind, bool gauge = false) {
+    uint32_t existing = Find(name);
+    if (existing != INVALID)
+      return existing;
+    if (channelCount == MAX_CHANNELS)
+      return INVALID;
+    Channel &c = channels[channelCount];
+    c.name = name;
+    c.kind = kind;
+    c.gauge = gauge;
+    c.history.fill(0.0f);
+    return channelCount++;
+  }
+
+  uint32_t Find(const std::string &name) const {
+    for (uint32_t i = 0; i < channelCount; ++i)
+      if (channels[i].name == name)
+        return i;
+    return INVALID;
+  }
+
+  // Any thread, lock-free
+  void Record(uint32_t channel, double value) {
+    Push(channel, Op::Add, value);
+  }
+  void Set(uint32_t channel, double value) { Push(channel, Op::Set, value); }
+
+  // Records the scope's wall time in milliseconds
+  class Scope {
+  public:
+    Scope(Profiler &profiler, uint32_t channel)
+        : profiler(profiler), channel(channel),
+          start(std::chrono::steady_clock::now()) {}
+    ~Scope() {
+      std::chrono::duration<double, std::milli> ms =
+          std::chrono::steady_clock::now() - start;
+      profiler.Record(channel, ms.count());
+    }
+
+  private:
+    Profiler &profiler;
+    uint32_t channel;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // Main thread, once per frame: closes the frame's values
+  void EndFrame() {
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> frameMs = now - lastEndFrame;
+    lastEndFrame = now;
+
+    std::array<double, MAX_CHANNELS> sums{};
+    uint32_t threads = ringCount.load(std::memory_order_acquire);
+    for (uint32_t t = 0; t < threads; ++t) {
+      Event e;
+      while (rings[t]->events.TryPop(e)) {
+        if (e.channel >= channelCount)
+          continue;
+        if (e.op == Op::Set)
+          gaugeValues[e.channel] = e.value;
+        else
+          sums[e.channel] += e.value;
+      }
+    }
+    sums[FRAME] += frameMs.count();
+
+    for (uint32_t i = 0; i < channelCount; ++i) {
+      Channel &c = channels[i];
+      double v = c.gauge ? gaugeValues[i] : sums[i];
+      c.history[cursor] = float(v);
+    }
+    cursor = (cursor + 1) % HISTORY;
+    frames++;
+  }
+
+  uint32_t ChannelCount() const { return channelCount; }
+  const std::string &Name(uint32_t channel) const {
+    return channels[channel].name;
+  }
+  Kind GetKind(uint32_t channel) const { return channels[channel].kind; }
+  // Frames with values, up to HISTORY
+  uint32_t FramesRecorded() const {
+    return uint32_t(std::min<uint64_t>(frames, HISTORY));
+  }
+
+  // `age` 0 is the last closed frame
+  float Sample(uint32_t channel, uint32_t age) const {
+    if (age >= FramesRecorded())
+      return 0.0f;
+    return channels[channel].history[(cursor + HISTORY - 1 - age) % HISTORY];
+  }
+  float Latest(uint32_t channel) const { return Sample(channel, 0); }
+  float Average(uint32_t channel) const {
+    uint32_t n = FramesRecorded();
+    double sum = 0.0;
+    for (uint32_t i = 0; i < n; ++i)
+      sum += Sample(channel, i);
+    return n ? float(sum / n) : 0.0f;
+  }
+  float Max(uint32_t channel) const {
+    float m = 0.0f;
+    for (uint32_t i = 0; i < FramesRecorded(); ++i)
+      m = std::max(m, Sample(channel, i));
+    return m;
+  }
+
+  // Events lost to full rings or past MAX_THREADS threads
+  uint64_t DroppedEvents() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  enum class Op : uint32_t { Add, Set };
+  struct Event {
+    uint32_t channel = 0;
+    Op op = Op::Add;
+    double value = 0.0;
+  };
+  struct ThreadRing {
+    std::thread::id owner;
+    SPSCRing<Event, RING_EVENTS> events;
+  };
+  struct Channel {
+    std::string name;
+    Kind kind = Kind::Time;
+    bool gauge = false;
+    std::array<float, HISTORY> history{};
+  };
+
+  static uint64_t NextInstance() {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Push(uint32_t channel, Op op, double value) {
+    if (!enabled.load(std::memory_order_relaxed))
+      return;
+    ThreadRing *ring = LocalRing();
+    if (!ring || !ring->events.TryPush({channel, op, value}))
+      dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // The calling thread's ring; the mutex is only taken the first time a
+  // thread records into this profiler (or after switching profilers)
+  ThreadRing *LocalRing() {
+    struct Cache {
+      uint64_t instance = 0;
+      ThreadRing *ring = nullptr;
+    };
+    thread_local Cache cache;
+    if (cache.instance == instance)
+      return cache.ring;
+
+    std::lock_guard<std::mutex> lock(registerMutex);
+    std::thread::id self = std::this_thread::get_id();
+    uint32_t count = ringCount.load(std::memory_order_relaxed);
+    ThreadRing *ring = nullptr;
+    for (uint32_t t = 0; t < count && !ring; ++t)
+      if (rings[t]->owner == self)
+        ring = rings[t].get();
+    if (!ring && count < MAX_THREADS) {
+      rings[count] = std::make_unique<ThreadRing>();
+      rings[count]->owner = self;
+      ring = rings[count].get();
+      ringCount.store(count + 1, std::memory_order_release);
+    }
+    cache = {instance, ring};
+    return ring;
+  }
+
+  const uint64_t instance;
+  std::array<Channel, MAX_CHANNELS> channels;
+  uint32_t channelCount = 0;
+  std::array<double, MAX_CHANNELS> gaugeValues{};
+  uint32_t cursor = 0;
+  uint64_t frames = 0;
+  std::chrono::steady_clock::time_point lastEndFrame;
+
+  std::mutex registerMutex;
+  std::array<std::unique_ptr<ThreadRing>, MAX_THREADS> rings;
+  std::atomic<uint32_t> ringCount{0};
+  std::atomic<uint64_t> dropped{0};
+};
+
+// Per-worker JobSystem utilisation as "<prefix> N" percent gauges: busy
+// time each worker spent in jobs over the wall time since the last Sample
+class JobSystemSampler {
+public:
+  JobSystemSampler(Profiler &profiler, const Threading::JobSystem &jobs,
+                   const std::string &prefix = "Worker")
+      : profiler(profiler), jobs(jobs) {
+    for (unsigned int i = 0; i < jobs.ThreadCount(); ++i) {
+      channels.push_back(profiler.Register(prefix + " " + std::to_string(i),
+                                           Profiler::Kind::Percent, true));
+      lastBusy.push_back(jobs.WorkerBusyNs(i));
+    }
+    lastSample = std::chrono::steady_clock::now();
+  }
+
+  void Sample() {
+    auto now = std::chrono::steady_clock::now();
+    double wallNs = double(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastSample)
+            .count());
+    lastSample = now;
+    for (size_t i = 0; i < channels.size(); ++i) {
+      uint64_t busy = jobs.WorkerBusyNs(unsigned(i));
+      double pct = wallNs > 0.0 ? double(busy - lastBusy[i]) / wallNs * 100.0
+                                : 0.0;
+      lastBusy[i] = busy;
+      profiler.Set(channels[i], std::min(pct, 100.0));
+    }
+  }
+
+private:
+  Profiler &profiler;
+  const Threading::JobSystem &jobs;
+  std::vector<uint32_t> channels;
+  std::vector<uint64_t> lastBusy;
+  std::chrono::steady_clock::time_point lastSample;
+};
+
+} // namespace Profiling
+} // namespace Core
+} // namespace Mesozoic
@@ -7,6 +7,7 @@
 #include "../Threading/JobSystem.h"
 #include "EntityFactory.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
@@ -38,6 +39,37 @@ public:
   float timeOfDay = 12.0f; // 0-24 hours
   bool isNight = false;
 
+  // Wall time of the last Tick's phases in milliseconds. Only filled while
+  // profilePhases is set, since it costs a few clock reads per entity.
+  struct PhaseTimes {
+    double perception = 0.0; // Perception snapshot of live entities
+    double needs = 0.0;      // Need decay and AI decision
+    double vision = 0.0;     // Vision queries
+    double movement = 0.0;   // Action execution, damage, terrain snap
+    double smell = 0.0;      // Smell grid diffusion and death checks
+  };
+  bool profilePhases = false;
+  PhaseTimes phaseTimes;
+
+  // Heap bytes held by each subsystem
+  struct MemoryUsage {
+    size_t entities = 0;
+    size_t ai = 0;
+    size_t perception = 0;
+    size_t smell = 0;
+    size_t Total() const { return entities + ai + perception + smell; }
+  };
+  MemoryUsage Memory() const {
+    MemoryUsage m;
+    m.entities = entities.capacity() * sizeof(entities[0]);
+    m.ai = aiControllers.capacity() * sizeof(aiControllers[0]);
+    for (const auto &ai : aiControllers)
+      m.ai += ai.needs.capacity() * sizeof(ai.needs[0]);
+    m.perception = perceptionData.capacity() * sizeof(perceptionData[0]);
+    m.smell = smellGrid.MemoryBytes();
+    return m;
+  }
+
   // Water source positions
   std::vector<std::array<float, 3>> waterSources = {
       {0.0f, 0.0f, 0.0f}, {50.0f, 0.0f, 50.0f}, {-50.0f, 0.0f, -30.0f}};
@@ -125,8 +157,20 @@ public:
       timeOfDay -= 24.0f;
     isNight = (timeOfDay < 6.0f || timeOfDay > 20.0f);
 
+    // Phase timer: lap(x) charges the time since the previous lap to x
+    PhaseTimes times;
+    auto last = std::chrono::steady_clock::now();
+    auto lap = [&](double &to) {
+      if (!profilePhases)
+        return;
+      auto now = std::chrono::steady_clock::now();
+      to += std::chrono::duration<double, std::milli>(now - last).count();
+      last = now;
+    };
+
     // Build perception data
-    auto perceptionData = BuildPerceptionData();
+    BuildPerceptionData();
+    lap(times.perception);
 
     // Update each entity
     for (size_t i = 0; i < entities.size(); ++i) {
@@ -143,6 +187,7 @@ public:
       e.vitals.thirst = ai.GetNeedValue("Thirst") * 100.0f;
       e.vitals.energy = ai.GetNeedValue("Energy") * 100.0f;
       e.vitals.age += dt;
+      lap(times.needs);
 
       // 2. Vision: detect threats and food
       Perception::VisionSystem vision(sp.isPredator ? 55.0f : 160.0f, 80.0f);
@@ -172,6 +217,7 @@ public:
       }
       if (!threatVisible)
         ai.SetSafety(1.0f);
+      lap(times.vision);
 
       // 3. Check water proximity
       bool waterNearby = false;
@@ -186,6 +232,7 @@ public:
 
       // 4. AI Decision
       auto decision = ai.DecideAction(threatVisible, foodVisible, waterNearby);
+      lap(times.needs);
 
       // 5. Execute action
       float speed = sp.baseSpeed * e.genetics.speedMultiplier;
@@ -314,6 +361,7 @@ public:
       } else {
         e.transform.position[1] = 0.0f;
       }
+      lap(times.movement);
     }
 
     // Update smell grid
@@ -321,6 +369,9 @@ public:
 
     // Check deaths
     CheckDeaths();
+    lap(times.smell);
+    if (profilePhases)
+      phaseTimes = times;
   }
 
   // Print simulation status
@@ -374,8 +425,12 @@ public:
   }
 
 private:
-  std::vector<Perception::EntityPerceptionData> BuildPerceptionData() const {
-    std::vector<Perception::EntityPerceptionData> data;
+  // Rebuilt every tick; kept as a member so its buffer is reused
+  std::vector<Perception::EntityPerceptionData> perceptionData;
+
+  void BuildPerceptionData() {
+    auto &data = perceptionData;
+    data.clear();
     for (const auto &e : entities) {
       if (!e.vitals.alive)
         continue;
@@ -387,7 +442,6 @@ private:
       pd.stealthFactor = 0.0f;
       data.push_back(pd);
     }
-    return data;
   }
 
   void CheckDeaths() {
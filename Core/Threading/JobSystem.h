@@ -1,8 +1,10 @@
 #pragma once
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -19,12 +21,17 @@ struct Job {
 
 class JobSystem {
 public:
-  JobSystem() : stop(false), activeJobs(0) {
-    unsigned int numThreads = std::thread::hardware_concurrency();
+  // One worker per hardware thread
+  JobSystem() : JobSystem(std::thread::hardware_concurrency()) {}
+
+  // A fixed worker count, for pools that should not compete with the main
+  // one for every core (0 picks 2)
+  explicit JobSystem(unsigned int numThreads) : stop(false), activeJobs(0) {
     if (numThreads == 0)
       numThreads = 2;
+    workerStats = std::make_unique<WorkerStats[]>(numThreads);
     for (unsigned int i = 0; i < numThreads; ++i) {
-      workers.emplace_back([this] {
+      workers.emplace_back([this, i] {
         while (true) {
           std::function<void()> task;
           {
@@ -36,7 +43,14 @@ public:
             task = std::move(this->jobs.front());
             this->jobs.pop();
           }
+          auto start = std::chrono::steady_clock::now();
           task();
+          auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start);
+          WorkerStats &ws = workerStats[i];
+          ws.busyNs.fetch_add(uint64_t(busy.count()),
+                              std::memory_order_relaxed);
+          ws.jobsRun.fetch_add(1, std::memory_order_relaxed);
           {
             std::unique_lock<std::mutex> lock(completionMutex);
             activeJobs--;
@@ -97,7 +111,22 @@ public:
     return static_cast<unsigned int>(workers.size());
   }
 
+  // Time worker `i` has spent running jobs and how many it ran, since
+  // construction. Relaxed counters: sample twice and diff for utilisation.
+  uint64_t WorkerBusyNs(unsigned int i) const {
+    return workerStats[i].busyNs.load(std::memory_order_relaxed);
+  }
+  uint64_t WorkerJobsRun(unsigned int i) const {
+    return workerStats[i].jobsRun.load(std::memory_order_relaxed);
+  }
+
 private:
+  // One cache line per worker so the counters do not false-share
+  struct alignas(64) WorkerStats {
+    std::atomic<uint64_t> busyNs{0};
+    std::atomic<uint64_t> jobsRun{0};
+  };
+
   std::vector<std::thread> workers;
   std::queue<std::function<void()>> jobs;
 
@@ -109,6 +138,8 @@ private:
   std::mutex completionMutex;
   std::condition_variable completionCV;
   int activeJobs;
+
+  std::unique_ptr<WorkerStats[]> workerStats;
 };
 
 } // namespace Threading
@@ -1,18 +1,24 @@
+#include "../Assets/AssetPak.h"
+#include "../Assets/AssetStreamer.h"
 #include "../Assets/GLTFLoader.h"
 #include "../Assets/MorphTargetExtractor.h"
 #include "../Assets/TextureLoader.h"
+#include "../Core/Profiling/Profiler.h"
 #include "../Core/Simulation/SimulationManager.h"
+#include "../Graphics/MorphDeltaCodec.h"
 #include "../Graphics/Renderer.h"
 #include "../Graphics/TerrainGenerator.h"
 #include "../Graphics/TerrainSystem.h"
 #include "../Graphics/UI/UISystem.h"
 #include "../Graphics/Window.h"
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <glm/glm.hpp> // Ensure GLM is included for vec3 math
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <thread>
 
@@ -58,6 +64,15 @@ int main() {
   terrainSystem.Initialize(&renderer, 512, 512, 3.0f, 50.0f);
   renderer.terrainSystem = &terrainSystem;
 
+  // Grass density tiles (baked from the terrain splat/height maps)
+  GrassSystem grassSystem;
+  grassSystem.BuildTiles(terrainSystem.heightMap, terrainSystem.splatMap,
+                         terrainSystem.width, terrainSystem.depth,
+                         terrainSystem.scale);
+  grassSystem.InitializeGPU(&backend);
+  terrainSystem.grassSystem = &grassSystem;
+  renderer.grassSystem = &grassSystem;
+
   // Initialize UI System (needs Backend & Window)
   UISystem uiSystem;
   uiSystem.Initialize(&backend, &window);
@@ -89,19 +104,39 @@ int main() {
   sim.SpawnDinosaur(Species::Brachiosaurus);
 
   // 3. Meshes
-  auto gltfDino = Assets::GLTFLoader::CreateDinosaurPlaceholder(6.0f, 3.0f);
-  UberMesh dinoMesh;
-  for (const auto &vert : gltfDino.primitives[0].vertices) {
-    Vertex v;
-    v.position = {vert.position.x, vert.position.y, vert.position.z};
-    v.normal = {vert.normal.x, vert.normal.y, vert.normal.z};
-    v.uv = {vert.uv[0], vert.uv[1]};
-    v.boneIndices = {0, 0, 0, 0};
-    v.boneWeights = {1, 0, 0, 0};
-    dinoMesh.baseVertices.push_back(v);
+  // Mesozoic.mpak (cooked by MesozoicCook --builtin) holds GPU-ready
+  // vertices and packed morphs; without it everything is generated here.
+  AssetPak pak;
+  bool usePak = pak.Open("Mesozoic.mpak");
+  auto cookMesh = [&](const char *name, auto generate) {
+    UberMesh mesh;
+    if (!usePak || !pak.LoadMesh(name, mesh))
+      mesh = PakCook::ToUberMesh(generate().primitives[0]);
+    return mesh;
+  };
+
+  // Species meshes stream in on worker threads once a dinosaur of that
+  // species exists (a cooked "<species>" mesh, else the shared dinosaur).
+  // Loads are mostly I/O and decode, so two workers keep them moving
+  // without doubling the thread count next to the sim's per-core pool.
+  Threading::JobSystem streamingJobs(2);
+  AssetStreamer streamer(streamingJobs);
+  constexpr size_t kSpeciesCount = static_cast<size_t>(Species::COUNT);
+  std::array<AssetStreamer::Handle, kSpeciesCount> speciesMesh;
+  std::array<bool, kSpeciesCount> speciesAcquired{};
+  for (size_t s = 0; s < kSpeciesCount; ++s) {
+    std::string name = GetSpeciesData(static_cast<Species>(s)).name;
+    speciesMesh[s] = streamer.Register(
+        name, AssetKind::Mesh, [&pak, usePak, name](AssetPayload &out) {
+          if (usePak && (pak.LoadMesh(name, out.mesh) ||
+                         pak.LoadMesh("Dinosaur", out.mesh)))
+            return true;
+          out.mesh = PakCook::ToUberMesh(
+              Assets::GLTFLoader::CreateDinosaurPlaceholder(6.0f, 3.0f)
+                  .primitives[0]);
+          return true;
+        });
   }
-  dinoMesh.indices = gltfDino.primitives[0].indices;
-  uint32_t dinoMeshId = renderer.RegisterMesh(dinoMesh);
 
   UberMesh terrainMesh = TerrainGenerator::GenerateGrid(
       terrainSystem.width, terrainSystem.depth, terrainSystem.scale);
@@ -122,16 +157,8 @@ int main() {
                      4, 0, 3, 3, 7, 4, 4, 5, 1, 1, 0, 4, 3, 2, 6, 6, 7, 3};
   uint32_t skyMeshId = renderer.RegisterMesh(skyMesh);
 
-  auto grassGltf = Assets::GLTFLoader::CreateGrassMesh(1.5f);
-  UberMesh grassMesh;
-  for (auto &v : grassGltf.primitives[0].vertices) {
-    Vertex vert;
-    vert.position = {v.position.x, v.position.y, v.position.z};
-    vert.normal = {v.normal.x, v.normal.y, v.normal.z};
-    vert.uv = {v.uv[0], v.uv[1]};
-    grassMesh.baseVertices.push_back(vert);
-  }
-  grassMesh.indices = grassGltf.primitives[0].indices;
+  UberMesh grassMesh = cookMesh(
+      "Grass", [] { return Assets::GLTFLoader::CreateGrassMesh(1.5f); });
   uint32_t grassMeshId = renderer.RegisterMesh(grassMesh);
 
   // --- EDITOR STATE ---
@@ -142,61 +169,39 @@ int main() {
   bool isFlattenTargetSet = false;
 
   // --- MORPH SYSTEM SETUP ---
-  // Generate Procedural Morphs for Dino
-  auto morphSet =
-      Assets::MorphTargetExtractor::GenerateDinosaurMorphs(gltfDino);
-
-  // Flatten for GPU (Target_Snout, Target_Bulk, Target_Horn)
-  struct ShaderMorphDelta {
-    float p[4];
-    float n[4];
-  };
-  std::vector<ShaderMorphDelta> morphData;
-  size_t dinoVertCount = dinoMesh.baseVertices.size();
-  morphData.resize(dinoVertCount * 3);
-
-  // Helper to copy
-  auto CopyTargetToBuffer = [&](const std::string &name, int targetIndex) {
-    for (const auto &t : morphSet.targets) {
-      if (t.name == name) {
-        for (size_t i = 0; i < dinoVertCount && i < t.positionDeltas.size();
-             ++i) {
-          size_t dstIdx = targetIndex * dinoVertCount + i;
-          morphData[dstIdx].p[0] = t.positionDeltas[i].x;
-          morphData[dstIdx].p[1] = t.positionDeltas[i].y;
-          morphData[dstIdx].p[2] = t.positionDeltas[i].z;
-          morphData[dstIdx].p[3] = 0.0f; // Padding
-
-          if (i < t.normalDeltas.size()) {
-            morphData[dstIdx].n[0] = t.normalDeltas[i].x;
-            morphData[dstIdx].n[1] = t.normalDeltas[i].y;
-            morphData[dstIdx].n[2] = t.normalDeltas[i].z;
-            morphData[dstIdx].n[3] = 0.0f;
-          }
-        }
-        std::cout << "[Main] Bound Morph Target: " << name << " to index "
-                  << targetIndex << std::endl;
-        return;
-      }
+  // Pack every DNA target for the GPU (12 bytes per vertex per target). The
+  // slider-driven targets take slots 0-2 (Target_Snout, Target_Bulk,
+  // Target_Horn), which is where the vertex shader looks for them.
+  const std::vector<std::string> sliderTargets = {
+      "Target_Snout", "Target_Bulk", "Target_Horn"};
+  PackedMorphBuffer packedMorphs;
+  if (!usePak || !pak.LoadMorphs("Dinosaur", packedMorphs)) {
+    auto gltfDino = Assets::GLTFLoader::CreateDinosaurPlaceholder(6.0f, 3.0f);
+    auto morphSet =
+        Assets::MorphTargetExtractor::GenerateDinosaurMorphs(gltfDino);
+    packedMorphs = MorphDeltaCodec::Encode(morphSet, sliderTargets);
+  }
+  // Encode() drops missing names, so a later target would slide into the
+  // slot; only report a slot as bound when it holds the expected target
+  for (size_t slot = 0; slot < sliderTargets.size(); ++slot) {
+    if (slot < packedMorphs.names.size() &&
+        packedMorphs.names[slot] == sliderTargets[slot]) {
+      std::cout << "[Main] Bound Morph Target: " << packedMorphs.names[slot]
+                << " to index " << slot << std::endl;
+    } else {
+      std::cerr << "[Main] Warning: Morph Target '" << sliderTargets[slot]
+                << "' not found!" << std::endl;
     }
-    std::cerr << "[Main] Warning: Morph Target '" << name << "' not found!"
-              << std::endl;
-  };
-
-  CopyTargetToBuffer("Target_Snout", 0);
-  CopyTargetToBuffer("Target_Bulk", 1);
-  CopyTargetToBuffer("Target_Horn", 2);
+  }
 
   // Upload to SSBO
-  GPUBuffer morphBuffer =
-      backend.CreateBuffer(morphData.size() * sizeof(ShaderMorphDelta),
-                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  GPUBuffer morphBuffer = backend.CreateBuffer(
+      packedMorphs.GPUSizeBytes(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
   if (morphBuffer.mapped) {
-    memcpy(morphBuffer.mapped, morphData.data(),
-           morphData.size() * sizeof(ShaderMorphDelta));
+    packedMorphs.WriteGPU(morphBuffer.mapped);
   }
 
   // Update Global Descriptors (Terrain + Morph)
@@ -208,6 +213,54 @@ int main() {
   float wBulk = 0.0f;
   float wHorn = 0.0f;
 
+  // --- PROFILER ---
+  // Channels shown by the perf HUD (F3). Times are recorded with scopes in
+  // the loop; counters and memory are gauges set once per frame.
+  using ProfKind = Profiling::Profiler::Kind;
+  Profiling::Profiler profiler;
+  const uint32_t profSim = profiler.Register("Sim tick", ProfKind::Time);
+  // Sim tick phases, copied from sim.phaseTimes after each tick
+  const uint32_t profSimPerception =
+      profiler.Register("Sim perception", ProfKind::Time);
+  const uint32_t profSimNeeds =
+      profiler.Register("Sim needs/AI", ProfKind::Time);
+  const uint32_t profSimVision =
+      profiler.Register("Sim vision", ProfKind::Time);
+  const uint32_t profSimMove =
+      profiler.Register("Sim movement", ProfKind::Time);
+  const uint32_t profSimSmell = profiler.Register("Sim smell", ProfKind::Time);
+  sim.profilePhases = true;
+  const uint32_t profStream = profiler.Register("Streaming", ProfKind::Time);
+  const uint32_t profRender = profiler.Register("Render", ProfKind::Time);
+  const uint32_t profDraws =
+      profiler.Register("Draw calls", ProfKind::Count, true);
+  const uint32_t profTris =
+      profiler.Register("Triangles", ProfKind::Count, true);
+  const uint32_t profInstances =
+      profiler.Register("Instances", ProfKind::Count, true);
+  const uint32_t profUIBatches =
+      profiler.Register("UI batches", ProfKind::Count, true);
+  const uint32_t profEntities =
+      profiler.Register("Entities", ProfKind::Count, true);
+  const uint32_t profSimMem =
+      profiler.Register("Sim memory", ProfKind::Bytes, true);
+  const uint32_t profEntityMem =
+      profiler.Register("Entity memory", ProfKind::Bytes, true);
+  const uint32_t profAIMem =
+      profiler.Register("AI memory", ProfKind::Bytes, true);
+  const uint32_t profPerceptionMem =
+      profiler.Register("Perception memory", ProfKind::Bytes, true);
+  const uint32_t profSmellMem =
+      profiler.Register("Smell grid", ProfKind::Bytes, true);
+  const uint32_t profMeshMem =
+      profiler.Register("Mesh cache", ProfKind::Bytes, true);
+  const uint32_t profUIMem =
+      profiler.Register("UI atlas", ProfKind::Bytes, true);
+  Profiling::JobSystemSampler simWorkers(profiler, sim.jobSystem, "Job");
+  Profiling::JobSystemSampler ioWorkers(profiler, streamingJobs, "IO");
+  PerfHUD perfHUD;
+  bool perfKeyWasDown = false;
+
   // --- MAIN LOOP ---
   GameState currentState = GameState::MENU;
   window.SetCursorLocked(false);
@@ -225,6 +278,11 @@ int main() {
 
     window.PollEvents();
 
+    bool perfKeyDown = window.IsKeyPressed(114); // F3
+    if (perfKeyDown && !perfKeyWasDown)
+      perfHUD.Toggle();
+    perfKeyWasDown = perfKeyDown;
+
     if (window.IsKeyPressed(27)) { // ESC
       if (currentState == GameState::PLAYING ||
           currentState == GameState::EDITOR) {
@@ -276,7 +334,15 @@ int main() {
 
       // 1. Simulation Tick
       if (!renderer.isDayCyclePaused) {
-        sim.Tick(dt);
+        {
+          Profiling::Profiler::Scope scope(profiler, profSim);
+          sim.Tick(dt);
+        }
+        profiler.Record(profSimPerception, sim.phaseTimes.perception);
+        profiler.Record(profSimNeeds, sim.phaseTimes.needs);
+        profiler.Record(profSimVision, sim.phaseTimes.vision);
+        profiler.Record(profSimMove, sim.phaseTimes.movement);
+        profiler.Record(profSimSmell, sim.phaseTimes.smell);
       }
 
       bool canMoveCamera = (currentState == GameState::PLAYING) ||
@@ -376,6 +442,42 @@ int main() {
         }
       }
 
+      // --- ASSET STREAMING ---
+      // Nearest dinosaur of each species sets its mesh's load priority;
+      // species that died out release their mesh to the LRU cache
+      std::array<float, kSpeciesCount> nearest;
+      nearest.fill(std::numeric_limits<float>::max());
+      for (const auto &dino : sim.entities) {
+        if (!dino.vitals.alive)
+          continue;
+        float dx = dino.transform.position[0] - renderer.camera.position.x;
+        float dy = dino.transform.position[1] - renderer.camera.position.y;
+        float dz = dino.transform.position[2] - renderer.camera.position.z;
+        float &n = nearest[static_cast<size_t>(dino.species)];
+        n = std::min(n, std::sqrt(dx * dx + dy * dy + dz * dz));
+      }
+      for (size_t s = 0; s < kSpeciesCount; ++s) {
+        bool present = nearest[s] < std::numeric_limits<float>::max();
+        if (present && !speciesAcquired[s]) {
+          streamer.Acquire(speciesMesh[s], nearest[s]);
+        } else if (present) {
+          streamer.SetPriority(speciesMesh[s], nearest[s]);
+        } else if (speciesAcquired[s]) {
+          streamer.Release(speciesMesh[s]);
+        }
+        speciesAcquired[s] = present;
+      }
+      {
+        Profiling::Profiler::Scope scope(profiler, profStream);
+        streamer.Update(
+            [&](const std::string &, const AssetPayload &asset) {
+              return renderer.RegisterMesh(asset.mesh);
+            },
+            [&](const std::string &, uint32_t meshId) {
+              renderer.UnregisterMesh(meshId);
+            });
+      }
+
       // --- RENDER SUBMISSION ---
       Matrix4 skyModel = Matrix4::Identity();
       skyModel.m[12] = renderer.camera.position.x;
@@ -408,7 +510,10 @@ int main() {
         m.m[13] = dino.transform.position[1];
         m.m[14] = dino.transform.position[2];
         obj.worldTransform = m.m;
-        obj.meshIndex = dinoMeshId;
+        obj.meshIndex =
+            streamer.GpuId(speciesMesh[static_cast<size_t>(dino.species)]);
+        if (obj.meshIndex == AssetStreamer::INVALID_GPU_ID)
+          continue; // Still streaming
         obj.color = (dino.species == Species::TRex)
                         ? std::array<float, 4>{0.8f, 0.3f, 0.2f, 1}
                         : std::array<float, 4>{0.2f, 0.7f, 0.3f, 1};
@@ -563,7 +668,28 @@ int main() {
         renderer.camera.nearPlane, renderer.camera.farPlane);
     renderer.camera.projMatrix = proj.m;
 
-    renderer.RenderFrame(dt);
+    uiSystem.DrawPerfHUD(perfHUD, profiler);
+    {
+      Profiling::Profiler::Scope scope(profiler, profRender);
+      renderer.RenderFrame(dt);
+    }
+
+    profiler.Set(profDraws, renderer.drawCallsThisFrame);
+    profiler.Set(profTris, renderer.trianglesThisFrame);
+    profiler.Set(profInstances, renderer.instancesThisFrame);
+    profiler.Set(profUIBatches, uiSystem.batchesLastFrame);
+    profiler.Set(profEntities, double(sim.entities.size()));
+    const auto simMem = sim.Memory();
+    profiler.Set(profSimMem, double(simMem.Total()));
+    profiler.Set(profEntityMem, double(simMem.entities));
+    profiler.Set(profAIMem, double(simMem.ai));
+    profiler.Set(profPerceptionMem, double(simMem.perception));
+    profiler.Set(profSmellMem, double(simMem.smell));
+    profiler.Set(profMeshMem, double(streamer.ResidentBytes()));
+    profiler.Set(profUIMem, double(uiSystem.atlas.Pixels().size()));
+    simWorkers.Sample();
+    ioWorkers.Sample();
+    profiler.EndFrame();
 
     frameCount++;
     fpsTimer += dt;
@@ -579,6 +705,9 @@ int main() {
   }
 
   renderer.Cleanup();
+  grassSystem.Cleanup();
+  backend.DestroyTexture(whiteTex);
+  uiSystem.Cleanup();
   backend.Cleanup();
   window.Cleanup();
   return 0;
@@ -0,0 +1,405 @@
+#pragma once
+#include "../Core/Math/Vec3.h"
+#include "ParkManager.h"
+#include "VisitorAI.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace Mesozoic {
+namespace Gameplay {
+
+using Math::Vec3;
+
+// =========================================================================
+// Crowd Field
+// =========================================================================
+// Continuum view of the crowd on a flat x/z grid: people per square metre
+// and their mean velocity per cell. Visitors are splatted once per tick,
+// so every query is a cell read rather than a pass over nearby visitors.
+// Positions outside the grid are not counted.
+
+class CrowdField {
+public:
+  CrowdField(float originX = -512.0f, float originZ = -512.0f,
+             int cellsX = 256, int cellsZ = 256, float cellSize = 4.0f)
+      : originX(originX), originZ(originZ), cellsX(cellsX), cellsZ(cellsZ),
+        cellSize(cellSize) {
+    cells.assign(size_t(cellsX) * size_t(cellsZ), Cell{});
+  }
+
+  void Clear() { std::fill(cells.begin(), cells.end(), Cell{}); }
+
+  // One person at `p` moving with `velocity`; call Resolve() when done
+  void Splat(const Vec3 &p, const Vec3 &velocity) {
+    int c = CellIndex(p);
+    if (c < 0)
+      return;
+    cells[c].density += 1.0f;
+    cells[c].velX += velocity.x;
+    cells[c].velZ += velocity.z;
+  }
+
+  // Turns splatted counts into densities and velocity sums into means
+  void Resolve() {
+    const float invArea = 1.0f / (cellSize * cellSize);
+    for (Cell &c : cells) {
+      float count = c.density;
+      if (count == 0.0f)
+        continue;
+      c.velX /= count;
+      c.velZ /= count;
+      c.density = count * invArea;
+    }
+  }
+
+  float Density(const Vec3 &p) const {
+    int c = CellIndex(p);
+    return c < 0 ? 0.0f : cells[c].density;
+  }
+
+  // Mean crowd velocity at `p` (y is always 0)
+  Vec3 Velocity(const Vec3 &p) const {
+    int c = CellIndex(p);
+    return c < 0 ? Vec3(0, 0, 0) : Vec3(cells[c].velX, 0.0f, cells[c].velZ);
+  }
+
+  // Mean density over `samples` evenly spaced points from a to b
+  float PathDensity(const Vec3 &a, const Vec3 &b, int samples = 8) const {
+    float sum = 0.0f;
+    for (int k = 0; k < samples; ++k) {
+      float t = (float(k) + 0.5f) / float(samples);
+      sum += Density(a + (b - a) * t);
+    }
+    return sum / float(samples);
+  }
+
+  float CellSize() const { return cellSize; }
+  size_t CellCount() const { return cells.size(); }
+
+private:
+  // Interleaved: a visitor's splat and lookups touch one cache line
+  struct Cell {
+    float density = 0.0f; // Count while splatting, then people per m²
+    float velX = 0.0f, velZ = 0.0f;
+  };
+
+  int CellIndex(const Vec3 &p) const {
+    float fx = std::floor((p.x - originX) / cellSize);
+    float fz = std::floor((p.z - originZ) / cellSize);
+    if (!(fx >= 0.0f && fx < float(cellsX) && fz >= 0.0f &&
+          fz < float(cellsZ)))
+      return -1;
+    return int(fz) * cellsX + int(fx);
+  }
+
+  float originX, originZ;
+  int cellsX, cellsZ;
+  float cellSize;
+  std::vector<Cell> cells;
+};
+
+// =========================================================================
+// Crowd System
+// =========================================================================
+// Sends visitors to the guest facilities their current action calls for,
+// slows them down in dense crowds and queues them at the door. Each tick
+// is three linear passes: splat the field, steer every visitor, serve
+// every queue. Nothing compares visitors pairwise, so the cost grows with
+// visitors + grid cells + facilities.
+//
+//   crowd.SyncBuildings(park.GetBuildings());    // after building changes
+//   visitors.Update(dt, rating, escaped);        // needs, actions, walking
+//   crowd.Update(visitors.Store(), dt);          // routing and queues
+//   economy.Earn(crowd.CollectRevenue(), TransactionType::FoodSales);
+
+class CrowdSystem {
+public:
+  // A guest building with a FIFO queue. Throughput is `capacity` guests
+  // per ServiceSeconds(type), so bigger buildings clear queues faster.
+  struct Facility {
+    uint32_t buildingId;
+    BuildingType type;
+    Vec3 position;
+    float serviceRate = 0.0f;  // Guests per second
+    float price = 0.0f;        // Building::revenue, billed per guest served
+    float satisfaction = 0.0f; // Building::satisfaction
+    std::deque<uint32_t> queue; // Visitor ids, front is served next
+    uint32_t waiting = 0;       // Queued visitors still in the park
+    uint32_t enRoute = 0;       // Visitors walking here
+    float credit = 0.0f;        // Fractional services carried over
+    float pendingRevenue = 0.0f;
+    uint64_t served = 0;
+  };
+
+  // Continuum-crowd speed model: visitors walk freely below densityMin
+  // people/m² and at the local flow speed above densityMax
+  float densityMin = 0.5f;
+  float densityMax = 2.5f;
+  float minPace = 0.1f;
+  float arriveRadius = 3.0f;
+  // Seconds added to a route per person/m² of mean density along it
+  float congestionCost = 60.0f;
+  Vec3 exit = Vec3(0, 0, -200); // Where leaving visitors go
+
+  explicit CrowdSystem(CrowdField field = CrowdField())
+      : field(std::move(field)) {}
+
+  static float ServiceSeconds(BuildingType type) {
+    switch (type) {
+    case BuildingType::VisitorCenter: return 600.0f;
+    case BuildingType::Restaurant: return 900.0f;
+    case BuildingType::GiftShop: return 300.0f;
+    case BuildingType::Restroom: return 120.0f;
+    case BuildingType::ViewingPlatform: return 600.0f;
+    default: return 0.0f; // Not open to guests
+    }
+  }
+
+  static bool Serves(BuildingType type, VisitorAction action) {
+    switch (action) {
+    case VisitorAction::Eating: return type == BuildingType::Restaurant;
+    case VisitorAction::Shopping: return type == BuildingType::GiftShop;
+    case VisitorAction::Resting:
+      return type == BuildingType::VisitorCenter ||
+             type == BuildingType::Restroom;
+    case VisitorAction::WatchingDinos:
+      return type == BuildingType::ViewingPlatform;
+    default: return false;
+    }
+  }
+
+  // Mirrors the park's operational guest buildings. Queues of buildings
+  // that stay open are kept; visitors bound for closed ones re-route.
+  void SyncBuildings(const std::vector<Building> &buildings) {
+    std::vector<Facility> next;
+    for (const auto &b : buildings) {
+      float seconds = ServiceSeconds(b.type);
+      if (!b.operational || seconds == 0.0f || b.capacity <= 0.0f)
+        continue;
+      Facility *old = Find(b.id);
+      Facility f = old ? std::move(*old) : Facility{};
+      f.buildingId = b.id;
+      f.type = b.type;
+      f.position = b.position;
+      f.serviceRate = b.capacity / seconds;
+      f.price = b.revenue;
+      f.satisfaction = b.satisfaction;
+      next.push_back(std::move(f));
+    }
+    facilities = std::move(next);
+    facilityOf.clear();
+    for (uint32_t k = 0; k < facilities.size(); ++k) {
+      uint32_t id = facilities[k].buildingId;
+      if (id >= facilityOf.size())
+        facilityOf.resize(size_t(id) + 1, NONE);
+      facilityOf[id] = k;
+    }
+    for (size_t a = 0; a < servedBy.size(); ++a) {
+      servedBy[a].clear();
+      for (uint32_t k = 0; k < facilities.size(); ++k)
+        if (Serves(facilities[k].type, VisitorAction(a)))
+          servedBy[a].push_back(k);
+    }
+  }
+
+  void Update(VisitorStore &visitors, float dt) {
+    const size_t n = visitors.Size();
+
+    // Pass 1: splat the field and recount who is heading where
+    field.Clear();
+    for (auto &f : facilities)
+      f.waiting = f.enRoute = 0;
+    for (size_t i = 0; i < n; ++i) {
+      Vec3 p(visitors.posX[i], visitors.posY[i], visitors.posZ[i]);
+      Vec3 v(0, 0, 0);
+      if (visitors.walking[i]) {
+        Vec3 dir = Heading(visitors, i);
+        v = dir * (visitors.speed[i] * visitors.pace[i]);
+      }
+      field.Splat(p, v);
+      if (Facility *f = Find(visitors.destination[i]))
+        (visitors.queued[i] ? f->waiting : f->enRoute)++;
+    }
+    field.Resolve();
+
+    // Pass 2: route, arrive and set each walker's pace
+    for (size_t i = 0; i < n; ++i) {
+      Vec3 p(visitors.posX[i], visitors.posY[i], visitors.posZ[i]);
+      VisitorAction action = visitors.action[i];
+      Facility *f = Find(visitors.destination[i]);
+      if (!f) { // Never chosen, or closed along with its queue
+        visitors.destination[i] = Visitor::NO_DESTINATION;
+        visitors.queued[i] = 0;
+      }
+
+      if (action == VisitorAction::Fleeing) {
+        if (f) // PanicSystem steers them out
+          Abandon(visitors, i, *f);
+      } else if (action == VisitorAction::Leaving) {
+        if (f)
+          Abandon(visitors, i, *f);
+        if (visitors.targetX[i] != exit.x || visitors.targetY[i] != exit.y ||
+            visitors.targetZ[i] != exit.z)
+          SetTarget(visitors, i, exit);
+      } else if (!f) {
+        if (Facility *best = Choose(visitors, i, p)) {
+          visitors.destination[i] = best->buildingId;
+          best->enRoute++;
+          SetTarget(visitors, i, best->position);
+        }
+      } else if (!visitors.queued[i] &&
+                 (p - f->position).LengthSq() <=
+                     arriveRadius * arriveRadius) {
+        visitors.queued[i] = 1;
+        f->queue.push_back(visitors.ids[i]);
+        f->enRoute--;
+        f->waiting++;
+      }
+
+      visitors.pace[i] = visitors.walking[i] ? Pace(visitors, i, p) : 1.0f;
+    }
+
+    // Pass 3: serve queues at each facility's rate
+    for (auto &fac : facilities) {
+      fac.credit += fac.serviceRate * dt;
+      while (!fac.queue.empty()) {
+        size_t row = visitors.Find(fac.queue.front());
+        if (row != visitors.Size()) {
+          if (fac.credit < 1.0f)
+            break;
+          Serve(visitors, row, fac);
+          fac.credit -= 1.0f;
+        }
+        fac.queue.pop_front(); // Served, or left the park while queueing
+      }
+      if (fac.queue.empty())
+        fac.credit = std::min(fac.credit, 1.0f);
+    }
+  }
+
+  // Revenue billed since the last call
+  float CollectRevenue() {
+    float total = 0.0f;
+    for (auto &f : facilities) {
+      total += f.pendingRevenue;
+      f.pendingRevenue = 0.0f;
+    }
+    return total;
+  }
+
+  const std::vector<Facility> &Facilities() const { return facilities; }
+  const Facility *GetFacility(uint32_t buildingId) const {
+    return const_cast<CrowdSystem *>(this)->Find(buildingId);
+  }
+  const CrowdField &Field() const { return field; }
+
+private:
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+  // Building ids are handed out sequentially, so a dense table beats a
+  // hash map for the two lookups every visitor makes each tick
+  Facility *Find(uint32_t buildingId) {
+    if (buildingId >= facilityOf.size() || facilityOf[buildingId] == NONE)
+      return nullptr;
+    return &facilities[facilityOf[buildingId]];
+  }
+
+  static Vec3 Heading(const VisitorStore &v, size_t i) {
+    Vec3 d(v.targetX[i] - v.posX[i], 0.0f, v.targetZ[i] - v.posZ[i]);
+    float len = d.Length();
+    return len > 0.0f ? d * (1.0f / len) : Vec3(0, 0, 0);
+  }
+
+  static void SetTarget(VisitorStore &v, size_t i, const Vec3 &target) {
+    v.targetX[i] = target.x;
+    v.targetY[i] = target.y;
+    v.targetZ[i] = target.z;
+    v.walking[i] = 1;
+  }
+
+  // Cheapest facility for the visitor's action: walking time, expected
+  // wait behind everyone queued or already on the way, and crowding
+  Facility *Choose(const VisitorStore &v, size_t i, const Vec3 &p) {
+    Facility *best = nullptr;
+    float bestCost = 0.0f;
+    const float speed = std::max(v.speed[i], 0.1f);
+    for (uint32_t k : servedBy[size_t(v.action[i])]) {
+      Facility &f = facilities[k];
+      float walk = (f.position - p).Length() / speed;
+      float wait = float(f.waiting + f.enRoute) / f.serviceRate;
+      float crowd = field.PathDensity(p, f.position) * congestionCost;
+      float cost = walk + wait + crowd;
+      if (!best || cost < bestCost) {
+        best = &f;
+        bestCost = cost;
+      }
+    }
+    return best;
+  }
+
+  // Blends free walking into the local flow speed as density rises, so
+  // walking against a dense crowd is slow and walking with it is not
+  float Pace(const VisitorStore &v, size_t i, const Vec3 &p) const {
+    float t = (field.Density(p) - densityMin) / (densityMax - densityMin);
+    if (t <= 0.0f)
+      return 1.0f;
+    t = std::min(t, 1.0f);
+    float speed = std::max(v.speed[i], 0.1f);
+    float flow = field.Velocity(p).Dot(Heading(v, i));
+    flow = std::clamp(flow, minPace * speed, speed);
+    return (speed + (flow - speed) * t) / speed;
+  }
+
+  void Abandon(VisitorStore &v, size_t i, Facility &f) {
+    if (v.queued[i]) {
+      std::erase(f.queue, v.ids[i]);
+      f.waiting--;
+    } else {
+      f.enRoute--;
+    }
+    v.queued[i] = 0;
+    v.destination[i] = Visitor::NO_DESTINATION;
+  }
+
+  void Serve(VisitorStore &v, size_t i, Facility &f) {
+    switch (f.type) {
+    case BuildingType::Restaurant:
+      v.hunger[i] = 1.0f;
+      v.thirst[i] = 1.0f;
+      break;
+    case BuildingType::GiftShop:
+      v.excitement[i] = std::min(1.0f, v.excitement[i] + 0.2f);
+      break;
+    case BuildingType::Restroom: v.comfort[i] = 1.0f; break;
+    case BuildingType::VisitorCenter: v.energy[i] = 1.0f; break;
+    case BuildingType::ViewingPlatform:
+      v.excitement[i] = std::min(1.0f, v.excitement[i] + 0.3f);
+      break;
+    default: break;
+    }
+    v.satisfaction[i] =
+        std::min(1.0f, v.satisfaction[i] + f.satisfaction * 0.1f);
+    if (v.moneySpent[i] + f.price <= v.budget[i]) {
+      v.moneySpent[i] += f.price;
+      f.pendingRevenue += f.price;
+    }
+    v.queued[i] = 0;
+    v.destination[i] = Visitor::NO_DESTINATION;
+    f.waiting--;
+    f.served++;
+  }
+
+  CrowdField field;
+  std::vector<Facility> facilities;
+  std::vector<uint32_t> facilityOf; // By building id, NONE if closed
+  // Facility indices per VisitorAction, so idle visitors cost nothing
+  std::array<std::vector<uint32_t>, size_t(VisitorAction::Leaving) + 1>
+      servedBy;
+};
+
+} // namespace Gameplay
+} // namespace Mesozoic
@@ -0,0 +1,335 @@
+#pragma once
+#include "../Core/Math/Vec3.h"
+#include "VisitorAI.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Mesozoic {
+namespace Gameplay {
+
+using Math::Vec3;
+
+// =========================================================================
+// Fear Field
+// =========================================================================
+// 2D counterpart of SmellGrid over the park's x/z plane: loose animals
+// emit fear, which diffuses towards the neighbour average and decays.
+// Double-buffered; a visitor reads its cell in O(1).
+
+class FearField {
+public:
+  static constexpr float DIFFUSION_RATE = 0.6f;
+  static constexpr float DECAY_RATE = 0.15f;
+
+  FearField(float originX = -512.0f, float originZ = -512.0f,
+            int cellsX = 128, int cellsZ = 128, float cellSize = 8.0f)
+      : originX(originX), originZ(originZ), cellsX(cellsX), cellsZ(cellsZ),
+        cellSize(cellSize),
+        gridA(size_t(cellsX) * size_t(cellsZ), 0.0f), gridB(gridA) {}
+
+  // Cell under `p`, or -1 off the grid
+  int CellIndex(const Vec3 &p) const {
+    float fx = std::floor((p.x - originX) / cellSize);
+    float fz = std::floor((p.z - originZ) / cellSize);
+    if (!(fx >= 0.0f && fx < float(cellsX) && fz >= 0.0f &&
+          fz < float(cellsZ)))
+      return -1;
+    return int(fz) * cellsX + int(fx);
+  }
+
+  Vec3 CellCenter(int cell) const {
+    return Vec3(originX + (float(cell % cellsX) + 0.5f) * cellSize, 0.0f,
+                originZ + (float(cell / cellsX) + 0.5f) * cellSize);
+  }
+
+  // Full strength in the animal's cell, 0.3 in the eight around it
+  void Emit(const Vec3 &p, float amount) {
+    int c = CellIndex(p);
+    if (c < 0)
+      return;
+    int cx = c % cellsX, cz = c / cellsX;
+    for (int dz = -1; dz <= 1; dz++) {
+      for (int dx = -1; dx <= 1; dx++) {
+        int nx = cx + dx, nz = cz + dz;
+        if (nx >= 0 && nx < cellsX && nz >= 0 && nz < cellsZ) {
+          float falloff = (dx == 0 && dz == 0) ? 1.0f : 0.3f;
+          Current()[size_t(nz) * cellsX + nx] += amount * falloff;
+        }
+      }
+    }
+  }
+
+  // Adds to the cell under `p` without raising it past `cap`
+  void EmitCapped(const Vec3 &p, float amount, float cap) {
+    int c = CellIndex(p);
+    if (c < 0)
+      return;
+    float &v = Current()[c];
+    if (v < cap)
+      v = std::min(cap, v + amount);
+  }
+
+  void Update(float dt) {
+    const std::vector<float> &src = Current();
+    std::vector<float> &dst = useA ? gridB : gridA;
+    const float diffusion = std::min(1.0f, DIFFUSION_RATE * dt);
+    const float keep = std::max(0.0f, 1.0f - DECAY_RATE * dt);
+
+    for (int z = 0; z < cellsZ; z++) {
+      for (int x = 0; x < cellsX; x++) {
+        size_t c = size_t(z) * cellsX + x;
+        float neighborSum = (x > 0 ? src[c - 1] : 0.0f) +
+                            (x < cellsX - 1 ? src[c + 1] : 0.0f) +
+                            (z > 0 ? src[c - cellsX] : 0.0f) +
+                            (z < cellsZ - 1 ? src[c + cellsX] : 0.0f);
+        int neighborCount = int(x > 0) + int(x < cellsX - 1) + int(z > 0) +
+                            int(z < cellsZ - 1);
+        float avgNeighbor =
+            neighborCount > 0 ? neighborSum / float(neighborCount) : 0.0f;
+        float diffused = src[c] + diffusion * (avgNeighbor - src[c]);
+        dst[c] = std::max(0.0f, diffused * keep);
+      }
+    }
+    useA = !useA;
+  }
+
+  float Value(int cell) const { return cell < 0 ? 0.0f : Current()[cell]; }
+  // Threat at `p`, saturating at 1
+  float Sample(const Vec3 &p) const {
+    return std::min(1.0f, Value(CellIndex(p)));
+  }
+
+  int CellsX() const { return cellsX; }
+  int CellsZ() const { return cellsZ; }
+  float CellSize() const { return cellSize; }
+
+private:
+  std::vector<float> &Current() { return useA ? gridA : gridB; }
+  const std::vector<float> &Current() const { return useA ? gridA : gridB; }
+
+  float originX, originZ;
+  int cellsX, cellsZ;
+  float cellSize;
+  std::vector<float> gridA, gridB;
+  bool useA = true;
+};
+
+// =========================================================================
+// Evacuation Flow Field
+// =========================================================================
+// Dijkstra from every exit over the fear field's grid (8-connected).
+// Entering a cell costs its length times 1 + fearCost * fear, so routes
+// bend around the danger; each cell stores the step towards the cheapest
+// exit and visitors just follow their cell's arrow.
+
+class EvacuationField {
+public:
+  float fearCost = 20.0f;
+
+  void Build(const FearField &fear, std::span<const Vec3> exits) {
+    cellsX = fear.CellsX();
+    cellsZ = fear.CellsZ();
+    const size_t n = size_t(cellsX) * size_t(cellsZ);
+    cost.assign(n, INF);
+    next.assign(n, NO_STEP);
+    enter.resize(n);
+    for (size_t c = 0; c < n; ++c)
+      enter[c] = 1.0f + fearCost * std::min(1.0f, fear.Value(int(c)));
+
+    // Min-heap on a reused buffer, so rebuilds do not allocate
+    auto later = [](const Entry &a, const Entry &b) { return a > b; };
+    heap.clear();
+    auto push = [&](float d, int c) {
+      heap.push_back({d, c});
+      std::push_heap(heap.begin(), heap.end(), later);
+    };
+    for (const Vec3 &e : exits) {
+      int c = fear.CellIndex(e);
+      if (c >= 0 && cost[c] > 0.0f) {
+        cost[c] = 0.0f;
+        next[c] = AT_EXIT;
+        push(0.0f, c);
+      }
+    }
+
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), later);
+      auto [d, c] = heap.back();
+      heap.pop_back();
+      if (d > cost[c])
+        continue; // Stale entry
+      int cx = c % cellsX, cz = c / cellsX;
+      for (int k = 0; k < 8; ++k) {
+        int nx = cx + DX[k], nz = cz + DZ[k];
+        if (nx < 0 || nx >= cellsX || nz < 0 || nz >= cellsZ)
+          continue;
+        int nc = nz * cellsX + nx;
+        float step = (k < 4 ? 1.0f : 1.41421356f) * enter[nc];
+        if (d + step < cost[nc]) {
+          cost[nc] = d + step;
+          next[nc] = int8_t(Opposite(k)); // From nc back towards c
+          push(cost[nc], nc);
+        }
+      }
+    }
+  }
+
+  // Unit step towards the cheapest exit; zero on an exit cell, off the
+  // grid or where no exit is reachable
+  Vec3 Direction(int cell) const {
+    if (cell < 0 || size_t(cell) >= next.size() || next[cell] < 0)
+      return Vec3(0, 0, 0);
+    int k = next[cell];
+    float inv = k < 4 ? 1.0f : 0.70710678f;
+    return Vec3(float(DX[k]) * inv, 0.0f, float(DZ[k]) * inv);
+  }
+
+  // Cost to the nearest exit, in cells; INF when unreachable
+  float Cost(int cell) const {
+    return cell < 0 || size_t(cell) >= cost.size() ? INF : cost[cell];
+  }
+
+  bool AtExit(int cell) const {
+    return cell >= 0 && size_t(cell) < next.size() && next[cell] == AT_EXIT;
+  }
+
+  static constexpr float INF = std::numeric_limits<float>::infinity();
+
+private:
+  static constexpr int8_t NO_STEP = -1;
+  static constexpr int8_t AT_EXIT = -2;
+  // Axis neighbours first, then diagonals
+  static constexpr int DX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+  static constexpr int DZ[8] = {0, 0, 1, -1, 1, 1, -1, -1};
+  static int Opposite(int k) { return k < 4 ? (k ^ 1) : 11 - k; }
+
+  using Entry = std::pair<float, int>;
+
+  int cellsX = 0, cellsZ = 0;
+  std::vector<float> cost;
+  std::vector<int8_t> next; // Index into DX/DZ, or NO_STEP / AT_EXIT
+  std::vector<float> enter; // Cost of stepping into each cell, axis-wise
+  std::vector<Entry> heap;
+};
+
+// =========================================================================
+// Panic System
+// =========================================================================
+// Localised panic for escapes. Each tick loose animals feed the fear
+// field, it diffuses, every visitor samples its cell into
+// VisitorStore::threat, and VisitorAI turns that into fear and the Fleeing
+// action. Once fleeing, a visitor follows the evacuation field, which is
+// rebuilt every `repathSeconds` as the fear moves. Their threat is held at
+// `fleeingThreat` until they reach an exit, where they are marked to leave
+// the park.
+//
+// Terrified visitors add a little fear of their own. It is capped below
+// VisitorAI::THREAT_MIN, so contagion widens an animal's panic zone but
+// cannot keep a crowd scared once the animal is gone.
+//
+//   panic.Update(visitors.Store(), loosePositions, dt);
+//   visitors.Update(dt, rating, false); // No park-wide alarm needed
+
+class PanicSystem {
+public:
+  float animalFear = 4.0f; // Emitted per second by each loose animal
+  float contagion = 0.5f;  // Emitted per second by each terrified visitor
+  float contagionCap = 0.08f;
+  float fleeingThreat = 0.5f; // Floor for visitors still on their way out
+  float repathSeconds = 1.0f;
+  float exitRadius = 10.0f; // Fleeing visitors this close are out
+  std::vector<Vec3> exits = {Vec3(0, 0, -200)};
+
+  explicit PanicSystem(FearField field = FearField())
+      : fear(std::move(field)) {}
+
+  void Update(VisitorStore &visitors, std::span<const Vec3> looseAnimals,
+              float dt) {
+    for (const Vec3 &a : looseAnimals)
+      fear.Emit(a, animalFear * dt);
+    fear.Update(dt);
+
+    repathTimer -= dt;
+    if (repathTimer <= 0.0f || !built) {
+      evacuation.Build(fear, exits);
+      repathTimer = repathSeconds;
+      built = true;
+    }
+
+    // Sample and steer first, so every visitor reads the same field
+    const size_t n = visitors.Size();
+    evacuated = 0;
+    for (size_t i = 0; i < n; ++i) {
+      Vec3 p(visitors.posX[i], visitors.posY[i], visitors.posZ[i]);
+      int cell = fear.CellIndex(p);
+      float threat = std::min(1.0f, fear.Value(cell));
+      if (visitors.action[i] == VisitorAction::Fleeing) {
+        if (Steer(visitors, i, p, cell)) {
+          evacuated++;
+          visitors.maxStayTime[i] =
+              std::min(visitors.maxStayTime[i], visitors.timeInPark[i]);
+        } else {
+          threat = std::max(threat, fleeingThreat);
+        }
+      }
+      visitors.threat[i] = threat;
+    }
+    for (size_t i = 0; i < n; ++i)
+      if (visitors.fear[i] > 0.5f)
+        fear.EmitCapped(
+            Vec3(visitors.posX[i], visitors.posY[i], visitors.posZ[i]),
+            contagion * dt, contagionCap);
+  }
+
+  // Call after exits change; the next Update rebuilds the routes
+  void InvalidateRoutes() { built = false; }
+
+  const FearField &Field() const { return fear; }
+  const EvacuationField &Evacuation() const { return evacuation; }
+  // Fleeing visitors within exitRadius of an exit at the last Update
+  uint32_t Evacuated() const { return evacuated; }
+
+private:
+  // Points a fleeing visitor along the evacuation field; true once they
+  // are at an exit
+  bool Steer(VisitorStore &v, size_t i, const Vec3 &p, int cell) {
+    const Vec3 *nearest = nullptr;
+    float best = 0.0f;
+    for (const Vec3 &e : exits) {
+      float d = (e - p).LengthSq();
+      if (!nearest || d < best) {
+        nearest = &e;
+        best = d;
+      }
+    }
+    if (!nearest)
+      return false;
+    if (best <= exitRadius * exitRadius)
+      return true;
+
+    // Follow the field a cell ahead; head straight for the nearest exit
+    // from the exit's own cell, off the grid or when cut off
+    Vec3 dir = evacuation.Direction(cell);
+    Vec3 target = dir.LengthSq() > 0.0f ? p + dir * fear.CellSize()
+                                        : *nearest;
+    v.targetX[i] = target.x;
+    v.targetY[i] = target.y;
+    v.targetZ[i] = target.z;
+    v.walking[i] = 1;
+    return false;
+  }
+
+  FearField fear;
+  EvacuationField evacuation;
+  float repathTimer = 0.0f;
+  bool built = false;
+  uint32_t evacuated = 0;
+};
+
+} // namespace Gameplay
+} // namespace Mesozoic
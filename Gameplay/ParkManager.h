@@ -327,6 +327,8 @@ public:
     return cost;
   }
 
+  // Rough estimate that spreads visitors evenly over the buildings; a
+  // CrowdSystem bills the visitors its queues actually serve instead
   float GetTotalRevenue(uint32_t visitorCount) const {
     float rev = 0;
     for (const auto &b : buildings) {
@@ -0,0 +1,196 @@
+#pragma once
+#include "../Core/Math/Vec3.h"
+#include "ParkManager.h"
+#include "VisitorAI.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Mesozoic {
+namespace Gameplay {
+
+using Math::Vec3;
+
+// =========================================================================
+// Sighting Join
+// =========================================================================
+// Turns visitor and dinosaur positions into Sighting events. Dinosaurs are
+// counting-sorted into a flat x/z grid once per Build(); each visitor then
+// checks only the cells its view range overlaps instead of every animal.
+// Visitors out on the paths see `groundRange` metres; standing on a
+// viewpoint (a viewing platform) raises that to the viewpoint's range.
+//
+//   SightingGrid grid;
+//   grid.Build(dinosaurs);
+//   grid.Join(visitors.Store(), viewpoints, events);
+//   visitors.ProcessSightings(events);
+
+struct SightingTarget {
+  Vec3 position;
+  uint32_t speciesId;
+};
+
+struct Viewpoint {
+  Vec3 position;
+  float radius;    // Visitors within this distance stand on the viewpoint
+  float viewRange; // How far they see from it
+};
+
+// Operational viewing platforms as viewpoints
+inline std::vector<Viewpoint>
+ViewpointsFromBuildings(const std::vector<Building> &buildings,
+                        float radius = 15.0f, float viewRange = 120.0f) {
+  std::vector<Viewpoint> viewpoints;
+  for (const auto &b : buildings)
+    if (b.type == BuildingType::ViewingPlatform && b.operational)
+      viewpoints.push_back({b.position, radius, viewRange});
+  return viewpoints;
+}
+
+class SightingGrid {
+public:
+  float groundRange = 30.0f;
+
+  explicit SightingGrid(float cellSize = 32.0f) : cellSize(cellSize) {}
+
+  // Targets with a non-finite x or z are skipped: they cannot be binned,
+  // and their bounds would keep the cell-doubling loop below going forever
+  void Build(std::span<const SightingTarget> targets) {
+    sorted.clear();
+    cellStart.clear();
+    cellsX = cellsZ = 0;
+
+    size_t count = 0;
+    float minX = 0.0f, maxX = 0.0f, minZ = 0.0f, maxZ = 0.0f;
+    for (const auto &t : targets) {
+      if (!Finite(t.position))
+        continue;
+      if (count++ == 0) {
+        minX = maxX = t.position.x;
+        minZ = maxZ = t.position.z;
+      }
+      minX = std::min(minX, t.position.x);
+      maxX = std::max(maxX, t.position.x);
+      minZ = std::min(minZ, t.position.z);
+      maxZ = std::max(maxZ, t.position.z);
+    }
+    if (count == 0)
+      return;
+
+    // Spread-out herds coarsen the grid rather than allocate empty cells
+    cell = cellSize;
+    while (true) {
+      originX = std::floor(minX / cell);
+      originZ = std::floor(minZ / cell);
+      float spanX = std::floor(maxX / cell) - originX + 1.0f;
+      float spanZ = std::floor(maxZ / cell) - originZ + 1.0f;
+      if (spanX * spanZ <= float(MAX_CELLS)) {
+        cellsX = int(spanX);
+        cellsZ = int(spanZ);
+        break;
+      }
+      cell *= 2.0f;
+    }
+
+    // Counting sort: count per cell, prefix sum, scatter
+    cellStart.assign(size_t(cellsX) * cellsZ + 1, 0);
+    for (const auto &t : targets)
+      if (Finite(t.position))
+        cellStart[CellOf(t.position) + 1]++;
+    for (size_t c = 1; c < cellStart.size(); ++c)
+      cellStart[c] += cellStart[c - 1];
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    sorted.resize(count);
+    for (const auto &t : targets)
+      if (Finite(t.position))
+        sorted[cursor[CellOf(t.position)]++] = t;
+  }
+
+  // Appends one Sighting per visitor and species in range, in row order
+  void Join(const VisitorStore &visitors,
+            std::span<const Viewpoint> viewpoints,
+            std::vector<Sighting> &out) const {
+    if (cellStart.empty())
+      return;
+    for (size_t i = 0; i < visitors.Size(); ++i) {
+      Vec3 p(visitors.posX[i], visitors.posY[i], visitors.posZ[i]);
+      if (!Finite(p))
+        continue;
+      float range = groundRange;
+      for (const auto &vp : viewpoints)
+        if ((p - vp.position).LengthSq() <= vp.radius * vp.radius)
+          range = std::max(range, vp.viewRange);
+
+      int x0 = std::max(CellX(p.x - range), 0);
+      int x1 = std::min(CellX(p.x + range), cellsX - 1);
+      int z0 = std::max(CellZ(p.z - range), 0);
+      int z1 = std::min(CellZ(p.z + range), cellsZ - 1);
+
+      const float rangeSq = range * range;
+      const uint32_t id = visitors.ids[i];
+      const size_t first = out.size();
+      uint64_t emitted = 0;
+      for (int z = z0; z <= z1; ++z) {
+        for (int x = x0; x <= x1; ++x) {
+          size_t c = size_t(z) * cellsX + x;
+          for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+            const SightingTarget &t = sorted[k];
+            if ((t.position - p).LengthSq() > rangeSq)
+              continue;
+            if (t.speciesId < 64) {
+              uint64_t bit = uint64_t(1) << t.speciesId;
+              if (emitted & bit)
+                continue;
+              emitted |= bit;
+            } else if (std::any_of(out.begin() + first, out.end(),
+                                   [&](const Sighting &s) {
+                                     return s.speciesId == t.speciesId;
+                                   })) {
+              continue;
+            }
+            out.push_back({id, t.speciesId});
+          }
+        }
+      }
+    }
+  }
+
+  size_t TargetCount() const { return sorted.size(); }
+  size_t CellCount() const { return size_t(cellsX) * size_t(cellsZ); }
+
+private:
+  static constexpr size_t MAX_CELLS = 1 << 16;
+
+  static bool Finite(const Vec3 &p) {
+    return std::isfinite(p.x) && std::isfinite(p.z);
+  }
+
+  // Grid column/row of a coordinate, clamped to one cell past either edge
+  // before the int conversion so far-away visitors cannot overflow it
+  int CellX(float x) const {
+    return int(std::clamp(std::floor(x / cell) - originX, -1.0f,
+                          float(cellsX)));
+  }
+  int CellZ(float z) const {
+    return int(std::clamp(std::floor(z / cell) - originZ, -1.0f,
+                          float(cellsZ)));
+  }
+  size_t CellOf(const Vec3 &p) const {
+    int x = std::clamp(CellX(p.x), 0, cellsX - 1);
+    int z = std::clamp(CellZ(p.z), 0, cellsZ - 1);
+    return size_t(z) * cellsX + x;
+  }
+
+  float cellSize;
+  float cell = 0.0f; // cellSize, doubled while the grid is too large
+  float originX = 0.0f, originZ = 0.0f;
+  int cellsX = 0, cellsZ = 0;
+  std::vector<uint32_t> cellStart; // CSR offsets, one past the last cell
+  std::vector<uint32_t> cursor;
+  std::vector<SightingTarget> sorted;
+};
+
+} // namespace Gameplay
+} // namespace Mesozoic
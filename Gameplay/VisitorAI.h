@@ -3,10 +3,24 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#ifndef MESOZOIC_SSE
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MESOZOIC_SSE 1
+#else
+#define MESOZOIC_SSE 0
+#endif
+#endif
+#if MESOZOIC_SSE
+#include <emmintrin.h>
+#endif
+
 namespace Mesozoic {
 namespace Gameplay {
 
@@ -34,6 +48,7 @@ enum class VisitorAction : uint8_t {
   Leaving
 };
 
+// Snapshot of one visitor (VisitorAI keeps them column-wise)
 struct Visitor {
   uint32_t id;
   Vec3 position;
@@ -47,6 +62,7 @@ struct Visitor {
   float excitement = 0.5f;
   float comfort = 0.7f;
   float fear = 0.0f;
+  float threat = 0.0f; // Local danger [0..1] that fear rises with
 
   // State
   VisitorMood mood = VisitorMood::Neutral;
@@ -57,8 +73,145 @@ struct Visitor {
   float timeInPark = 0.0f;     // Seconds
   float maxStayTime = 7200.0f; // 2 hours default
 
-  // Species seen (for variety bonus)
-  std::vector<uint32_t> speciesSeen;
+  // Species seen (for variety bonus): bit N = species id N
+  uint64_t speciesSeen = 0;
+
+  // Crowd state (see Crowd.h)
+  static constexpr uint32_t NO_DESTINATION = 0xFFFFFFFFu;
+  float pace = 1.0f; // Fraction of `speed` the crowd allows
+  uint32_t destination = NO_DESTINATION; // Building id
+  bool queued = false;                   // Waiting at the destination
+};
+
+// One visitor spotting one dinosaur species
+struct Sighting {
+  uint32_t visitorId;
+  uint32_t speciesId;
+};
+
+// =========================================================================
+// Visitor Store (SoA)
+// =========================================================================
+// One array per field, so the per-tick pass streams only the columns it
+// touches and processes four visitors per SSE2 instruction. Rows are
+// removed by moving the last visitor into the hole, so visitor order is
+// not stable; `rowOf` maps ids to their current row, sparse-set style.
+
+struct VisitorStore {
+  std::vector<uint32_t> ids;
+  std::vector<float> posX, posY, posZ;
+  std::vector<float> targetX, targetY, targetZ;
+  std::vector<float> speed;
+  std::vector<float> hunger, thirst, energy, excitement, comfort, fear;
+  std::vector<float> threat;
+  std::vector<float> satisfaction, moneySpent, budget;
+  std::vector<float> timeInPark, maxStayTime;
+  std::vector<VisitorMood> mood;
+  std::vector<VisitorAction> action;
+  std::vector<uint64_t> speciesSeen;
+  // 0 once a visitor stood within 1 m of its target, so the tick skips
+  // the position and target columns of visitors that are not walking
+  std::vector<uint8_t> walking;
+  std::vector<float> pace;
+  std::vector<uint32_t> destination;
+  std::vector<uint8_t> queued;
+  std::unordered_map<uint32_t, uint32_t> rowOf; // Not a column
+
+  size_t Size() const { return ids.size(); }
+
+  // Row of a visitor id, or Size() when it is not in the park
+  size_t Find(uint32_t id) const {
+    auto it = rowOf.find(id);
+    return it == rowOf.end() ? Size() : it->second;
+  }
+
+  template <typename F> void ForEachColumn(F &&f) {
+    f(ids);
+    f(posX), f(posY), f(posZ);
+    f(targetX), f(targetY), f(targetZ);
+    f(speed);
+    f(hunger), f(thirst), f(energy), f(excitement), f(comfort), f(fear);
+    f(threat);
+    f(satisfaction), f(moneySpent), f(budget);
+    f(timeInPark), f(maxStayTime);
+    f(mood), f(action), f(speciesSeen);
+    f(walking);
+    f(pace), f(destination), f(queued);
+  }
+
+  void Reserve(size_t n) {
+    ForEachColumn([n](auto &column) { column.reserve(n); });
+    rowOf.reserve(n);
+  }
+
+  void Push(const Visitor &v) {
+    rowOf[v.id] = uint32_t(ids.size());
+    ids.push_back(v.id);
+    posX.push_back(v.position.x);
+    posY.push_back(v.position.y);
+    posZ.push_back(v.position.z);
+    targetX.push_back(v.targetPosition.x);
+    targetY.push_back(v.targetPosition.y);
+    targetZ.push_back(v.targetPosition.z);
+    speed.push_back(v.speed);
+    hunger.push_back(v.hunger);
+    thirst.push_back(v.thirst);
+    energy.push_back(v.energy);
+    excitement.push_back(v.excitement);
+    comfort.push_back(v.comfort);
+    fear.push_back(v.fear);
+    threat.push_back(v.threat);
+    satisfaction.push_back(v.satisfaction);
+    moneySpent.push_back(v.moneySpent);
+    budget.push_back(v.budget);
+    timeInPark.push_back(v.timeInPark);
+    maxStayTime.push_back(v.maxStayTime);
+    mood.push_back(v.mood);
+    action.push_back(v.action);
+    speciesSeen.push_back(v.speciesSeen);
+    walking.push_back(1);
+    pace.push_back(v.pace);
+    destination.push_back(v.destination);
+    queued.push_back(v.queued);
+  }
+
+  Visitor Get(size_t i) const {
+    Visitor v;
+    v.id = ids[i];
+    v.position = Vec3(posX[i], posY[i], posZ[i]);
+    v.targetPosition = Vec3(targetX[i], targetY[i], targetZ[i]);
+    v.speed = speed[i];
+    v.hunger = hunger[i];
+    v.thirst = thirst[i];
+    v.energy = energy[i];
+    v.excitement = excitement[i];
+    v.comfort = comfort[i];
+    v.fear = fear[i];
+    v.threat = threat[i];
+    v.mood = mood[i];
+    v.action = action[i];
+    v.satisfaction = satisfaction[i];
+    v.moneySpent = moneySpent[i];
+    v.budget = budget[i];
+    v.timeInPark = timeInPark[i];
+    v.maxStayTime = maxStayTime[i];
+    v.speciesSeen = speciesSeen[i];
+    v.pace = pace[i];
+    v.destination = destination[i];
+    v.queued = queued[i] != 0;
+    return v;
+  }
+
+  // Moves the last row into `i`
+  void SwapRemove(size_t i) {
+    rowOf.erase(ids[i]);
+    if (i + 1 != ids.size())
+      rowOf[ids.back()] = uint32_t(i);
+    ForEachColumn([i](auto &column) {
+      column[i] = column.back();
+      column.pop_back();
+    });
+  }
 };
 
 // =========================================================================
@@ -66,12 +219,24 @@ struct Visitor {
 // =========================================================================
 
 class VisitorAI {
-  std::vector<Visitor> visitors;
+  VisitorStore store;
   uint32_t nextVisitorId = 0;
   float spawnTimer = 0.0f;
   float spawnRate = 5.0f; // Seconds between spawns
+  std::vector<Sighting> sightingScratch;
+
+  // Need decay per second
+  static constexpr float HUNGER_DECAY = 0.0003f;
+  static constexpr float THIRST_DECAY = 0.0005f;
+  static constexpr float ENERGY_DECAY = 0.0002f;
+  static constexpr float EXCITEMENT_DECAY = 0.0001f;
+  static constexpr float FEAR_RISE = 0.5f; // Per second at full threat
+  static constexpr float FEAR_CALM = 0.1f;
 
 public:
+  // Threat at or below this calms visitors down instead
+  static constexpr float THREAT_MIN = 0.1f;
+
   uint32_t SpawnVisitor(Vec3 entrance) {
     Visitor v;
     v.id = nextVisitorId++;
@@ -79,10 +244,15 @@ public:
     v.targetPosition = entrance;
     v.budget = 100.0f + static_cast<float>(v.id * 37 % 300);
     v.maxStayTime = 3600.0f + static_cast<float>(v.id * 53 % 7200);
-    visitors.push_back(v);
+    store.Push(v);
     return v.id;
   }
 
+  void Reserve(size_t visitors) { store.Reserve(visitors); }
+
+  // `dinosaurEscaped` sounds a park-wide alarm (full threat everywhere);
+  // without it fear follows each visitor's `threat`, which a PanicSystem
+  // samples from the local fear field
   void Update(float dt, float parkRating, bool dinosaurEscaped) {
     spawnTimer += dt;
 
@@ -94,110 +264,93 @@ public:
       SpawnVisitor(Vec3(0, 0, -200));
     }
 
-    for (auto &v : visitors) {
-      v.timeInPark += dt;
-
-      // Decay needs
-      v.hunger -= 0.0003f * dt;
-      v.thirst -= 0.0005f * dt;
-      v.energy -= 0.0002f * dt;
-      v.excitement -= 0.0001f * dt;
-
-      // Clamp
-      v.hunger = std::clamp(v.hunger, 0.0f, 1.0f);
-      v.thirst = std::clamp(v.thirst, 0.0f, 1.0f);
-      v.energy = std::clamp(v.energy, 0.0f, 1.0f);
-      v.excitement = std::clamp(v.excitement, 0.0f, 1.0f);
-
-      // Escaped dinosaur = panic!
-      if (dinosaurEscaped) {
-        v.fear = std::min(1.0f, v.fear + 0.5f * dt);
-        v.action = VisitorAction::Fleeing;
-      } else {
-        v.fear = std::max(0.0f, v.fear - 0.1f * dt);
-      }
+    const size_t n = store.Size();
+    size_t i = 0;
+    bool anyDone = false;
+#if MESOZOIC_SSE
+    for (; i + 4 <= n; i += 4)
+      anyDone |= UpdateFour(i, dt, dinosaurEscaped);
+#endif
+    for (; i < n; ++i)
+      anyDone |= UpdateOne(i, dt, dinosaurEscaped);
+    if (!anyDone)
+      return; // The tick already checked every row; skip the rescan
 
-      // Decide action (utility-based)
-      DecideAction(v);
-
-      // Update mood
-      UpdateMood(v);
-
-      // Update satisfaction
-      float moodFactor = (v.mood == VisitorMood::Ecstatic)  ? 1.0f
-                         : (v.mood == VisitorMood::Happy)   ? 0.8f
-                         : (v.mood == VisitorMood::Neutral) ? 0.5f
-                         : (v.mood == VisitorMood::Unhappy) ? 0.3f
-                         : (v.mood == VisitorMood::Angry)   ? 0.1f
-                                                            : 0.0f;
-      v.satisfaction = v.satisfaction * 0.99f + moodFactor * 0.01f;
-
-      // Movement
-      Vec3 delta = v.targetPosition - v.position;
-      float dist = delta.Length();
-      if (dist > 1.0f) {
-        Vec3 dir = delta * (1.0f / dist);
-        v.position = v.position + dir * (v.speed * dt);
-      }
+    // Remove visitors who are leaving and have reached exit
+    for (size_t r = 0; r < store.Size();) {
+      if (store.action[r] == VisitorAction::Leaving &&
+          store.timeInPark[r] > store.maxStayTime[r] + 60.0f)
+        store.SwapRemove(r);
+      else
+        ++r;
     }
+  }
 
-    // Remove visitors who are leaving and have reached exit
-    visitors.erase(std::remove_if(visitors.begin(), visitors.end(),
-                                  [](const Visitor &v) {
-                                    return v.action == VisitorAction::Leaving &&
-                                           v.timeInPark > v.maxStayTime + 60.0f;
-                                  }),
-                   visitors.end());
+  // Sends a visitor walking towards `target`; false for unknown ids
+  bool SetTarget(uint32_t visitorId, Vec3 target) {
+    size_t i = store.Find(visitorId);
+    if (i == store.Size())
+      return false;
+    store.targetX[i] = target.x;
+    store.targetY[i] = target.y;
+    store.targetZ[i] = target.z;
+    store.walking[i] = 1;
+    return true;
   }
 
-  // Handle dinosaur sighting
+  // Handle dinosaur sighting. Species ids past 63 do not fit the seen
+  // mask and never count as new.
   void OnDinosaurSeen(uint32_t visitorId, uint32_t speciesId) {
-    for (auto &v : visitors) {
-      if (v.id == visitorId) {
-        bool newSpecies = true;
-        for (uint32_t s : v.speciesSeen) {
-          if (s == speciesId) {
-            newSpecies = false;
-            break;
-          }
-        }
-        if (newSpecies) {
-          v.speciesSeen.push_back(speciesId);
-          v.excitement = std::min(1.0f, v.excitement + 0.3f);
-          v.satisfaction = std::min(1.0f, v.satisfaction + 0.1f);
-        }
-        v.excitement = std::min(1.0f, v.excitement + 0.05f);
-        break;
-      }
+    size_t i = store.Find(visitorId);
+    if (i != store.Size())
+      ApplySighting(i, speciesId);
+  }
+
+  // Same result as calling OnDinosaurSeen for each event in order, but
+  // events are grouped by visitor so each id is looked up once and its
+  // row stays in cache for the whole group
+  void ProcessSightings(std::span<const Sighting> sightings) {
+    sightingScratch.assign(sightings.begin(), sightings.end());
+    std::stable_sort(sightingScratch.begin(), sightingScratch.end(),
+                     [](const Sighting &a, const Sighting &b) {
+                       return a.visitorId < b.visitorId;
+                     });
+    for (size_t g = 0; g < sightingScratch.size();) {
+      uint32_t id = sightingScratch[g].visitorId;
+      size_t row = store.Find(id);
+      for (; g < sightingScratch.size() && sightingScratch[g].visitorId == id;
+           ++g)
+        if (row != store.Size())
+          ApplySighting(row, sightingScratch[g].speciesId);
     }
   }
 
+  const VisitorStore &Store() const { return store; }
+  // For systems that drive visitors column-wise, like the crowd
+  VisitorStore &Store() { return store; }
+  Visitor GetVisitor(size_t index) const { return store.Get(index); }
+
   // Stats
-  size_t GetVisitorCount() const { return visitors.size(); }
+  size_t GetVisitorCount() const { return store.Size(); }
 
   float GetAverageSatisfaction() const {
-    if (visitors.empty())
+    if (store.Size() == 0)
       return 0;
     float total = 0;
-    for (const auto &v : visitors)
-      total += v.satisfaction;
-    return total / visitors.size();
+    for (float s : store.satisfaction)
+      total += s;
+    return total / store.Size();
   }
 
   float GetTotalMoneySpent() const {
     float total = 0;
-    for (const auto &v : visitors)
-      total += v.moneySpent;
+    for (float m : store.moneySpent)
+      total += m;
     return total;
   }
 
   int GetMoodCount(VisitorMood mood) const {
-    int count = 0;
-    for (const auto &v : visitors) {
-      if (v.mood == mood)
-        count++;
-    }
-    return count;
+    return int(std::count(store.mood.begin(), store.mood.end(), mood));
   }
 
   void PrintVisitorStats() const {
@@ -210,10 +363,10 @@ public:
     int angryCount = 0;
     int terrifiedCount = 0;
 
-    for (const auto &v : visitors) {
-      totalSatisfaction += v.satisfaction;
-      totalSpending += v.moneySpent;
-      switch (v.mood) {
+    for (size_t i = 0; i < store.Size(); ++i) {
+      totalSatisfaction += store.satisfaction[i];
+      totalSpending += store.moneySpent[i];
+      switch (store.mood[i]) {
       case VisitorMood::Ecstatic: ecstaticCount++; break;
       case VisitorMood::Happy: happyCount++; break;
       case VisitorMood::Neutral: neutralCount++; break;
@@ -224,10 +377,10 @@ public:
     }
 
     float avgSatisfaction =
-        visitors.empty() ? 0.0f : totalSatisfaction / visitors.size();
+        store.Size() == 0 ? 0.0f : totalSatisfaction / store.Size();
 
     std::cout << "\n=== VISITOR STATS ===" << std::endl;
-    std::cout << "  Active: " << visitors.size() << std::endl;
+    std::cout << "  Active: " << store.Size() << std::endl;
     std::cout << "  Avg Satisfaction: " << static_cast<int>(avgSatisfaction * 100)
               << "%" << std::endl;
     std::cout << "  Mood Distribution:" << std::endl;
@@ -240,64 +393,236 @@ public:
   }
 
 private:
-  void DecideAction(Visitor &v) {
-    if (v.fear > 0.5f) {
-      v.action = VisitorAction::Fleeing;
-      return;
-    }
-    if (v.timeInPark > v.maxStayTime) {
-      v.action = VisitorAction::Leaving;
-      return;
+  void ApplySighting(size_t i, uint32_t speciesId) {
+    uint64_t bit = speciesId < 64 ? uint64_t(1) << speciesId : 0;
+    float &excitement = store.excitement[i];
+    if (bit && !(store.speciesSeen[i] & bit)) {
+      store.speciesSeen[i] |= bit;
+      excitement = std::min(1.0f, excitement + 0.3f);
+      store.satisfaction[i] = std::min(1.0f, store.satisfaction[i] + 0.1f);
     }
+    excitement = std::min(1.0f, excitement + 0.05f);
+  }
 
-    // Utility scores
-    float eatScore = (1.0f - v.hunger) * 2.0f;
-    float restScore = (1.0f - v.energy) * 1.5f;
-    float watchScore = (1.0f - v.excitement) * 1.2f + 0.3f;
-    float shopScore = (v.budget - v.moneySpent > 20.0f) ? 0.4f : 0.0f;
-    float exploreScore = 0.5f;
-
-    // Pick highest scoring action
-    float maxScore = exploreScore;
-    v.action = VisitorAction::Exploring;
-
-    if (eatScore > maxScore) {
-      maxScore = eatScore;
-      v.action = VisitorAction::Eating;
-    }
-    if (restScore > maxScore) {
-      maxScore = restScore;
-      v.action = VisitorAction::Resting;
-    }
-    if (watchScore > maxScore) {
-      maxScore = watchScore;
-      v.action = VisitorAction::WatchingDinos;
-    }
-    if (shopScore > maxScore) {
-      maxScore = shopScore;
-      v.action = VisitorAction::Shopping;
+  // Satisfaction each mood pulls towards, indexed by VisitorMood
+  static constexpr float MOOD_FACTOR[6] = {1.0f, 0.8f, 0.5f, 0.3f, 0.1f, 0.0f};
+  // Average need above which moods Ecstatic .. Unhappy apply
+  static constexpr float MOOD_ABOVE[4] = {0.8f, 0.6f, 0.4f, 0.2f};
+
+  // One visitor, branchless except for the movement step. Mood counts the
+  // average-need thresholds passed; the action is the first best of the
+  // utility scores, overridden by leaving time and then by fear. Returns
+  // true once the visitor has left and Update should remove it.
+  bool UpdateOne(size_t i, float dt, bool escaped) {
+    VisitorStore &s = store;
+    s.timeInPark[i] += dt;
+
+    // Decay needs
+    s.hunger[i] = std::clamp(s.hunger[i] - HUNGER_DECAY * dt, 0.0f, 1.0f);
+    s.thirst[i] = std::clamp(s.thirst[i] - THIRST_DECAY * dt, 0.0f, 1.0f);
+    s.energy[i] = std::clamp(s.energy[i] - ENERGY_DECAY * dt, 0.0f, 1.0f);
+    s.excitement[i] =
+        std::clamp(s.excitement[i] - EXCITEMENT_DECAY * dt, 0.0f, 1.0f);
+
+    // Fear rises with the local threat (or the alarm), else calms
+    float threat = std::max(s.threat[i], escaped ? 1.0f : 0.0f);
+    float fear = threat > THREAT_MIN
+                     ? std::min(1.0f, s.fear[i] + FEAR_RISE * threat * dt)
+                     : std::max(0.0f, s.fear[i] - FEAR_CALM * dt);
+    s.fear[i] = fear;
+    const bool terrified = fear > 0.5f;
+
+    // Mood
+    float avg = (s.hunger[i] + s.thirst[i] + s.energy[i] + s.excitement[i] +
+                 s.comfort[i]) /
+                5.0f;
+    uint32_t mood = uint32_t(VisitorMood::Angry);
+    for (float above : MOOD_ABOVE)
+      mood -= uint32_t(avg > above);
+    mood = terrified ? uint32_t(VisitorMood::Terrified) : mood;
+    s.mood[i] = VisitorMood(mood);
+
+    // Decide action (utility-based)
+    float best = 0.5f; // Exploring
+    uint32_t action = uint32_t(VisitorAction::Exploring);
+    auto consider = [&](float score, VisitorAction a) {
+      bool better = score > best;
+      best = better ? score : best;
+      action = better ? uint32_t(a) : action;
+    };
+    consider((1.0f - s.hunger[i]) * 2.0f, VisitorAction::Eating);
+    consider((1.0f - s.energy[i]) * 1.5f, VisitorAction::Resting);
+    consider((1.0f - s.excitement[i]) * 1.2f + 0.3f,
+             VisitorAction::WatchingDinos);
+    consider(s.budget[i] - s.moneySpent[i] > 20.0f ? 0.4f : 0.0f,
+             VisitorAction::Shopping);
+    action = s.timeInPark[i] > s.maxStayTime[i]
+                 ? uint32_t(VisitorAction::Leaving)
+                 : action;
+    action = terrified ? uint32_t(VisitorAction::Fleeing) : action;
+    s.action[i] = VisitorAction(action);
+    const bool done = action == uint32_t(VisitorAction::Leaving) &&
+                      s.timeInPark[i] > s.maxStayTime[i] + 60.0f;
+
+    // Update satisfaction
+    s.satisfaction[i] = s.satisfaction[i] * 0.99f + MOOD_FACTOR[mood] * 0.01f;
+
+    // Movement at the crowd's pace, stopping at the target
+    if (!s.walking[i])
+      return done;
+    float dx = s.targetX[i] - s.posX[i];
+    float dy = s.targetY[i] - s.posY[i];
+    float dz = s.targetZ[i] - s.posZ[i];
+    float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+    s.walking[i] = dist > 1.0f;
+    if (dist > 1.0f) {
+      float inv = 1.0f / dist;
+      float step = std::min(s.speed[i] * s.pace[i] * dt, dist);
+      s.posX[i] += dx * inv * step;
+      s.posY[i] += dy * inv * step;
+      s.posZ[i] += dz * inv * step;
     }
+    return done;
   }
 
-  void UpdateMood(Visitor &v) {
-    if (v.fear > 0.5f) {
-      v.mood = VisitorMood::Terrified;
-      return;
+#if MESOZOIC_SSE
+  // UpdateOne for visitors i..i+3, bit-identical results; true if any of
+  // them is done
+  bool UpdateFour(size_t i, float dt, bool escaped) {
+    VisitorStore &s = store;
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    auto clamp01 = [&](__m128 x) {
+      return _mm_min_ps(_mm_max_ps(x, zero), one);
+    };
+    auto select = [](__m128 mask, __m128 a, __m128 b) {
+      return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    };
+    auto selectInt = [](__m128 mask, __m128i a, __m128i b) {
+      __m128i m = _mm_castps_si128(mask);
+      return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    };
+    auto decay = [&](std::vector<float> &column, float rate) {
+      __m128 v = _mm_sub_ps(_mm_loadu_ps(&column[i]), _mm_set1_ps(rate * dt));
+      v = clamp01(v);
+      _mm_storeu_ps(&column[i], v);
+      return v;
+    };
+
+    __m128 time = _mm_add_ps(_mm_loadu_ps(&s.timeInPark[i]), _mm_set1_ps(dt));
+    _mm_storeu_ps(&s.timeInPark[i], time);
+    __m128 hunger = decay(s.hunger, HUNGER_DECAY);
+    __m128 thirst = decay(s.thirst, THIRST_DECAY);
+    __m128 energy = decay(s.energy, ENERGY_DECAY);
+    __m128 excitement = decay(s.excitement, EXCITEMENT_DECAY);
+
+    __m128 fear = _mm_loadu_ps(&s.fear[i]);
+    __m128 threat = _mm_max_ps(_mm_loadu_ps(&s.threat[i]),
+                               escaped ? one : zero);
+    __m128 rise = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(FEAR_RISE), threat),
+                             _mm_set1_ps(dt));
+    fear = select(_mm_cmpgt_ps(threat, _mm_set1_ps(THREAT_MIN)),
+                  _mm_min_ps(_mm_add_ps(fear, rise), one),
+                  _mm_max_ps(_mm_sub_ps(fear, _mm_set1_ps(FEAR_CALM * dt)),
+                             zero));
+    _mm_storeu_ps(&s.fear[i], fear);
+    const __m128 terrified = _mm_cmpgt_ps(fear, _mm_set1_ps(0.5f));
+
+    // Mood: 4 minus the thresholds passed (compare masks are -1), and the
+    // satisfaction factor of that mood selected along the way
+    __m128 avg = _mm_add_ps(_mm_add_ps(hunger, thirst), energy);
+    avg = _mm_add_ps(_mm_add_ps(avg, excitement),
+                     _mm_loadu_ps(&s.comfort[i]));
+    avg = _mm_div_ps(avg, _mm_set1_ps(5.0f));
+    __m128i mood = _mm_set1_epi32(4);
+    __m128 factor = _mm_set1_ps(MOOD_FACTOR[4]);
+    for (int m = 3; m >= 0; --m) {
+      __m128 passed = _mm_cmpgt_ps(avg, _mm_set1_ps(MOOD_ABOVE[m]));
+      mood = _mm_add_epi32(mood, _mm_castps_si128(passed));
+      factor = select(passed, _mm_set1_ps(MOOD_FACTOR[m]), factor);
     }
-
-    float avg =
-        (v.hunger + v.thirst + v.energy + v.excitement + v.comfort) / 5.0f;
-    if (avg > 0.8f)
-      v.mood = VisitorMood::Ecstatic;
-    else if (avg > 0.6f)
-      v.mood = VisitorMood::Happy;
-    else if (avg > 0.4f)
-      v.mood = VisitorMood::Neutral;
-    else if (avg > 0.2f)
-      v.mood = VisitorMood::Unhappy;
-    else
-      v.mood = VisitorMood::Angry;
+    mood = selectInt(terrified, _mm_set1_epi32(int(VisitorMood::Terrified)),
+                     mood);
+    factor = _mm_andnot_ps(terrified, factor); // Terrified: 0
+
+    // Action: running best score, first one wins ties
+    __m128 best = _mm_set1_ps(0.5f);
+    __m128i action = _mm_set1_epi32(int(VisitorAction::Exploring));
+    auto consider = [&](__m128 score, VisitorAction a) {
+      __m128 better = _mm_cmpgt_ps(score, best);
+      best = select(better, score, best);
+      action = selectInt(better, _mm_set1_epi32(int(a)), action);
+    };
+    consider(_mm_mul_ps(_mm_sub_ps(one, hunger), _mm_set1_ps(2.0f)),
+             VisitorAction::Eating);
+    consider(_mm_mul_ps(_mm_sub_ps(one, energy), _mm_set1_ps(1.5f)),
+             VisitorAction::Resting);
+    consider(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, excitement),
+                                   _mm_set1_ps(1.2f)),
+                        _mm_set1_ps(0.3f)),
+             VisitorAction::WatchingDinos);
+    __m128 canShop = _mm_cmpgt_ps(
+        _mm_sub_ps(_mm_loadu_ps(&s.budget[i]), _mm_loadu_ps(&s.moneySpent[i])),
+        _mm_set1_ps(20.0f));
+    consider(_mm_and_ps(canShop, _mm_set1_ps(0.4f)), VisitorAction::Shopping);
+    __m128 maxStay = _mm_loadu_ps(&s.maxStayTime[i]);
+    action = selectInt(_mm_cmpgt_ps(time, maxStay),
+                       _mm_set1_epi32(int(VisitorAction::Leaving)), action);
+    action = selectInt(terrified, _mm_set1_epi32(int(VisitorAction::Fleeing)),
+                       action);
+    // Leaving (past the stay, not terrified) and a minute over it
+    const bool done =
+        _mm_movemask_ps(_mm_andnot_ps(
+            terrified,
+            _mm_cmpgt_ps(time, _mm_add_ps(maxStay, _mm_set1_ps(60.0f))))) !=
+        0;
+
+    // Both enums fit a byte: narrow the four lanes and store them at once
+    auto storeBytes = [](__m128i lanes, void *dst) {
+      __m128i packed = _mm_packs_epi32(lanes, lanes);
+      int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+      std::memcpy(dst, &bytes, 4);
+    };
+    storeBytes(mood, &s.mood[i]);
+    storeBytes(action, &s.action[i]);
+
+    __m128 sat = _mm_add_ps(
+        _mm_mul_ps(_mm_loadu_ps(&s.satisfaction[i]), _mm_set1_ps(0.99f)),
+        _mm_mul_ps(factor, _mm_set1_ps(0.01f)));
+    _mm_storeu_ps(&s.satisfaction[i], sat);
+
+    // Movement, masked to visitors more than 1 m from their target
+    int32_t walking;
+    std::memcpy(&walking, &s.walking[i], 4);
+    if (!walking)
+      return done;
+    __m128 px = _mm_loadu_ps(&s.posX[i]), py = _mm_loadu_ps(&s.posY[i]),
+           pz = _mm_loadu_ps(&s.posZ[i]);
+    __m128 dx = _mm_sub_ps(_mm_loadu_ps(&s.targetX[i]), px);
+    __m128 dy = _mm_sub_ps(_mm_loadu_ps(&s.targetY[i]), py);
+    __m128 dz = _mm_sub_ps(_mm_loadu_ps(&s.targetZ[i]), pz);
+    __m128 dist = _mm_sqrt_ps(_mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+        _mm_mul_ps(dz, dz)));
+    __m128 moving = _mm_cmpgt_ps(dist, one);
+    storeBytes(_mm_srli_epi32(_mm_castps_si128(moving), 31), &s.walking[i]);
+    if (_mm_movemask_ps(moving)) {
+      __m128 inv = _mm_div_ps(one, dist);
+      __m128 step = _mm_min_ps(
+          _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&s.speed[i]),
+                                _mm_loadu_ps(&s.pace[i])),
+                     _mm_set1_ps(dt)),
+          dist);
+      auto advance = [&](__m128 p, __m128 d, float *dst) {
+        __m128 move = _mm_mul_ps(_mm_mul_ps(d, inv), step);
+        _mm_storeu_ps(dst, _mm_add_ps(p, _mm_and_ps(moving, move)));
+      };
+      advance(px, dx, &s.posX[i]);
+      advance(py, dy, &s.posY[i]);
+      advance(pz, dz, &s.posZ[i]);
+    }
+    return done;
   }
+#endif
 };
 
 } // namespace Gameplay
@@ -0,0 +1,212 @@
+#pragma once
+#include "../Assets/AnimationLoader.h"
+#include "../Core/AI/AIController.h"
+#include "../Core/Threading/JobSystem.h"
+#include "PosePipeline.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// Animation State Machine
+// AI actions pick a locomotion/behaviour state; state changes crossfade over
+// a short window (a two-layer blend tree: outgoing pose + incoming pose).
+// Distant, settled instances share poses: they are bucketed by state and
+// clip phase and each bucket is evaluated once per frame.
+
+enum class AnimState : uint8_t { Idle, Walk, Run, Attack, Drink, Sleep, COUNT };
+
+inline const char *AnimStateName(AnimState s) {
+  switch (s) {
+  case AnimState::Idle:
+    return "Idle";
+  case AnimState::Walk:
+    return "Walk";
+  case AnimState::Run:
+    return "Run";
+  case AnimState::Attack:
+    return "Attack";
+  case AnimState::Drink:
+    return "Drink";
+  case AnimState::Sleep:
+    return "Sleep";
+  default:
+    return "Unknown";
+  }
+}
+
+inline AnimState StateForAction(Core::AI::ActionType action) {
+  using Core::AI::ActionType;
+  switch (action) {
+  case ActionType::Wander:
+  case ActionType::SeekFood:
+  case ActionType::SeekWater:
+  case ActionType::Patrol:
+    return AnimState::Walk;
+  case ActionType::Hunt:
+  case ActionType::Flee:
+    return AnimState::Run;
+  case ActionType::Defend:
+    return AnimState::Attack;
+  case ActionType::Eat: // Head-down loop doubles as grazing
+  case ActionType::Drink:
+    return AnimState::Drink;
+  case ActionType::Sleep:
+    return AnimState::Sleep;
+  default:
+    return AnimState::Idle;
+  }
+}
+
+struct AnimStateConfig {
+  const Assets::AnimationClip *clip = nullptr;
+  float playbackRate = 1.0f;
+  float fadeIn = 0.25f; // Crossfade duration when entering this state
+};
+
+struct AnimInstanceState {
+  AnimState state = AnimState::Idle;
+  AnimState previous = AnimState::Idle;
+  float stateTime = 0.0f;
+  float previousTime = 0.0f;
+  float fadeElapsed = 0.0f;
+  float fadeDuration = 0.0f; // 0 = not fading
+  float cameraDistance = 0.0f;
+  Assets::AnimationCursor cursor;
+  Assets::AnimationCursor previousCursor;
+
+  bool Fading() const { return fadeElapsed < fadeDuration; }
+};
+
+class AnimationStateMachine {
+public:
+  static constexpr int STATE_COUNT = static_cast<int>(AnimState::COUNT);
+
+  std::array<AnimStateConfig, STATE_COUNT> states;
+  std::vector<AnimInstanceState> instances;
+
+  // Pose sharing for distant instances
+  float cacheDistance = 80.0f;
+  uint32_t phaseBuckets = 16;
+
+  // Output of Evaluate: palette slot per instance (shared slots for cached)
+  std::vector<uint32_t> paletteSlot;
+
+  // Stats (last Evaluate)
+  uint32_t evaluatedPoses = 0;
+  uint32_t sharedInstances = 0;
+
+  void SetClip(AnimState state, const Assets::AnimationClip *clip,
+               float playbackRate = 1.0f, float fadeIn = 0.25f) {
+    states[static_cast<int>(state)] = {clip, playbackRate, fadeIn};
+  }
+
+  uint32_t AddInstance(AnimState initial = AnimState::Idle,
+                       float phaseOffset = 0.0f) {
+    AnimInstanceState inst;
+    inst.state = inst.previous = initial;
+    inst.stateTime = phaseOffset;
+    instances.push_back(inst);
+    return static_cast<uint32_t>(instances.size() - 1);
+  }
+
+  void SetAction(uint32_t id, Core::AI::ActionType action) {
+    SetState(id, StateForAction(action));
+  }
+
+  void SetState(uint32_t id, AnimState next) {
+    AnimInstanceState &inst = instances[id];
+    if (inst.state == next)
+      return;
+    inst.previous = inst.state;
+    inst.previousTime = inst.stateTime;
+    std::swap(inst.cursor, inst.previousCursor);
+    inst.state = next;
+    inst.stateTime = 0.0f;
+    inst.fadeElapsed = 0.0f;
+    inst.fadeDuration = states[static_cast<int>(next)].fadeIn;
+  }
+
+  void Update(float dt) {
+    for (auto &inst : instances) {
+      inst.stateTime += dt * states[static_cast<int>(inst.state)].playbackRate;
+      if (inst.Fading()) {
+        inst.previousTime +=
+            dt * states[static_cast<int>(inst.previous)].playbackRate;
+        inst.fadeElapsed += dt;
+      }
+    }
+  }
+
+  // Build the blend trees, evaluate them in batches and fill paletteSlot.
+  void Evaluate(SkinningPaletteBuilder &builder,
+                Core::Threading::JobSystem *jobs = nullptr) {
+    poses.clear();
+    paletteSlot.resize(instances.size());
+    bucketSlot.assign(size_t(STATE_COUNT) * phaseBuckets, -1);
+    sharedInstances = 0;
+
+    for (size_t i = 0; i < instances.size(); ++i) {
+      AnimInstanceState &inst = instances[i];
+      const AnimStateConfig &cfg = states[static_cast<int>(inst.state)];
+
+      if (inst.cameraDistance > cacheDistance && !inst.Fading() && cfg.clip) {
+        uint32_t bucket = PhaseBucket(*cfg.clip, inst.stateTime);
+        int32_t &slot =
+            bucketSlot[static_cast<int>(inst.state) * phaseBuckets + bucket];
+        if (slot < 0) {
+          slot = static_cast<int32_t>(poses.size());
+          PoseInstance pose;
+          pose.layerCount = 1;
+          pose.layers[0].clip = cfg.clip;
+          pose.layers[0].time =
+              (bucket + 0.5f) / phaseBuckets * cfg.clip->duration;
+          poses.push_back(pose);
+        } else {
+          ++sharedInstances;
+        }
+        paletteSlot[i] = static_cast<uint32_t>(slot);
+        continue;
+      }
+
+      PoseInstance pose;
+      if (inst.Fading()) {
+        // Layer 0: outgoing state, layer 1: incoming state at fade weight
+        pose.layers[0] = {states[static_cast<int>(inst.previous)].clip,
+                          &inst.previousCursor, inst.previousTime, 1.0f,
+                          nullptr};
+        pose.layers[1] = {cfg.clip, &inst.cursor, inst.stateTime,
+                          inst.fadeElapsed / inst.fadeDuration, nullptr};
+        pose.layerCount = 2;
+      } else {
+        pose.layers[0] = {cfg.clip, &inst.cursor, inst.stateTime, 1.0f,
+                          nullptr};
+        pose.layerCount = 1;
+      }
+      paletteSlot[i] = static_cast<uint32_t>(poses.size());
+      poses.push_back(pose);
+    }
+
+    evaluatedPoses = static_cast<uint32_t>(poses.size());
+    builder.Build(poses, jobs);
+  }
+
+private:
+  std::vector<PoseInstance> poses;
+  std::vector<int32_t> bucketSlot;
+
+  uint32_t PhaseBucket(const Assets::AnimationClip &clip, float time) const {
+    if (clip.duration <= 0.0f)
+      return 0;
+    float phase = clip.LocalTime(time) / clip.duration;
+    return std::min(phaseBuckets - 1,
+                    static_cast<uint32_t>(phase * phaseBuckets));
+  }
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
@@ -1,7 +1,12 @@
 #pragma once
+#include "../Assets/AnimationLoader.h"
+#include "../Core/Math/Vec3.h"
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -10,12 +15,14 @@ namespace Graphics {
 
 // GPU Animation Instancing: Store bone matrices in a 2D texture
 // Each row = one animation frame
-// Each column = one bone matrix (4x4 = 16 floats packed into 4 RGBA texels)
+// Each column = one bone matrix (3x4 = 12 values packed into 3 RGBA texels,
+// the implied last row is 0 0 0 1)
 // All instances read from this texture with a time offset -> desynchronized
 // animation
 
 using Mat4 = std::array<float, 16>;
 
+// Pre-baked clip (legacy input: full 4x4 skinning matrices per frame)
 struct AnimationClip {
   std::string name;
   float duration; // seconds
@@ -30,19 +37,231 @@ struct InstanceData {
   std::array<float, 16> worldTransform; // Model matrix
 };
 
+// =========================================================================
+// Half-float packing (IEEE 754 binary16, round-to-nearest)
+// =========================================================================
+inline uint16_t FloatToHalf(float f) {
+  uint32_t x;
+  std::memcpy(&x, &f, sizeof(x));
+  uint32_t sign = (x >> 16) & 0x8000u;
+  int32_t exp = static_cast<int32_t>((x >> 23) & 0xFFu) - 127 + 15;
+  uint32_t mant = x & 0x7FFFFFu;
+
+  if (exp <= 0) { // Subnormal or zero
+    if (exp < -10)
+      return static_cast<uint16_t>(sign);
+    mant |= 0x800000u;
+    uint32_t shift = static_cast<uint32_t>(14 - exp);
+    uint32_t half = mant >> shift;
+    if ((mant >> (shift - 1)) & 1u)
+      ++half;
+    return static_cast<uint16_t>(sign | half);
+  }
+  if (((x >> 23) & 0xFFu) == 0xFFu) // Inf stays Inf, NaN stays quiet NaN
+    return static_cast<uint16_t>(sign | 0x7C00u | (mant ? 0x200u : 0u));
+  if (exp >= 31) // Finite but above 65504: rounds to Inf
+    return static_cast<uint16_t>(sign | 0x7C00u);
+
+  uint32_t half = sign | (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+  if (mant & 0x1000u) // Round (may carry into the exponent, which is correct)
+    ++half;
+  return static_cast<uint16_t>(half);
+}
+
+inline float HalfToFloat(uint16_t h) {
+  uint32_t sign = (static_cast<uint32_t>(h) & 0x8000u) << 16;
+  uint32_t exp = (h >> 10) & 0x1Fu;
+  uint32_t mant = h & 0x3FFu;
+  uint32_t x;
+  if (exp == 0) {
+    if (mant == 0) {
+      x = sign;
+    } else { // Normalize subnormal
+      exp = 1;
+      while (!(mant & 0x400u)) {
+        mant <<= 1;
+        --exp;
+      }
+      mant &= 0x3FFu;
+      x = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+  } else if (exp == 31) {
+    x = sign | 0x7F800000u | (mant << 13);
+  } else {
+    x = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+  }
+  float f;
+  std::memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+// =========================================================================
+// Bone Atlas: every clip's frames packed into one contiguous texture
+// =========================================================================
+enum class BoneFormat : uint8_t {
+  Float3x4, // RGBA32F, 48 bytes per bone
+  Half3x4   // RGBA16F, 24 bytes per bone
+};
+
+struct BakedClip {
+  std::string name;
+  uint32_t firstRow = 0; // First atlas row of this clip
+  uint32_t frameCount = 0;
+  uint32_t boneCount = 0;
+  float framesPerSecond = 30.0f;
+  float duration = 0.0f;
+  bool loops = true;
+};
+
+struct BoneAtlas {
+  static constexpr int VALUES_PER_BONE = 12; // 3x4 row-major
+  static constexpr int TEXELS_PER_BONE = 3;  // RGBA texels
+
+  BoneFormat format = BoneFormat::Float3x4;
+  uint32_t bonesPerRow = 0;
+  uint32_t rowCount = 0;
+  std::vector<float> rows;      // Float3x4 storage
+  std::vector<uint16_t> halfs;  // Half3x4 storage
+
+  size_t RowStride() const { return size_t(bonesPerRow) * VALUES_PER_BONE; }
+  uint32_t TextureWidth() const { return bonesPerRow * TEXELS_PER_BONE; }
+  uint32_t TextureHeight() const { return rowCount; }
+
+  const void *Data() const {
+    return format == BoneFormat::Half3x4
+               ? static_cast<const void *>(halfs.data())
+               : static_cast<const void *>(rows.data());
+  }
+  size_t SizeBytes() const {
+    return format == BoneFormat::Half3x4 ? halfs.size() * sizeof(uint16_t)
+                                         : rows.size() * sizeof(float);
+  }
+
+  // Append one row of RowStride() values, converting to the atlas format
+  void AppendRow(const float *values) {
+    size_t stride = RowStride();
+    if (format == BoneFormat::Half3x4) {
+      size_t base = halfs.size();
+      halfs.resize(base + stride);
+      for (size_t i = 0; i < stride; ++i)
+        halfs[base + i] = FloatToHalf(values[i]);
+    } else {
+      rows.insert(rows.end(), values, values + stride);
+    }
+    ++rowCount;
+  }
+
+  // Read one bone (12 values) of a row
+  void ReadBone(uint32_t row, uint32_t bone, float *out) const {
+    size_t offset = row * RowStride() + size_t(bone) * VALUES_PER_BONE;
+    if (format == BoneFormat::Half3x4) {
+      for (int i = 0; i < VALUES_PER_BONE; ++i)
+        out[i] = HalfToFloat(halfs[offset + i]);
+    } else {
+      std::memcpy(out, &rows[offset], VALUES_PER_BONE * sizeof(float));
+    }
+  }
+};
+
 class GPUAnimationSystem {
 public:
   static constexpr int MAX_BONES = 64;
   static constexpr int TEXTURE_WIDTH =
-      MAX_BONES * 4; // 4 texels per bone (4x4 matrix)
+      MAX_BONES * BoneAtlas::TEXELS_PER_BONE; // 3 texels per bone (3x4)
 
-  // Conceptually: all clips are baked into one big texture on load
-  std::vector<AnimationClip> clips;
+  // All clips are baked into one atlas on load
+  BoneAtlas atlas;
+  std::vector<BakedClip> clips;
   std::vector<InstanceData> instances;
 
-  // Register an animation clip
+  explicit GPUAnimationSystem(BoneFormat format = BoneFormat::Float3x4) {
+    atlas.format = format;
+    atlas.bonesPerRow = MAX_BONES;
+  }
+
+  // Register a pre-baked clip (4x4 matrices per frame)
   uint32_t AddClip(const AnimationClip &clip) {
-    clips.push_back(clip);
+    BakedClip baked = BeginClip(clip.name, clip.duration, clip.framesPerSecond,
+                                true);
+    std::vector<float> row(atlas.RowStride(), 0.0f);
+    for (const auto &frame : clip.frames) {
+      baked.boneCount = std::max(
+          baked.boneCount,
+          static_cast<uint32_t>(std::min<size_t>(frame.size(), MAX_BONES)));
+      std::fill(row.begin(), row.end(), 0.0f);
+      for (size_t b = 0; b < frame.size() && b < MAX_BONES; ++b)
+        Pack3x4(frame[b].data(), &row[b * BoneAtlas::VALUES_PER_BONE]);
+      atlas.AppendRow(row.data());
+    }
+    baked.frameCount = static_cast<uint32_t>(clip.frames.size());
+    clips.push_back(baked);
+    return static_cast<uint32_t>(clips.size() - 1);
+  }
+
+  // Bake a keyframed clip against its skeleton: samples the tracks at a fixed
+  // rate, walks the hierarchy and stores skinning matrices
+  // (global * inverseBind). Bones must be stored parents-first.
+  uint32_t BakeClip(const Assets::Skeleton &skeleton,
+                    const Assets::AnimationClip &clip,
+                    float framesPerSecond = 30.0f) {
+    uint32_t boneCount = static_cast<uint32_t>(
+        std::min<size_t>(skeleton.bones.size(), MAX_BONES));
+    BakedClip baked =
+        BeginClip(clip.name, clip.duration, framesPerSecond, clip.loops);
+    baked.boneCount = boneCount;
+
+    // Looping clips wrap frame N-1 -> 0, one-shots keep the end pose
+    uint32_t frameCount = std::max(
+        1u, static_cast<uint32_t>(std::ceil(clip.duration * framesPerSecond)));
+    if (!clip.loops)
+      ++frameCount;
+    baked.frameCount = frameCount;
+
+    // Bind pose for bones without a track
+    std::vector<Assets::BoneKeyframe> pose(boneCount);
+    std::vector<Math::Mat4> global(boneCount);
+    std::vector<float> row(atlas.RowStride(), 0.0f);
+    Assets::AnimationCursor cursor; // Frames are baked in time order
+    cursor.Reset(clip.tracks.size());
+
+    for (uint32_t f = 0; f < frameCount; ++f) {
+      float t = std::min(static_cast<float>(f) / framesPerSecond,
+                         clip.duration);
+      for (uint32_t b = 0; b < boneCount; ++b) {
+        const auto &bone = skeleton.bones[b];
+        pose[b] = {t, bone.localPosition, bone.localRotation, bone.localScale};
+      }
+      for (size_t i = 0; i < clip.tracks.size(); ++i) {
+        const auto &track = clip.tracks[i];
+        if (track.boneIndex >= 0 &&
+            static_cast<uint32_t>(track.boneIndex) < boneCount)
+          pose[track.boneIndex] = track.Sample(t, cursor.keys[i]);
+      }
+
+      std::fill(row.begin(), row.end(), 0.0f);
+      for (uint32_t b = 0; b < boneCount; ++b) {
+        const auto &bone = skeleton.bones[b];
+        Math::Mat4 local = Math::Mat4::Translation(pose[b].translation) *
+                           Math::Mat4::FromQuat(pose[b].rotation) *
+                           Math::Mat4::Scale(pose[b].scale);
+        int parent = bone.parentIndex;
+        global[b] = (parent >= 0 && static_cast<uint32_t>(parent) < b)
+                        ? global[parent] * local
+                        : local;
+
+        Math::Mat4 invBind;
+        std::memcpy(invBind.m, bone.inverseBindMatrix.data(),
+                    sizeof(invBind.m));
+        Math::Mat4 skin = global[b] * invBind;
+        Pack3x4(skin.m, &row[b * BoneAtlas::VALUES_PER_BONE]);
+      }
+      atlas.AppendRow(row.data());
+    }
+
+    clips.push_back(baked);
+    std::cout << "[GPUAnimation] Baked '" << clip.name << "': " << frameCount
+              << " frames x " << boneCount << " bones (" << atlas.SizeBytes()
+              << " bytes atlas)" << std::endl;
     return static_cast<uint32_t>(clips.size() - 1);
   }
 
@@ -57,33 +276,117 @@ public:
     instances.push_back(inst);
   }
 
-  // CPU reference: resolve bone matrices for an instance at time t
+  // CPU sampler: writes up to `capacity` 3x4 row-major bone matrices
+  // (12 floats each) into `out`. Returns the number of bones written.
+  uint32_t SampleBones3x4(uint32_t clipIndex, float time, float *out,
+                          uint32_t capacity) const {
+    const BakedClip &clip = clips[clipIndex];
+    if (clip.frameCount == 0)
+      return 0;
+
+    uint32_t row0, row1;
+    float blend;
+    FrameRows(clip, time, row0, row1, blend);
+
+    uint32_t count = std::min(clip.boneCount, capacity);
+    float a[BoneAtlas::VALUES_PER_BONE], b[BoneAtlas::VALUES_PER_BONE];
+    for (uint32_t bone = 0; bone < count; ++bone) {
+      atlas.ReadBone(row0, bone, a);
+      atlas.ReadBone(row1, bone, b);
+      float *dst = out + size_t(bone) * BoneAtlas::VALUES_PER_BONE;
+      for (int j = 0; j < BoneAtlas::VALUES_PER_BONE; ++j)
+        dst[j] = a[j] + (b[j] - a[j]) * blend;
+    }
+    return count;
+  }
+
+  // CPU reference: resolve 4x4 bone matrices for an instance at time t into
+  // a caller-provided buffer (no allocation). Returns bones written.
+  uint32_t ResolveBones(const InstanceData &inst, float globalTime, Mat4 *out,
+                        uint32_t capacity) const {
+    float packed[MAX_BONES * BoneAtlas::VALUES_PER_BONE];
+    uint32_t count = SampleBones3x4(inst.clipIndex,
+                                    globalTime + inst.timeOffset, packed,
+                                    std::min<uint32_t>(capacity, MAX_BONES));
+    for (uint32_t b = 0; b < count; ++b)
+      Unpack3x4(&packed[b * BoneAtlas::VALUES_PER_BONE], out[b].data());
+    return count;
+  }
+
+  // Convenience wrapper (allocates; prefer the buffer overload per frame)
   std::vector<Mat4> ResolveBones(const InstanceData &inst,
                                  float globalTime) const {
-    const AnimationClip &clip = clips[inst.clipIndex];
-    float localTime = std::fmod(globalTime + inst.timeOffset, clip.duration);
-    float frameF = localTime * clip.framesPerSecond;
-    int frame0 =
-        static_cast<int>(frameF) % static_cast<int>(clip.frames.size());
-    int frame1 = (frame0 + 1) % static_cast<int>(clip.frames.size());
-    float blend = frameF - std::floor(frameF);
-
-    // Linear interpolation between frames (LERP on matrices - simplified)
-    std::vector<Mat4> result(clip.frames[frame0].size());
-    for (size_t b = 0; b < result.size(); ++b) {
-      for (int j = 0; j < 16; ++j) {
-        result[b][j] = clip.frames[frame0][b][j] * (1.0f - blend) +
-                       clip.frames[frame1][b][j] * blend;
-      }
-    }
+    std::vector<Mat4> result(clips[inst.clipIndex].boneCount);
+    result.resize(ResolveBones(inst, globalTime, result.data(),
+                               static_cast<uint32_t>(result.size())));
     return result;
   }
 
-  // In GPU path: all of this happens in a Vertex Shader reading from the bone
-  // texture Vertex Shader pseudocode:
-  //   float row = (time + instanceOffset) * fps;
-  //   mat4 bone = texelFetch(boneTexture, ivec2(boneIndex * 4, row), 0);
+  // In GPU path: the atlas is uploaded as a TEXTURE_WIDTH x rowCount texture
+  // (RGBA32F or RGBA16F). Vertex Shader pseudocode, identical to FrameRows
+  // and SampleBones3x4 (GLSL mod() is already non-negative):
+  //   float t = time + instanceOffset;
+  //   t = loops && duration > 0.0 ? mod(t, duration)
+  //                               : clamp(t, 0.0, duration);
+  //   float f = t * framesPerSecond;
+  //   uint f0 = min(uint(f), frameCount - 1);
+  //   uint f1 = loops ? (f0 + 1) % frameCount : min(f0 + 1, frameCount - 1);
+  //   float blend = clamp(f - float(f0), 0.0, 1.0);
+  //   int row0 = int(firstRow + f0), row1 = int(firstRow + f1);
+  //   for k in 0..2:
+  //     r[k] = mix(texelFetch(boneAtlas, ivec2(boneIndex * 3 + k, row0), 0),
+  //                texelFetch(boneAtlas, ivec2(boneIndex * 3 + k, row1), 0),
+  //                blend);
+  //   mat4 bone = transpose(mat4(r[0], r[1], r[2], vec4(0, 0, 0, 1)));
   //   gl_Position = VP * worldMatrix * bone * vertexPos;
+
+private:
+  BakedClip BeginClip(const std::string &name, float duration, float fps,
+                      bool loops) const {
+    BakedClip baked;
+    baked.name = name;
+    baked.firstRow = atlas.rowCount;
+    baked.framesPerSecond = fps;
+    baked.duration = duration;
+    baked.loops = loops;
+    return baked;
+  }
+
+  // Same frame selection as the vertex shader
+  static void FrameRows(const BakedClip &clip, float time, uint32_t &row0,
+                        uint32_t &row1, float &blend) {
+    float localTime;
+    if (clip.loops && clip.duration > 0.0f) {
+      localTime = std::fmod(time, clip.duration);
+      if (localTime < 0.0f)
+        localTime += clip.duration;
+    } else {
+      localTime = std::clamp(time, 0.0f, clip.duration);
+    }
+
+    float frameF = localTime * clip.framesPerSecond;
+    uint32_t f0 = std::min(static_cast<uint32_t>(frameF), clip.frameCount - 1);
+    uint32_t f1 = clip.loops ? (f0 + 1) % clip.frameCount
+                             : std::min(f0 + 1, clip.frameCount - 1);
+    blend = std::clamp(frameF - static_cast<float>(f0), 0.0f, 1.0f);
+    row0 = clip.firstRow + f0;
+    row1 = clip.firstRow + f1;
+  }
+
+  // Column-major 4x4 -> row-major 3x4
+  static void Pack3x4(const float *m, float *dst) {
+    for (int r = 0; r < 3; ++r)
+      for (int c = 0; c < 4; ++c)
+        dst[r * 4 + c] = m[c * 4 + r];
+  }
+
+  static void Unpack3x4(const float *src, float *m) {
+    for (int r = 0; r < 3; ++r)
+      for (int c = 0; c < 4; ++c)
+        m[c * 4 + r] = src[r * 4 + c];
+    m[3] = m[7] = m[11] = 0.0f;
+    m[15] = 1.0f;
+  }
 };
 
 } // namespace Graphics
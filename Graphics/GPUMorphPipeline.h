@@ -1,7 +1,11 @@
 #pragma once
+#include "MorphDeltaCodec.h"
+#include "UberMesh.h"
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -17,42 +21,78 @@ namespace Graphics {
 
 // Push constant data for the morph compute shader
 struct MorphComputePushConstants {
-  uint32_t vertexCount;
-  uint32_t targetCount;
+  uint32_t workItemCount;
+  uint32_t dispatchCount;
   uint32_t padding[2];
 };
 
-// Per-entity morph dispatch data
+// Per-entity morph dispatch data (std430, one record per entity in an SSBO)
 struct MorphDispatch {
   uint32_t entityId;
   uint32_t baseVertexOffset; // Offset into global vertex buffer
   uint32_t vertexCount;
-  uint32_t morphTargetOffset; // Offset into morph delta buffer
-  float weights[16];          // Up to 16 morph targets per entity
+  uint32_t morphTargetOffset;  // Offset into morph delta buffer
+  uint32_t outputVertexOffset; // Offset into the morphed output buffer
+  uint32_t targetCount;
+  uint32_t padding[2];
+  float weights[16]; // Up to 16 morph targets per entity
+};
+static_assert(sizeof(MorphDispatch) == 96, "std430 layout");
+
+// One workgroup of the flattened (entity, vertex-block) list
+struct MorphWorkItem {
+  uint32_t dispatchIndex;
+  uint32_t firstVertex; // Entity-local first vertex of the block
+};
+
+// Mirrors VkDispatchIndirectCommand
+struct DispatchIndirectCommand {
+  uint32_t x = 0;
+  uint32_t y = 1;
+  uint32_t z = 1;
 };
 
 // =========================================================================
 // GPU Morphing Pipeline
 // Runs as a Compute Shader before the vertex stage
 // =========================================================================
+// All entities are morphed by one indirect dispatch: every MorphDispatch
+// lives in a single SSBO and each workgroup looks up its (entity, block)
+// pair in the work list, so per-entity push constants and dispatch calls
+// are gone.
 class GPUMorphPipeline {
 public:
+  static constexpr uint32_t GROUP_SIZE = 64;      // local_size_x
+  static constexpr uint32_t MAX_GROUPS_X = 65535; // Spec minimum limit
+
   // Buffers (managed by VulkanBackend)
   // inputVertexBuffer:  Base mesh vertices (read-only)
   // morphDeltaBuffer:   All morph deltas packed (read-only)
   // outputVertexBuffer: Deformed vertices (write, used as VBO)
-  // dispatchBuffer:     Per-entity morph dispatch data
+  // dispatchBuffer:     MorphDispatch[] records
+  // workListBuffer:     MorphWorkItem[] for the indirect dispatch
+  // indirectBuffer:     One DispatchIndirectCommand
 
   std::vector<MorphDispatch> dispatches;
+  std::vector<MorphWorkItem> workItems;
+  DispatchIndirectCommand indirect;
 
+  // Outputs are packed back to back unless an explicit offset is given
   void PrepareDispatch(uint32_t entityId, uint32_t baseOffset,
                        uint32_t vertCount, uint32_t morphOffset,
-                       const std::vector<float> &weights) {
-    MorphDispatch d;
+                       const std::vector<float> &weights,
+                       uint32_t outputOffset = AUTO_OFFSET) {
+    MorphDispatch d{};
     d.entityId = entityId;
     d.baseVertexOffset = baseOffset;
     d.vertexCount = vertCount;
     d.morphTargetOffset = morphOffset;
+    d.outputVertexOffset =
+        outputOffset == AUTO_OFFSET ? nextOutputOffset : outputOffset;
+    d.targetCount =
+        static_cast<uint32_t>(std::min<size_t>(weights.size(), 16));
+    nextOutputOffset =
+        std::max(nextOutputOffset, d.outputVertexOffset + vertCount);
 
     for (int i = 0; i < 16; ++i) {
       d.weights[i] = (i < static_cast<int>(weights.size())) ? weights[i] : 0.0f;
@@ -60,17 +100,52 @@ public:
     dispatches.push_back(d);
   }
 
+  // Flatten every dispatch into GROUP_SIZE-vertex blocks and size the
+  // indirect command. Long lists spill into Y (maxComputeWorkGroupCount).
+  void BuildWorkList() {
+    workItems.clear();
+    for (uint32_t i = 0; i < dispatches.size(); ++i) {
+      for (uint32_t v = 0; v < dispatches[i].vertexCount; v += GROUP_SIZE)
+        workItems.push_back({i, v});
+    }
+    uint32_t groups = static_cast<uint32_t>(workItems.size());
+    indirect.x = std::min(groups, MAX_GROUPS_X);
+    indirect.y =
+        groups > MAX_GROUPS_X ? (groups + MAX_GROUPS_X - 1) / MAX_GROUPS_X : 1;
+    indirect.z = 1;
+  }
+
+  MorphComputePushConstants PushConstants() const {
+    return {static_cast<uint32_t>(workItems.size()),
+            static_cast<uint32_t>(dispatches.size()),
+            {0, 0}};
+  }
+
+  size_t DispatchBufferBytes() const {
+    return dispatches.size() * sizeof(MorphDispatch);
+  }
+  size_t WorkListBytes() const {
+    return workItems.size() * sizeof(MorphWorkItem);
+  }
+  uint32_t OutputVertexCount() const { return nextOutputOffset; }
+
+  // Copy the records into mapped staging memory
+  void WriteBuffers(void *dispatchDst, void *workListDst,
+                    void *indirectDst) const {
+    std::memcpy(dispatchDst, dispatches.data(), DispatchBufferBytes());
+    std::memcpy(workListDst, workItems.data(), WorkListBytes());
+    std::memcpy(indirectDst, &indirect, sizeof(indirect));
+  }
+
   void Execute() {
-    // In real Vulkan:
+    // In real Vulkan (after BuildWorkList + WriteBuffers):
     // vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-    // morphComputePipeline); vkCmdBindDescriptorSets(cmd,
-    // VK_PIPELINE_BIND_POINT_COMPUTE, ...);
-    //
-    // for (auto& d : dispatches) {
-    //     vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
-    //     sizeof(d), &d); uint32_t groupCount = (d.vertexCount + 63) / 64; //
-    //     64 threads per group vkCmdDispatch(cmd, groupCount, 1, 1);
-    // }
+    //     morphComputePipeline);
+    // vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, ...);
+    // auto pc = PushConstants();
+    // vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+    //     sizeof(pc), &pc);
+    // vkCmdDispatchIndirect(cmd, indirectBuffer, 0);
     //
     // // Memory barrier: compute write -> vertex read
     // VkMemoryBarrier barrier{};
@@ -81,7 +156,55 @@ public:
     //     nullptr);
   }
 
-  void Clear() { dispatches.clear(); }
+  // CPU reference of the compute shader: walks the indirect grid group by
+  // group and invocation by invocation, with the shader's index math (delta
+  // morphTargetOffset + t * vertexCount + gid, scaled by header slot t).
+  // `packed` is read as the raw GPU buffer, so dispatches sharing a delta
+  // buffer must share its scale header.
+  void ExecuteCPU(const std::vector<Vertex> &baseVerts,
+                  const PackedMorphBuffer &packed,
+                  std::vector<Vertex> &outVerts) const {
+    outVerts.resize(std::max<size_t>(outVerts.size(), nextOutputOffset));
+    uint32_t groupCount = indirect.x * indirect.y * indirect.z;
+    for (uint32_t group = 0; group < groupCount; ++group) {
+      if (group >= workItems.size())
+        break; // Padding groups of the last Y row
+      const MorphWorkItem &item = workItems[group];
+      const MorphDispatch &d = dispatches[item.dispatchIndex];
+      for (uint32_t local = 0; local < GROUP_SIZE; ++local) {
+        uint32_t gid = item.firstVertex + local;
+        if (gid >= d.vertexCount)
+          break;
+        Vertex v = baseVerts[d.baseVertexOffset + gid];
+        for (uint32_t t = 0; t < d.targetCount; ++t) {
+          float w = d.weights[t];
+          if (std::abs(w) < 0.001f)
+            continue;
+          uint32_t did = d.morphTargetOffset + t * d.vertexCount + gid;
+          MorphDelta delta = packed.DecodeAt(did, t);
+          for (int k = 0; k < 3; ++k) {
+            v.position[k] += delta.positionDelta[k] * w;
+            v.normal[k] += delta.normalDelta[k] * w;
+          }
+        }
+        float len = std::sqrt(v.normal[0] * v.normal[0] +
+                              v.normal[1] * v.normal[1] +
+                              v.normal[2] * v.normal[2]);
+        if (len > 0.0f) {
+          for (int k = 0; k < 3; ++k)
+            v.normal[k] /= len;
+        }
+        outVerts[d.outputVertexOffset + gid] = v;
+      }
+    }
+  }
+
+  void Clear() {
+    dispatches.clear();
+    workItems.clear();
+    indirect = {};
+    nextOutputOffset = 0;
+  }
 
   // =====================================================================
   // GLSL Compute Shader source (embedded as string for runtime compilation)
@@ -101,9 +224,28 @@ public:
                     vec4 boneWeights;
                 };
 
+                // PackedMorphDelta (see MorphDeltaCodec.h)
                 struct MorphDelta {
-                    vec3 positionDelta;
-                    vec3 normalDelta;
+                    uint w0; // snorm16 pos.x | pos.y
+                    uint w1; // snorm16 pos.z | unorm16 normal length
+                    uint w2; // snorm16 oct normal direction
+                };
+
+                struct MorphDispatch {
+                    uint entityId;
+                    uint baseVertexOffset;
+                    uint vertexCount;
+                    uint morphTargetOffset;
+                    uint outputVertexOffset;
+                    uint targetCount;
+                    uint pad0;
+                    uint pad1;
+                    float weights[16];
+                };
+
+                struct MorphWorkItem {
+                    uint dispatchIndex;
+                    uint firstVertex;
                 };
 
                 layout(std430, binding = 0) readonly buffer BaseVertices {
@@ -111,45 +253,75 @@ public:
                 };
 
                 layout(std430, binding = 1) readonly buffer MorphDeltas {
+                    vec2 scales[16]; // Per target position / normal scale
                     MorphDelta deltas[];
                 };
 
+                vec3 octDecode(vec2 e) {
+                    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+                    if (v.z < 0.0) {
+                        vec2 s = mix(vec2(-1.0), vec2(1.0),
+                                     greaterThanEqual(v.xy, vec2(0.0)));
+                        v.xy = (1.0 - abs(v.yx)) * s;
+                    }
+                    return normalize(v);
+                }
+
                 layout(std430, binding = 2) writeonly buffer OutputVertices {
                     Vertex outVerts[];
                 };
 
+                layout(std430, binding = 3) readonly buffer Dispatches {
+                    MorphDispatch dispatches[];
+                };
+
+                layout(std430, binding = 4) readonly buffer WorkList {
+                    MorphWorkItem workItems[];
+                };
+
                 layout(push_constant) uniform PushConstants {
-                    uint vertexCount;
-                    uint targetCount;
-                    uint baseOffset;
-                    uint deltaOffset;
-                    float weights[16];
+                    uint workItemCount;
+                    uint dispatchCount;
                 } pc;
 
                 void main() {
-                    uint gid = gl_GlobalInvocationID.x;
-                    if (gid >= pc.vertexCount) return;
+                    // Flattened group index (X spills into Y on huge lists)
+                    uint group = gl_WorkGroupID.y * gl_NumWorkGroups.x +
+                                 gl_WorkGroupID.x;
+                    if (group >= pc.workItemCount) return;
 
-                    uint vid = pc.baseOffset + gid;
-                    Vertex v = baseVerts[vid];
+                    MorphWorkItem item = workItems[group];
+                    MorphDispatch e = dispatches[item.dispatchIndex];
+                    uint gid = item.firstVertex + gl_LocalInvocationID.x;
+                    if (gid >= e.vertexCount) return;
+
+                    Vertex v = baseVerts[e.baseVertexOffset + gid];
 
                     // Apply morph targets: V_final = V_base + Sum(Delta_i * Weight_i)
-                    for (uint t = 0; t < pc.targetCount && t < 16; ++t) {
-                        float w = pc.weights[t];
+                    for (uint t = 0; t < e.targetCount && t < 16; ++t) {
+                        float w = e.weights[t];
                         if (abs(w) < 0.001) continue;
 
-                        uint did = pc.deltaOffset + t * pc.vertexCount + gid;
+                        uint did = e.morphTargetOffset + t * e.vertexCount + gid;
                         MorphDelta d = deltas[did];
+                        vec3 dp = vec3(unpackSnorm2x16(d.w0),
+                                       unpackSnorm2x16(d.w1).x) * scales[t].x;
+                        float nl = unpackUnorm2x16(d.w1).y * scales[t].y;
+                        vec3 dn = octDecode(unpackSnorm2x16(d.w2)) * nl;
 
-                        v.position += d.positionDelta * w;
-                        v.normal += d.normalDelta * w;
+                        v.position += dp * w;
+                        v.normal += dn * w;
                     }
 
                     v.normal = normalize(v.normal);
-                    outVerts[vid] = v;
+                    outVerts[e.outputVertexOffset + gid] = v;
                 }
             )";
   }
+
+private:
+  static constexpr uint32_t AUTO_OFFSET = 0xFFFFFFFFu;
+  uint32_t nextOutputOffset = 0;
 };
 
 // =========================================================================
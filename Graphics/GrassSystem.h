@@ -0,0 +1,345 @@
+#pragma once
+#include "VulkanBackend.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// =========================================================================
+// Grass Instancing: tile-based density map culled on the CPU
+// The terrain is split into square tiles. Each tile stores how much of it is
+// grass (from the splat map) and its height range (from the height map).
+// Every frame the visible tiles are collected from the camera frustum, given a
+// distance-based density LOD and packed into one compacted instance range, so
+// the vertex shader only ever runs for blades that can actually be on screen.
+// =========================================================================
+
+// Per-tile draw record uploaded to the GPU (std430 layout, 32 bytes).
+// Mirrors `GrassTile` in shader.vert.
+struct GrassTileGPU {
+  float originX;          // World-space min corner
+  float originZ;
+  float size;             // Tile edge length in metres
+  uint32_t firstInstance; // Start of this tile's range in the compacted list
+  uint32_t instanceCount;
+  uint32_t seed; // Stable per-tile hash seed (blades don't pop when panning)
+  uint32_t padding[2];
+};
+
+// Header of the tile SSBO; the tile array follows it directly
+struct GrassTileBufferHeader {
+  uint32_t tileCount;
+  uint32_t totalInstances;
+  uint32_t padding[2];
+};
+
+// Static per-tile data baked from the terrain maps
+struct GrassTileInfo {
+  float minY = 0.0f;
+  float maxY = 0.0f;
+  float coverage = 0.0f; // Fraction of splat texels that accept grass [0..1]
+};
+
+struct GrassConfig {
+  float tileSize = 24.0f;        // Metres per tile edge
+  float maxDistance = 500.0f;    // Matches the old per-vertex distance cull
+  float bladeHeight = 2.5f;      // Padding on the tile AABB for blade height
+  uint32_t maxBladesPerTile = 1600; // LOD0 density at full coverage
+  // Density LOD: fraction of blades kept below each distance
+  std::array<float, 4> lodDistances = {60.0f, 150.0f, 300.0f, 500.0f};
+  std::array<float, 4> lodDensity = {1.0f, 0.5f, 0.2f, 0.08f};
+  // Splat thresholds (same rule as the shader: red = grass, blue = rock)
+  uint8_t minGrassWeight = 51; // 0.2 * 255
+  uint8_t maxRockWeight = 127; // 0.5 * 255
+  uint32_t maxVisibleTiles = 4096;
+};
+
+// =========================================================================
+// View frustum (six planes, extracted from a column-major view-projection)
+// =========================================================================
+struct Frustum {
+  // Plane: (a, b, c, d) with a*x + b*y + c*z + d >= 0 for points inside
+  std::array<std::array<float, 4>, 6> planes{};
+
+  static Frustum FromViewProjection(const std::array<float, 16> &m) {
+    // Row i of a column-major matrix is (m[i], m[4+i], m[8+i], m[12+i])
+    auto row = [&](int i) {
+      return std::array<float, 4>{m[i], m[4 + i], m[8 + i], m[12 + i]};
+    };
+    auto r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    Frustum f;
+    for (int k = 0; k < 4; ++k) {
+      f.planes[0][k] = r3[k] + r0[k]; // Left
+      f.planes[1][k] = r3[k] - r0[k]; // Right
+      f.planes[2][k] = r3[k] + r1[k]; // Bottom
+      f.planes[3][k] = r3[k] - r1[k]; // Top
+      f.planes[4][k] = r2[k];         // Near (Vulkan depth range 0..1)
+      f.planes[5][k] = r3[k] - r2[k]; // Far
+    }
+    for (auto &p : f.planes) {
+      float len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+      if (len > 0.00001f) {
+        for (float &c : p)
+          c /= len;
+      }
+    }
+    return f;
+  }
+
+  // Conservative AABB test (positive-vertex method)
+  bool IntersectsAABB(float minX, float minY, float minZ, float maxX,
+                      float maxY, float maxZ) const {
+    for (const auto &p : planes) {
+      float px = p[0] >= 0 ? maxX : minX;
+      float py = p[1] >= 0 ? maxY : minY;
+      float pz = p[2] >= 0 ? maxZ : minZ;
+      if (p[0] * px + p[1] * py + p[2] * pz + p[3] < 0.0f)
+        return false;
+    }
+    return true;
+  }
+};
+
+// =========================================================================
+// Grass System
+// =========================================================================
+class GrassSystem {
+public:
+  GrassConfig config;
+
+  // Tile grid
+  int tilesX = 0;
+  int tilesZ = 0;
+  float worldWidth = 0.0f;
+  float worldDepth = 0.0f;
+  std::vector<GrassTileInfo> tiles;
+
+  // Per-frame output
+  std::vector<GrassTileGPU> visibleTiles;
+  uint32_t visibleInstanceCount = 0;
+
+  // GPU tile tables (host-visible SSBOs). One per frame in flight: the
+  // frame being recorded writes its own while the GPU may still read the
+  // previous frames' lists.
+  VulkanBackend *backend = nullptr;
+  std::array<GPUBuffer, VulkanBackend::MAX_FRAMES_IN_FLIGHT> tileBuffers;
+
+  // Bake tile coverage and height bounds from terrain data.
+  // heightMap: width*depth floats, splatMap: width*depth RGBA8, scale: metres
+  // per texel. World space is centred on the origin like TerrainSystem.
+  void BuildTiles(const std::vector<float> &heightMap,
+                  const std::vector<uint8_t> &splatMap, int width, int depth,
+                  float scale) {
+    srcHeight = &heightMap;
+    srcSplat = &splatMap;
+    mapWidth = width;
+    mapDepth = depth;
+    mapScale = scale;
+
+    worldWidth = width * scale;
+    worldDepth = depth * scale;
+    tilesX = std::max(1, static_cast<int>(std::ceil(worldWidth /
+                                                    config.tileSize)));
+    tilesZ = std::max(1, static_cast<int>(std::ceil(worldDepth /
+                                                    config.tileSize)));
+    tiles.assign(static_cast<size_t>(tilesX) * tilesZ, GrassTileInfo{});
+
+    for (int tz = 0; tz < tilesZ; ++tz) {
+      for (int tx = 0; tx < tilesX; ++tx) {
+        BakeTile(tx, tz);
+      }
+    }
+  }
+
+  // Re-bake the tiles touched by a terrain edit (paint or sculpt)
+  void RebuildRegion(float worldX, float worldZ, float radius) {
+    if (!srcHeight || !srcSplat || tiles.empty())
+      return;
+    int minTX, minTZ, maxTX, maxTZ;
+    WorldToTile(worldX - radius, worldZ - radius, minTX, minTZ);
+    WorldToTile(worldX + radius, worldZ + radius, maxTX, maxTZ);
+    for (int tz = minTZ; tz <= maxTZ; ++tz) {
+      for (int tx = minTX; tx <= maxTX; ++tx) {
+        BakeTile(tx, tz);
+      }
+    }
+  }
+
+  // Collect visible tiles, assign LOD density and compact instance ranges.
+  // Returns the total instance count for the single instanced draw.
+  uint32_t Cull(const std::array<float, 16> &viewProjection, float camX,
+                float camY, float camZ) {
+    (void)camY;
+    visibleTiles.clear();
+    visibleInstanceCount = 0;
+    if (tiles.empty())
+      return 0;
+
+    Frustum frustum = Frustum::FromViewProjection(viewProjection);
+    float halfW = worldWidth * 0.5f;
+    float halfD = worldDepth * 0.5f;
+    float maxDistSq = config.maxDistance * config.maxDistance;
+
+    // Only walk the tiles inside the max-distance square around the camera
+    int minTX, minTZ, maxTX, maxTZ;
+    WorldToTile(camX - config.maxDistance, camZ - config.maxDistance, minTX,
+                minTZ);
+    WorldToTile(camX + config.maxDistance, camZ + config.maxDistance, maxTX,
+                maxTZ);
+
+    for (int tz = minTZ; tz <= maxTZ; ++tz) {
+      for (int tx = minTX; tx <= maxTX; ++tx) {
+        const GrassTileInfo &info = tiles[tz * tilesX + tx];
+        if (info.coverage <= 0.0f)
+          continue;
+
+        float x0 = tx * config.tileSize - halfW;
+        float z0 = tz * config.tileSize - halfD;
+        float x1 = x0 + config.tileSize;
+        float z1 = z0 + config.tileSize;
+
+        // Distance from camera to the closest point of the tile (XZ)
+        float cx = std::clamp(camX, x0, x1);
+        float cz = std::clamp(camZ, z0, z1);
+        float distSq = (cx - camX) * (cx - camX) + (cz - camZ) * (cz - camZ);
+        if (distSq > maxDistSq)
+          continue;
+
+        if (!frustum.IntersectsAABB(x0, info.minY, z0, x1,
+                                    info.maxY + config.bladeHeight, z1))
+          continue;
+
+        uint32_t count = static_cast<uint32_t>(
+            config.maxBladesPerTile * info.coverage *
+            DensityForDistance(std::sqrt(distSq)));
+        if (count == 0)
+          continue;
+
+        GrassTileGPU t{};
+        t.originX = x0;
+        t.originZ = z0;
+        t.size = config.tileSize;
+        t.firstInstance = visibleInstanceCount;
+        t.instanceCount = count;
+        t.seed = static_cast<uint32_t>(tz * tilesX + tx) * 2654435761u;
+        visibleTiles.push_back(t);
+        visibleInstanceCount += count;
+
+        if (visibleTiles.size() >= config.maxVisibleTiles)
+          return visibleInstanceCount;
+      }
+    }
+    return visibleInstanceCount;
+  }
+
+  float DensityForDistance(float dist) const {
+    for (size_t i = 0; i < config.lodDistances.size(); ++i) {
+      if (dist < config.lodDistances[i])
+        return config.lodDensity[i];
+    }
+    return 0.0f;
+  }
+
+  // --- GPU side ---
+  void InitializeGPU(VulkanBackend *backendPtr) {
+    backend = backendPtr;
+    if (!backend)
+      return;
+    size_t size = sizeof(GrassTileBufferHeader) +
+                  config.maxVisibleTiles * sizeof(GrassTileGPU);
+    for (uint32_t frame = 0; frame < tileBuffers.size(); ++frame) {
+      tileBuffers[frame] = backend->CreateBuffer(
+          size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+      backend->UpdateGrassDescriptor(frame, tileBuffers[frame]);
+    }
+  }
+
+  // Write this frame's tile table into the frame's mapped SSBO. Call while
+  // recording, after BeginFrame has waited on the frame's fence.
+  void Upload() {
+    if (!backend)
+      return;
+    GPUBuffer &tileBuffer = tileBuffers[backend->currentFrame];
+    if (!tileBuffer.mapped)
+      return;
+    GrassTileBufferHeader header{};
+    header.tileCount = static_cast<uint32_t>(visibleTiles.size());
+    header.totalInstances = visibleInstanceCount;
+    auto *dst = static_cast<uint8_t *>(tileBuffer.mapped);
+    memcpy(dst, &header, sizeof(header));
+    memcpy(dst + sizeof(header), visibleTiles.data(),
+           visibleTiles.size() * sizeof(GrassTileGPU));
+  }
+
+  void Cleanup() {
+    if (!backend)
+      return;
+    for (GPUBuffer &tileBuffer : tileBuffers)
+      backend->DestroyBuffer(tileBuffer);
+  }
+
+private:
+  const std::vector<float> *srcHeight = nullptr;
+  const std::vector<uint8_t> *srcSplat = nullptr;
+  int mapWidth = 0;
+  int mapDepth = 0;
+  float mapScale = 1.0f;
+
+  void WorldToTile(float x, float z, int &tx, int &tz) const {
+    tx = static_cast<int>(std::floor((x + worldWidth * 0.5f) /
+                                     config.tileSize));
+    tz = static_cast<int>(std::floor((z + worldDepth * 0.5f) /
+                                     config.tileSize));
+    tx = std::clamp(tx, 0, tilesX - 1);
+    tz = std::clamp(tz, 0, tilesZ - 1);
+  }
+
+  void BakeTile(int tx, int tz) {
+    const auto &heightMap = *srcHeight;
+    const auto &splatMap = *srcSplat;
+
+    float texelsPerTile = config.tileSize / mapScale;
+    int px0 = static_cast<int>(std::floor(tx * texelsPerTile));
+    int pz0 = static_cast<int>(std::floor(tz * texelsPerTile));
+    int px1 = std::min(mapWidth,
+                       static_cast<int>(std::ceil((tx + 1) * texelsPerTile)));
+    int pz1 = std::min(mapDepth,
+                       static_cast<int>(std::ceil((tz + 1) * texelsPerTile)));
+
+    GrassTileInfo info;
+    info.minY = 1e30f;
+    info.maxY = -1e30f;
+    uint32_t grassTexels = 0, totalTexels = 0;
+
+    for (int z = pz0; z < pz1; ++z) {
+      for (int x = px0; x < px1; ++x) {
+        size_t idx = static_cast<size_t>(z) * mapWidth + x;
+        float h = heightMap[idx];
+        info.minY = std::min(info.minY, h);
+        info.maxY = std::max(info.maxY, h);
+        const uint8_t *s = &splatMap[idx * 4];
+        if (s[0] >= config.minGrassWeight && s[2] <= config.maxRockWeight)
+          grassTexels++;
+        totalTexels++;
+      }
+    }
+
+    if (totalTexels == 0) {
+      info = GrassTileInfo{};
+    } else {
+      info.coverage = static_cast<float>(grassTexels) / totalTexels;
+    }
+    tiles[tz * tilesX + tx] = info;
+  }
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
@@ -0,0 +1,201 @@
+#pragma once
+#include "MorphingSystem.h"
+#include "UberMesh.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// =========================================================================
+// Morph Result Cache
+// =========================================================================
+// Phenotypes come from a handful of allele values (ResolvePhenotype yields
+// 0.2 / 1.0 / 1.5), so most of a herd shares a weight vector. The cache
+// quantizes each weight vector into a key and morphs every distinct key
+// once; entities hold a refcounted handle to the shared vertex buffer.
+// Unreferenced results stay resident for reuse until evicted in LRU order.
+
+struct MorphCacheKey {
+  static constexpr size_t MAX_TARGETS = 16; // Matches MorphDispatch
+
+  std::array<int16_t, MAX_TARGETS> q{};
+  uint8_t count = 0;
+
+  bool operator==(const MorphCacheKey &o) const {
+    return count == o.count && q == o.q;
+  }
+};
+
+struct MorphCacheKeyHash {
+  size_t operator()(const MorphCacheKey &k) const {
+    // FNV-1a over the used components
+    uint64_t h = 1469598103934665603ull ^ k.count;
+    for (uint8_t i = 0; i < k.count; ++i) {
+      h ^= static_cast<uint16_t>(k.q[i]);
+      h *= 1099511628211ull;
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+class MorphCache {
+public:
+  using Handle = uint32_t;
+  static constexpr Handle INVALID_HANDLE = 0xFFFFFFFFu;
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+    float HitRate() const {
+      uint64_t total = hits + misses;
+      return total ? static_cast<float>(hits) / total : 0.0f;
+    }
+  };
+
+  // `capacity` bounds the resident results; referenced results are never
+  // evicted, so the cache can exceed it while every entry is in use.
+  // `steps` is the quantization resolution per unit weight.
+  explicit MorphCache(const UberMesh &mesh, size_t capacity = 64,
+                      float steps = 256.0f)
+      : mesh(mesh), capacity(capacity), steps(steps) {}
+
+  MorphCacheKey MakeKey(const std::vector<float> &weights) const {
+    MorphCacheKey key;
+    key.count = static_cast<uint8_t>(
+        std::min({weights.size(), mesh.morphTargets.size(),
+                  MorphCacheKey::MAX_TARGETS}));
+    for (uint8_t i = 0; i < key.count; ++i) {
+      float v = std::clamp(weights[i] * steps, -32767.0f, 32767.0f);
+      key.q[i] = static_cast<int16_t>(std::lround(v));
+    }
+    // Trailing zero weights do not change the result
+    while (key.count > 0 && key.q[key.count - 1] == 0)
+      --key.count;
+    return key;
+  }
+
+  // Returns a handle to the morphed vertices for `weights`, morphing only
+  // on a miss. Every Acquire must be paired with a Release.
+  Handle Acquire(const std::vector<float> &weights) {
+    MorphCacheKey key = MakeKey(weights);
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+      ++stats.hits;
+      Entry &e = entries[it->second];
+      if (e.refCount++ == 0)
+        lru.erase(e.lruPos);
+      return it->second;
+    }
+
+    ++stats.misses;
+    Handle h;
+    if (!freeSlots.empty()) {
+      h = freeSlots.back();
+      freeSlots.pop_back();
+    } else {
+      h = static_cast<Handle>(entries.size());
+      entries.emplace_back();
+    }
+
+    // Morph the dequantized weights so every sharer gets the same result
+    Entry &e = entries[h];
+    e.key = key;
+    e.refCount = 1;
+    e.live = true;
+    quantized.assign(key.count, 0.0f);
+    for (uint8_t i = 0; i < key.count; ++i)
+      quantized[i] = key.q[i] / steps;
+    MorphingSystem::ApplyMorphs(mesh, quantized, e.vertices, scratch);
+    lookup.emplace(key, h);
+
+    Trim();
+    return h;
+  }
+
+  void Release(Handle h) {
+    if (h >= entries.size() || !entries[h].live || entries[h].refCount == 0)
+      return;
+    Entry &e = entries[h];
+    if (--e.refCount == 0) {
+      lru.push_front(h);
+      e.lruPos = lru.begin();
+      Trim();
+    }
+  }
+
+  // Stays valid while `h` is held: entries never move, and referenced
+  // results are never evicted
+  const std::vector<Vertex> &Vertices(Handle h) const {
+    return entries[h].vertices;
+  }
+  uint32_t RefCount(Handle h) const { return entries[h].refCount; }
+
+  size_t ResidentCount() const { return lookup.size(); }
+  size_t ReferencedCount() const { return lookup.size() - lru.size(); }
+  size_t ResidentBytes() const {
+    return lookup.size() * mesh.baseVertices.size() * sizeof(Vertex);
+  }
+
+  void SetCapacity(size_t n) {
+    capacity = n;
+    Trim();
+  }
+
+  const Stats &GetStats() const { return stats; }
+  void ResetStats() { stats = {}; }
+
+  // Drops every unreferenced result (e.g. after the base mesh changes)
+  void Flush() {
+    size_t keep = capacity;
+    capacity = 0;
+    Trim();
+    capacity = keep;
+  }
+
+private:
+  struct Entry {
+    MorphCacheKey key;
+    std::vector<Vertex> vertices;
+    uint32_t refCount = 0;
+    bool live = false;
+    std::list<Handle>::iterator lruPos;
+  };
+
+  const UberMesh &mesh;
+  size_t capacity;
+  float steps;
+
+  std::deque<Entry> entries; // Grows without moving existing entries
+  std::vector<Handle> freeSlots;
+  std::unordered_map<MorphCacheKey, Handle, MorphCacheKeyHash> lookup;
+  std::list<Handle> lru; // Unreferenced entries, most recent first
+  MorphingSystem::MorphScratch scratch;
+  std::vector<float> quantized;
+  Stats stats;
+
+  void Trim() {
+    while (lookup.size() > capacity && !lru.empty()) {
+      Handle h = lru.back();
+      lru.pop_back();
+      Entry &e = entries[h];
+      lookup.erase(e.key);
+      e.live = false;
+      e.vertices.clear();
+      e.vertices.shrink_to_fit();
+      freeSlots.push_back(h);
+      ++stats.evictions;
+    }
+  }
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
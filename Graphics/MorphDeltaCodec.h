@@ -0,0 +1,211 @@
+#pragma once
+#include "../Assets/MorphTargetExtractor.h"
+#include "UberMesh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// =========================================================================
+// Packed Morph Deltas (GPU format)
+// =========================================================================
+// 12 bytes per vertex per target instead of 32 (two padded vec4s):
+//   word0 = snorm16 pos.x | snorm16 pos.y << 16
+//   word1 = snorm16 pos.z | unorm16 |normal delta| << 16
+//   word2 = snorm16 oct.x | snorm16 oct.y << 16   (normal delta direction)
+// Positions are divided by the target's position scale (largest component)
+// and the normal length by its normal scale, so each target uses the full
+// 16-bit range. The shader decodes with unpackSnorm2x16/unpackUnorm2x16.
+struct PackedMorphDelta {
+  uint32_t words[3];
+};
+
+// std430 vec2 per target
+struct MorphTargetScale {
+  float position = 0.0f;
+  float normal = 0.0f;
+};
+
+namespace MorphPacking {
+inline uint16_t PackSnorm16(float v) {
+  float c = std::clamp(v, -1.0f, 1.0f);
+  return static_cast<uint16_t>(static_cast<int16_t>(std::lround(c * 32767.0f)));
+}
+
+inline float UnpackSnorm16(uint16_t bits) {
+  return std::max(static_cast<int16_t>(bits) / 32767.0f, -1.0f);
+}
+
+inline uint16_t PackUnorm16(float v) {
+  return static_cast<uint16_t>(
+      std::lround(std::clamp(v, 0.0f, 1.0f) * 65535.0f));
+}
+
+inline float UnpackUnorm16(uint16_t bits) { return bits / 65535.0f; }
+
+// Octahedral mapping of a unit vector to [-1, 1]^2
+inline void OctEncode(float x, float y, float z, float &u, float &v) {
+  float l1 = std::abs(x) + std::abs(y) + std::abs(z);
+  if (l1 < 1e-12f) {
+    u = v = 0.0f;
+    return;
+  }
+  x /= l1;
+  y /= l1;
+  if (z < 0.0f) {
+    float ox = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    float oy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    x = ox;
+    y = oy;
+  }
+  u = x;
+  v = y;
+}
+
+inline void OctDecode(float u, float v, float &x, float &y, float &z) {
+  x = u;
+  y = v;
+  z = 1.0f - std::abs(u) - std::abs(v);
+  if (z < 0.0f) {
+    float ox = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    float oy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    x = ox;
+    y = oy;
+  }
+  float len = std::sqrt(x * x + y * y + z * z);
+  x /= len;
+  y /= len;
+  z /= len;
+}
+} // namespace MorphPacking
+
+// Dense [target][vertex] packed deltas plus per-target scales
+struct PackedMorphBuffer {
+  static constexpr uint32_t MAX_TARGETS = 16; // Matches MorphDispatch
+
+  uint32_t vertexCount = 0;
+  uint32_t targetCount = 0;
+  std::vector<std::string> names;
+  std::vector<MorphTargetScale> scales;
+  std::vector<PackedMorphDelta> deltas;
+
+  int FindTarget(const std::string &name) const {
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (names[i] == name)
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  // GPU layout: MorphTargetScale[MAX_TARGETS] followed by the deltas
+  size_t GPUSizeBytes() const {
+    return MAX_TARGETS * sizeof(MorphTargetScale) +
+           deltas.size() * sizeof(PackedMorphDelta);
+  }
+
+  void WriteGPU(void *dst) const {
+    MorphTargetScale header[MAX_TARGETS] = {};
+    std::copy(scales.begin(), scales.end(), header);
+    std::memcpy(dst, header, sizeof(header));
+    std::memcpy(static_cast<uint8_t *>(dst) + sizeof(header), deltas.data(),
+                deltas.size() * sizeof(PackedMorphDelta));
+  }
+
+  MorphDelta Decode(uint32_t target, uint32_t vertex) const {
+    return DecodeAt(size_t(target) * vertexCount + vertex, target);
+  }
+
+  // The shader's decode: raw delta `index` scaled by header slot
+  // `scaleSlot` (deltas[i] * scales[t]). Slots past `scales` read the zeroed
+  // GPU header.
+  MorphDelta DecodeAt(size_t index, uint32_t scaleSlot) const {
+    using namespace MorphPacking;
+    const PackedMorphDelta &p = deltas[index];
+    const MorphTargetScale s =
+        scaleSlot < scales.size() ? scales[scaleSlot] : MorphTargetScale{};
+    MorphDelta d;
+    d.positionDelta = {UnpackSnorm16(p.words[0] & 0xFFFF) * s.position,
+                       UnpackSnorm16(p.words[0] >> 16) * s.position,
+                       UnpackSnorm16(p.words[1] & 0xFFFF) * s.position};
+    float len = UnpackUnorm16(p.words[1] >> 16) * s.normal;
+    float x, y, z;
+    OctDecode(UnpackSnorm16(p.words[2] & 0xFFFF),
+              UnpackSnorm16(p.words[2] >> 16), x, y, z);
+    d.normalDelta = {x * len, y * len, z * len};
+    return d;
+  }
+};
+
+class MorphDeltaCodec {
+public:
+  // Pack every target of the set (up to MAX_TARGETS). Targets named in
+  // `leading` take the first slots, in that order; the rest keep set order.
+  static PackedMorphBuffer Encode(const Assets::MorphTargetSet &set,
+                                  const std::vector<std::string> &leading = {}) {
+    using namespace MorphPacking;
+    PackedMorphBuffer buf;
+    buf.vertexCount = static_cast<uint32_t>(set.baseMesh.size());
+
+    std::vector<const Assets::MorphTarget *> ordered;
+    for (const auto &name : leading) {
+      for (const auto &t : set.targets) {
+        if (t.name == name)
+          ordered.push_back(&t);
+      }
+    }
+    for (const auto &t : set.targets) {
+      if (std::find(ordered.begin(), ordered.end(), &t) == ordered.end())
+        ordered.push_back(&t);
+    }
+    if (ordered.size() > PackedMorphBuffer::MAX_TARGETS)
+      ordered.resize(PackedMorphBuffer::MAX_TARGETS);
+
+    buf.targetCount = static_cast<uint32_t>(ordered.size());
+    buf.deltas.assign(size_t(buf.targetCount) * buf.vertexCount,
+                      PackedMorphDelta{{0, 0, 0}});
+
+    for (uint32_t ti = 0; ti < buf.targetCount; ++ti) {
+      const Assets::MorphTarget &t = *ordered[ti];
+      buf.names.push_back(t.name);
+
+      // Bounding scales
+      MorphTargetScale scale;
+      for (size_t i = 0; i < t.indices.size(); ++i) {
+        const auto &p = t.positionDeltas[i];
+        scale.position = std::max(
+            {scale.position, std::abs(p.x), std::abs(p.y), std::abs(p.z)});
+        scale.normal = std::max(scale.normal, t.normalDeltas[i].Length());
+      }
+      buf.scales.push_back(scale);
+      float invP = scale.position > 0.0f ? 1.0f / scale.position : 0.0f;
+      float invN = scale.normal > 0.0f ? 1.0f / scale.normal : 0.0f;
+
+      for (size_t i = 0; i < t.indices.size(); ++i) {
+        if (t.indices[i] >= buf.vertexCount)
+          break;
+        const auto &p = t.positionDeltas[i];
+        const auto &n = t.normalDeltas[i];
+        float u, v;
+        OctEncode(n.x, n.y, n.z, u, v);
+
+        PackedMorphDelta &out =
+            buf.deltas[size_t(ti) * buf.vertexCount + t.indices[i]];
+        out.words[0] = PackSnorm16(p.x * invP) |
+                       (uint32_t(PackSnorm16(p.y * invP)) << 16);
+        out.words[1] = PackSnorm16(p.z * invP) |
+                       (uint32_t(PackUnorm16(n.Length() * invN)) << 16);
+        out.words[2] =
+            PackSnorm16(u) | (uint32_t(PackSnorm16(v)) << 16);
+      }
+    }
+    return buf;
+  }
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
@@ -5,46 +5,90 @@
 #include <cmath>
 #include <vector>
 
+#ifndef MESOZOIC_SSE
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define MESOZOIC_SSE 1
+#else
+#define MESOZOIC_SSE 0
+#endif
+#endif
+#if MESOZOIC_SSE
+#include <emmintrin.h>
+#endif
+
 namespace Mesozoic {
 namespace Graphics {
 
 class MorphingSystem {
 public:
+  // Reusable SoA working set for the CPU kernel (xyz interleaved)
+  struct MorphScratch {
+    std::vector<float> positions;
+    std::vector<float> normals;
+  };
+
+  // dst[i] += src[i] * w over n contiguous floats
+  static void MulAdd(float *dst, const float *src, float w, size_t n) {
+    size_t i = 0;
+#if MESOZOIC_SSE
+    __m128 vw = _mm_set1_ps(w);
+    for (; i + 4 <= n; i += 4) {
+      __m128 d = _mm_loadu_ps(dst + i);
+      __m128 s = _mm_loadu_ps(src + i);
+      _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, vw)));
+    }
+#endif
+    for (; i < n; ++i)
+      dst[i] += src[i] * w;
+  }
+
   // CPU Reference implementation of the Vertex Shader logic
   // V_final = V_base + Sum(V_delta_i * Weight_i)
+  // Target-major: each active target streams its runs of consecutive
+  // vertices through MulAdd, untouched vertices cost nothing.
   static void ApplyMorphs(const UberMesh &mesh,
                           const std::vector<float> &weights,
-                          std::vector<Vertex> &outVertices) {
-    if (outVertices.size() != mesh.baseVertices.size()) {
-      outVertices.resize(mesh.baseVertices.size());
-    }
-
-    // For each vertex
-    for (size_t v = 0; v < mesh.baseVertices.size(); ++v) {
-      // Start with base
-      Vertex finalVert = mesh.baseVertices[v];
-
-      // Accumulate deltas
-      for (size_t t = 0; t < mesh.morphTargets.size(); ++t) {
-        if (t >= weights.size())
-          break;
+                          std::vector<Vertex> &outVertices,
+                          MorphScratch &scratch) {
+    const size_t vertCount = mesh.baseVertices.size();
+    outVertices = mesh.baseVertices;
 
-        float w = weights[t];
-        if (std::abs(w) < 0.001f)
-          continue; // Optimization
-
-        const auto &delta = mesh.morphTargets[t].deltas[v];
+    scratch.positions.resize(vertCount * 3);
+    scratch.normals.resize(vertCount * 3);
+    for (size_t v = 0; v < vertCount; ++v) {
+      const Vertex &b = mesh.baseVertices[v];
+      std::copy(b.position.begin(), b.position.end(), &scratch.positions[v * 3]);
+      std::copy(b.normal.begin(), b.normal.end(), &scratch.normals[v * 3]);
+    }
 
-        finalVert.position[0] += delta.positionDelta[0] * w;
-        finalVert.position[1] += delta.positionDelta[1] * w;
-        finalVert.position[2] += delta.positionDelta[2] * w;
+    size_t targetCount = std::min(mesh.morphTargets.size(), weights.size());
+    for (size_t t = 0; t < targetCount; ++t) {
+      float w = weights[t];
+      if (std::abs(w) < 0.001f)
+        continue; // Optimization
 
-        finalVert.normal[0] += delta.normalDelta[0] * w;
-        finalVert.normal[1] += delta.normalDelta[1] * w;
-        finalVert.normal[2] += delta.normalDelta[2] * w;
+      const UberMesh::Target &target = mesh.morphTargets[t];
+      for (const auto &run : target.runs) {
+        size_t dst = size_t(run.firstVertex) * 3;
+        size_t src = size_t(run.firstDelta) * 3;
+        size_t n = size_t(run.count) * 3;
+        MulAdd(&scratch.positions[dst], &target.positionDeltas[src], w, n);
+        MulAdd(&scratch.normals[dst], &target.normalDeltas[src], w, n);
       }
-      outVertices[v] = finalVert;
     }
+
+    for (size_t v = 0; v < vertCount; ++v) {
+      Vertex &o = outVertices[v];
+      std::copy_n(&scratch.positions[v * 3], 3, o.position.begin());
+      std::copy_n(&scratch.normals[v * 3], 3, o.normal.begin());
+    }
+  }
+
+  static void ApplyMorphs(const UberMesh &mesh,
+                          const std::vector<float> &weights,
+                          std::vector<Vertex> &outVertices) {
+    MorphScratch scratch;
+    ApplyMorphs(mesh, weights, outVertices, scratch);
   }
 
   // Maps DNA Alleles to Morph Weights
@@ -0,0 +1,284 @@
+#pragma once
+#include "../Assets/AnimationLoader.h"
+#include "../Core/Threading/JobSystem.h"
+#include "VulkanBackend.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// Pose Pipeline: sampled local poses -> skinning matrix palette
+//   1. Sample each layer's clip (cursors keep sequential playback O(1))
+//   2. Blend layers (lerp T/S, nlerp R, optional per-bone mask)
+//   3. Local -> model space over a topologically sorted bone array
+//   4. Multiply by the inverse bind matrix and write 3x4 rows to the palette
+// All matrices are 3x4 row-major affine (12 floats), the same layout as the
+// bone atlas, so the palette can be uploaded as-is.
+
+// =========================================================================
+// 3x4 affine helpers
+// =========================================================================
+namespace Affine {
+constexpr int FLOATS = 12;
+
+inline void Identity(float *m) {
+  static constexpr float I[FLOATS] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+  std::memcpy(m, I, sizeof(I));
+}
+
+// T * R * S
+inline void FromTRS(const Math::Vec3 &t, const Math::Quat &q,
+                    const Math::Vec3 &s, float *m) {
+  float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+  float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+  float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+  m[0] = (1 - 2 * (yy + zz)) * s.x;
+  m[1] = 2 * (xy - wz) * s.y;
+  m[2] = 2 * (xz + wy) * s.z;
+  m[3] = t.x;
+  m[4] = 2 * (xy + wz) * s.x;
+  m[5] = (1 - 2 * (xx + zz)) * s.y;
+  m[6] = 2 * (yz - wx) * s.z;
+  m[7] = t.y;
+  m[8] = 2 * (xz - wy) * s.x;
+  m[9] = 2 * (yz + wx) * s.y;
+  m[10] = (1 - 2 * (xx + yy)) * s.z;
+  m[11] = t.z;
+}
+
+// out = a * b (implied bottom row 0 0 0 1); out must not alias a or b
+inline void Multiply(const float *a, const float *b, float *out) {
+  for (int r = 0; r < 3; ++r) {
+    const float *ar = a + r * 4;
+    for (int c = 0; c < 4; ++c) {
+      out[r * 4 + c] =
+          ar[0] * b[c] + ar[1] * b[4 + c] + ar[2] * b[8 + c];
+    }
+    out[r * 4 + 3] += ar[3];
+  }
+}
+
+// Column-major 4x4 -> row-major 3x4
+inline void FromColumnMajor(const float *m, float *out) {
+  for (int r = 0; r < 3; ++r)
+    for (int c = 0; c < 4; ++c)
+      out[r * 4 + c] = m[c * 4 + r];
+}
+} // namespace Affine
+
+// =========================================================================
+// Skeleton Layout: hierarchy flattened for a linear walk
+// =========================================================================
+struct SkeletonLayout {
+  uint32_t boneCount = 0;
+  std::vector<uint32_t> order;      // Sorted slot -> skeleton bone index
+  std::vector<int32_t> parentSlot;  // Sorted slot -> parent slot (-1 = root)
+  std::vector<float> inverseBind;   // 12 floats per slot
+  std::vector<Assets::BoneKeyframe> bindPose; // Per slot
+  std::vector<int32_t> boneToSlot;  // Skeleton bone index -> slot
+
+  static SkeletonLayout Build(const Assets::Skeleton &skeleton) {
+    SkeletonLayout layout;
+    uint32_t n = static_cast<uint32_t>(skeleton.bones.size());
+    layout.boneCount = n;
+
+    // Breadth-first from the roots: every parent precedes its children
+    std::vector<std::vector<uint32_t>> children(n);
+    for (uint32_t i = 0; i < n; ++i) {
+      int p = skeleton.bones[i].parentIndex;
+      if (p >= 0 && static_cast<uint32_t>(p) < n)
+        children[p].push_back(i);
+      else
+        layout.order.push_back(i);
+    }
+    for (size_t head = 0; head < layout.order.size(); ++head) {
+      for (uint32_t c : children[layout.order[head]])
+        layout.order.push_back(c);
+    }
+
+    layout.boneToSlot.assign(n, -1);
+    for (uint32_t s = 0; s < layout.order.size(); ++s)
+      layout.boneToSlot[layout.order[s]] = static_cast<int32_t>(s);
+
+    layout.parentSlot.resize(n);
+    layout.inverseBind.resize(size_t(n) * Affine::FLOATS);
+    layout.bindPose.resize(n);
+    for (uint32_t s = 0; s < n; ++s) {
+      const Assets::Bone &bone = skeleton.bones[layout.order[s]];
+      layout.parentSlot[s] =
+          bone.parentIndex >= 0 ? layout.boneToSlot[bone.parentIndex] : -1;
+      Affine::FromColumnMajor(bone.inverseBindMatrix.data(),
+                              &layout.inverseBind[s * Affine::FLOATS]);
+      layout.bindPose[s] = {0.0f, bone.localPosition, bone.localRotation,
+                            bone.localScale};
+    }
+    return layout;
+  }
+};
+
+// =========================================================================
+// Pose Instances
+// =========================================================================
+struct PoseLayer {
+  const Assets::AnimationClip *clip = nullptr;
+  Assets::AnimationCursor *cursor = nullptr; // Optional, owned by the caller
+  float time = 0.0f;
+  float weight = 1.0f;              // Ignored for layer 0
+  const float *boneMask = nullptr;  // Optional per-bone weights (bone order)
+};
+
+struct PoseInstance {
+  static constexpr int MAX_LAYERS = 4;
+  std::array<PoseLayer, MAX_LAYERS> layers;
+  uint32_t layerCount = 0;
+};
+
+// Per-batch working memory, reused across frames
+struct PoseScratch {
+  std::vector<Assets::BoneKeyframe> sampled; // Per track of the current clip
+  std::vector<Assets::BoneKeyframe> pose;    // Per slot
+  std::vector<float> model;                  // 12 floats per slot
+
+  void Reserve(uint32_t boneCount) {
+    pose.resize(boneCount);
+    model.resize(size_t(boneCount) * Affine::FLOATS);
+  }
+};
+
+// =========================================================================
+// Palette Builder
+// =========================================================================
+class SkinningPaletteBuilder {
+public:
+  SkeletonLayout layout;
+  uint32_t batchSize = 64; // Instances per job
+
+  // palette[instance][bone] as 3x4 rows, in skeleton bone order
+  std::vector<float> palette;
+
+  void Initialize(const Assets::Skeleton &skeleton) {
+    layout = SkeletonLayout::Build(skeleton);
+  }
+
+  size_t PaletteStride() const { return size_t(layout.boneCount) * Affine::FLOATS; }
+  const float *InstancePalette(size_t instance) const {
+    return &palette[instance * PaletteStride()];
+  }
+
+  // Evaluate every instance. With a JobSystem the instances are split into
+  // batches of `batchSize` and evaluated in parallel; each batch writes a
+  // disjoint palette range.
+  void Build(const std::vector<PoseInstance> &instances,
+             Core::Threading::JobSystem *jobs = nullptr) {
+    palette.resize(instances.size() * PaletteStride());
+    size_t batchCount = (instances.size() + batchSize - 1) / batchSize;
+    if (scratch.size() < batchCount)
+      scratch.resize(batchCount);
+
+    auto runBatch = [this, &instances](size_t batch) {
+      PoseScratch &s = scratch[batch];
+      s.Reserve(layout.boneCount);
+      size_t begin = batch * batchSize;
+      size_t end = std::min(instances.size(), begin + batchSize);
+      for (size_t i = begin; i < end; ++i)
+        Evaluate(instances[i], s, &palette[i * PaletteStride()]);
+    };
+
+    if (!jobs || batchCount <= 1) {
+      for (size_t b = 0; b < batchCount; ++b)
+        runBatch(b);
+      return;
+    }
+
+    pending.clear();
+    for (size_t b = 0; b < batchCount; ++b)
+      pending.push_back(jobs->PushJob(runBatch, b));
+    for (auto &f : pending)
+      f.get();
+  }
+
+  // Copy the palette into a host-visible storage buffer
+  void Upload(GPUBuffer &buffer) const {
+    size_t bytes = palette.size() * sizeof(float);
+    if (buffer.mapped && bytes <= buffer.size)
+      std::memcpy(buffer.mapped, palette.data(), bytes);
+  }
+
+  // Single-instance evaluation into `out` (PaletteStride() floats)
+  void Evaluate(const PoseInstance &inst, PoseScratch &s, float *out) const {
+    const uint32_t n = layout.boneCount;
+
+    // 1-2. Sample and blend into slot order (bind pose when no track)
+    std::copy(layout.bindPose.begin(), layout.bindPose.end(), s.pose.begin());
+    for (uint32_t l = 0; l < inst.layerCount; ++l) {
+      const PoseLayer &layer = inst.layers[l];
+      if (!layer.clip || (l > 0 && layer.weight <= 0.0f))
+        continue;
+      const auto &tracks = layer.clip->tracks;
+      s.sampled.resize(tracks.size());
+      layer.clip->SampleAll(layer.time, s.sampled.data(), layer.cursor);
+
+      for (size_t t = 0; t < tracks.size(); ++t) {
+        int bone = tracks[t].boneIndex;
+        if (bone < 0 || static_cast<uint32_t>(bone) >= n)
+          continue;
+        Assets::BoneKeyframe &dst = s.pose[layout.boneToSlot[bone]];
+        if (l == 0) {
+          dst = s.sampled[t];
+          continue;
+        }
+        float w = layer.weight * (layer.boneMask ? layer.boneMask[bone] : 1.0f);
+        Blend(dst, s.sampled[t], w);
+      }
+    }
+
+    // 3. Local -> model (parents are always earlier slots)
+    float local[Affine::FLOATS];
+    for (uint32_t slot = 0; slot < n; ++slot) {
+      const Assets::BoneKeyframe &p = s.pose[slot];
+      float *model = &s.model[slot * Affine::FLOATS];
+      int32_t parent = layout.parentSlot[slot];
+      if (parent < 0) {
+        Affine::FromTRS(p.translation, p.rotation, p.scale, model);
+      } else {
+        Affine::FromTRS(p.translation, p.rotation, p.scale, local);
+        Affine::Multiply(&s.model[parent * Affine::FLOATS], local, model);
+      }
+    }
+
+    // 4. Skinning matrix = model * inverseBind, stored in bone order
+    for (uint32_t slot = 0; slot < n; ++slot) {
+      Affine::Multiply(&s.model[slot * Affine::FLOATS],
+                       &layout.inverseBind[slot * Affine::FLOATS],
+                       out + size_t(layout.order[slot]) * Affine::FLOATS);
+    }
+  }
+
+private:
+  std::vector<PoseScratch> scratch;
+  std::vector<std::future<void>> pending;
+
+  static void Blend(Assets::BoneKeyframe &a, const Assets::BoneKeyframe &b,
+                    float w) {
+    w = std::clamp(w, 0.0f, 1.0f);
+    a.translation = a.translation + (b.translation - a.translation) * w;
+    a.scale = a.scale + (b.scale - a.scale) * w;
+    // nlerp on the shortest arc
+    const Math::Quat &qa = a.rotation;
+    Math::Quat qb = b.rotation;
+    if (qa.x * qb.x + qa.y * qb.y + qa.z * qb.z + qa.w * qb.w < 0.0f)
+      qb = {-qb.x, -qb.y, -qb.z, -qb.w};
+    a.rotation = Math::Quat{qa.x + (qb.x - qa.x) * w, qa.y + (qb.y - qa.y) * w,
+                            qa.z + (qb.z - qa.z) * w, qa.w + (qb.w - qa.w) * w}
+                     .Normalized();
+  }
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
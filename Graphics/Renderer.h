@@ -1,6 +1,7 @@
 #pragma once
 #include "../Core/Math/Matrix4.h"
 #include "GPUAnimationInstancing.h"
+#include "GrassSystem.h"
 #include "MorphingSystem.h"
 #include "PBRSkinShader.h"
 #include "UI/UISystem.h"
@@ -128,12 +129,14 @@ public:
   // Registries
   std::vector<UberMesh> meshRegistry;
   std::vector<GPUMesh> gpuMeshes;
+  std::vector<uint32_t> freeMeshSlots; // Unregistered (streamed-out) ids
   SkinShaderSystem skinSystem;
   GPUAnimationSystem animSystem;
 
   // External Systems
   TerrainSystem *terrainSystem = nullptr;
   UISystem *uiSystem = nullptr;
+  GrassSystem *grassSystem = nullptr;
 
   // Render queue
   std::vector<RenderObject> renderQueue;
@@ -179,11 +182,29 @@ public:
     if (!backend || !backend->initialized)
       return 0xFFFFFFFF;
     GPUMesh gpuMesh = backend->UploadMesh(mesh.baseVertices, mesh.indices);
+    if (!freeMeshSlots.empty()) {
+      uint32_t id = freeMeshSlots.back();
+      freeMeshSlots.pop_back();
+      gpuMeshes[id] = gpuMesh;
+      meshRegistry[id] = mesh;
+      return id;
+    }
     gpuMeshes.push_back(gpuMesh);
     meshRegistry.push_back(mesh); // Keep CPU copy for metadata
     return (uint32_t)gpuMeshes.size() - 1;
   }
 
+  // Frees a mesh's GPU buffers; its id may be handed out again
+  void UnregisterMesh(uint32_t meshId) {
+    if (meshId >= gpuMeshes.size() || gpuMeshes[meshId].indexCount == 0)
+      return;
+    backend->WaitIdle(); // Buffers may still be referenced by frames in flight
+    backend->DestroyMesh(gpuMeshes[meshId]);
+    gpuMeshes[meshId] = {};
+    meshRegistry[meshId] = {};
+    freeMeshSlots.push_back(meshId);
+  }
+
   void UpdateMesh(uint32_t meshId, const std::vector<Vertex> &vertices) {
     if (meshId >= gpuMeshes.size())
       return;
@@ -224,6 +245,10 @@ public:
     // Let's pass dayTime as "time".
     sceneData.time = dayTime;
 
+    // UI atlas changes go up before this frame's commands are recorded
+    if (uiSystem)
+      uiSystem->SyncAtlas();
+
     // 1. Acquire swapchain image
     uint32_t imageIndex = 0;
     if (!backend->BeginFrame(imageIndex))
@@ -271,11 +296,22 @@ private:
     backend->BindPipeline(backend->graphicsPipeline);
     backend->BindTerrainTextures();
 
+    // Grass: cull tiles against the camera once per frame
+    if (grassSystem) {
+      Mesozoic::Math::Matrix4 view, proj;
+      view.m = camera.viewMatrix;
+      proj.m = camera.projMatrix;
+      grassSystem->Cull((proj * view).m, camera.position.x, camera.position.y,
+                        camera.position.z);
+      grassSystem->Upload();
+    }
+
     for (const auto &obj : renderQueue) {
       if (!obj.visible)
         continue;
 
-      if (obj.meshIndex >= gpuMeshes.size())
+      if (obj.meshIndex >= gpuMeshes.size() ||
+          gpuMeshes[obj.meshIndex].indexCount == 0)
         continue;
 
       // Compute MVP
@@ -342,8 +378,12 @@ private:
 
       // Special check for grass instancing (flagged by alpha 0.5)
       if (abs(obj.color[3] - 0.5f) < 0.01f) {
-        backend->DrawMeshInstanced(gpuMeshes[obj.meshIndex], 800000);
-        instancesThisFrame += 800000;
+        uint32_t grassCount =
+            grassSystem ? grassSystem->visibleInstanceCount : 0;
+        if (grassCount == 0)
+          continue;
+        backend->DrawMeshInstanced(gpuMeshes[obj.meshIndex], grassCount);
+        instancesThisFrame += grassCount;
       } else {
         backend->DrawMesh(gpuMeshes[obj.meshIndex]);
         instancesThisFrame++;
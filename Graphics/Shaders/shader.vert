@@ -11,16 +11,37 @@ layout(push_constant) uniform PushConstants {
     uint vertexCount;
 } push;
 
-struct MorphDelta {
-    vec4 pos;
-    vec4 norm;
+// Packed morph delta (mirrors PackedMorphDelta, see MorphDeltaCodec.h)
+struct PackedMorphDelta {
+    uint w0; // snorm16 pos.x | pos.y
+    uint w1; // snorm16 pos.z | unorm16 normal length
+    uint w2; // snorm16 oct normal direction
 };
 
 // New Texture Bindings (Set 0)
 layout(set = 0, binding = 0) uniform sampler2D heightMap;
 layout(set = 0, binding = 1) uniform sampler2D splatMap;
 layout(std430, set = 0, binding = 2) readonly buffer MorphDeltas {
-    MorphDelta deltas[];
+    vec2 morphScales[16]; // Per target: x = position scale, y = normal scale
+    PackedMorphDelta deltas[];
+};
+
+// Visible grass tiles (built by GrassSystem::Cull, mirrors GrassTileGPU)
+struct GrassTile {
+    vec2 origin;
+    float size;
+    uint firstInstance;
+    uint instanceCount;
+    uint seed;
+    uint pad0;
+    uint pad1;
+};
+layout(std430, set = 0, binding = 3) readonly buffer GrassTiles {
+    uint grassTileCount;
+    uint grassTotalInstances;
+    uint grassPad0;
+    uint grassPad1;
+    GrassTile grassTiles[];
 };
 
 layout(location = 0) in vec3 inPosition;
@@ -36,6 +57,27 @@ layout(location = 4) out vec3 fragCameraPos;
 layout(location = 5) out vec2 fragUV;
 layout(location = 6) out vec4 fragSplat; // Pass splat to fragment shader
 
+vec3 octDecode(vec2 e) {
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0.0) {
+        vec2 s = mix(vec2(-1.0), vec2(1.0), greaterThanEqual(v.xy, vec2(0.0)));
+        v.xy = (1.0 - abs(v.yx)) * s;
+    }
+    return normalize(v);
+}
+
+vec3 morphPosition(uint target, uint vid) {
+    PackedMorphDelta d = deltas[target * push.vertexCount + vid];
+    vec3 p = vec3(unpackSnorm2x16(d.w0), unpackSnorm2x16(d.w1).x);
+    return p * morphScales[target].x;
+}
+
+vec3 morphNormal(uint target, uint vid) {
+    PackedMorphDelta d = deltas[target * push.vertexCount + vid];
+    float len = unpackUnorm2x16(d.w1).y * morphScales[target].y;
+    return octDecode(unpackSnorm2x16(d.w2)) * len;
+}
+
 // --- Instance hashing ---
 float instanceHash(uint n) {
     n = (n << 13U) ^ n;
@@ -69,14 +111,25 @@ void main() {
     if (abs(push.color.a - 0.5) < 0.05) {
         uint id = uint(gl_InstanceIndex);
 
-        float r1 = instanceHash(id * 1678U + 11U);
-        float r2 = instanceHash(id * 9821U + 33U);
-        float r3 = instanceHash(id * 5432U + 77U);
-        float r4 = instanceHash(id * 1122U + 99U);
+        // Find the tile owning this instance (ranges are sorted prefix sums)
+        uint lo = 0U;
+        uint hi = grassTileCount;
+        while (hi - lo > 1U) {
+            uint mid = (lo + hi) >> 1U;
+            if (grassTiles[mid].firstInstance <= id) lo = mid; else hi = mid;
+        }
+        GrassTile tile = grassTiles[lo];
+        uint local = id - tile.firstInstance;
+        uint key = local ^ tile.seed;
+
+        float r1 = instanceHash(key * 1678U + 11U);
+        float r2 = instanceHash(key * 9821U + 33U);
+        float r3 = instanceHash(key * 5432U + 77U);
+        float r4 = instanceHash(key * 1122U + 99U);
 
-        // Position on map
-        float grassX = r1 * mapSize - halfMap;
-        float grassZ = r2 * mapSize - halfMap;
+        // Position inside the tile (distance/frustum culling done on the CPU)
+        float grassX = tile.origin.x + r1 * tile.size;
+        float grassZ = tile.origin.y + r2 * tile.size;
 
         // Sample Height & Splat from Texture
         vec2 uv = (vec2(grassX, grassZ) + halfMap) / mapSize;
@@ -87,7 +140,8 @@ void main() {
         float h = texture(heightMap, uv).r;
         vec4 splat = texture(splatMap, uv);
 
-        // Context Cull: No grass on Rock (Blue > 0.5) or if Grass Weight (Red) is low
+        // Context Cull: tiles are only partially grass, so blades that land
+        // on Rock (Blue > 0.5) or low Grass Weight (Red) are still rejected
         if (splat.b > 0.5 || splat.r < 0.2) {
             gl_Position = vec4(0,0,0,0);
             return;
@@ -95,13 +149,6 @@ void main() {
 
         vec3 grassWorldPos = vec3(grassX, h, grassZ);
 
-        // Distance cull (500m)
-        float camDist = distance(grassWorldPos.xz, push.cameraPos.xz);
-        if (camDist > 500.0) {
-            gl_Position = vec4(0,0,0,0);
-            return;
-        }
-
         // Procedural Animation & Variation
         float rot = r3 * 6.28318;
         float sr = sin(rot);
@@ -114,18 +161,15 @@ void main() {
             uint vid = gl_VertexIndex;
             // Target Snout
             if (push.morphWeights.x > 0.0) {
-                MorphDelta d = deltas[0 * push.vertexCount + vid];
-                lp += d.pos.xyz * push.morphWeights.x;
+                lp += morphPosition(0U, vid) * push.morphWeights.x;
             }
             // Target Bulk
             if (push.morphWeights.y > 0.0) {
-                MorphDelta d = deltas[1 * push.vertexCount + vid];
-                lp += d.pos.xyz * push.morphWeights.y;
+                lp += morphPosition(1U, vid) * push.morphWeights.y;
             }
             // Target Horn
             if (push.morphWeights.z > 0.0) {
-                MorphDelta d = deltas[2 * push.vertexCount + vid];
-                lp += d.pos.xyz * push.morphWeights.z;
+                lp += morphPosition(2U, vid) * push.morphWeights.z;
             }
         }
         
@@ -180,20 +224,13 @@ void main() {
         vec3 dP = vec3(0);
         vec3 dN = vec3(0);
 
-        if (push.morphWeights.x > 0.0) {
-            MorphDelta d = deltas[0 * push.vertexCount + vid];
-            dP += d.pos.xyz * push.morphWeights.x;
-            dN += d.norm.xyz * push.morphWeights.x;
-        }
-        if (push.morphWeights.y > 0.0) {
-            MorphDelta d = deltas[1 * push.vertexCount + vid];
-            dP += d.pos.xyz * push.morphWeights.y;
-            dN += d.norm.xyz * push.morphWeights.y;
-        }
-        if (push.morphWeights.z > 0.0) {
-            MorphDelta d = deltas[2 * push.vertexCount + vid];
-            dP += d.pos.xyz * push.morphWeights.z;
-            dN += d.norm.xyz * push.morphWeights.z;
+        // Slots 0-2 are the slider-driven targets (Snout, Bulk, Horn)
+        for (uint t = 0U; t < 3U; ++t) {
+            float w = push.morphWeights[t];
+            if (w > 0.0) {
+                dP += morphPosition(t, vid) * w;
+                dN += morphNormal(t, vid) * w;
+            }
         }
         morphedPos += dP;
         morphedNorm = normalize(morphedNorm + dN);
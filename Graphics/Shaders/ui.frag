@@ -11,7 +11,7 @@ void main() {
     // Sample texture and tint
     vec4 texColor = texture(texSampler, fragTexCoord);
     
-    // UI Tinting: Use vertex color (from push constant)
+    // UI Tinting: per-vertex colour
     outColor = texColor * fragColor;
     
     // Alpha discard check if needed, but blending handles it mostly
@@ -286,6 +286,8 @@ void TerrainSystem::ModifyHeight(float worldX, float worldZ, float radius,
   if (dirty) {
     UpdateMesh();
     UpdateTextures();
+    if (grassSystem)
+      grassSystem->RebuildRegion(worldX, worldZ, radius);
   }
 }
 
@@ -329,6 +331,10 @@ void TerrainSystem::Paint(float x, float z, float radius, int type) {
 
   bool dirty = false;
 
+  // Page composites read the splat map on the workers
+  if (virtualTexture)
+    virtualTexture->WaitForCompositing();
+
   for (int j = -r; j <= r; ++j) {
     for (int i = -r; i <= r; ++i) {
       int tx = cx + i;
@@ -364,6 +370,20 @@ void TerrainSystem::Paint(float x, float z, float radius, int type) {
   if (dirty && backend && splatTex.IsValid()) {
     backend->UpdateTexture(splatTex, splatMap.data(), splatMap.size());
   }
+  if (dirty && grassSystem) {
+    grassSystem->RebuildRegion(x, z, radius);
+  }
+  if (dirty && virtualTexture) {
+    // Splat texels -> level 0 virtual texels, one texel of bilinear margin
+    const VirtualTextureLayout &vt = virtualTexture->Layout();
+    float sx = float(vt.width) / float(width);
+    float sz = float(vt.height) / float(depth);
+    int x0 = std::max(0, cx - r - 1), x1 = std::min(width, cx + r + 2);
+    int z0 = std::max(0, cz - r - 1), z1 = std::min(depth, cz + r + 2);
+    virtualTexture->Invalidate(uint32_t(x0 * sx), uint32_t(z0 * sz),
+                               uint32_t(std::ceil(x1 * sx)),
+                               uint32_t(std::ceil(z1 * sz)));
+  }
 }
 
 } // namespace Graphics
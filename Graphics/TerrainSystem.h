@@ -2,6 +2,7 @@
 #include "../Core/Math/Vec3.h"
 #include "Renderer.h"
 #include "TerrainGenerator.h"
+#include "VirtualTexture.h"
 #include "VulkanBackend.h" // Needed for GPUTexture and backend pointer
 #include <algorithm>
 #include <cmath>
@@ -14,11 +15,15 @@ namespace Mesozoic {
 namespace Graphics {
 
 class Renderer;
+class GrassSystem;
 
 class TerrainSystem {
 public:
   VulkanBackend *backend = nullptr;
   Renderer *renderer = nullptr;
+  GrassSystem *grassSystem = nullptr; // Re-baked on paint/sculpt
+  // Optional; its pages over painted texels are re-composited
+  VirtualTexture *virtualTexture = nullptr;
 
   // Config
   int width = 512;
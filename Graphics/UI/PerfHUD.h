@@ -0,0 +1,145 @@
+#pragma once
+#include "../../Core/Profiling/Profiler.h"
+#include "UIBatcher.h"
+#include "UIFont.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// =========================================================================
+// Performance HUD
+// =========================================================================
+// Toggleable overlay of every profiler channel: a text line per channel
+// (latest value plus max or average) and a rolling bar graph for times and
+// utilisations. Labels are re-formatted every `refreshFrames` frames so
+// the text cache serves them in between; graphs are plain quads from the
+// atlas' white texel, so the whole HUD is a single batch.
+
+class PerfHUD {
+public:
+  bool visible = false;
+  float x = 10.0f, y = 10.0f;
+  float width = 420.0f;
+  float graphHeight = 24.0f;
+  uint32_t refreshFrames = 15;
+  float timeBudgetMs = 16.6f; // Bars above this are red
+
+  void Toggle() { visible = !visible; }
+
+  void Draw(const Core::Profiling::Profiler &profiler, UIBatcher &batcher,
+            UITextCache &text, const UIFont &font, GPUTexture *atlasTexture,
+            const UIAtlasRegion &white) {
+    using Kind = Core::Profiling::Profiler::Kind;
+    quadsLastDraw = 0;
+    if (!visible)
+      return;
+    const uint32_t channels = profiler.ChannelCount();
+    // refreshFrames 0 or 1 reformats every frame
+    if (labels.size() != channels || refreshFrames <= 1 ||
+        frame % refreshFrames == 0)
+      FormatLabels(profiler);
+    frame++;
+
+    const float pad = 6.0f, line = font.LineHeight();
+    auto rect = [&](float rx, float ry, float rw, float rh, uint32_t color) {
+      batcher.AddQuad(rx, ry, rw, rh, atlasTexture, color, white.u0,
+                      white.v0, white.u1, white.v1);
+      quadsLastDraw++;
+    };
+
+    float height = pad;
+    for (uint32_t c = 0; c < channels; ++c)
+      height += line + (HasGraph(profiler.GetKind(c)) ? graphHeight : 0.0f);
+    rect(x, y, width, height + pad, PackUIColor(0.0f, 0.0f, 0.0f, 0.6f));
+
+    const uint32_t bars = profiler.FramesRecorded();
+    const float barW = (width - 2.0f * pad) /
+                       float(Core::Profiling::Profiler::HISTORY);
+    float penY = y + pad;
+    for (uint32_t c = 0; c < channels; ++c) {
+      for (const UIGlyphQuad &g : text.Get(labels[c], labelRuns[c]).quads) {
+        batcher.AddQuad(x + pad + g.x, penY + g.y, g.w, g.h, atlasTexture,
+                        PackUIColor(1.0f, 1.0f, 1.0f, 1.0f), g.u0, g.v0,
+                        g.u1, g.v1);
+        quadsLastDraw++;
+      }
+      penY += line;
+
+      Kind kind = profiler.GetKind(c);
+      if (!HasGraph(kind))
+        continue;
+      // Times scale to the worst of budget and history, so spikes show
+      float top = kind == Kind::Percent
+                      ? 100.0f
+                      : std::max(timeBudgetMs, profiler.Max(c));
+      float baseY = penY + graphHeight - 2.0f;
+      for (uint32_t age = 0; age < bars; ++age) {
+        float v = profiler.Sample(c, age);
+        if (v <= 0.0f)
+          continue;
+        float h = std::min(v / top, 1.0f) * (graphHeight - 2.0f);
+        float bx = x + width - pad - float(age + 1) * barW;
+        rect(bx, baseY - h, barW, h, BarColor(kind, v));
+      }
+      penY += graphHeight;
+    }
+  }
+
+  size_t QuadsLastDraw() const { return quadsLastDraw; }
+
+private:
+  static bool HasGraph(Core::Profiling::Profiler::Kind kind) {
+    using Kind = Core::Profiling::Profiler::Kind;
+    return kind == Kind::Time || kind == Kind::Percent;
+  }
+
+  uint32_t BarColor(Core::Profiling::Profiler::Kind kind, float v) const {
+    if (kind == Core::Profiling::Profiler::Kind::Percent)
+      return PackUIColor(0.3f, 0.6f, 1.0f, 0.9f);
+    if (v > timeBudgetMs)
+      return PackUIColor(1.0f, 0.25f, 0.2f, 0.9f);
+    if (v > timeBudgetMs * 0.5f)
+      return PackUIColor(1.0f, 0.8f, 0.2f, 0.9f);
+    return PackUIColor(0.3f, 0.9f, 0.3f, 0.9f);
+  }
+
+  void FormatLabels(const Core::Profiling::Profiler &profiler) {
+    using Kind = Core::Profiling::Profiler::Kind;
+    labels.resize(profiler.ChannelCount());
+    labelRuns.resize(labels.size());
+    char buf[96];
+    for (uint32_t c = 0; c < profiler.ChannelCount(); ++c) {
+      const char *name = profiler.Name(c).c_str();
+      float v = profiler.Latest(c);
+      switch (profiler.GetKind(c)) {
+      case Kind::Time:
+        std::snprintf(buf, sizeof(buf), "%-12.12s %6.2f ms max %6.2f", name,
+                      v, profiler.Max(c));
+        break;
+      case Kind::Percent:
+        std::snprintf(buf, sizeof(buf), "%-12.12s %5.1f%% avg %5.1f%%", name,
+                      v, profiler.Average(c));
+        break;
+      case Kind::Bytes:
+        std::snprintf(buf, sizeof(buf), "%-12.12s %8.2f MB", name,
+                      v / (1024.0f * 1024.0f));
+        break;
+      case Kind::Count:
+        std::snprintf(buf, sizeof(buf), "%-12.12s %8.0f", name, v);
+        break;
+      }
+      labels[c] = buf;
+    }
+  }
+
+  std::vector<std::string> labels;
+  std::vector<UITextCache::Handle> labelRuns;
+  uint32_t frame = 0;
+  size_t quadsLastDraw = 0;
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
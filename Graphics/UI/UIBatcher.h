@@ -0,0 +1,350 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+struct GPUTexture;
+
+// =========================================================================
+// UI Batching
+// =========================================================================
+// Every UI quad of a frame is expanded into one vertex stream (position,
+// UV, packed colour) written straight into a mapped per-frame buffer, and
+// quads sharing a texture are drawn with one vkCmdDrawIndexed. A quad may
+// join an earlier batch with its texture only if no batch in between
+// overlaps it, so painter's order is kept where it matters. Icons and
+// glyphs live in one UITextureAtlas, so most of the UI collapses into a
+// single batch. Nothing here touches Vulkan, so layout can be tested and
+// benchmarked headless.
+
+// Mirrors ui.vert's inputs (20 bytes)
+struct UIVertex {
+  float x, y; // Pixels, top-left origin
+  float u, v;
+  uint32_t color; // RGBA8, R in the lowest byte (VK_FORMAT_R8G8B8A8_UNORM)
+};
+
+inline uint32_t PackUIColor(float r, float g, float b, float a) {
+  auto q = [](float v) {
+    return uint32_t(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+  };
+  return q(r) | (q(g) << 8) | (q(b) << 16) | (q(a) << 24);
+}
+
+struct UIBatch {
+  GPUTexture *texture = nullptr;
+  uint32_t firstIndex = 0; // Into the shared quad index buffer
+  uint32_t indexCount = 0;
+  // Union of the batch's quads, for the reordering test
+  float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+};
+
+class UIBatcher {
+public:
+  // Batches searched backwards for one with the same texture
+  static constexpr size_t LOOKBACK = 8;
+
+  void Begin(float width, float height) {
+    screenWidth = width;
+    screenHeight = height;
+    quads.clear();
+    batches.clear();
+  }
+
+  // Off-screen, empty and fully transparent quads are dropped here
+  void AddQuad(float x, float y, float w, float h, GPUTexture *texture,
+               uint32_t color, float u0 = 0.0f, float v0 = 0.0f,
+               float u1 = 1.0f, float v1 = 1.0f) {
+    if (!texture || w <= 0.0f || h <= 0.0f || (color >> 24) == 0)
+      return;
+    const float x1 = x + w, y1 = y + h;
+    if (x1 <= 0.0f || y1 <= 0.0f || x >= screenWidth || y >= screenHeight)
+      return;
+
+    uint32_t target = uint32_t(batches.size());
+    for (size_t i = batches.size(), seen = 0; i-- > 0 && seen < LOOKBACK;
+         ++seen) {
+      const UIBatch &b = batches[i];
+      if (b.texture == texture) {
+        target = uint32_t(i);
+        break;
+      }
+      if (x < b.maxX && x1 > b.minX && y < b.maxY && y1 > b.minY)
+        break; // Would jump over something drawn on top of it
+    }
+    if (target == batches.size()) {
+      UIBatch b;
+      b.texture = texture;
+      b.minX = x;
+      b.minY = y;
+      b.maxX = x1;
+      b.maxY = y1;
+      batches.push_back(b);
+    } else {
+      UIBatch &b = batches[target];
+      b.minX = std::min(b.minX, x);
+      b.minY = std::min(b.minY, y);
+      b.maxX = std::max(b.maxX, x1);
+      b.maxY = std::max(b.maxY, y1);
+    }
+    batches[target].indexCount += 6;
+    quads.push_back({x, y, x1, y1, u0, v0, u1, v1, color, target});
+  }
+
+  // Writes the quads grouped by batch (4 vertices each) and fixes up the
+  // batch ranges. Quads past `capacityQuads` are dropped; returns the
+  // number written. Call once, after the last AddQuad of the frame.
+  size_t Finish(UIVertex *dst, size_t capacityQuads) {
+    // Counting sort by batch: each batch's quads become contiguous
+    uint32_t first = 0;
+    for (UIBatch &b : batches) {
+      b.firstIndex = first;
+      first += b.indexCount;
+    }
+    cursor.resize(batches.size());
+    for (size_t i = 0; i < batches.size(); ++i)
+      cursor[i] = batches[i].firstIndex / 6;
+    for (const Quad &q : quads) {
+      uint32_t slot = cursor[q.batch]++;
+      if (slot >= capacityQuads)
+        continue;
+      UIVertex *v = dst + size_t(slot) * 4;
+      v[0] = {q.x0, q.y0, q.u0, q.v0, q.color};
+      v[1] = {q.x1, q.y0, q.u1, q.v0, q.color};
+      v[2] = {q.x1, q.y1, q.u1, q.v1, q.color};
+      v[3] = {q.x0, q.y1, q.u0, q.v1, q.color};
+    }
+    const uint32_t capIndices = uint32_t(std::min<size_t>(
+        capacityQuads * 6, size_t(first)));
+    size_t kept = 0;
+    for (UIBatch &b : batches) {
+      if (b.firstIndex >= capIndices)
+        break;
+      b.indexCount = std::min(b.indexCount, capIndices - b.firstIndex);
+      batches[kept++] = b;
+    }
+    batches.resize(kept);
+    return capIndices / 6;
+  }
+
+  size_t Finish(std::vector<UIVertex> &out) {
+    out.resize(quads.size() * 4);
+    return Finish(out.data(), quads.size());
+  }
+
+  const std::vector<UIBatch> &Batches() const { return batches; }
+  size_t QuadCount() const { return quads.size(); }
+
+  // Pixel -> clip space as (scale.xy, offset.xy): the frame's one push
+  // constant. Vulkan clip space has y down, like the UI.
+  std::array<float, 4> ScaleOffset() const {
+    return {2.0f / std::max(1.0f, screenWidth),
+            2.0f / std::max(1.0f, screenHeight), -1.0f, -1.0f};
+  }
+
+  // 0 1 2, 2 3 0 per quad, for the shared index buffer
+  static std::vector<uint32_t> BuildIndices(uint32_t maxQuads) {
+    std::vector<uint32_t> indices(size_t(maxQuads) * 6);
+    for (uint32_t q = 0; q < maxQuads; ++q) {
+      uint32_t *i = indices.data() + size_t(q) * 6;
+      uint32_t v = q * 4;
+      i[0] = v;
+      i[1] = v + 1;
+      i[2] = v + 2;
+      i[3] = v + 2;
+      i[4] = v + 3;
+      i[5] = v;
+    }
+    return indices;
+  }
+
+private:
+  struct Quad {
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+    uint32_t color;
+    uint32_t batch;
+  };
+
+  float screenWidth = 0.0f;
+  float screenHeight = 0.0f;
+  std::vector<Quad> quads;
+  std::vector<UIBatch> batches;
+  std::vector<uint32_t> cursor;
+};
+
+// =========================================================================
+// UI Texture Atlas
+// =========================================================================
+// Shelf packer for icons and glyphs on one RGBA8 page. Each image gets a
+// padding of its own edge texels so bilinear sampling never bleeds in a
+// neighbour. Region 0 is a white texel for untextured rectangles, so
+// panels batch together with icons.
+
+struct UIAtlasRegion {
+  uint32_t x = 0, y = 0, width = 0, height = 0; // Texels, without padding
+  float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+};
+
+class UITextureAtlas {
+public:
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+  static constexpr uint32_t WHITE = 0; // Region of the white texel
+
+  explicit UITextureAtlas(uint32_t width = 1024, uint32_t height = 1024,
+                          uint32_t padding = 1)
+      : width(width), height(height), padding(padding) {
+    Clear();
+  }
+
+  void Clear() {
+    pixels.assign(size_t(width) * height * 4, 0);
+    regions.clear();
+    names.clear();
+    shelves.clear();
+    shelfBottom = 0;
+    MarkDirty(0, 0, width, height);
+    const uint8_t white[16] = {255, 255, 255, 255, 255, 255, 255, 255,
+                               255, 255, 255, 255, 255, 255, 255, 255};
+    Add(2, 2, white); // 2x2 so the centre samples exactly white
+    UIAtlasRegion &r = regions[WHITE];
+    r.u0 = r.u1 = (float(r.x) + 1.0f) / float(width);
+    r.v0 = r.v1 = (float(r.y) + 1.0f) / float(height);
+  }
+
+  // Copies a tightly packed RGBA8 image in; NONE when it does not fit
+  uint32_t Add(uint32_t w, uint32_t h, const uint8_t *rgba) {
+    if (w == 0 || h == 0)
+      return NONE;
+    const uint32_t pw = w + 2 * padding, ph = h + 2 * padding;
+    if (pw > width || ph > height)
+      return NONE;
+
+    // Best fit: the lowest shelf that is tall and wide enough
+    Shelf *best = nullptr;
+    for (Shelf &s : shelves) {
+      if (s.height >= ph && width - s.cursor >= pw &&
+          (!best || s.height < best->height))
+        best = &s;
+    }
+    if (!best) {
+      if (height - shelfBottom < ph)
+        return NONE;
+      shelves.push_back({shelfBottom, ph, 0});
+      shelfBottom += ph;
+      best = &shelves.back();
+    }
+    const uint32_t x = best->cursor + padding, y = best->y + padding;
+    best->cursor += pw;
+
+    for (uint32_t row = 0; row < ph; ++row) {
+      // Padding rows repeat the first/last image row
+      uint32_t sy = uint32_t(
+          std::clamp(int64_t(row) - int64_t(padding), int64_t(0),
+                     int64_t(h) - 1));
+      uint8_t *dst = &pixels[(size_t(y - padding + row) * width +
+                              (x - padding)) * 4];
+      const uint8_t *src = rgba + size_t(sy) * w * 4;
+      for (uint32_t p = 0; p < padding; ++p) {
+        std::memcpy(dst + p * 4, src, 4);
+        std::memcpy(dst + (padding + w + p) * 4, src + (w - 1) * 4, 4);
+      }
+      std::memcpy(dst + padding * 4, src, size_t(w) * 4);
+    }
+    MarkDirty(x - padding, y - padding, pw, ph);
+
+    UIAtlasRegion r;
+    r.x = x;
+    r.y = y;
+    r.width = w;
+    r.height = h;
+    r.u0 = float(x) / float(width);
+    r.v0 = float(y) / float(height);
+    r.u1 = float(x + w) / float(width);
+    r.v1 = float(y + h) / float(height);
+    regions.push_back(r);
+    return uint32_t(regions.size() - 1);
+  }
+
+  // Named images (icons); adding an existing name returns its region
+  uint32_t Add(const std::string &name, uint32_t w, uint32_t h,
+               const uint8_t *rgba) {
+    auto it = names.find(name);
+    if (it != names.end())
+      return it->second;
+    uint32_t id = Add(w, h, rgba);
+    if (id != NONE)
+      names.emplace(name, id);
+    return id;
+  }
+
+  uint32_t Find(const std::string &name) const {
+    auto it = names.find(name);
+    return it == names.end() ? NONE : it->second;
+  }
+  const UIAtlasRegion &Region(uint32_t id) const { return regions[id]; }
+  size_t RegionCount() const { return regions.size(); }
+
+  uint32_t Width() const { return width; }
+  uint32_t Height() const { return height; }
+  const std::vector<uint8_t> &Pixels() const { return pixels; }
+
+  // Texel rect changed since ClearDirty(), for a partial upload
+  bool IsDirty() const { return dirtyX1 > dirtyX0; }
+  void DirtyRect(uint32_t &x, uint32_t &y, uint32_t &w, uint32_t &h) const {
+    x = dirtyX0;
+    y = dirtyY0;
+    w = dirtyX1 - dirtyX0;
+    h = dirtyY1 - dirtyY0;
+  }
+  // Tightly packed copy of the dirty rect
+  std::vector<uint8_t> DirtyPixels() const {
+    uint32_t x, y, w, h;
+    DirtyRect(x, y, w, h);
+    std::vector<uint8_t> out(size_t(w) * h * 4);
+    for (uint32_t row = 0; row < h; ++row)
+      std::memcpy(&out[size_t(row) * w * 4],
+                  &pixels[(size_t(y + row) * width + x) * 4], size_t(w) * 4);
+    return out;
+  }
+  void ClearDirty() { dirtyX0 = dirtyY0 = dirtyX1 = dirtyY1 = 0; }
+
+private:
+  struct Shelf {
+    uint32_t y;
+    uint32_t height;
+    uint32_t cursor; // Next free x
+  };
+
+  uint32_t width, height, padding;
+  std::vector<uint8_t> pixels;
+  std::vector<UIAtlasRegion> regions;
+  std::unordered_map<std::string, uint32_t> names;
+  std::vector<Shelf> shelves;
+  uint32_t shelfBottom = 0;
+  uint32_t dirtyX0 = 0, dirtyY0 = 0, dirtyX1 = 0, dirtyY1 = 0;
+
+  void MarkDirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if (!IsDirty()) {
+      dirtyX0 = x;
+      dirtyY0 = y;
+      dirtyX1 = x + w;
+      dirtyY1 = y + h;
+      return;
+    }
+    dirtyX0 = std::min(dirtyX0, x);
+    dirtyY0 = std::min(dirtyY0, y);
+    dirtyX1 = std::max(dirtyX1, x + w);
+    dirtyY1 = std::max(dirtyY1, y + h);
+  }
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
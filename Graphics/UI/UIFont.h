@@ -0,0 +1,329 @@
+#pragma once
+#include "UIBatcher.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// =========================================================================
+// UI Text
+// =========================================================================
+// Text is drawn from a bitmap font that is rasterised into the
+// UITextureAtlas once at startup, so glyphs batch together with panels and
+// icons. A string is laid out into a UITextRun (glyph quads relative to the
+// pen origin) only when it changes; the UITextCache keeps runs of strings
+// that were drawn recently, so an overlay that redraws the same labels
+// every frame does no layout work at all.
+
+// One glyph quad of a laid out string, relative to the run's origin
+struct UIGlyphQuad {
+  float x, y, w, h;
+  float u0, v0, u1, v1;
+};
+
+struct UITextRun {
+  std::vector<UIGlyphQuad> quads;
+  float width = 0.0f;  // Widest line, in font pixels
+  float height = 0.0f; // Lines * line height
+};
+
+class UIFont {
+public:
+  static constexpr uint32_t FIRST_CHAR = 32; // ' '
+  static constexpr uint32_t CHAR_COUNT = 95; // ' ' .. '~'
+
+  // Built-in 5x7 ASCII font, drawn with `pixelScale` texels per font dot
+  bool Rasterize(UITextureAtlas &atlas, uint32_t pixelScale = 2) {
+    scale = pixelScale;
+    return Build(atlas, 5, 7, 1, 2, [](uint32_t c, uint32_t x, uint32_t y) {
+      return (BUILTIN_5X7[c][x] >> y) & 1;
+    });
+  }
+
+  // Monospaced bitmap font from a cooked RGBA8 sheet: CHAR_COUNT cells of
+  // cellW x cellH in rows, starting at ' '. A cell texel is set when its
+  // alpha is at least 128.
+  bool RasterizeSheet(UITextureAtlas &atlas, const uint8_t *rgba,
+                      uint32_t sheetWidth, uint32_t cellW, uint32_t cellH,
+                      uint32_t pixelScale = 1) {
+    const uint32_t columns = cellW ? sheetWidth / cellW : 0;
+    if (columns == 0 || cellH == 0)
+      return false;
+    scale = pixelScale;
+    return Build(atlas, cellW, cellH, 0, 0,
+                 [&](uint32_t c, uint32_t x, uint32_t y) {
+                   size_t px = size_t(c % columns) * cellW + x;
+                   size_t py = size_t(c / columns) * cellH + y;
+                   return rgba[(py * sheetWidth + px) * 4 + 3] >= 128;
+                 });
+  }
+
+  bool IsLoaded() const { return !glyphs.empty(); }
+  float Advance() const { return advance; }
+  float LineHeight() const { return lineHeight; }
+
+  // Lays `text` out from (0, 0) downwards; '\n' starts a new line and
+  // characters outside ' '..'~' draw as '?'
+  void Layout(std::string_view text, UITextRun &run) const {
+    run.quads.clear();
+    run.width = run.height = 0.0f;
+    if (glyphs.empty())
+      return;
+    run.quads.reserve(text.size());
+    float penX = 0.0f, penY = 0.0f;
+    for (char ch : text) {
+      if (ch == '\n') {
+        run.width = std::max(run.width, penX);
+        penX = 0.0f;
+        penY += lineHeight;
+        continue;
+      }
+      uint32_t c = uint32_t(uint8_t(ch));
+      if (c < FIRST_CHAR || c >= FIRST_CHAR + CHAR_COUNT)
+        c = '?';
+      const Glyph &g = glyphs[c - FIRST_CHAR];
+      if (g.w > 0.0f)
+        run.quads.push_back({penX, penY, g.w, g.h, g.u0, g.v0, g.u1, g.v1});
+      penX += advance;
+    }
+    run.width = std::max(run.width, penX);
+    run.height = text.empty() ? 0.0f : penY + lineHeight;
+  }
+
+  // Size of `text` without building quads
+  void Measure(std::string_view text, float &width, float &height) const {
+    float lineW = 0.0f;
+    width = 0.0f;
+    height = text.empty() ? 0.0f : lineHeight;
+    for (char ch : text) {
+      if (ch == '\n') {
+        width = std::max(width, lineW);
+        lineW = 0.0f;
+        height += lineHeight;
+      } else {
+        lineW += advance;
+      }
+    }
+    width = std::max(width, lineW);
+  }
+
+private:
+  struct Glyph {
+    float w = 0.0f, h = 0.0f; // 0 for blank glyphs (no quad)
+    float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+  };
+
+  // Column-major: byte x of a glyph holds column x, bit 0 is the top row
+  static constexpr uint8_t BUILTIN_5X7[CHAR_COUNT][5] = {
+      {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, // sp !
+      {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14}, // " #
+      {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, // $ %
+      {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, // & '
+      {0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00}, // ( )
+      {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08}, // * +
+      {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, // , -
+      {0x00, 0x60, 0x60, 0x00, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02}, // . /
+      {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, // 0 1
+      {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, // 2 3
+      {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39}, // 4 5
+      {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03}, // 6 7
+      {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, // 8 9
+      {0x00, 0x36, 0x36, 0x00, 0x00}, {0x00, 0x56, 0x36, 0x00, 0x00}, // : ;
+      {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, // < =
+      {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, // > ?
+      {0x32, 0x49, 0x79, 0x41, 0x3E}, {0x7E, 0x11, 0x11, 0x11, 0x7E}, // @ A
+      {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22}, // B C
+      {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, // D E
+      {0x7F, 0x09, 0x09, 0x01, 0x01}, {0x3E, 0x41, 0x41, 0x51, 0x32}, // F G
+      {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, // H I
+      {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, // J K
+      {0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x04, 0x02, 0x7F}, // L M
+      {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E}, // N O
+      {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, // P Q
+      {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x46, 0x49, 0x49, 0x49, 0x31}, // R S
+      {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, // T U
+      {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x7F, 0x20, 0x18, 0x20, 0x7F}, // V W
+      {0x63, 0x14, 0x08, 0x14, 0x63}, {0x03, 0x04, 0x78, 0x04, 0x03}, // X Y
+      {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00}, // Z [
+      {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, // \ ]
+      {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40}, // ^ _
+      {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, // ` a
+      {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, // b c
+      {0x38, 0x44, 0x44, 0x48, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18}, // d e
+      {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E}, // f g
+      {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, // h i
+      {0x20, 0x40, 0x44, 0x3D, 0x00}, {0x7F, 0x10, 0x28, 0x44, 0x00}, // j k
+      {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, // l m
+      {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, // n o
+      {0x7C, 0x14, 0x14, 0x14, 0x08}, {0x08, 0x14, 0x14, 0x18, 0x7C}, // p q
+      {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20}, // r s
+      {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, // t u
+      {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C}, // v w
+      {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, // x y
+      {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, // z {
+      {0x00, 0x00, 0x7F, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00}, // | }
+      {0x08, 0x04, 0x08, 0x10, 0x08},                                 // ~
+  };
+
+  // Rasterises every glyph as white with 0/255 alpha (tinted by the vertex
+  // colour) and adds it to the atlas. Blank glyphs (space) get no region
+  // and emit no quad.
+  template <typename Bit>
+  bool Build(UITextureAtlas &atlas, uint32_t cellW, uint32_t cellH,
+             uint32_t spacingX, uint32_t spacingY, Bit bit) {
+    glyphs.assign(CHAR_COUNT, Glyph{});
+    advance = float((cellW + spacingX) * scale);
+    lineHeight = float((cellH + spacingY) * scale);
+    std::vector<uint8_t> texels;
+    for (uint32_t c = 0; c < CHAR_COUNT; ++c) {
+      bool any = false;
+      for (uint32_t x = 0; x < cellW && !any; ++x)
+        for (uint32_t y = 0; y < cellH && !any; ++y)
+          any = bit(c, x, y);
+      if (!any)
+        continue;
+
+      const uint32_t w = cellW * scale, h = cellH * scale;
+      texels.assign(size_t(w) * h * 4, 255);
+      for (uint32_t y = 0; y < h; ++y)
+        for (uint32_t x = 0; x < w; ++x)
+          texels[(size_t(y) * w + x) * 4 + 3] =
+              bit(c, x / scale, y / scale) ? 255 : 0;
+
+      uint32_t id = atlas.Add(w, h, texels.data());
+      if (id == UITextureAtlas::NONE) {
+        glyphs.clear();
+        return false;
+      }
+      const UIAtlasRegion &r = atlas.Region(id);
+      glyphs[c] = {float(w), float(h), r.u0, r.v0, r.u1, r.v1};
+    }
+    return true;
+  }
+
+  std::vector<Glyph> glyphs;
+  uint32_t scale = 1;
+  float advance = 0.0f;
+  float lineHeight = 0.0f;
+};
+
+// Laid out runs keyed by string. A run not drawn for `maxIdleFrames`
+// frames is dropped in NextFrame, so a changing label (an FPS counter)
+// costs one layout per new value and the cache stays small.
+//
+// Text drawn every frame from the same call site can pass a Handle: a hit
+// then checks the handle's slot and compares the string, skipping the
+// hash lookup. Dropped slots keep their quad buffers for the next miss.
+class UITextCache {
+public:
+  uint32_t maxIdleFrames = 8;
+
+  // Caller-held; stale handles (the run was dropped) fall back to a lookup
+  struct Handle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+  };
+
+  explicit UITextCache(const UIFont *font = nullptr) : font(font) {}
+
+  void SetFont(const UIFont *newFont) {
+    font = newFont;
+    index.clear();
+    slots.clear();
+    freeSlots.clear();
+  }
+
+  const UITextRun &Get(std::string_view text) {
+    return Touch(Find(text));
+  }
+
+  const UITextRun &Get(std::string_view text, Handle &handle) {
+    if (handle.slot < slots.size()) {
+      const Slot &s = slots[handle.slot];
+      if (s.live && s.generation == handle.generation && s.text == text)
+        return Touch(handle.slot);
+    }
+    uint32_t slot = Find(text);
+    handle = {slot, slots[slot].generation};
+    return Touch(slot);
+  }
+
+  void NextFrame() {
+    ++frame;
+    for (uint32_t i = 0; i < slots.size(); ++i) {
+      Slot &s = slots[i];
+      if (!s.live || frame - s.lastFrame <= maxIdleFrames)
+        continue;
+      index.erase(s.text);
+      s.live = false;
+      ++s.generation;
+      freeSlots.push_back(i);
+    }
+  }
+
+  size_t Size() const { return index.size(); }
+  // Layouts performed since construction (cache misses)
+  uint64_t LayoutCount() const { return layoutCount; }
+
+private:
+  // A deque keeps returned runs in place while later misses add slots
+  struct Slot {
+    std::string text;
+    UITextRun run;
+    uint64_t lastFrame = 0;
+    uint32_t generation = 0;
+    bool live = false;
+  };
+  // Transparent hash, so lookups by string_view do not allocate
+  struct Hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
+  uint32_t Find(std::string_view text) {
+    auto it = index.find(text);
+    if (it != index.end())
+      return it->second;
+
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+      slot = freeSlots.back();
+      freeSlots.pop_back();
+    } else {
+      slot = uint32_t(slots.size());
+      slots.emplace_back();
+    }
+    Slot &s = slots[slot];
+    s.text = text;
+    s.live = true;
+    if (font)
+      font->Layout(text, s.run);
+    else
+      s.run = {};
+    ++layoutCount;
+    index.emplace(s.text, slot);
+    return slot;
+  }
+
+  const UITextRun &Touch(uint32_t slot) {
+    slots[slot].lastFrame = frame;
+    return slots[slot].run;
+  }
+
+  const UIFont *font;
+  std::unordered_map<std::string, uint32_t, Hash, std::equal_to<>> index;
+  std::deque<Slot> slots;
+  std::vector<uint32_t> freeSlots;
+  uint64_t frame = 0;
+  uint64_t layoutCount = 0;
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
@@ -8,57 +8,112 @@ namespace Graphics {
 void UISystem::Initialize(VulkanBackend *backend, Window *window) {
   this->backend = backend;
   this->window = window;
-  CreateQuadMesh();
+  // Before CreateBuffers so the first atlas upload has the glyphs
+  if (!font.Rasterize(atlas, 2))
+    std::cerr << "[UI] Font does not fit the atlas" << std::endl;
+  CreateBuffers();
 }
 
-void UISystem::CreateQuadMesh() {
-  // Vertices
-  std::vector<Vertex> vertices(4);
-  vertices[0].position = {0, 0, 0};
-  vertices[0].uv = {0, 0};
-  vertices[0].normal = {0, 0, 1};
-  vertices[1].position = {1, 0, 0};
-  vertices[1].uv = {1, 0};
-  vertices[1].normal = {0, 0, 1};
-  vertices[2].position = {1, 1, 0};
-  vertices[2].uv = {1, 1};
-  vertices[2].normal = {0, 0, 1};
-  vertices[3].position = {0, 1, 0};
-  vertices[3].uv = {0, 1};
-  vertices[3].normal = {0, 0, 1};
-
-  std::vector<uint32_t> indices = {0, 1, 2, 2, 3, 0};
-
-  // Upload to GPU using backend helper
-  if (backend) {
-      quadMesh = backend->UploadMesh(vertices, indices);
+void UISystem::CreateBuffers() {
+  if (!backend)
+    return;
+  // Rewritten every frame, so host-visible and persistently mapped
+  for (auto &vb : vertexBuffers) {
+    vb = backend->CreateBuffer(size_t(MAX_QUADS) * 4 * sizeof(UIVertex),
+                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  }
+  std::vector<uint32_t> indices = UIBatcher::BuildIndices(MAX_QUADS);
+  indexBuffer = backend->CreateBuffer(indices.size() * sizeof(uint32_t),
+                                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  if (indexBuffer.mapped) {
+    memcpy(indexBuffer.mapped, indices.data(),
+           indices.size() * sizeof(uint32_t));
   }
+
+  atlasTexture = backend->CreateTextureFromBuffer(
+      const_cast<uint8_t *>(atlas.Pixels().data()), atlas.Pixels().size(),
+      atlas.Width(), atlas.Height(), VK_FORMAT_R8G8B8A8_UNORM);
+  atlas.ClearDirty();
 }
 
-void UISystem::BeginFrame() {
-  drawList.clear();
+void UISystem::Cleanup() {
+  if (!backend)
+    return;
+  for (auto &vb : vertexBuffers)
+    backend->DestroyBuffer(vb);
+  backend->DestroyBuffer(indexBuffer);
+  backend->DestroyTexture(atlasTexture);
+}
 
-  // Update Projection (Ortho 0..W, 0..H)
-  float w = (float)window->config.width;
-  float h = (float)window->config.height;
+void UISystem::SyncAtlas() {
+  if (!atlas.IsDirty() || !atlasTexture.IsValid())
+    return;
+  // Earlier frames may still sample the atlas. New glyphs and icons are
+  // rare, so stalling for them is cheaper than an atlas per frame.
+  backend->WaitForFramesInFlight();
+  uint32_t x, y, w, h;
+  atlas.DirtyRect(x, y, w, h);
+  std::vector<uint8_t> texels = atlas.DirtyPixels();
+  backend->UpdateTextureRegion(atlasTexture, texels.data(), x, y, w, h);
+  atlas.ClearDirty();
+}
 
-  // Ortho: 0, w, 0, h (Top-Left Origin)
-  projection = glm::ortho(0.0f, w, 0.0f, h, -1.0f, 1.0f);
+void UISystem::BeginFrame() {
+  textCache.NextFrame();
+  batcher.Begin((float)window->config.width, (float)window->config.height);
 }
 
 void UISystem::DrawImage(float x, float y, float w, float h,
                          GPUTexture &texture, glm::vec4 color) {
   if (!texture.IsValid())
     return;
-  UIElement el;
-  el.x = x;
-  el.y = y;
-  el.width = w;
-  el.height = h;
-  el.texture = &texture;
-  el.color = color;
-  el.isButton = false;
-  drawList.push_back(el);
+  batcher.AddQuad(x, y, w, h, &texture, Pack(color));
+}
+
+void UISystem::DrawRect(float x, float y, float w, float h, glm::vec4 color) {
+  const UIAtlasRegion &r = atlas.Region(UITextureAtlas::WHITE);
+  batcher.AddQuad(x, y, w, h, &atlasTexture, Pack(color), r.u0, r.v0, r.u1,
+                  r.v1);
+}
+
+bool UISystem::DrawIcon(float x, float y, float w, float h,
+                        const std::string &name, glm::vec4 color) {
+  uint32_t id = atlas.Find(name);
+  if (id == UITextureAtlas::NONE)
+    return false;
+  const UIAtlasRegion &r = atlas.Region(id);
+  batcher.AddQuad(x, y, w, h, &atlasTexture, Pack(color), r.u0, r.v0, r.u1,
+                  r.v1);
+  return true;
+}
+
+float UISystem::DrawString(float x, float y, std::string_view text,
+                           glm::vec4 color, float scale) {
+  const UITextRun &run = textCache.Get(text);
+  const uint32_t packed = Pack(color);
+  for (const UIGlyphQuad &g : run.quads) {
+    batcher.AddQuad(x + g.x * scale, y + g.y * scale, g.w * scale,
+                    g.h * scale, &atlasTexture, packed, g.u0, g.v0, g.u1,
+                    g.v1);
+  }
+  return run.width * scale;
+}
+
+void UISystem::MeasureString(std::string_view text, float &width,
+                             float &height, float scale) const {
+  font.Measure(text, width, height);
+  width *= scale;
+  height *= scale;
+}
+
+void UISystem::DrawPerfHUD(PerfHUD &hud,
+                           const Core::Profiling::Profiler &profiler) {
+  hud.Draw(profiler, batcher, textCache, font, &atlasTexture,
+           atlas.Region(UITextureAtlas::WHITE));
 }
 
 bool UISystem::DrawButton(float x, float y, float w, float h,
@@ -113,50 +168,36 @@ bool UISystem::DrawSlider(float x, float y, float w, float h, float &value,
 }
 
 void UISystem::EndFrame(VkCommandBuffer commandBuffer) {
+  batchesLastFrame = 0;
 #if VULKAN_SDK_AVAILABLE
-  if (drawList.empty())
+  GPUBuffer &vertexBuffer = vertexBuffers[backend->currentFrame];
+  if (!vertexBuffer.mapped || batcher.QuadCount() == 0)
+    return;
+  batcher.Finish(static_cast<UIVertex *>(vertexBuffer.mapped), MAX_QUADS);
+  if (batcher.Batches().empty())
     return;
 
   // Bind Pipeline (UI Pipeline)
   vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                     backend->uiPipeline);
 
-  // Bind Vertex Buffers
-  VkBuffer vertexBuffers[] = {quadMesh.vertexBuffer.buffer};
+  VkBuffer vertexBuffersToBind[] = {vertexBuffer.buffer};
   VkDeviceSize offsets[] = {0};
-  vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-  vkCmdBindIndexBuffer(commandBuffer, quadMesh.indexBuffer.buffer, 0,
+  vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffersToBind, offsets);
+  vkCmdBindIndexBuffer(commandBuffer, indexBuffer.buffer, 0,
                        VK_INDEX_TYPE_UINT32);
 
-  GPUTexture *lastTex = nullptr;
-
-  for (const auto &el : drawList) {
-    if (!el.texture)
-      continue;
-
-    // Push Constants
-    struct {
-      glm::mat4 proj;
-      glm::vec4 pos; // x, y, w, h
-      glm::vec4 color;
-    } pc;
-
-    pc.proj = projection;
-    pc.pos = glm::vec4(el.x, el.y, el.width, el.height);
-    pc.color = el.color;
-
-    vkCmdPushConstants(commandBuffer, backend->pipelineLayout,
-                       VK_SHADER_STAGE_VERTEX_BIT |
-                           VK_SHADER_STAGE_FRAGMENT_BIT,
-                       0, sizeof(pc), &pc);
-
-    // Bind Texture if changed
-    if (el.texture != lastTex) {
-      backend->BindTexture(*el.texture, commandBuffer);
-      lastTex = el.texture;
-    }
-
-    vkCmdDrawIndexed(commandBuffer, quadMesh.indexCount, 1, 0, 0, 0);
+  // Pixel -> clip transform, once for the whole UI
+  std::array<float, 4> scaleOffset = batcher.ScaleOffset();
+  vkCmdPushConstants(commandBuffer, backend->pipelineLayout,
+                     VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                     0, sizeof(scaleOffset), scaleOffset.data());
+
+  for (const UIBatch &batch : batcher.Batches()) {
+    backend->BindTexture(*batch.texture, commandBuffer);
+    vkCmdDrawIndexed(commandBuffer, batch.indexCount, 1, batch.firstIndex, 0,
+                     0);
+    ++batchesLastFrame;
   }
 #endif
 }
@@ -1,47 +1,65 @@
 #pragma once
 #include "../VulkanBackend.h"
 #include "../Window.h"
+#include "PerfHUD.h"
+#include "UIBatcher.h"
+#include "UIFont.h"
 #include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 
-
 namespace Mesozoic {
 namespace Graphics {
 
-struct UIElement {
-  float x, y, width, height;
-  GPUTexture *texture;
-  glm::vec4 color;
-  bool isButton;
-  bool visible;
-  // Callback or ID could go here
-};
-
 class UISystem {
 public:
   VulkanBackend *backend;
   Window *window;
 
-  // Orthographic Matrix
-  glm::mat4 projection;
+  // Quads per frame; further quads are dropped
+  static constexpr uint32_t MAX_QUADS = 16384;
+
+  // This frame's quads, grouped into per-texture draws in EndFrame
+  UIBatcher batcher;
+
+  // Icons and glyphs share one texture so they batch with each other
+  UITextureAtlas atlas;
+  GPUTexture atlasTexture;
 
-  // Batch of draw calls
-  std::vector<UIElement> drawList;
+  // Built-in bitmap font in the atlas; runs re-laid out only on change
+  UIFont font;
+  UITextCache textCache{&font};
 
-  // Quad mesh (shared)
-  GPUMesh quadMesh;
-  uint32_t quadMeshId;
+  // Mapped vertex buffer per frame in flight + the shared quad indices
+  std::array<GPUBuffer, VulkanBackend::MAX_FRAMES_IN_FLIGHT> vertexBuffers;
+  GPUBuffer indexBuffer;
+  uint32_t batchesLastFrame = 0;
 
   void Initialize(VulkanBackend *backend, Window *window);
+  void Cleanup();
 
   void BeginFrame();
+  // Uploads atlas texels added this frame; before the backend's BeginFrame
+  void SyncAtlas();
   void EndFrame(VkCommandBuffer commandBuffer); // Record draw commands
 
   // Immediate Mode API
   void DrawImage(float x, float y, float w, float h, GPUTexture &texture,
                  glm::vec4 color = {1, 1, 1, 1});
+  // Untextured rectangle from the atlas' white texel
+  void DrawRect(float x, float y, float w, float h, glm::vec4 color);
+  // Atlas image added with atlas.Add(name, ...); false if unknown
+  bool DrawIcon(float x, float y, float w, float h, const std::string &name,
+                glm::vec4 color = {1, 1, 1, 1});
+  // Text from the cached glyph runs; returns the drawn width
+  float DrawString(float x, float y, std::string_view text,
+                   glm::vec4 color = {1, 1, 1, 1}, float scale = 1.0f);
+  void MeasureString(std::string_view text, float &width, float &height,
+                     float scale = 1.0f) const;
+  // Profiler overlay, when hud.visible
+  void DrawPerfHUD(PerfHUD &hud, const Core::Profiling::Profiler &profiler);
   bool DrawButton(float x, float y, float w, float h, GPUTexture &texture,
                   glm::vec4 color = {1, 1, 1, 1},
                   glm::vec4 hoverColor = {0.8, 0.8, 0.8, 1});
@@ -55,7 +73,10 @@ public:
   float GetScreenHeight() const { return (float)window->config.height; }
 
 private:
-  void CreateQuadMesh();
+  void CreateBuffers();
+  static uint32_t Pack(const glm::vec4 &c) {
+    return PackUIColor(c.r, c.g, c.b, c.a);
+  }
 };
 
 } // namespace Graphics
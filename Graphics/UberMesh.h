@@ -3,7 +3,9 @@
 
 #if defined(__cplusplus)
 #include <array>
+#include <cmath>
 #include <iostream>
+#include <string>
 #include <vector>
 using float2 = std::array<float, 2>;
 using float3 = std::array<float, 3>;
@@ -37,22 +39,76 @@ struct UberMesh {
   std::vector<Vertex> baseVertices;
   std::vector<uint32_t> indices;
 
-  // Morph Targets: Each target has a list of deltas matching vertex count (or
-  // sparse) For 10,000 entities, we use GPU Compute to apply these. But here is
-  // the CPU data structure.
+  // Morph Targets: sparse, only the vertices a target moves are stored.
+  // For 10,000 entities, we use GPU Compute to apply these. But here is the
+  // CPU data structure.
   struct Target {
+    // Span of consecutive vertex indices stored back-to-back in the delta
+    // arrays, so the CPU kernel can stream it without gathers
+    struct Run {
+      uint32_t firstVertex;
+      uint32_t firstDelta;
+      uint32_t count;
+    };
+
     std::string name;
-    std::vector<MorphDelta>
-        deltas; // Same size as baseVertices for simplicity here
+    std::vector<uint32_t> indices;       // Ascending vertex indices
+    std::vector<float> positionDeltas;   // xyz per entry in `indices`
+    std::vector<float> normalDeltas;     // xyz per entry in `indices`
+    std::vector<Run> runs;
+
+    size_t DeltaCount() const { return indices.size(); }
+
+    // Append a delta; vertices must be added in ascending order
+    void Add(uint32_t vertex, const MorphDelta &delta) {
+      uint32_t slot = static_cast<uint32_t>(indices.size());
+      if (!runs.empty() && runs.back().firstVertex + runs.back().count ==
+                               vertex) {
+        runs.back().count++;
+      } else {
+        runs.push_back({vertex, slot, 1});
+      }
+      indices.push_back(vertex);
+      positionDeltas.insert(positionDeltas.end(), delta.positionDelta.begin(),
+                            delta.positionDelta.end());
+      normalDeltas.insert(normalDeltas.end(), delta.normalDelta.begin(),
+                          delta.normalDelta.end());
+    }
+
+    MorphDelta Delta(size_t i) const {
+      return {{positionDeltas[i * 3], positionDeltas[i * 3 + 1],
+               positionDeltas[i * 3 + 2]},
+              {normalDeltas[i * 3], normalDeltas[i * 3 + 1],
+               normalDeltas[i * 3 + 2]}};
+    }
   };
 
   std::vector<Target> morphTargets;
 
-  void AddMorphTarget(const std::string &name) {
+  Target &AddMorphTarget(const std::string &name) {
     Target t;
     t.name = name;
-    t.deltas.resize(baseVertices.size(), {{0, 0, 0}, {0, 0, 0}});
     morphTargets.push_back(t);
+    return morphTargets.back();
+  }
+
+  // Build a sparse target from dense per-vertex deltas, dropping vertices
+  // whose position and normal deltas are both below `epsilon`
+  Target &AddMorphTarget(const std::string &name,
+                         const std::vector<MorphDelta> &dense,
+                         float epsilon = 1e-6f) {
+    Target &t = AddMorphTarget(name);
+    for (size_t v = 0; v < dense.size(); ++v) {
+      const MorphDelta &d = dense[v];
+      bool moves = false;
+      for (int k = 0; k < 3; ++k) {
+        moves |= std::abs(d.positionDelta[k]) > epsilon ||
+                 std::abs(d.normalDelta[k]) > epsilon;
+      }
+      if (moves)
+        t.Add(static_cast<uint32_t>(v), d);
+    }
+    return t;
   }
 };
 
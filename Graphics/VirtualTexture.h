@@ -0,0 +1,742 @@
+#pragma once
+#include "../Assets/TextureData.h"
+#include "../Core/Threading/JobSystem.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace Mesozoic {
+namespace Graphics {
+
+// =========================================================================
+// Virtual Texturing
+// =========================================================================
+// The terrain's material texture is a huge virtual mip chain cut into
+// fixed-size pages; only the pages the camera actually sees live in a
+// physical atlas of `cacheSlotsX * cacheSlotsY` slots, so texel density no
+// longer depends on the park size and VRAM use is fixed. Each frame:
+//   1. the GPU writes the page it wanted per (downscaled) pixel into a
+//      feedback buffer; AnalyzeFeedback() dedups it, adds every ancestor
+//      so a fallback chain exists, and orders requests coarse-first,
+//   2. requested pages already in the cache are touched (LRU),
+//   3. missing pages are composited on JobSystem workers from the splat
+//      map and material layers (TerrainPageCompositor),
+//   4. finished pages are uploaded into the least recently used slot not
+//      needed this frame, under a per-frame upload budget,
+//   5. the page table (one RGBA8 indirection texel per page and level)
+//      points every page at its nearest resident ancestor.
+// Everything but the composite callback runs on the main thread, and the
+// page logic needs no GPU so it can be driven headless.
+
+namespace VT {
+
+// Page address: level in the top 8 bits, then 12 bits each of y and x
+// (so at most 4096 pages per side)
+using PageKey = uint32_t;
+constexpr PageKey INVALID_PAGE = 0xFFFFFFFFu; // Feedback texels with no page
+
+inline PageKey PackPage(uint32_t mip, uint32_t x, uint32_t y) {
+  return (mip << 24) | (y << 12) | x;
+}
+inline uint32_t PageMip(PageKey key) { return key >> 24; }
+inline uint32_t PageX(PageKey key) { return key & 0xFFFu; }
+inline uint32_t PageY(PageKey key) { return (key >> 12) & 0xFFFu; }
+
+} // namespace VT
+
+// Page grid of every level, down to the level that fits one page
+struct VirtualTextureLayout {
+  uint32_t width = 0; // Level 0 texels
+  uint32_t height = 0;
+  uint32_t pageSize = 0; // Payload texels per page edge
+  uint32_t border = 0;   // Extra texels per side for bilinear/aniso taps
+  uint32_t levels = 0;
+  uint32_t pageCount = 0;
+  std::vector<uint32_t> pagesX, pagesY, levelOffset;
+
+  void Build(uint32_t w, uint32_t h, uint32_t page, uint32_t pageBorder) {
+    width = w;
+    height = h;
+    pageSize = std::max(1u, page);
+    border = pageBorder;
+    pagesX.clear();
+    pagesY.clear();
+    levelOffset.clear();
+    pageCount = 0;
+    uint32_t lw = std::max(1u, w), lh = std::max(1u, h);
+    while (true) {
+      uint32_t px = (lw + pageSize - 1) / pageSize;
+      uint32_t py = (lh + pageSize - 1) / pageSize;
+      pagesX.push_back(px);
+      pagesY.push_back(py);
+      levelOffset.push_back(pageCount);
+      pageCount += px * py;
+      if (px == 1 && py == 1)
+        break;
+      lw = std::max(1u, lw / 2);
+      lh = std::max(1u, lh / 2);
+    }
+    levels = static_cast<uint32_t>(pagesX.size());
+  }
+
+  // Edge of a cache slot: the page plus its border on both sides
+  uint32_t SlotTexels() const { return pageSize + 2 * border; }
+
+  bool Contains(VT::PageKey key) const {
+    uint32_t mip = VT::PageMip(key);
+    return mip < levels && VT::PageX(key) < pagesX[mip] &&
+           VT::PageY(key) < pagesY[mip];
+  }
+  // Dense index over all levels (Contains(key) must hold)
+  uint32_t Index(VT::PageKey key) const {
+    uint32_t mip = VT::PageMip(key);
+    return levelOffset[mip] + VT::PageY(key) * pagesX[mip] + VT::PageX(key);
+  }
+  // Same area one level coarser; the top page returns INVALID_PAGE
+  VT::PageKey Parent(VT::PageKey key) const {
+    uint32_t mip = VT::PageMip(key);
+    if (mip + 1 >= levels)
+      return VT::INVALID_PAGE;
+    return VT::PackPage(mip + 1, VT::PageX(key) / 2, VT::PageY(key) / 2);
+  }
+  VT::PageKey Top() const { return VT::PackPage(levels - 1, 0, 0); }
+};
+
+// Indirection texel. Mirrors the RGBA8 page table texture: `mip` is the
+// level of the page actually mapped (>= the level looked up), so the shader
+// rescales the virtual UV by 2^(mip - wanted) inside the slot.
+struct PageTableEntry {
+  uint8_t slotX = 0;
+  uint8_t slotY = 0;
+  uint8_t mip = 0;
+  uint8_t resident = 0; // 0 until some ancestor (or the page) is mapped
+};
+
+class PageTable {
+public:
+  void Reset(const VirtualTextureLayout &l) {
+    layout = &l;
+    entries.assign(l.pageCount, PageTableEntry{});
+    mapped.assign(l.pageCount, 0);
+    dirtyLevels = l.levels >= 32 ? ~0u : (1u << l.levels) - 1;
+  }
+
+  void Map(VT::PageKey key, uint32_t slotX, uint32_t slotY) {
+    uint32_t idx = layout->Index(key);
+    mapped[idx] = 1;
+    entries[idx] = {uint8_t(slotX), uint8_t(slotY),
+                    uint8_t(VT::PageMip(key)), 1};
+    dirtyLevels |= 1u << VT::PageMip(key);
+    if (VT::PageMip(key) > 0)
+      Propagate(key, VT::PageMip(key) - 1);
+  }
+
+  // Finer pages fall back to the nearest mapped ancestor again
+  void Unmap(VT::PageKey key) {
+    mapped[layout->Index(key)] = 0;
+    Propagate(key, VT::PageMip(key));
+  }
+
+  const PageTableEntry &Lookup(VT::PageKey key) const {
+    return entries[layout->Index(key)];
+  }
+  bool IsMapped(VT::PageKey key) const {
+    return mapped[layout->Index(key)] != 0;
+  }
+  // pagesX * pagesY texels, row-major: the upload for one table mip
+  std::span<const PageTableEntry> Level(uint32_t mip) const {
+    return {entries.data() + layout->levelOffset[mip],
+            size_t(layout->pagesX[mip]) * layout->pagesY[mip]};
+  }
+  // Bit per level changed since ClearDirty()
+  uint32_t DirtyLevels() const { return dirtyLevels; }
+  void ClearDirty() { dirtyLevels = 0; }
+
+private:
+  const VirtualTextureLayout *layout = nullptr;
+  std::vector<PageTableEntry> entries;
+  std::vector<uint8_t> mapped;
+  uint32_t dirtyLevels = 0;
+
+  // Recomputes unmapped entries under `key`'s footprint from `first` down
+  // to level 0, coarse to fine so each parent is final before its children
+  void Propagate(VT::PageKey key, uint32_t first) {
+    const uint32_t mip = VT::PageMip(key);
+    for (int32_t l = int32_t(first); l >= 0; --l) {
+      const uint32_t level = uint32_t(l), shift = mip - level;
+      const uint32_t x0 = VT::PageX(key) << shift;
+      const uint32_t y0 = VT::PageY(key) << shift;
+      const uint32_t x1 = std::min(layout->pagesX[level], x0 + (1u << shift));
+      const uint32_t y1 = std::min(layout->pagesY[level], y0 + (1u << shift));
+      const bool top = level + 1 >= layout->levels;
+      for (uint32_t y = y0; y < y1; ++y) {
+        for (uint32_t x = x0; x < x1; ++x) {
+          uint32_t idx = layout->Index(VT::PackPage(level, x, y));
+          if (mapped[idx])
+            continue;
+          entries[idx] =
+              top ? PageTableEntry{}
+                  : entries[layout->Index(VT::PackPage(level + 1, x / 2,
+                                                       y / 2))];
+        }
+      }
+      dirtyLevels |= 1u << level;
+    }
+  }
+};
+
+// Fixed set of physical slots with least-recently-used replacement. Slots
+// hold an intrusive doubly linked list (head = most recent); pinned slots
+// leave the list and are never handed out again.
+class PageCache {
+public:
+  static constexpr int32_t NONE = -1;
+
+  void Reset(uint32_t slotCount) {
+    keys.assign(slotCount, VT::INVALID_PAGE);
+    lastUsed.assign(slotCount, 0);
+    prev.assign(slotCount, NONE);
+    next.assign(slotCount, NONE);
+    pinned.assign(slotCount, 0);
+    head = tail = NONE;
+    freeSlots.clear();
+    for (uint32_t s = slotCount; s-- > 0;)
+      freeSlots.push_back(int32_t(s)); // Slot 0 is handed out first
+  }
+
+  uint32_t SlotCount() const { return uint32_t(keys.size()); }
+  VT::PageKey Key(int32_t slot) const { return keys[slot]; }
+  uint32_t LastUsed(int32_t slot) const { return lastUsed[slot]; }
+  bool IsPinned(int32_t slot) const { return pinned[slot] != 0; }
+  uint32_t FreeCount() const { return uint32_t(freeSlots.size()); }
+
+  // A free slot, else the LRU slot not used in `frame`; NONE when every
+  // slot is pinned or needed this frame
+  int32_t Victim(uint32_t frame) const {
+    if (!freeSlots.empty())
+      return freeSlots.back();
+    if (tail != NONE && lastUsed[tail] < frame)
+      return tail;
+    return NONE;
+  }
+
+  void Assign(int32_t slot, VT::PageKey key, uint32_t frame) {
+    if (!freeSlots.empty() && freeSlots.back() == slot)
+      freeSlots.pop_back();
+    else
+      Unlink(slot);
+    keys[slot] = key;
+    lastUsed[slot] = frame;
+    PushFront(slot);
+  }
+
+  void Touch(int32_t slot, uint32_t frame) {
+    lastUsed[slot] = frame;
+    if (pinned[slot] || head == slot)
+      return;
+    Unlink(slot);
+    PushFront(slot);
+  }
+
+  void Pin(int32_t slot) {
+    if (pinned[slot])
+      return;
+    Unlink(slot);
+    pinned[slot] = 1;
+  }
+
+private:
+  std::vector<VT::PageKey> keys;
+  std::vector<uint32_t> lastUsed;
+  std::vector<int32_t> prev, next;
+  std::vector<uint8_t> pinned;
+  std::vector<int32_t> freeSlots;
+  int32_t head = NONE, tail = NONE;
+
+  void Unlink(int32_t slot) {
+    if (prev[slot] != NONE)
+      next[prev[slot]] = next[slot];
+    else if (head == slot)
+      head = next[slot];
+    if (next[slot] != NONE)
+      prev[next[slot]] = prev[slot];
+    else if (tail == slot)
+      tail = prev[slot];
+    prev[slot] = next[slot] = NONE;
+  }
+
+  void PushFront(int32_t slot) {
+    prev[slot] = NONE;
+    next[slot] = head;
+    if (head != NONE)
+      prev[head] = slot;
+    head = slot;
+    if (tail == NONE)
+      tail = slot;
+  }
+};
+
+struct PageRequest {
+  VT::PageKey key;
+  uint32_t count; // Feedback texels asking for it (ancestors sum children)
+};
+
+class VirtualTexture {
+public:
+  // Worker thread: writes SlotTexels()^2 RGBA8 texels (page plus border)
+  using CompositeFn =
+      std::function<void(VT::PageKey, uint8_t *rgba, uint32_t rowPitch)>;
+  // Main thread: copies a finished page (tightly packed) into its slot
+  using UploadFn = std::function<void(uint32_t slotX, uint32_t slotY,
+                                      const uint8_t *rgba)>;
+
+  struct Settings {
+    uint32_t virtualWidth = 32768; // Level 0 texels
+    uint32_t virtualHeight = 32768;
+    uint32_t pageSize = 128;
+    uint32_t border = 4;
+    uint32_t cacheSlotsX = 16; // Physical atlas, in slots (max 256 each)
+    uint32_t cacheSlotsY = 16;
+    uint32_t maxInFlight = 8;        // Composites queued or running
+    uint32_t maxUploadsPerFrame = 8; // Pages copied to the atlas per Update
+  };
+
+  struct Stats {
+    uint64_t composites = 0;
+    uint64_t uploads = 0;
+    uint64_t evictions = 0;
+    uint64_t dropped = 0;         // Finished after an Invalidate; redone
+    uint32_t requestedLastFrame = 0;
+    uint32_t missingLastFrame = 0; // Requested but not resident
+  };
+
+  VirtualTexture(Core::Threading::JobSystem &jobs, const Settings &settings,
+                 CompositeFn composite)
+      : jobs(jobs), settings(settings), composite(std::move(composite)) {
+    layout.Build(settings.virtualWidth, settings.virtualHeight,
+                 settings.pageSize, settings.border);
+    table.Reset(layout);
+    cache.Reset(std::min(settings.cacheSlotsX, 256u) *
+                std::min(settings.cacheSlotsY, 256u));
+    slotOf.assign(layout.pageCount, PageCache::NONE);
+    state.assign(layout.pageCount, PageState::Absent);
+    generation.assign(layout.pageCount, 0);
+    stale.assign(layout.pageCount, 0);
+    requestStamp.assign(layout.pageCount, 0);
+    requestCount.assign(layout.pageCount, 0);
+  }
+
+  // Workers write into buffers the completions own, but read the sources
+  ~VirtualTexture() { WaitForCompositing(); }
+
+  VirtualTexture(const VirtualTexture &) = delete;
+  VirtualTexture &operator=(const VirtualTexture &) = delete;
+
+  // Unique pages in `feedback` plus all their ancestors, coarsest level
+  // first, then most requested. Keys outside the layout are ignored.
+  const std::vector<PageRequest> &
+  AnalyzeFeedback(std::span<const VT::PageKey> feedback) {
+    ++requestFrame;
+    requests.clear();
+    for (VT::PageKey key : feedback) {
+      if (key == VT::INVALID_PAGE || !layout.Contains(key))
+        continue;
+      uint32_t idx = layout.Index(key);
+      if (requestStamp[idx] != requestFrame) {
+        requestStamp[idx] = requestFrame;
+        requestCount[idx] = 0;
+        requests.push_back({key, 0});
+      }
+      ++requestCount[idx];
+    }
+    // One level at a time, finest first, so every page's count is final
+    // before it is added to its parent
+    for (uint32_t mip = 0; mip + 1 < layout.levels; ++mip) {
+      const size_t end = requests.size(); // Parents appended are mip + 1
+      for (size_t i = 0; i < end; ++i) {
+        VT::PageKey key = requests[i].key;
+        if (VT::PageMip(key) != mip)
+          continue;
+        VT::PageKey parent = layout.Parent(key);
+        uint32_t pidx = layout.Index(parent);
+        if (requestStamp[pidx] != requestFrame) {
+          requestStamp[pidx] = requestFrame;
+          requestCount[pidx] = 0;
+          requests.push_back({parent, 0});
+        }
+        requestCount[pidx] += requestCount[layout.Index(key)];
+      }
+    }
+    for (PageRequest &r : requests)
+      r.count = requestCount[layout.Index(r.key)];
+    std::sort(requests.begin(), requests.end(),
+              [](const PageRequest &a, const PageRequest &b) {
+                if (VT::PageMip(a.key) != VT::PageMip(b.key))
+                  return VT::PageMip(a.key) > VT::PageMip(b.key);
+                if (a.count != b.count)
+                  return a.count > b.count;
+                return a.key < b.key;
+              });
+    return requests;
+  }
+
+  // Once a frame, with last frame's feedback. The top page is always
+  // requested and stays pinned once resident, so every lookup resolves.
+  void Update(std::span<const VT::PageKey> feedback, const UploadFn &upload) {
+    ++frame;
+    AnalyzeFeedback(feedback);
+    if (requests.empty() || requests.front().key != layout.Top())
+      requests.insert(requests.begin(), {layout.Top(), 0});
+    // Touch before uploading, so no page this frame needs is a victim
+    for (const PageRequest &r : requests) {
+      int32_t slot = slotOf[layout.Index(r.key)];
+      if (slot != PageCache::NONE)
+        cache.Touch(slot, frame);
+    }
+    Collect();
+    Upload(upload);
+
+    stats.requestedLastFrame = uint32_t(requests.size());
+    stats.missingLastFrame = 0;
+    for (const PageRequest &r : requests) {
+      uint32_t idx = layout.Index(r.key);
+      if (slotOf[idx] == PageCache::NONE)
+        ++stats.missingLastFrame;
+      bool needed = slotOf[idx] == PageCache::NONE || stale[idx];
+      if (needed && state[idx] == PageState::Absent)
+        Dispatch(r.key);
+    }
+  }
+
+  // Level 0 texels [x0, x1) x [y0, y1) changed in the sources. Resident
+  // pages over it keep their old contents until the recomposite lands;
+  // composites already running for them are discarded.
+  void Invalidate(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+    if (x1 <= x0 || y1 <= y0)
+      return;
+    const uint32_t b = layout.border;
+    for (uint32_t mip = 0; mip < layout.levels; ++mip) {
+      // Borders reach into the neighbours, so widen by one border texel
+      uint32_t span = layout.pageSize << mip;
+      uint32_t px0 = (x0 > (b << mip) ? x0 - (b << mip) : 0) / span;
+      uint32_t py0 = (y0 > (b << mip) ? y0 - (b << mip) : 0) / span;
+      uint32_t px1 = std::min(layout.pagesX[mip] - 1,
+                              (x1 - 1 + (b << mip)) / span);
+      uint32_t py1 = std::min(layout.pagesY[mip] - 1,
+                              (y1 - 1 + (b << mip)) / span);
+      for (uint32_t y = py0; y <= py1; ++y) {
+        for (uint32_t x = px0; x <= px1; ++x) {
+          uint32_t idx = layout.Index(VT::PackPage(mip, x, y));
+          ++generation[idx];
+          if (slotOf[idx] != PageCache::NONE)
+            stale[idx] = 1;
+        }
+      }
+    }
+  }
+
+  // Blocks until no composite is running; call before editing the sources
+  void WaitForCompositing() {
+    std::unique_lock<std::mutex> lock(completedMutex);
+    completedCV.wait(lock, [this] { return inFlight == 0; });
+  }
+
+  bool IsResident(VT::PageKey key) const {
+    return layout.Contains(key) &&
+           slotOf[layout.Index(key)] != PageCache::NONE;
+  }
+  int32_t SlotOf(VT::PageKey key) const {
+    return layout.Contains(key) ? slotOf[layout.Index(key)]
+                                : PageCache::NONE;
+  }
+  bool IsStale(VT::PageKey key) const {
+    return layout.Contains(key) && stale[layout.Index(key)] != 0;
+  }
+
+  const VirtualTextureLayout &Layout() const { return layout; }
+  const PageTable &Table() const { return table; }
+  PageTable &Table() { return table; }
+  const PageCache &Cache() const { return cache; }
+  const Stats &GetStats() const { return stats; }
+  const Settings &GetSettings() const { return settings; }
+  uint32_t AtlasWidth() const {
+    return std::min(settings.cacheSlotsX, 256u) * layout.SlotTexels();
+  }
+  uint32_t AtlasHeight() const {
+    return std::min(settings.cacheSlotsY, 256u) * layout.SlotTexels();
+  }
+
+private:
+  enum class PageState : uint8_t {
+    Absent,  // Nothing in flight (may still be resident)
+    Pending, // Composite queued or running
+    Ready    // Composited, waiting for a slot and upload budget
+  };
+
+  struct Completion {
+    VT::PageKey key;
+    uint32_t generation;
+    std::vector<uint8_t> texels;
+  };
+
+  Core::Threading::JobSystem &jobs;
+  Settings settings;
+  CompositeFn composite;
+  VirtualTextureLayout layout;
+  PageTable table;
+  PageCache cache;
+  // Dense per-page state, indexed by VirtualTextureLayout::Index
+  std::vector<int32_t> slotOf;
+  std::vector<PageState> state;
+  std::vector<uint32_t> generation; // Bumped by Invalidate
+  std::vector<uint8_t> stale; // Resident but invalidated
+  std::vector<uint32_t> requestStamp, requestCount;
+  std::vector<PageRequest> requests;
+  std::vector<Completion> ready;
+  uint32_t requestFrame = 0;
+  uint32_t frame = 0;
+  Stats stats;
+
+  std::mutex completedMutex;
+  std::condition_variable completedCV;
+  std::vector<Completion> completed;
+  uint32_t inFlight = 0;
+
+  void Dispatch(VT::PageKey key) {
+    {
+      std::lock_guard<std::mutex> lock(completedMutex);
+      if (inFlight + ready.size() >= settings.maxInFlight)
+        return;
+      ++inFlight;
+    }
+    uint32_t idx = layout.Index(key);
+    state[idx] = PageState::Pending;
+    uint32_t gen = generation[idx];
+    uint32_t edge = layout.SlotTexels();
+    jobs.PushJob([this, key, gen, edge] {
+      Completion c{key, gen, std::vector<uint8_t>(size_t(edge) * edge * 4)};
+      if (composite)
+        composite(key, c.texels.data(), edge * 4);
+      std::lock_guard<std::mutex> lock(completedMutex);
+      completed.push_back(std::move(c));
+      --inFlight;
+      completedCV.notify_all();
+    });
+    ++stats.composites;
+  }
+
+  void Collect() {
+    std::vector<Completion> done;
+    {
+      std::lock_guard<std::mutex> lock(completedMutex);
+      done.swap(completed);
+    }
+    for (Completion &c : done) {
+      uint32_t idx = layout.Index(c.key);
+      if (c.generation != generation[idx]) {
+        state[idx] = PageState::Absent; // Sources changed; composite again
+        ++stats.dropped;
+        continue;
+      }
+      state[idx] = PageState::Ready;
+      ready.push_back(std::move(c));
+    }
+    // Coarse pages first: they are the fallback for everything below
+    std::stable_sort(ready.begin(), ready.end(),
+                     [](const Completion &a, const Completion &b) {
+                       return VT::PageMip(a.key) > VT::PageMip(b.key);
+                     });
+  }
+
+  void Upload(const UploadFn &upload) {
+    const uint32_t slotsX = std::min(settings.cacheSlotsX, 256u);
+    uint32_t uploads = 0;
+    size_t next = 0;
+    for (; next < ready.size() && uploads < settings.maxUploadsPerFrame;
+         ++next) {
+      Completion &c = ready[next];
+      uint32_t idx = layout.Index(c.key);
+      int32_t slot = slotOf[idx];
+      if (slot == PageCache::NONE) {
+        slot = cache.Victim(frame);
+        if (slot == PageCache::NONE)
+          break; // Every slot is in use this frame; retry next frame
+        VT::PageKey old = cache.Key(slot);
+        if (old != VT::INVALID_PAGE) {
+          uint32_t oldIdx = layout.Index(old);
+          table.Unmap(old);
+          slotOf[oldIdx] = PageCache::NONE;
+          stale[oldIdx] = 0;
+          ++stats.evictions;
+        }
+        cache.Assign(slot, c.key, frame);
+        slotOf[idx] = slot;
+      } else {
+        cache.Touch(slot, frame); // Refresh after Invalidate
+      }
+      uint32_t sx = uint32_t(slot) % slotsX, sy = uint32_t(slot) / slotsX;
+      if (upload)
+        upload(sx, sy, c.texels.data());
+      table.Map(c.key, sx, sy);
+      if (c.key == layout.Top())
+        cache.Pin(slot);
+      state[idx] = PageState::Absent;
+      stale[idx] = 0;
+      ++uploads;
+      ++stats.uploads;
+    }
+    ready.erase(ready.begin(), ready.begin() + next);
+  }
+};
+
+// =========================================================================
+// Terrain page compositing
+// =========================================================================
+// Blends the material layers by the splat weights (r = grass, g = dirt,
+// b = rock) at page resolution. Each layer tiles every `repeatTexels`
+// virtual texels and is sampled from the mip whose texel size matches the
+// page's level, so coarse pages come out pre-filtered.
+
+struct TerrainMaterialLayer {
+  const Assets::TextureData *texture = nullptr; // RGBA8 with a mip chain
+  float repeatTexels = 512.0f; // Level 0 virtual texels per repeat
+  std::array<uint8_t, 4> color = {255, 255, 255, 255}; // Without texture
+};
+
+class TerrainPageCompositor {
+public:
+  const uint8_t *splat = nullptr; // RGBA8, splatWidth * splatHeight
+  uint32_t splatWidth = 0;
+  uint32_t splatHeight = 0;
+  std::array<TerrainMaterialLayer, 3> layers;
+
+  explicit TerrainPageCompositor(const VirtualTextureLayout &layout)
+      : layout(layout) {}
+
+  void operator()(VT::PageKey key, uint8_t *dst, uint32_t rowPitch) const {
+    const uint32_t mip = VT::PageMip(key);
+    const float texelScale = float(1u << mip);
+    const int32_t edge = int32_t(layout.SlotTexels());
+    const float originX =
+        float(VT::PageX(key) * layout.pageSize) - float(layout.border);
+    const float originY =
+        float(VT::PageY(key) * layout.pageSize) - float(layout.border);
+    const float toSplatX = float(splatWidth) / float(layout.width);
+    const float toSplatY = float(splatHeight) / float(layout.height);
+
+    // Per layer: source mip and level-0-texel to layer-texel scale
+    struct LayerSampler {
+      const uint8_t *pixels = nullptr;
+      uint32_t width = 0, height = 0;
+      float scale = 0.0f;
+    } samplers[3];
+    for (int i = 0; i < 3; ++i) {
+      const Assets::TextureData *tex = layers[i].texture;
+      if (!tex || !tex->valid || tex->format != Assets::PixelFormat::RGBA8)
+        continue;
+      float scale = float(tex->width) / std::max(1.0f, layers[i].repeatTexels);
+      float footprint = std::log2(std::max(1e-6f, scale * texelScale));
+      uint32_t levels = std::max<uint32_t>(1, uint32_t(tex->mips.size()));
+      uint32_t level = uint32_t(std::clamp(
+          int(std::floor(footprint + 0.5f)), 0, int(levels) - 1));
+      LayerSampler &s = samplers[i];
+      s.pixels = tex->pixels.data();
+      s.width = tex->width;
+      s.height = tex->height;
+      if (!tex->mips.empty()) {
+        const Assets::TextureMip &m = tex->mips[level];
+        s.pixels += m.offset;
+        s.width = m.width;
+        s.height = m.height;
+      }
+      s.scale = scale * float(s.width) / float(tex->width);
+    }
+
+    for (int32_t y = 0; y < edge; ++y) {
+      float vy = std::clamp((originY + float(y) + 0.5f) * texelScale, 0.0f,
+                            float(layout.height) - 0.5f);
+      uint8_t *row = dst + size_t(y) * rowPitch;
+      for (int32_t x = 0; x < edge; ++x) {
+        float vx = std::clamp((originX + float(x) + 0.5f) * texelScale, 0.0f,
+                              float(layout.width) - 0.5f);
+        float w[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+        if (splat && splatWidth > 0 && splatHeight > 0) {
+          SampleClamp(splat, splatWidth, splatHeight, vx * toSplatX - 0.5f,
+                      vy * toSplatY - 0.5f, w);
+        }
+        float sum = w[0] + w[1] + w[2];
+        if (sum < 1e-3f) {
+          w[0] = 255.0f;
+          w[1] = w[2] = 0.0f;
+          sum = 255.0f;
+        }
+        float out[4] = {};
+        for (int i = 0; i < 3; ++i) {
+          float weight = w[i] / sum;
+          if (weight <= 0.0f)
+            continue;
+          float c[4];
+          const LayerSampler &s = samplers[i];
+          if (s.pixels) {
+            SampleWrap(s.pixels, s.width, s.height,
+                       vx * s.scale - 0.5f, vy * s.scale - 0.5f, c);
+          } else {
+            for (int ch = 0; ch < 4; ++ch)
+              c[ch] = float(layers[i].color[ch]);
+          }
+          for (int ch = 0; ch < 4; ++ch)
+            out[ch] += c[ch] * weight;
+        }
+        for (int ch = 0; ch < 4; ++ch)
+          row[x * 4 + ch] = uint8_t(std::clamp(out[ch] + 0.5f, 0.0f, 255.0f));
+      }
+    }
+  }
+
+private:
+  const VirtualTextureLayout &layout;
+
+  static void SampleClamp(const uint8_t *rgba, uint32_t w, uint32_t h,
+                          float x, float y, float out[4]) {
+    x = std::clamp(x, 0.0f, float(w - 1));
+    y = std::clamp(y, 0.0f, float(h - 1));
+    uint32_t x0 = uint32_t(x), y0 = uint32_t(y);
+    uint32_t x1 = std::min(x0 + 1, w - 1), y1 = std::min(y0 + 1, h - 1);
+    Bilinear(rgba, w, x0, y0, x1, y1, x - float(x0), y - float(y0), out);
+  }
+
+  static void SampleWrap(const uint8_t *rgba, uint32_t w, uint32_t h,
+                         float x, float y, float out[4]) {
+    float fx = std::floor(x), fy = std::floor(y);
+    auto wrap = [](int64_t v, uint32_t n) {
+      int64_t m = v % int64_t(n);
+      return uint32_t(m < 0 ? m + n : m);
+    };
+    uint32_t x0 = wrap(int64_t(fx), w), y0 = wrap(int64_t(fy), h);
+    uint32_t x1 = x0 + 1 == w ? 0 : x0 + 1, y1 = y0 + 1 == h ? 0 : y0 + 1;
+    Bilinear(rgba, w, x0, y0, x1, y1, x - fx, y - fy, out);
+  }
+
+  static void Bilinear(const uint8_t *rgba, uint32_t w, uint32_t x0,
+                       uint32_t y0, uint32_t x1, uint32_t y1, float tx,
+                       float ty, float out[4]) {
+    const uint8_t *a = rgba + (size_t(y0) * w + x0) * 4;
+    const uint8_t *b = rgba + (size_t(y0) * w + x1) * 4;
+    const uint8_t *c = rgba + (size_t(y1) * w + x0) * 4;
+    const uint8_t *d = rgba + (size_t(y1) * w + x1) * 4;
+    for (int ch = 0; ch < 4; ++ch) {
+      float top = float(a[ch]) + (float(b[ch]) - float(a[ch])) * tx;
+      float bottom = float(c[ch]) + (float(d[ch]) - float(c[ch])) * tx;
+      out[ch] = top + (bottom - top) * ty;
+    }
+  }
+};
+
+} // namespace Graphics
+} // namespace Mesozoic
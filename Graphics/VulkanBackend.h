@@ -1,4 +1,6 @@
 #pragma once
+#include "../Assets/BCnEncoder.h"
+#include "UI/UIBatcher.h"
 #include "UberMesh.h"
 #include "Window.h"
 #include <algorithm>
@@ -76,6 +78,14 @@ typedef uint32_t VkImageLayout;
 #define VK_FORMAT_UNDEFINED 0
 #define VK_FORMAT_R8G8B8A8_UNORM 44
 #define VK_FORMAT_R32_SFLOAT 100
+#define VK_FORMAT_R8G8B8A8_SRGB 43
+#define VK_FORMAT_BC1_RGBA_UNORM_BLOCK 133
+#define VK_FORMAT_BC1_RGBA_SRGB_BLOCK 134
+#define VK_FORMAT_BC3_UNORM_BLOCK 137
+#define VK_FORMAT_BC3_SRGB_BLOCK 138
+#define VK_FORMAT_BC5_UNORM_BLOCK 141
+#define VK_FORMAT_BC7_UNORM_BLOCK 145
+#define VK_FORMAT_BC7_SRGB_BLOCK 146
 #endif
 
 namespace Mesozoic {
@@ -158,6 +168,9 @@ struct GPUTexture {
   uint32_t width = 0;
   uint32_t height = 0;
   VkFormat format = VK_FORMAT_UNDEFINED;
+  // Written once by BindTexture, so UI batches never rewrite a bound set;
+  // DestroyTexture returns it to the UI pool
+  VkDescriptorSet uiSet = VK_NULL_HANDLE;
   bool IsValid() const { return image != VK_NULL_HANDLE; }
 };
 
@@ -212,18 +225,24 @@ public:
   VkSurfaceKHR surface = VK_NULL_HANDLE;
   VkQueue graphicsQueue = VK_NULL_HANDLE;
   VkQueue presentQueue = VK_NULL_HANDLE;
+  bool textureCompressionBC = false; // Enabled when the device supports it
+
+  static constexpr int MAX_FRAMES_IN_FLIGHT = 3;
 
   VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
   VkPipeline graphicsPipeline = VK_NULL_HANDLE;
   VkPipeline uiPipeline = VK_NULL_HANDLE;
   VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
   VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
-  VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
-  VkDescriptorSet uiDescriptorSet = VK_NULL_HANDLE;
+  // One terrain set per frame in flight, so per-frame buffers (grass tiles)
+  // can be rebound without touching a set the GPU is still reading
+  std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> descriptorSets{};
+  // UI textures each get their own set from this pool (see BindTexture)
+  static constexpr uint32_t MAX_UI_TEXTURES = 64;
+  VkDescriptorPool uiDescriptorPool = VK_NULL_HANDLE;
 
   SwapchainData swapchain;
   std::vector<RenderPassData> renderPasses;
-  static constexpr int MAX_FRAMES_IN_FLIGHT = 3;
   std::array<FrameData, MAX_FRAMES_IN_FLIGHT> frames;
   std::vector<VkFence> imagesInFlight; // Tracks if a swapchain image is in use
   std::vector<VkSemaphore> renderFinishedSemaphores; // One per swapchain image
@@ -256,8 +275,16 @@ public:
     morphBinding.pImmutableSamplers = nullptr;
     morphBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-    std::array<VkDescriptorSetLayoutBinding, 3> bindings = {
-        heightMapBinding, splatMapBinding, morphBinding};
+    // Grass Tile Buffer (SSBO, visible tiles rebuilt by GrassSystem each frame)
+    VkDescriptorSetLayoutBinding grassBinding{};
+    grassBinding.binding = 3;
+    grassBinding.descriptorCount = 1;
+    grassBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    grassBinding.pImmutableSamplers = nullptr;
+    grassBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings = {
+        heightMapBinding, splatMapBinding, morphBinding, grassBinding};
 
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -293,9 +320,16 @@ public:
       return false;
     }
 
-    // Allocate UI Descriptor Set (Reusing the same layout for simplicity)
-    if (vkAllocateDescriptorSets(device, &allocInfo, &uiDescriptorSet) !=
-        VK_SUCCESS) {
+    // UI sets reuse the terrain layout; only binding 1 is written
+    VkDescriptorPoolSize uiPoolSize{};
+    uiPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    uiPoolSize.descriptorCount = MAX_UI_TEXTURES;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &uiPoolSize;
+    poolInfo.maxSets = MAX_UI_TEXTURES;
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr,
+                               &uiDescriptorPool) != VK_SUCCESS) {
       return false;
     }
 
@@ -307,13 +341,15 @@ public:
 
   bool CreateDescriptorSets() {
 #if VULKAN_SDK_AVAILABLE
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+    layouts.fill(descriptorSetLayout);
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = descriptorPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &descriptorSetLayout;
+    allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    allocInfo.pSetLayouts = layouts.data();
 
-    if (vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) !=
+    if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) !=
         VK_SUCCESS) {
       return false;
     }
@@ -349,38 +385,64 @@ public:
       // We will assume caller handles this or we crash/validate later.
     }
 
-    std::vector<VkWriteDescriptorSet> descriptorWrites;
-    descriptorWrites.resize(3);
-
-    descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrites[0].dstSet = descriptorSet;
-    descriptorWrites[0].dstBinding = 0;
-    descriptorWrites[0].dstArrayElement = 0;
-    descriptorWrites[0].descriptorType =
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrites[0].descriptorCount = 1;
-    descriptorWrites[0].pImageInfo = &heightInfo;
-
-    descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrites[1].dstSet = descriptorSet;
-    descriptorWrites[1].dstBinding = 1;
-    descriptorWrites[1].dstArrayElement = 0;
-    descriptorWrites[1].descriptorType =
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrites[1].descriptorCount = 1;
-    descriptorWrites[1].pImageInfo = &splatInfo;
-
-    descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrites[2].dstSet = descriptorSet;
-    descriptorWrites[2].dstBinding = 2;
-    descriptorWrites[2].dstArrayElement = 0;
-    descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    descriptorWrites[2].descriptorCount = 1;
-    descriptorWrites[2].pBufferInfo = &bufferInfo;
-
-    vkUpdateDescriptorSets(device,
-                           static_cast<uint32_t>(descriptorWrites.size()),
-                           descriptorWrites.data(), 0, nullptr);
+    for (VkDescriptorSet set : descriptorSets) {
+      std::vector<VkWriteDescriptorSet> descriptorWrites;
+      descriptorWrites.resize(3);
+
+      descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descriptorWrites[0].dstSet = set;
+      descriptorWrites[0].dstBinding = 0;
+      descriptorWrites[0].dstArrayElement = 0;
+      descriptorWrites[0].descriptorType =
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+      descriptorWrites[0].descriptorCount = 1;
+      descriptorWrites[0].pImageInfo = &heightInfo;
+
+      descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descriptorWrites[1].dstSet = set;
+      descriptorWrites[1].dstBinding = 1;
+      descriptorWrites[1].dstArrayElement = 0;
+      descriptorWrites[1].descriptorType =
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+      descriptorWrites[1].descriptorCount = 1;
+      descriptorWrites[1].pImageInfo = &splatInfo;
+
+      descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descriptorWrites[2].dstSet = set;
+      descriptorWrites[2].dstBinding = 2;
+      descriptorWrites[2].dstArrayElement = 0;
+      descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      descriptorWrites[2].descriptorCount = 1;
+      descriptorWrites[2].pBufferInfo = &bufferInfo;
+
+      vkUpdateDescriptorSets(device,
+                             static_cast<uint32_t>(descriptorWrites.size()),
+                             descriptorWrites.data(), 0, nullptr);
+    }
+#endif
+  }
+
+  // Points frame `frame`'s terrain set at that frame's grass tile buffer
+  void UpdateGrassDescriptor(uint32_t frame, GPUBuffer &tileBuffer) {
+#if VULKAN_SDK_AVAILABLE
+    if (!tileBuffer.IsValid())
+      return;
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = tileBuffer.buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = tileBuffer.size;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = descriptorSets[frame];
+    descriptorWrite.dstBinding = 3;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
 #endif
   }
 
@@ -436,37 +498,55 @@ public:
 
   void BindTerrainTextures() {
 #if VULKAN_SDK_AVAILABLE
-    if (descriptorSet != VK_NULL_HANDLE) {
+    if (descriptorSets[currentFrame] != VK_NULL_HANDLE) {
       vkCmdBindDescriptorSets(frames[currentFrame].commandBuffer,
                               VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
-                              0, 1, &descriptorSet, 0, nullptr);
+                              0, 1, &descriptorSets[currentFrame], 0, nullptr);
     }
 #endif
   }
 
+  // Updating a set that a recorded or in-flight command buffer uses is
+  // invalid, so each texture's set is written on first use and only bound
+  // afterwards
   void BindTexture(GPUTexture &texture, VkCommandBuffer cmd) {
 #if VULKAN_SDK_AVAILABLE
     if (!texture.IsValid())
       return;
 
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = texture.view;
-    imageInfo.sampler = texture.sampler;
-
-    VkWriteDescriptorSet descriptorWrite{};
-    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrite.dstSet = uiDescriptorSet; // Update UI specific set
-    descriptorWrite.dstBinding = 1;           // UI Shader uses Binding 1
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.pImageInfo = &imageInfo;
+    if (texture.uiSet == VK_NULL_HANDLE) {
+      VkDescriptorSetAllocateInfo allocInfo{};
+      allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+      allocInfo.descriptorPool = uiDescriptorPool;
+      allocInfo.descriptorSetCount = 1;
+      allocInfo.pSetLayouts = &descriptorSetLayout;
+      if (vkAllocateDescriptorSets(device, &allocInfo, &texture.uiSet) !=
+          VK_SUCCESS) {
+        std::cerr << "[Vulkan] Out of UI texture sets (max "
+                  << MAX_UI_TEXTURES << ")" << std::endl;
+        texture.uiSet = VK_NULL_HANDLE;
+        return;
+      }
 
-    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+      VkDescriptorImageInfo imageInfo{};
+      imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+      imageInfo.imageView = texture.view;
+      imageInfo.sampler = texture.sampler;
+
+      VkWriteDescriptorSet descriptorWrite{};
+      descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descriptorWrite.dstSet = texture.uiSet;
+      descriptorWrite.dstBinding = 1; // UI Shader uses Binding 1
+      descriptorWrite.dstArrayElement = 0;
+      descriptorWrite.descriptorType =
+          VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+      descriptorWrite.descriptorCount = 1;
+      descriptorWrite.pImageInfo = &imageInfo;
+      vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+    }
 
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            pipelineLayout, 0, 1, &uiDescriptorSet, 0, nullptr);
+                            pipelineLayout, 0, 1, &texture.uiSet, 0, nullptr);
 #endif
   }
 
@@ -477,6 +557,19 @@ public:
 #endif
   }
 
+  // Blocks until every submitted frame has finished on the GPU. Call it
+  // outside BeginFrame/EndFrame: BeginFrame resets the current fence, which
+  // would then never signal.
+  void WaitForFramesInFlight() {
+#if VULKAN_SDK_AVAILABLE
+    std::array<VkFence, MAX_FRAMES_IN_FLIGHT> fences;
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+      fences[i] = frames[i].inFlight;
+    vkWaitForFences(device, MAX_FRAMES_IN_FLIGHT, fences.data(), VK_TRUE,
+                    UINT64_MAX);
+#endif
+  }
+
   bool BeginFrame(uint32_t &imageIndex) {
     if (!initialized)
       return false;
@@ -593,6 +686,10 @@ public:
       vkDestroyPipeline(device, uiPipeline, nullptr);
     if (pipelineLayout)
       vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    if (uiDescriptorPool)
+      vkDestroyDescriptorPool(device, uiDescriptorPool, nullptr);
+    if (descriptorPool)
+      vkDestroyDescriptorPool(device, descriptorPool, nullptr);
 
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
       if (frames[i].imageAvailable)
@@ -707,6 +804,25 @@ public:
     buf.mapped = nullptr;
   }
 
+  // The GPU must be done with the texture (WaitForFramesInFlight). Its UI
+  // set goes back to the pool, so MAX_UI_TEXTURES bounds live textures
+  // rather than every texture ever bound.
+  void DestroyTexture(GPUTexture &texture) {
+#if VULKAN_SDK_AVAILABLE
+    if (texture.uiSet)
+      vkFreeDescriptorSets(device, uiDescriptorPool, 1, &texture.uiSet);
+    if (texture.sampler)
+      vkDestroySampler(device, texture.sampler, nullptr);
+    if (texture.view)
+      vkDestroyImageView(device, texture.view, nullptr);
+    if (texture.image)
+      vkDestroyImage(device, texture.image, nullptr);
+    if (texture.memory)
+      vkFreeMemory(device, texture.memory, nullptr);
+#endif
+    texture = GPUTexture{};
+  }
+
   void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
 #if VULKAN_SDK_AVAILABLE
     VkCommandBufferAllocateInfo allocInfo{};
@@ -742,8 +858,55 @@ public:
   }
 
   // --- TEXTURE HELPERS ---
+  static VkFormat ToVkFormat(const Assets::TextureData &tex) {
+    using Assets::PixelFormat;
+    switch (tex.format) {
+    case PixelFormat::BC1:
+      return tex.srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+                      : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case PixelFormat::BC3:
+      return tex.srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+    case PixelFormat::BC5:
+      return VK_FORMAT_BC5_UNORM_BLOCK;
+    case PixelFormat::BC7:
+      return tex.srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    case PixelFormat::R32F:
+      return VK_FORMAT_R32_SFLOAT;
+    default:
+      return tex.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+  }
+
+  // Uploads a whole mip chain. Block-compressed data is expanded to RGBA8
+  // first if the device lacks textureCompressionBC.
+  GPUTexture CreateTexture(const Assets::TextureData &source) {
+    const Assets::TextureData *tex = &source;
+    Assets::TextureData expanded;
+    if (source.IsBlockCompressed() && !textureCompressionBC) {
+      expanded = source;
+      if (!Assets::BCnEncoder::Decompress(expanded)) {
+        std::cerr << "[VulkanBackend] Cannot expand " << source.name
+                  << std::endl;
+        return {};
+      }
+      tex = &expanded;
+    }
+    std::vector<size_t> offsets;
+    for (const auto &mip : tex->mips)
+      offsets.push_back(mip.offset);
+    uint32_t levels = offsets.empty() ? 1 : tex->mipLevels;
+    return CreateTextureFromBuffer(
+        const_cast<uint8_t *>(tex->pixels.data()), tex->pixels.size(),
+        tex->width, tex->height, ToVkFormat(*tex), levels,
+        offsets.empty() ? nullptr : offsets.data());
+  }
+
+  // `data` may hold a whole mip chain (largest level first); `mipOffsets`
+  // gives each level's byte offset so every level comes from one staging copy
   GPUTexture CreateTextureFromBuffer(void *data, size_t size, uint32_t width,
-                                     uint32_t height, VkFormat format) {
+                                     uint32_t height, VkFormat format,
+                                     uint32_t mipLevels = 1,
+                                     const size_t *mipOffsets = nullptr) {
     GPUTexture tex;
 #if VULKAN_SDK_AVAILABLE
     tex.width = width;
@@ -766,7 +929,7 @@ public:
     imageInfo.extent.width = width;
     imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
     imageInfo.format = format;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -800,11 +963,12 @@ public:
 
     // 3. Transition & Copy (using helpers)
     TransitionImageLayout(tex.image, format, VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    CopyBufferToImage(staging.buffer, tex.image, width, height);
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+    CopyBufferToImage(staging.buffer, tex.image, width, height, mipLevels,
+                      mipOffsets);
     TransitionImageLayout(tex.image, format,
                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
 
     DestroyBuffer(staging);
 
@@ -816,7 +980,7 @@ public:
     viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
@@ -841,6 +1005,8 @@ public:
     samplerInfo.compareEnable = VK_FALSE;
     samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(mipLevels);
 
     if (vkCreateSampler(device, &samplerInfo, nullptr, &tex.sampler) !=
         VK_SUCCESS) {
@@ -891,7 +1057,8 @@ private:
   }
 
   void TransitionImageLayout(VkImage image, VkFormat format,
-                             VkImageLayout oldLayout, VkImageLayout newLayout) {
+                             VkImageLayout oldLayout, VkImageLayout newLayout,
+                             uint32_t levelCount = 1) {
 #if VULKAN_SDK_AVAILABLE
     VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
 
@@ -904,7 +1071,7 @@ private:
     barrier.image = image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = levelCount;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
@@ -938,23 +1105,32 @@ private:
   }
 
   void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width,
-                         uint32_t height) {
+                         uint32_t height, uint32_t mipLevels = 1,
+                         const size_t *mipOffsets = nullptr) {
 #if VULKAN_SDK_AVAILABLE
     VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
 
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
+    // One region per mip level, all sourced from the same staging buffer
+    std::vector<VkBufferImageCopy> regions(mipLevels);
+    for (uint32_t level = 0; level < mipLevels; ++level) {
+      VkBufferImageCopy &region = regions[level];
+      region = {};
+      region.bufferOffset = mipOffsets ? mipOffsets[level] : 0;
+      region.bufferRowLength = 0;
+      region.bufferImageHeight = 0;
+      region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      region.imageSubresource.mipLevel = level;
+      region.imageSubresource.baseArrayLayer = 0;
+      region.imageSubresource.layerCount = 1;
+      region.imageOffset = {0, 0, 0};
+      region.imageExtent = {std::max(1u, width >> level),
+                            std::max(1u, height >> level), 1};
+    }
 
     vkCmdCopyBufferToImage(commandBuffer, buffer, image,
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()),
+                           regions.data());
 
     EndSingleTimeCommands(commandBuffer);
 #endif
@@ -1009,6 +1185,41 @@ public:
 #endif
   }
 
+  // Copies `width` x `height` tightly packed texels into mip 0 at (x, y),
+  // e.g. one virtual texture page into its atlas slot
+  void UpdateTextureRegion(GPUTexture &texture, const void *data,
+                           uint32_t x, uint32_t y, uint32_t width,
+                           uint32_t height, size_t texelBytes = 4) {
+#if VULKAN_SDK_AVAILABLE
+    if (!texture.IsValid())
+      return;
+    size_t size = size_t(width) * height * texelBytes;
+    GPUBuffer staging = CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (!staging.mapped)
+      return;
+    memcpy(staging.mapped, data, size); // CreateBuffer maps host memory
+
+    TransitionImageLayout(texture.image, texture.format,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {int32_t(x), int32_t(y), 0};
+    region.imageExtent = {width, height, 1};
+    vkCmdCopyBufferToImage(commandBuffer, staging.buffer, texture.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    EndSingleTimeCommands(commandBuffer);
+    TransitionImageLayout(texture.image, texture.format,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    DestroyBuffer(staging);
+#endif
+  }
+
   // NEW: Update Buffer Data (for Dynamic Meshes)
   void UpdateBuffer(GPUBuffer &dstBuffer, const void *data, size_t size) {
 #if VULKAN_SDK_AVAILABLE
@@ -1100,6 +1311,14 @@ public:
     dci.enabledExtensionCount = 1;
     dci.ppEnabledExtensionNames = &ext;
 
+    // BCn textures from the cooker; without it they are expanded on upload
+    VkPhysicalDeviceFeatures supported{};
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supported);
+    VkPhysicalDeviceFeatures enabled{};
+    enabled.textureCompressionBC = supported.textureCompressionBC;
+    textureCompressionBC = supported.textureCompressionBC == VK_TRUE;
+    dci.pEnabledFeatures = &enabled;
+
     if (vkCreateDevice(physicalDevice, &dci, nullptr, &device) != VK_SUCCESS)
       return false;
     vkGetDeviceQueue(device, 0, 0, &graphicsQueue);
@@ -1672,8 +1891,18 @@ public:
       VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo,
                                                         fragShaderStageInfo};
 
-      auto bindingDescription = Vertex::getBindingDescription();
-      auto attributeDescriptions = Vertex::getAttributeDescriptions();
+      // UIVertex: pixel position, UV, RGBA8 colour
+      VkVertexInputBindingDescription bindingDescription{};
+      bindingDescription.binding = 0;
+      bindingDescription.stride = sizeof(UIVertex);
+      bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+      std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+      attributeDescriptions[0] = {0, 0, VK_FORMAT_R32G32_SFLOAT,
+                                  offsetof(UIVertex, x)};
+      attributeDescriptions[1] = {1, 0, VK_FORMAT_R32G32_SFLOAT,
+                                  offsetof(UIVertex, u)};
+      attributeDescriptions[2] = {2, 0, VK_FORMAT_R8G8B8A8_UNORM,
+                                  offsetof(UIVertex, color)};
 
       VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
       vertexInputInfo.sType =
@@ -0,0 +1,1160 @@
+#include "../Assets/AnimationCompression.h"
+#include "../Assets/AnimationLoader.h"
+#include "../Assets/BCnEncoder.h"
+#include "../Assets/GLBLoader.h"
+#include "../Assets/PNGWriter.h"
+#include "../Assets/TextureLoader.h"
+#include "../Core/Profiling/Profiler.h"
+#include "../Gameplay/Crowd.h"
+#include "../Gameplay/Panic.h"
+#include "../Gameplay/Sightings.h"
+#include "../Gameplay/VisitorAI.h"
+#include "../Graphics/MorphCache.h"
+#include "../Graphics/MorphingSystem.h"
+#include "../Graphics/UI/PerfHUD.h"
+#include "../Graphics/UI/UIBatcher.h"
+#include "../Graphics/UI/UIFont.h"
+#include "../Graphics/VirtualTexture.h"
+#include "../Graphics/VulkanBackend.h"
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Mesozoic::Math;
+
+// =========================================================================
+// Helpers
+// =========================================================================
+using BenchClock = std::chrono::high_resolution_clock;
+
+template <typename Fn> double MeasureMs(Fn &&fn) {
+  auto start = BenchClock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(BenchClock::now() - start)
+      .count();
+}
+
+// Keeps the optimizer from discarding sampled results
+static volatile float g_sink = 0.0f;
+
+// =========================================================================
+// Bench 1: Animation Compression
+// =========================================================================
+void BenchAnimationCompression() {
+  std::cout << "[Bench] AnimationCompression..." << std::endl;
+  using namespace Mesozoic::Assets;
+
+  Skeleton skel = AnimationLoader::CreateDinosaurSkeleton();
+  std::vector<AnimationClip> clips = {
+      AnimationLoader::Resample(AnimationLoader::CreateWalkCycle(skel, 1.0f),
+                                30.0f),
+      AnimationLoader::Resample(AnimationLoader::CreateIdleAnim(skel, 3.0f),
+                                30.0f)};
+
+  size_t rawBytes = 0, packedBytes = 0;
+  std::vector<CompressedClip> packed;
+  for (const auto &clip : clips) {
+    packed.push_back(AnimationCompressor::Compress(clip));
+    rawBytes += AnimationCompressor::RawSizeBytes(clip);
+    packedBytes += packed.back().SizeBytes();
+  }
+
+  // Sample 1000 desynchronized instances for 60 frames
+  const int instances = 1000;
+  const int frames = 60;
+  const float dt = 1.0f / 60.0f;
+  const AnimationClip &raw = clips[0];
+  const CompressedClip &comp = packed[0];
+  std::vector<BoneKeyframe> pose(raw.tracks.size());
+  std::vector<AnimationCursor> rawCursors(instances), compCursors(instances);
+
+  double rawMs = MeasureMs([&] {
+    for (int f = 0; f < frames; ++f) {
+      for (int i = 0; i < instances; ++i) {
+        raw.SampleAll(f * dt + i * 0.013f, pose.data(), &rawCursors[i]);
+        g_sink = g_sink + pose[0].translation.y;
+      }
+    }
+  });
+  double compMs = MeasureMs([&] {
+    for (int f = 0; f < frames; ++f) {
+      for (int i = 0; i < instances; ++i) {
+        comp.SampleAll(f * dt + i * 0.013f, pose.data(), &compCursors[i]);
+        g_sink = g_sink + pose[0].translation.y;
+      }
+    }
+  });
+
+  double samples = double(instances) * frames * raw.tracks.size();
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  Size: " << rawBytes << " -> " << packedBytes << " bytes ("
+            << double(rawBytes) / packedBytes << "x)" << std::endl;
+  std::cout << "  Raw sampling:        " << rawMs << " ms ("
+            << samples / rawMs / 1000.0 << " M bones/s)" << std::endl;
+  std::cout << "  Compressed sampling: " << compMs << " ms ("
+            << samples / compMs / 1000.0 << " M bones/s)" << std::endl;
+}
+
+// =========================================================================
+// Bench 2: Sparse Morph Kernel
+// =========================================================================
+void BenchMorphKernel() {
+  std::cout << "[Bench] MorphKernel..." << std::endl;
+  using namespace Mesozoic::Graphics;
+
+  // 20k vertex body: 2 whole-body targets + 7 localised ones (~5% each)
+  const int vertCount = 20000;
+  const int targetCount = 9;
+  UberMesh mesh;
+  mesh.baseVertices.resize(vertCount);
+  for (int v = 0; v < vertCount; ++v) {
+    mesh.baseVertices[v].position = {std::sin(v * 0.01f), v * 0.001f, 0.0f};
+    mesh.baseVertices[v].normal = {0.0f, 1.0f, 0.0f};
+  }
+  std::vector<std::vector<MorphDelta>> dense(targetCount);
+  for (int t = 0; t < targetCount; ++t) {
+    dense[t].assign(vertCount, MorphDelta{{0, 0, 0}, {0, 0, 0}});
+    int begin = t < 2 ? 0 : (t * 2111) % (vertCount - 1000);
+    int end = t < 2 ? vertCount : begin + 1000;
+    for (int v = begin; v < end; ++v)
+      dense[t][v] = {{0.01f * t, 0.02f, 0.0f}, {0.0f, 0.0f, 0.01f}};
+    mesh.AddMorphTarget("t" + std::to_string(t), dense[t]);
+  }
+  std::vector<float> weights = {0.2f, 1.0f, 1.5f, 0.2f, 1.0f,
+                                1.5f, 0.2f, 1.0f, 1.5f};
+
+  size_t denseBytes = size_t(vertCount) * targetCount * sizeof(MorphDelta);
+  size_t sparseBytes = 0;
+  for (const auto &t : mesh.morphTargets) {
+    sparseBytes += t.indices.size() * sizeof(uint32_t) +
+                   (t.positionDeltas.size() + t.normalDeltas.size()) *
+                       sizeof(float);
+  }
+
+  const int iterations = 200;
+  std::vector<Vertex> out(vertCount);
+
+  // Reference: dense vertex-major loop with a weight branch per target
+  double denseMs = MeasureMs([&] {
+    for (int it = 0; it < iterations; ++it) {
+      for (int v = 0; v < vertCount; ++v) {
+        Vertex vert = mesh.baseVertices[v];
+        for (int t = 0; t < targetCount; ++t) {
+          float w = weights[t];
+          if (std::abs(w) < 0.001f)
+            continue;
+          const MorphDelta &d = dense[t][v];
+          for (int k = 0; k < 3; ++k) {
+            vert.position[k] += d.positionDelta[k] * w;
+            vert.normal[k] += d.normalDelta[k] * w;
+          }
+        }
+        out[v] = vert;
+      }
+      g_sink = g_sink + out[it % vertCount].position[1];
+    }
+  });
+
+  MorphingSystem::MorphScratch scratch;
+  double sparseMs = MeasureMs([&] {
+    for (int it = 0; it < iterations; ++it) {
+      MorphingSystem::ApplyMorphs(mesh, weights, out, scratch);
+      g_sink = g_sink + out[it % vertCount].position[1];
+    }
+  });
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  Delta memory: " << denseBytes << " -> " << sparseBytes
+            << " bytes (" << double(denseBytes) / sparseBytes << "x)"
+            << std::endl;
+  std::cout << "  Dense vertex-major: " << denseMs / iterations
+            << " ms/mesh" << std::endl;
+  std::cout << "  Sparse target-major (SIMD=" << MESOZOIC_SSE
+            << "): " << sparseMs / iterations << " ms/mesh" << std::endl;
+}
+
+// =========================================================================
+// Bench 3: Morph Cache (population vs distinct phenotypes)
+// =========================================================================
+void BenchMorphCache() {
+  std::cout << "[Bench] MorphCache..." << std::endl;
+  using namespace Mesozoic::Graphics;
+
+  // Three DNA-driven targets: at most 3^3 phenotypes
+  const int vertCount = 8000;
+  const int targetCount = 3;
+  UberMesh mesh;
+  mesh.baseVertices.resize(vertCount);
+  for (int t = 0; t < targetCount; ++t) {
+    std::vector<MorphDelta> dense(vertCount, MorphDelta{{0, 0, 0}, {0, 0, 0}});
+    for (int v = t * 2000; v < t * 2000 + 4000; ++v)
+      dense[v].positionDelta = {0.0f, 0.01f * (t + 1), 0.0f};
+    mesh.AddMorphTarget("t" + std::to_string(t), dense);
+  }
+
+  const int population = 2000;
+  std::mt19937 rng(42);
+  std::vector<std::vector<float>> weights;
+  for (int i = 0; i < population; ++i) {
+    Mesozoic::Genetics::Genome dna;
+    for (uint8_t l = 0; l < targetCount; ++l)
+      dna.SetLocus(l, rng() & 1, rng() & 1);
+    weights.push_back(MorphingSystem::DecodeDNA(dna, targetCount));
+  }
+
+  std::vector<Vertex> out;
+  MorphingSystem::MorphScratch scratch;
+  double directMs = MeasureMs([&] {
+    for (const auto &w : weights) {
+      MorphingSystem::ApplyMorphs(mesh, w, out, scratch);
+      g_sink = g_sink + out[0].position[1];
+    }
+  });
+
+  MorphCache cache(mesh, 32);
+  std::vector<MorphCache::Handle> handles(population);
+  double cachedMs = MeasureMs([&] {
+    for (int i = 0; i < population; ++i) {
+      handles[i] = cache.Acquire(weights[i]);
+      g_sink = g_sink + cache.Vertices(handles[i])[0].position[1];
+    }
+  });
+  for (auto h : handles)
+    cache.Release(h);
+
+  const auto &stats = cache.GetStats();
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  " << population << " entities, " << stats.misses
+            << " distinct phenotypes (hit rate " << stats.HitRate() * 100.0f
+            << "%)" << std::endl;
+  std::cout << "  Per-entity morph: " << directMs << " ms" << std::endl;
+  std::cout << "  Cached morph:     " << cachedMs << " ms ("
+            << cache.ResidentBytes() / 1024 << " KB resident)" << std::endl;
+}
+
+// =========================================================================
+// Bench 4: GLB Loading
+// =========================================================================
+void BenchGLBLoad() {
+  std::cout << "[Bench] GLBLoad..." << std::endl;
+  using namespace Mesozoic::Assets;
+
+  // One dense 512x512 terrain-like grid plus 2000 small props, so both the
+  // BIN decode and the JSON chunk (~8000 accessors) are non-trivial
+  GLTFMesh model;
+  model.name = "BenchModel";
+  GLTFPrimitive grid;
+  const uint32_t res = 512;
+  for (uint32_t z = 0; z < res; ++z) {
+    for (uint32_t x = 0; x < res; ++x) {
+      GLTFVertex v;
+      v.position = Vec3(float(x), std::sin(x * 0.1f) * std::cos(z * 0.1f),
+                        float(z));
+      v.normal = Vec3(0, 1, 0);
+      v.uv[0] = float(x) / res;
+      v.uv[1] = float(z) / res;
+      grid.vertices.push_back(v);
+    }
+  }
+  for (uint32_t z = 0; z + 1 < res; ++z) {
+    for (uint32_t x = 0; x + 1 < res; ++x) {
+      uint32_t a = z * res + x;
+      grid.indices.insert(grid.indices.end(),
+                          {a, a + res, a + 1, a + 1, a + res, a + res + 1});
+    }
+  }
+  model.primitives.push_back(std::move(grid));
+  GLTFPrimitive prop = GLTFLoader::CreateDinosaurPlaceholder().primitives[0];
+  for (int i = 0; i < 2000; ++i)
+    model.primitives.push_back(prop);
+
+  const std::string path = "mesozoic_bench_model.glb";
+  std::vector<uint8_t> glb = GLBLoader::Write(model);
+  GLBLoader::WriteFile(path, glb);
+
+  GLBAsset probe;
+  probe.OpenMemory(glb.data(), glb.size());
+  std::string json(probe.Json().text);
+
+  // SAX: count every number without building anything
+  struct NumberCounter : JsonSaxHandler {
+    size_t numbers = 0;
+    bool Number(std::string_view) { return ++numbers, true; }
+  };
+  const int iterations = 5;
+  JsonReader reader;
+  NumberCounter counter;
+  double saxMs = MeasureMs([&] {
+    for (int i = 0; i < iterations; ++i) {
+      reader.Read(json, counter);
+      g_sink = g_sink + static_cast<float>(counter.numbers);
+    }
+  });
+  JsonDocument doc;
+  double domMs = MeasureMs([&] {
+    for (int i = 0; i < iterations; ++i) {
+      doc.Parse(json);
+      g_sink = g_sink + static_cast<float>(doc.Root()["accessors"].Size());
+    }
+  });
+
+  size_t vertices = 0;
+  double loadMs = MeasureMs([&] {
+    for (int i = 0; i < iterations; ++i) {
+      GLBAsset asset;
+      asset.Open(path);
+      GLTFScene scene = asset.ToScene();
+      vertices = 0;
+      for (const auto &p : scene.meshes[0].primitives)
+        vertices += p.vertices.size();
+    }
+  });
+  std::remove(path.c_str());
+
+  double mb = glb.size() / (1024.0 * 1024.0);
+  double jsonMb = json.size() / (1024.0 * 1024.0);
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  File: " << mb << " MB (JSON " << jsonMb << " MB), "
+            << vertices << " vertices" << std::endl;
+  std::cout << "  JSON SAX:        " << saxMs / iterations << " ms ("
+            << jsonMb * iterations / (saxMs / 1000.0) << " MB/s)" << std::endl;
+  std::cout << "  JSON DOM:        " << domMs / iterations << " ms ("
+            << jsonMb * iterations / (domMs / 1000.0) << " MB/s)" << std::endl;
+  std::cout << "  GLB map+decode:  " << loadMs / iterations << " ms ("
+            << mb * iterations / (loadMs / 1000.0) << " MB/s)" << std::endl;
+}
+
+// =========================================================================
+// Bench 5: Mip Chain Generation
+// =========================================================================
+void BenchMipmaps() {
+  std::cout << "[Bench] Mipmaps..." << std::endl;
+  using namespace Mesozoic::Assets;
+
+  const uint32_t size = 2048;
+  TextureData source = TextureLoader::CreateCheckerboard(size, size);
+  std::mt19937 rng(7);
+  for (auto &p : source.pixels)
+    p = static_cast<uint8_t>(p ^ (rng() & 15)); // Break up flat regions
+
+  Mesozoic::Core::Threading::JobSystem jobs;
+  auto run = [&](MipFilter filter, bool parallel) {
+    MipSettings settings;
+    settings.filter = filter;
+    settings.jobs = parallel ? &jobs : nullptr;
+    TextureData tex = source;
+    double ms = MeasureMs([&] {
+      TextureLoader::GenerateMipmaps(tex, settings);
+      g_sink = g_sink + tex.pixels.back();
+    });
+    return ms;
+  };
+
+  double boxMs = run(MipFilter::Box, false);
+  double boxParMs = run(MipFilter::Box, true);
+  double kaiserMs = run(MipFilter::Kaiser, false);
+  double kaiserParMs = run(MipFilter::Kaiser, true);
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  " << size << "x" << size << " sRGB RGBA8, full chain, "
+            << jobs.ThreadCount() << " workers" << std::endl;
+  std::cout << "  Box:    " << boxMs << " ms serial, " << boxParMs
+            << " ms tiled" << std::endl;
+  std::cout << "  Kaiser: " << kaiserMs << " ms serial, " << kaiserParMs
+            << " ms tiled" << std::endl;
+}
+
+// =========================================================================
+// Bench 6: PNG Decoding (throughput vs file size, batch loading)
+// =========================================================================
+void BenchPNGDecode() {
+  std::cout << "[Bench] PNGDecode..." << std::endl;
+  using namespace Mesozoic::Assets;
+
+  // Smooth gradients with a noisy band: every filter type gets used
+  auto makeImage = [](uint32_t size) {
+    std::vector<uint8_t> rgba(size_t(size) * size * 4);
+    std::mt19937 rng(size);
+    for (uint32_t y = 0; y < size; ++y) {
+      for (uint32_t x = 0; x < size; ++x) {
+        uint8_t *p = &rgba[(size_t(y) * size + x) * 4];
+        uint8_t noise = (y / 16) % 4 == 0 ? uint8_t(rng() & 31) : 0;
+        p[0] = static_cast<uint8_t>(x * 255 / size + noise);
+        p[1] = static_cast<uint8_t>(y * 255 / size);
+        p[2] = static_cast<uint8_t>((x + y) / 4 + noise);
+        p[3] = 255;
+      }
+    }
+    return rgba;
+  };
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  Single image, RGBA8, adaptive filters (SIMD="
+            << MESOZOIC_SSE << ")" << std::endl;
+  PNGDecoder decoder;
+  for (uint32_t size : {64u, 256u, 1024u, 2048u}) {
+    auto png = PNGWriter::Encode(makeImage(size).data(), size, size);
+    std::vector<uint8_t> dst(size_t(size) * size * 4);
+    const int iterations = size <= 256 ? 50 : 3;
+    double ms = MeasureMs([&] {
+                  for (int i = 0; i < iterations; ++i) {
+                    decoder.Decode(png.data(), png.size(), dst.data(),
+                                   size_t(size) * 4);
+                    g_sink = g_sink + dst[i % dst.size()];
+                  }
+                }) /
+                iterations;
+    std::cout << "  " << std::setw(4) << size << "^2 " << std::setw(8)
+              << png.size() / 1024.0 << " KB: " << ms << " ms, "
+              << png.size() / ms / 1000.0 << " MB/s in, "
+              << dst.size() / ms / 1000.0 << " MB/s out" << std::endl;
+  }
+
+  // Filter reconstruction alone: one 2048px Paeth row
+  std::vector<uint8_t> row(2048 * 4), prev(2048 * 4);
+  for (size_t i = 0; i < row.size(); ++i) {
+    row[i] = static_cast<uint8_t>(i * 7);
+    prev[i] = static_cast<uint8_t>(i * 3);
+  }
+  const int rows = 2000;
+  double simdMs = MeasureMs([&] {
+    for (int r = 0; r < rows; ++r)
+      PNGFilters::Unfilter(PNGFormat::Paeth, row.data(), prev.data(),
+                           row.size(), 4);
+    g_sink = g_sink + row[5];
+  });
+  double scalarMs = MeasureMs([&] {
+    for (int r = 0; r < rows; ++r)
+      PNGFilters::UnfilterScalar(PNGFormat::Paeth, row.data(), prev.data(),
+                                 row.size(), 4);
+    g_sink = g_sink + row[5];
+  });
+  std::cout << "  Paeth unfilter: " << scalarMs << " ms scalar, " << simdMs
+            << " ms SIMD (" << rows << " rows of 2048px)" << std::endl;
+
+  // Batch loading from disk
+  Mesozoic::Core::Threading::JobSystem jobs;
+  std::vector<std::string> paths;
+  auto image = makeImage(512);
+  for (int i = 0; i < 8; ++i) {
+    paths.push_back("mesozoic_bench_" + std::to_string(i) + ".png");
+    auto png = PNGWriter::Encode(image.data(), 512, 512);
+    std::ofstream(paths.back(), std::ios::binary)
+        .write(reinterpret_cast<const char *>(png.data()),
+               static_cast<std::streamsize>(png.size()));
+  }
+  double serialMs = MeasureMs([&] {
+    auto textures = PNGDecoder::LoadBatch(paths);
+    g_sink = g_sink + textures[0].pixels[0];
+  });
+  double batchMs = MeasureMs([&] {
+    auto textures = PNGDecoder::LoadBatch(paths, &jobs);
+    g_sink = g_sink + textures[0].pixels[0];
+  });
+  for (const auto &p : paths)
+    std::remove(p.c_str());
+  std::cout << "  Batch of 8 x 512^2: " << serialMs << " ms serial, "
+            << batchMs << " ms on " << jobs.ThreadCount() << " workers"
+            << std::endl;
+}
+
+// =========================================================================
+// Bench 7: BCn Encoding (formats, Fast vs Quality, tiled, quality loss)
+// =========================================================================
+void BenchBCnEncode() {
+  std::cout << "[Bench] BCnEncode..." << std::endl;
+  using namespace Mesozoic::Assets;
+
+  // Photo-like content: gradients, a noisy band and soft alpha
+  const uint32_t size = 512;
+  TextureData source;
+  source.width = source.height = size;
+  source.valid = true;
+  source.pixels.resize(size_t(size) * size * 4);
+  std::mt19937 rng(7);
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      uint8_t *p = &source.pixels[(size_t(y) * size + x) * 4];
+      uint8_t noise = (y / 32) % 3 == 0 ? uint8_t(rng() & 15) : 0;
+      p[0] = static_cast<uint8_t>(x * 255 / size + noise);
+      p[1] = static_cast<uint8_t>(y * 255 / size);
+      p[2] = static_cast<uint8_t>(128 + 100 * std::sin(x * 0.05f));
+      p[3] = static_cast<uint8_t>(255 - (x + y) * 64 / size);
+    }
+  }
+  TextureLoader::GenerateMipmaps(source);
+  const size_t texels = size_t(size) * size;
+
+  // Root-mean-square error of the top level against the source
+  auto rmse = [&](const TextureData &decoded, int channels) {
+    double sum = 0.0;
+    for (size_t i = 0; i < texels; ++i) {
+      for (int ch = 0; ch < channels; ++ch) {
+        double d = double(decoded.pixels[i * 4 + ch]) -
+                   double(source.pixels[i * 4 + ch]);
+        sum += d * d;
+      }
+    }
+    return std::sqrt(sum / double(texels * channels));
+  };
+
+  Mesozoic::Core::Threading::JobSystem jobs;
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  " << size << "^2 + mips, SIMD=" << MESOZOIC_SSE << ", "
+            << jobs.ThreadCount() << " workers" << std::endl;
+  struct Case {
+    const char *name;
+    PixelFormat format;
+    int channels;
+  };
+  for (const Case &c : {Case{"BC1", PixelFormat::BC1, 3},
+                        Case{"BC3", PixelFormat::BC3, 4},
+                        Case{"BC5", PixelFormat::BC5, 2},
+                        Case{"BC7", PixelFormat::BC7, 4}}) {
+    for (BCnQuality quality : {BCnQuality::Fast, BCnQuality::Quality}) {
+      BCnSettings settings{c.format, quality};
+      TextureData encoded;
+      double serialMs = MeasureMs([&] {
+        encoded = source;
+        BCnEncoder::Compress(encoded, settings);
+      });
+      settings.jobs = &jobs;
+      double tiledMs = MeasureMs([&] {
+        TextureData tiled = source;
+        BCnEncoder::Compress(tiled, settings);
+        g_sink = g_sink + tiled.pixels[0];
+      });
+      TextureData decoded = encoded;
+      BCnEncoder::Decompress(decoded);
+      std::cout << "  " << c.name
+                << (quality == BCnQuality::Fast ? " fast    " : " quality ")
+                << std::setw(8) << serialMs << " ms serial, " << std::setw(8)
+                << tiledMs << " ms tiled, "
+                << texels / serialMs / 1000.0 << " MTexel/s, "
+                << double(source.pixels.size()) / encoded.pixels.size()
+                << ":1, RMSE " << rmse(decoded, c.channels) << std::endl;
+    }
+  }
+}
+
+// =========================================================================
+// Bench 8: Virtual Texturing (feedback analysis, page table, compositing)
+// =========================================================================
+void BenchVirtualTexture() {
+  std::cout << "[Bench] VirtualTexture..." << std::endl;
+  using namespace Mesozoic::Graphics;
+
+  Mesozoic::Core::Threading::JobSystem jobs;
+  VirtualTexture::Settings settings; // 32768^2, 128 texel pages
+  VirtualTexture vt(jobs, settings, {});
+  const VirtualTextureLayout &layout = vt.Layout();
+
+  // 1/8-res feedback of a 1080p frame: a ground plane receding from the
+  // camera, so mip and page change with distance
+  const uint32_t fw = 240, fh = 135;
+  std::vector<VT::PageKey> feedback(fw * fh);
+  for (uint32_t y = 0; y < fh; ++y) {
+    float depth = 1.0f + 60.0f * float(fh - y) / float(fh);
+    uint32_t mip = std::min(layout.levels - 1, uint32_t(std::log2(depth)));
+    for (uint32_t x = 0; x < fw; ++x) {
+      float vx = 16384.0f + (float(x) - fw / 2.0f) * depth * 16.0f;
+      float vy = 8192.0f + depth * 180.0f;
+      uint32_t px = uint32_t(std::max(0.0f, vx)) / (128u << mip);
+      uint32_t py = uint32_t(std::max(0.0f, vy)) / (128u << mip);
+      feedback[y * fw + x] = VT::PackPage(
+          mip, std::min(px, layout.pagesX[mip] - 1),
+          std::min(py, layout.pagesY[mip] - 1));
+    }
+  }
+
+  std::cout << std::fixed << std::setprecision(3);
+  const int iterations = 200;
+  size_t unique = 0;
+  double analyzeMs = MeasureMs([&] {
+                       for (int i = 0; i < iterations; ++i)
+                         unique = vt.AnalyzeFeedback(feedback).size();
+                     }) /
+                     iterations;
+  std::cout << "  Feedback " << fw << "x" << fh << " -> " << unique
+            << " pages: " << analyzeMs << " ms" << std::endl;
+
+  PageTable table;
+  table.Reset(layout);
+  table.Map(layout.Top(), 0, 0);
+  double mapMs = MeasureMs([&] {
+    for (uint32_t i = 0; i < 256; ++i) {
+      VT::PageKey key = VT::PackPage(0, i, i);
+      table.Map(key, i % 16, i / 16);
+      table.Unmap(key);
+    }
+  });
+  double coarseMs = MeasureMs([&] {
+    table.Map(VT::PackPage(4, 3, 3), 1, 0);
+    table.Unmap(VT::PackPage(4, 3, 3));
+  });
+  std::cout << "  Page table: " << mapMs / 512.0 * 1000.0
+            << " us per level-0 map/unmap, " << coarseMs
+            << " ms for a level-4 page (16x16 level-0 pages)" << std::endl;
+
+  // Compositing from a 512^2 splat and three 256^2 material layers
+  std::vector<uint8_t> splat(512 * 512 * 4);
+  std::mt19937 rng(3);
+  for (size_t i = 0; i < splat.size(); ++i)
+    splat[i] = uint8_t(rng());
+  std::array<Mesozoic::Assets::TextureData, 3> materials;
+  TerrainPageCompositor compositor(layout);
+  compositor.splat = splat.data();
+  compositor.splatWidth = compositor.splatHeight = 512;
+  for (int i = 0; i < 3; ++i) {
+    materials[i] = Mesozoic::Assets::TextureLoader::CreateSolid(
+        256, 256, uint8_t(60 * i), 120, 80, 255);
+    Mesozoic::Assets::TextureLoader::GenerateMipmaps(materials[i]);
+    compositor.layers[i].texture = &materials[i];
+  }
+  std::vector<uint8_t> page(size_t(layout.SlotTexels()) *
+                            layout.SlotTexels() * 4);
+  const int pages = 64;
+  double compositeMs =
+      MeasureMs([&] {
+        for (int i = 0; i < pages; ++i)
+          compositor(VT::PackPage(uint32_t(i % 4), uint32_t(i), 7),
+                     page.data(), layout.SlotTexels() * 4);
+        g_sink = g_sink + page[77];
+      }) /
+      pages;
+  std::cout << "  Composite " << layout.SlotTexels() << "^2 page: "
+            << compositeMs << " ms per page per worker" << std::endl;
+}
+
+// =========================================================================
+// Bench 9: UI Batching (10k elements into one vertex stream)
+// =========================================================================
+void BenchUIBatching() {
+  std::cout << "[Bench] UIBatching..." << std::endl;
+  using namespace Mesozoic::Graphics;
+
+  // Stand-in for the mapped per-frame vertex buffer
+  const uint32_t elements = 10000;
+  std::vector<UIVertex> mapped(size_t(elements) * 4);
+  std::array<GPUTexture, 4> textures;
+  std::mt19937 rng(11);
+  struct Element {
+    float x, y, w, h;
+    uint32_t texture;
+    uint32_t color;
+  };
+  // Widgets on a grid; `textureMix` textures either interleaved randomly or
+  // in screen regions
+  auto makeElements = [&](uint32_t textureMix, bool regions) {
+    std::vector<Element> out(elements);
+    for (uint32_t i = 0; i < elements; ++i) {
+      float x = float(i % 100) * 19.0f, y = float(i / 100) * 10.0f;
+      uint32_t t = regions ? uint32_t(x / 1920.0f * textureMix)
+                           : uint32_t(rng() % textureMix);
+      out[i] = {x, y, 16.0f, 8.0f, t, PackUIColor(1, 1, 1, 1)};
+    }
+    return out;
+  };
+
+  std::cout << std::fixed << std::setprecision(3);
+  struct Case {
+    const char *name;
+    uint32_t textures;
+    bool regions;
+  };
+  for (const Case &c : {Case{"atlas only       ", 1, false},
+                        Case{"4 tex by region  ", 4, true},
+                        Case{"4 tex interleaved", 4, false}}) {
+    auto list = makeElements(c.textures, c.regions);
+    UIBatcher batcher;
+    const int iterations = 50;
+    double ms = MeasureMs([&] {
+                  for (int it = 0; it < iterations; ++it) {
+                    batcher.Begin(1920, 1080);
+                    for (const Element &e : list)
+                      batcher.AddQuad(e.x, e.y, e.w, e.h,
+                                      &textures[e.texture], e.color);
+                    batcher.Finish(mapped.data(), elements);
+                    g_sink = g_sink + uint32_t(mapped[5].x);
+                  }
+                }) /
+                iterations;
+    std::cout << "  " << c.name << ": " << ms << " ms build, "
+              << batcher.Batches().size() << " draws (was " << elements
+              << " draws + " << elements << " push constants)" << std::endl;
+  }
+}
+
+// =========================================================================
+// Bench 10: UI Text (cached runs vs per-frame layout)
+// =========================================================================
+void BenchUIText() {
+  std::cout << "[Bench] UIText..." << std::endl;
+  using namespace Mesozoic::Graphics;
+
+  UITextureAtlas atlas;
+  UIFont font;
+  font.Rasterize(atlas, 2);
+  GPUTexture atlasTexture;
+
+  // An overlay of 200 stat lines; 10 of them change every frame
+  std::vector<std::string> lines(200);
+  for (size_t i = 0; i < lines.size(); ++i)
+    lines[i] = "Dinosaur " + std::to_string(i) + "  hunger 0.42  fear 0.10";
+
+  // Text stage alone (what the cache saves), then the frame with batching
+  const int frames = 100;
+  enum class Mode { Layout, Keyed, Handle };
+  UIBatcher batcher;
+  UITextCache cache(&font);
+  std::vector<UITextCache::Handle> handles(lines.size());
+  UITextRun scratch;
+  std::vector<UIVertex> mapped;
+  std::string changing;
+  auto text = [&](int f, size_t i, Mode mode) -> const UITextRun & {
+    std::string_view line = lines[i];
+    if (i < 10) {
+      changing = "Frame " + std::to_string(f * 10 + i);
+      line = changing;
+    }
+    if (mode == Mode::Keyed)
+      return cache.Get(line);
+    if (mode == Mode::Handle)
+      return cache.Get(line, handles[i]);
+    font.Layout(line, scratch);
+    return scratch;
+  };
+  auto textOnly = [&](Mode mode) {
+    return MeasureMs([&] {
+             for (int f = 0; f < frames; ++f) {
+               cache.NextFrame();
+               for (size_t i = 0; i < lines.size(); ++i)
+                 g_sink = g_sink + uint32_t(text(f, i, mode).quads.size());
+             }
+           }) /
+           frames;
+  };
+  auto fullFrame = [&](Mode mode) {
+    return MeasureMs([&] {
+             for (int f = 0; f < frames; ++f) {
+               batcher.Begin(1920, 1080);
+               cache.NextFrame();
+               for (size_t i = 0; i < lines.size(); ++i) {
+                 float y = float(i % 100) * 10.0f;
+                 float x = float(i / 100) * 900.0f;
+                 for (const UIGlyphQuad &g : text(f, i, mode).quads)
+                   batcher.AddQuad(x + g.x, y + g.y, g.w, g.h, &atlasTexture,
+                                   ~0u, g.u0, g.v0, g.u1, g.v1);
+               }
+               batcher.Finish(mapped);
+               g_sink = g_sink + uint32_t(mapped.size());
+             }
+           }) /
+           frames;
+  };
+
+  double layoutMs = textOnly(Mode::Layout);
+  double keyedMs = textOnly(Mode::Keyed);
+  double handleMs = textOnly(Mode::Handle);
+  double frameLayoutMs = fullFrame(Mode::Layout);
+  double frameHandleMs = fullFrame(Mode::Handle);
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "  200 lines text stage: layout " << layoutMs
+            << " ms/frame, keyed lookup " << keyedMs << " ms/frame, handle "
+            << handleMs << " ms/frame (" << layoutMs / handleMs << "x)"
+            << std::endl;
+  std::cout << "  with batching, " << batcher.QuadCount()
+            << " glyphs: layout " << frameLayoutMs << " ms/frame, handle "
+            << frameHandleMs << " ms/frame, " << batcher.Batches().size()
+            << " draw" << std::endl;
+}
+
+// =========================================================================
+// Bench 11: Perf HUD (profiler recording + overlay build per frame)
+// =========================================================================
+void BenchPerfHUD() {
+  std::cout << "[Bench] PerfHUD..." << std::endl;
+  using namespace Mesozoic::Core::Profiling;
+  using namespace Mesozoic::Graphics;
+
+  // Roughly the game's channel set: 3 tick times, 8 workers, 7 gauges
+  Profiler profiler;
+  std::vector<uint32_t> times, gauges;
+  for (const char *n : {"Sim tick", "Streaming", "Render"})
+    times.push_back(profiler.Register(n, Profiler::Kind::Time));
+  for (int w = 0; w < 8; ++w)
+    gauges.push_back(profiler.Register("Job " + std::to_string(w),
+                                       Profiler::Kind::Percent, true));
+  for (int g = 0; g < 7; ++g)
+    gauges.push_back(profiler.Register("Gauge " + std::to_string(g),
+                                       Profiler::Kind::Count, true));
+
+  UITextureAtlas atlas;
+  UIFont font;
+  font.Rasterize(atlas, 2);
+  UITextCache text(&font);
+  GPUTexture atlasTexture;
+  UIBatcher batcher;
+  std::vector<UIVertex> mapped;
+  PerfHUD hud;
+  hud.visible = true;
+
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> ms(0.5f, 12.0f);
+  auto frame = [&] {
+    batcher.Begin(1920, 1080);
+    text.NextFrame();
+    for (uint32_t t : times)
+      profiler.Record(t, ms(rng));
+    for (uint32_t g : gauges)
+      profiler.Set(g, ms(rng) * 8.0f);
+    profiler.EndFrame();
+    hud.Draw(profiler, batcher, text, font, &atlasTexture,
+             atlas.Region(UITextureAtlas::WHITE));
+    batcher.Finish(mapped);
+    g_sink = g_sink + uint32_t(mapped.size());
+  };
+  for (uint32_t f = 0; f < Profiler::HISTORY; ++f)
+    frame(); // Fill the graphs
+
+  const int frames = 600;
+  double frameMs = MeasureMs([&] {
+                     for (int f = 0; f < frames; ++f)
+                       frame();
+                   }) /
+                   frames;
+
+  const int events = 1000000;
+  uint32_t channel = times[0];
+  double recordMs = MeasureMs([&] {
+    for (int i = 0; i < events; ++i) {
+      profiler.Record(channel, 1.0);
+      if ((i & 1023) == 1023)
+        profiler.EndFrame(); // Keep the ring drained
+    }
+  });
+
+  std::cout << std::fixed << std::setprecision(4);
+  std::cout << "  " << profiler.ChannelCount() << " channels, "
+            << hud.QuadsLastDraw() << " quads: " << frameMs
+            << " ms per frame (budget 0.1 ms)" << std::endl;
+  std::cout << std::setprecision(1) << "  Record: "
+            << recordMs * 1e6 / events << " ns per event" << std::endl;
+}
+
+// =========================================================================
+// Bench 12: Visitor Tick (100k visitors, SoA + SSE2 vs AoS)
+// =========================================================================
+void BenchVisitorTick() {
+  std::cout << "[Bench] VisitorTick..." << std::endl;
+  using namespace Mesozoic::Gameplay;
+  const uint32_t count = 100000;
+
+  VisitorAI ai;
+  ai.Reserve(count + 16);
+  for (uint32_t i = 0; i < count; ++i)
+    ai.SpawnVisitor(Vec3(0, 0, -200));
+  for (uint32_t i = 0; i < count; i += 7)
+    ai.OnDinosaurSeen(i, i % 12);
+
+  // The previous AoS layout: one struct per visitor with a heap vector of
+  // seen species, scalar branches and a remove_if compaction
+  struct AoSVisitor {
+    Vec3 position, target;
+    float speed = 1.5f, hunger = 0.8f, thirst = 0.8f, energy = 1.0f;
+    float excitement = 0.5f, comfort = 0.7f, fear = 0.0f;
+    VisitorMood mood = VisitorMood::Neutral;
+    VisitorAction action = VisitorAction::Exploring;
+    float satisfaction = 0.5f, moneySpent = 0.0f, budget = 200.0f;
+    float timeInPark = 0.0f, maxStayTime = 7200.0f;
+    std::vector<uint32_t> speciesSeen;
+  };
+  std::vector<AoSVisitor> aos(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    aos[i].position = aos[i].target = Vec3(0, 0, -200);
+    aos[i].speciesSeen.push_back(i % 12);
+  }
+  auto aosTick = [&](float dt) {
+    for (auto &v : aos) {
+      v.timeInPark += dt;
+      v.hunger = std::clamp(v.hunger - 0.0003f * dt, 0.0f, 1.0f);
+      v.thirst = std::clamp(v.thirst - 0.0005f * dt, 0.0f, 1.0f);
+      v.energy = std::clamp(v.energy - 0.0002f * dt, 0.0f, 1.0f);
+      v.excitement = std::clamp(v.excitement - 0.0001f * dt, 0.0f, 1.0f);
+      v.fear = std::max(0.0f, v.fear - 0.1f * dt);
+      float avg =
+          (v.hunger + v.thirst + v.energy + v.excitement + v.comfort) / 5.0f;
+      if (v.fear > 0.5f)
+        v.mood = VisitorMood::Terrified;
+      else if (avg > 0.8f)
+        v.mood = VisitorMood::Ecstatic;
+      else if (avg > 0.6f)
+        v.mood = VisitorMood::Happy;
+      else if (avg > 0.4f)
+        v.mood = VisitorMood::Neutral;
+      else
+        v.mood = VisitorMood::Unhappy;
+      float eat = (1.0f - v.hunger) * 2.0f, rest = (1.0f - v.energy) * 1.5f;
+      v.action = eat > 0.5f    ? VisitorAction::Eating
+                 : rest > 0.5f ? VisitorAction::Resting
+                               : VisitorAction::Exploring;
+      if (v.timeInPark > v.maxStayTime)
+        v.action = VisitorAction::Leaving;
+      v.satisfaction = v.satisfaction * 0.99f + 0.005f;
+      Vec3 delta = v.target - v.position;
+      float dist = delta.Length();
+      if (dist > 1.0f)
+        v.position = v.position + delta * (v.speed * dt / dist);
+    }
+    aos.erase(std::remove_if(aos.begin(), aos.end(),
+                             [](const AoSVisitor &v) {
+                               return v.action == VisitorAction::Leaving &&
+                                      v.timeInPark > v.maxStayTime + 60.0f;
+                             }),
+              aos.end());
+  };
+
+  const int ticks = 100;
+  double soaMs = MeasureMs([&] {
+                   for (int t = 0; t < ticks; ++t)
+                     ai.Update(0.016f, 3.0f, false);
+                 }) /
+                 ticks;
+  double aosMs = MeasureMs([&] {
+                   for (int t = 0; t < ticks; ++t)
+                     aosTick(0.016f);
+                 }) /
+                 ticks;
+  g_sink = g_sink + uint32_t(ai.GetAverageSatisfaction() * 100.0f) +
+           uint32_t(aos.size());
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "  " << ai.GetVisitorCount() << " visitors: SoA " << soaMs
+            << " ms/tick, AoS " << aosMs << " ms/tick (target < 1 ms)"
+            << std::endl;
+}
+
+// =========================================================================
+// Bench 13: Visitor Sightings (grid join + batched events, 100k visitors)
+// =========================================================================
+void BenchVisitorSightings() {
+  std::cout << "[Bench] VisitorSightings..." << std::endl;
+  using namespace Mesozoic::Gameplay;
+  const uint32_t count = 100000, dinoCount = 2000;
+
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<float> coord(-1000.0f, 1000.0f);
+  VisitorAI ai;
+  ai.Reserve(count);
+  for (uint32_t i = 0; i < count; ++i)
+    ai.SpawnVisitor(Vec3(coord(rng), 0.0f, coord(rng)));
+  std::vector<SightingTarget> dinos(dinoCount);
+  for (uint32_t i = 0; i < dinoCount; ++i)
+    dinos[i] = {Vec3(coord(rng), 0.0f, coord(rng)), i % 24};
+  std::vector<Viewpoint> viewpoints;
+  for (int i = 0; i < 8; ++i)
+    viewpoints.push_back({Vec3(coord(rng), 0.0f, coord(rng)), 15.0f, 120.0f});
+
+  SightingGrid grid;
+  std::vector<Sighting> events;
+  const int reps = 10;
+  double joinMs = MeasureMs([&] {
+                    for (int r = 0; r < reps; ++r) {
+                      events.clear();
+                      grid.Build(dinos);
+                      grid.Join(ai.Store(), viewpoints, events);
+                    }
+                  }) /
+                  reps;
+  double processMs = MeasureMs([&] { ai.ProcessSightings(events); });
+
+  // Every visitor against every dinosaur, as a per-visitor vision scan
+  const VisitorStore &store = ai.Store();
+  size_t bruteEvents = 0;
+  double bruteMs = MeasureMs([&] {
+    for (size_t i = 0; i < store.Size(); ++i) {
+      Vec3 p(store.posX[i], store.posY[i], store.posZ[i]);
+      float range = grid.groundRange;
+      for (const auto &vp : viewpoints)
+        if ((p - vp.position).LengthSq() <= vp.radius * vp.radius)
+          range = std::max(range, vp.viewRange);
+      uint64_t seen = 0;
+      for (const auto &d : dinos)
+        if ((d.position - p).LengthSq() <= range * range)
+          seen |= uint64_t(1) << d.speciesId;
+      bruteEvents += size_t(std::popcount(seen));
+    }
+  });
+
+  // Linear id scan per event (the old OnDinosaurSeen), timed on an evenly
+  // spaced sample
+  const size_t sample = std::min<size_t>(1000, events.size());
+  size_t found = 0;
+  double linearMs = MeasureMs([&] {
+    for (size_t e = 0; e < sample; ++e)
+      found += size_t(std::find(store.ids.begin(), store.ids.end(),
+                                events[e * events.size() / sample].visitorId) -
+                      store.ids.begin());
+  });
+  double linearEstMs =
+      sample ? linearMs * double(events.size()) / double(sample) : 0.0;
+  g_sink = g_sink + uint32_t(found) + uint32_t(bruteEvents) +
+           uint32_t(ai.GetAverageSatisfaction() * 100.0f);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "  " << events.size() << " sightings (brute force "
+            << bruteEvents << "), " << grid.CellCount() << " cells"
+            << std::endl;
+  std::cout << "  Grid join " << joinMs << " ms vs brute force " << bruteMs
+            << " ms (" << bruteMs / joinMs << "x)" << std::endl;
+  std::cout << "  Batched events " << processMs << " ms vs linear lookup ~"
+            << linearEstMs << " ms" << std::endl;
+}
+
+// =========================================================================
+// Bench 14: Crowd (field + routing + queues, 50k visitors)
+// =========================================================================
+void BenchCrowd() {
+  std::cout << "[Bench] Crowd..." << std::endl;
+  using namespace Mesozoic::Gameplay;
+  const uint32_t count = 50000;
+
+  std::mt19937 rng(14);
+  std::uniform_real_distribution<float> coord(-450.0f, 450.0f);
+  std::uniform_real_distribution<float> need(0.0f, 1.0f);
+  const BuildingType types[] = {
+      BuildingType::Restaurant, BuildingType::GiftShop,
+      BuildingType::Restroom, BuildingType::VisitorCenter,
+      BuildingType::ViewingPlatform};
+  std::vector<Building> buildings;
+  for (uint32_t i = 0; i < 40; ++i) {
+    buildings.push_back(
+        Building::Create(types[i % 5], Vec3(coord(rng), 0.0f, coord(rng))));
+    buildings.back().id = i;
+  }
+  CrowdSystem crowd;
+  crowd.SyncBuildings(buildings);
+
+  VisitorAI ai;
+  ai.Reserve(count + 16);
+  for (uint32_t i = 0; i < count; ++i)
+    ai.SpawnVisitor(Vec3(coord(rng), 0.0f, coord(rng)));
+  VisitorStore &store = ai.Store();
+  for (size_t i = 0; i < store.Size(); ++i) {
+    store.hunger[i] = need(rng);
+    store.energy[i] = need(rng);
+    store.excitement[i] = need(rng);
+  }
+
+  // The first tick routes every visitor at once; later ticks only route
+  // visitors who were just served
+  const int ticks = 50;
+  const float dt = 0.5f;
+  ai.Update(dt, 3.0f, false);
+  double firstMs = MeasureMs([&] { crowd.Update(store, dt); });
+  double aiMs = 0.0, crowdMs = 0.0;
+  for (int t = 0; t < ticks; ++t) {
+    aiMs += MeasureMs([&] { ai.Update(dt, 3.0f, false); });
+    crowdMs += MeasureMs([&] { crowd.Update(store, dt); });
+  }
+  uint64_t served = 0, waiting = 0;
+  for (const auto &f : crowd.Facilities()) {
+    served += f.served;
+    waiting += f.waiting;
+  }
+  g_sink = g_sink + uint32_t(served) + uint32_t(crowd.CollectRevenue());
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "  " << store.Size() << " visitors, "
+            << crowd.Facilities().size() << " facilities, "
+            << crowd.Field().CellCount() << " cells: visitors "
+            << aiMs / ticks << " ms + crowd " << crowdMs / ticks
+            << " ms per tick" << std::endl;
+  std::cout << "  First tick routing " << firstMs << " ms, " << waiting
+            << " queued, " << served << " served" << std::endl;
+}
+
+// =========================================================================
+// Bench 15: Panic (fear field + evacuation routes, 50k visitors)
+// =========================================================================
+void BenchPanic() {
+  std::cout << "[Bench] Panic..." << std::endl;
+  using namespace Mesozoic::Gameplay;
+  const uint32_t count = 50000;
+
+  std::mt19937 rng(15);
+  std::uniform_real_distribution<float> coord(-450.0f, 450.0f);
+  VisitorAI ai;
+  ai.Reserve(count + 16);
+  for (uint32_t i = 0; i < count; ++i)
+    ai.SpawnVisitor(Vec3(coord(rng), 0.0f, coord(rng)));
+  std::vector<Vec3> loose;
+  for (int i = 0; i < 4; ++i)
+    loose.push_back(Vec3(coord(rng), 0.0f, coord(rng)));
+
+  PanicSystem panic;
+  panic.exits = {Vec3(0, 0, -450), Vec3(450, 0, 0), Vec3(-450, 0, 200)};
+  VisitorStore &store = ai.Store();
+  const int ticks = 60;
+  const float dt = 0.25f; // Routes rebuild every fourth tick
+  double panicMs = 0.0, aiMs = 0.0;
+  for (int t = 0; t < ticks; ++t) {
+    panicMs += MeasureMs([&] { panic.Update(store, loose, dt); });
+    aiMs += MeasureMs([&] { ai.Update(dt, 3.0f, false); });
+  }
+  EvacuationField evac;
+  double buildMs = MeasureMs([&] {
+    evac.Build(panic.Field(), panic.exits);
+  });
+  int fleeing = 0;
+  for (VisitorAction a : store.action)
+    fleeing += a == VisitorAction::Fleeing;
+  g_sink = g_sink + uint32_t(fleeing);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "  " << store.Size() << " visitors, " << loose.size()
+            << " loose: panic " << panicMs / ticks << " ms + visitors "
+            << aiMs / ticks << " ms per tick, " << fleeing << " fleeing"
+            << std::endl;
+  std::cout << "  Evacuation route rebuild " << buildMs << " ms" << std::endl;
+}
+
+// =========================================================================
+// Main
+// =========================================================================
+
+int main() {
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " Mesozoic Genesis - Benchmarks" << std::endl;
+  std::cout << "========================================\n" << std::endl;
+
+  BenchAnimationCompression();
+  BenchMorphKernel();
+  BenchMorphCache();
+  BenchGLBLoad();
+  BenchMipmaps();
+  BenchPNGDecode();
+  BenchBCnEncode();
+  BenchVirtualTexture();
+  BenchUIBatching();
+  BenchUIText();
+  BenchPerfHUD();
+  BenchVisitorTick();
+  BenchVisitorSightings();
+  BenchCrowd();
+  BenchPanic();
+
+  std::cout << "\n========================================" << std::endl;
+  std::cout << " Benchmarks complete" << std::endl;
+  std::cout << "========================================\n" << std::endl;
+  return 0;
+}
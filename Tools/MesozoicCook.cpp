@@ -0,0 +1,190 @@
+// =========================================================================
+// MesozoicCook: offline asset cooker
+// =========================================================================
+// Converts source assets into a baked .mpak the game maps at startup.
+//
+//   MesozoicCook <output.mpak> [--builtin] [--compress=MODE] [inputs...]
+//
+//   --builtin     Procedural dinosaur + grass meshes, the dinosaur morph set
+//                 and the baked idle/walk/run bone atlas
+//   --compress    Texture encoding for the inputs that follow:
+//                   fast (default)  BC1 opaque / BC3 with alpha / BC5 normals
+//                   quality         BC7 color / BC5 normals
+//                   none            RGBA8
+//   *.gltf *.glb  Every mesh primitive ("<mesh>" or "<mesh>#<primitive>")
+//   *.bmp *.png   Textures, stored with their mip chain. Names ending in
+//                 _n, _nrm or _normal are treated as tangent-space normals.
+
+#include "../Assets/AssetPak.h"
+#include "../Assets/BCnEncoder.h"
+#include "../Assets/GLBLoader.h"
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace Mesozoic::Assets;
+
+static bool EndsWith(const std::string &s, const std::string &suffix) {
+  if (s.size() < suffix.size())
+    return false;
+  std::string tail = s.substr(s.size() - suffix.size());
+  for (auto &c : tail)
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return tail == suffix;
+}
+
+static std::string BaseName(const std::string &path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.find_last_of('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+static bool CookScene(PakWriter &pak, const std::string &path) {
+  GLTFScene scene =
+      EndsWith(path, ".glb") ? GLBLoader::Load(path) : GLTFLoader::Load(path);
+  if (scene.meshes.empty()) {
+    std::cerr << "[Cook] No meshes in " << path << std::endl;
+    return false;
+  }
+  for (size_t m = 0; m < scene.meshes.size(); ++m) {
+    const GLTFMesh &mesh = scene.meshes[m];
+    std::string base = mesh.name.empty() ? BaseName(path) + "_" +
+                                               std::to_string(m)
+                                         : mesh.name;
+    for (size_t p = 0; p < mesh.primitives.size(); ++p) {
+      std::string name =
+          p == 0 ? base : base + "#" + std::to_string(p);
+      if (!pak.AddMesh(name, PakCook::ToUberMesh(mesh.primitives[p])))
+        return false;
+      std::cout << "[Cook] Mesh " << name << " ("
+                << mesh.primitives[p].vertices.size() << " verts)"
+                << std::endl;
+    }
+  }
+  return true;
+}
+
+enum class Compression { None, Fast, Quality };
+
+static const char *FormatName(PixelFormat format) {
+  switch (format) {
+  case PixelFormat::BC1:
+    return "BC1";
+  case PixelFormat::BC3:
+    return "BC3";
+  case PixelFormat::BC5:
+    return "BC5";
+  case PixelFormat::BC7:
+    return "BC7";
+  default:
+    return "RGBA8";
+  }
+}
+
+static bool CookTexture(PakWriter &pak, const std::string &path,
+                        Compression compression,
+                        Mesozoic::Core::Threading::JobSystem &jobs) {
+  TextureData tex = TextureLoader::LoadFromFile(path);
+  if (!tex.valid) {
+    std::cerr << "[Cook] Failed to load texture " << path << std::endl;
+    return false;
+  }
+  std::string name = BaseName(path);
+  bool normalMap = EndsWith(name, "_n") || EndsWith(name, "_nrm") ||
+                   EndsWith(name, "_normal");
+  bool hasAlpha = false;
+  for (size_t i = 3; i < tex.pixels.size() && !hasAlpha; i += 4)
+    hasAlpha = tex.pixels[i] != 255;
+
+  MipSettings mips;
+  mips.normalMap = normalMap;
+  mips.srgb = !normalMap;
+  mips.jobs = &jobs;
+  TextureLoader::GenerateMipmaps(tex, mips);
+  tex.srgb = !normalMap;
+
+  if (compression != Compression::None) {
+    BCnSettings bc;
+    bc.jobs = &jobs;
+    if (normalMap)
+      bc.format = PixelFormat::BC5;
+    else if (compression == Compression::Quality)
+      bc.format = PixelFormat::BC7;
+    else
+      bc.format = hasAlpha ? PixelFormat::BC3 : PixelFormat::BC1;
+    bc.quality = compression == Compression::Quality ? BCnQuality::Quality
+                                                     : BCnQuality::Fast;
+    if (!BCnEncoder::Compress(tex, bc))
+      return false;
+  }
+  if (!pak.AddTexture(name, tex))
+    return false;
+  std::cout << "[Cook] Texture " << name << " (" << tex.width << "x"
+            << tex.height << ", " << tex.mipLevels << " mips, "
+            << FormatName(tex.format) << ", " << tex.pixels.size() / 1024
+            << " KB)" << std::endl;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: MesozoicCook <output.mpak> [--builtin] "
+                 "[--compress=fast|quality|none] [inputs...]"
+              << std::endl;
+    return 1;
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::string output = argv[1];
+  PakWriter pak;
+  Mesozoic::Core::Threading::JobSystem jobs;
+  Compression compression = Compression::Fast;
+  bool ok = true;
+
+  for (int i = 2; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--builtin") {
+      if (PakCook::AddBuiltinAssets(pak)) {
+        std::cout << "[Cook] Built-in dinosaur, grass, morphs and animations"
+                  << std::endl;
+      } else {
+        ok = false;
+      }
+    } else if (arg.rfind("--compress=", 0) == 0) {
+      std::string mode = arg.substr(11);
+      if (mode == "fast") {
+        compression = Compression::Fast;
+      } else if (mode == "quality") {
+        compression = Compression::Quality;
+      } else if (mode == "none") {
+        compression = Compression::None;
+      } else {
+        std::cerr << "[Cook] Unknown compression mode: " << mode << std::endl;
+        ok = false;
+      }
+    } else if (EndsWith(arg, ".gltf") || EndsWith(arg, ".glb")) {
+      ok &= CookScene(pak, arg);
+    } else if (EndsWith(arg, ".bmp") || EndsWith(arg, ".png")) {
+      ok &= CookTexture(pak, arg, compression, jobs);
+    } else {
+      std::cerr << "[Cook] Unknown input type: " << arg << std::endl;
+      ok = false;
+    }
+  }
+
+  if (!ok) {
+    std::cerr << "[Cook] Errors above, not writing " << output << std::endl;
+    return 1;
+  }
+  if (!pak.WriteFile(output))
+    return 1;
+
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::high_resolution_clock::now() - start)
+                  .count();
+  std::cout << "[Cook] Wrote " << output << ": " << pak.EntryCount()
+            << " entries in " << ms << " ms" << std::endl;
+  return 0;
+}